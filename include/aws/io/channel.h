@@ -26,6 +26,10 @@ typedef void(aws_channel_on_setup_completed_fn)(struct aws_channel *channel, int
 /* Callback called when a channel is completely shutdown. error_code refers to the reason the channel was closed. */
 typedef void(aws_channel_on_shutdown_completed_fn)(struct aws_channel *channel, int error_code, void *user_data);
 
+/* Callback called on the event loop's thread once aws_channel_prewarm_event_loop() has finished. */
+typedef void(
+    aws_channel_on_event_loop_prewarmed_fn)(struct aws_event_loop *event_loop, int error_code, void *user_data);
+
 struct aws_channel_slot {
     struct aws_allocator *alloc;
     struct aws_channel *channel;
@@ -119,6 +123,12 @@ struct aws_channel_handler_vtable {
      * associated with the channel's handler chain.
      */
     void (*gather_statistics)(struct aws_channel_handler *handler, struct aws_array_list *stats_list);
+
+    /**
+     * Optional. Directs the channel handler to release any buffers it is holding but not currently using. The
+     * handler must be able to reacquire them on demand. Called from the channel's event loop thread.
+     */
+    void (*trim)(struct aws_channel_handler *handler);
 };
 
 struct aws_channel_handler {
@@ -150,6 +160,36 @@ struct aws_channel_options {
     bool enable_read_back_pressure;
 };
 
+/**
+ * Options for the periodic trimmer configured via aws_channel_trim_event_loop_resources().
+ *
+ * interval_ms is how often the trimmer runs. Zero disables the trimmer.
+ *
+ * If rss_threshold_bytes is non-zero, the trimmer only releases memory while the process's resident set size is
+ * above it. Otherwise memory is released on every interval. The RSS threshold is currently only supported on Linux.
+ */
+struct aws_channel_trim_options {
+    uint64_t interval_ms;
+    uint64_t rss_threshold_bytes;
+};
+
+/**
+ * Options for aws_channel_shutdown_event_loop_channels().
+ *
+ * error_code is passed to every channel's shutdown, as it would be by aws_channel_shutdown().
+ *
+ * If abortive is true, handlers are asked to free their resources immediately instead of flushing pending writes, and
+ * socket handlers reset their connections (SO_LINGER 0) rather than closing them gracefully.
+ *
+ * batch_size is the maximum number of channels whose shutdown is started per event-loop task run, so other work on
+ * the loop isn't starved while a large number of channels is drained. Zero uses a default.
+ */
+struct aws_channel_bulk_shutdown_options {
+    int error_code;
+    bool abortive;
+    size_t batch_size;
+};
+
 AWS_EXTERN_C_BEGIN
 
 extern AWS_IO_API size_t g_aws_channel_max_fragment_size;
@@ -193,6 +233,26 @@ void aws_channel_destroy(struct aws_channel *channel);
 AWS_IO_API
 int aws_channel_shutdown(struct aws_channel *channel, int error_code);
 
+/**
+ * Starts shutdown of every channel that has finished setup on event_loop, without scheduling a task per channel:
+ * channels are shut down in batches from tasks on the loop. Channels set up after the request is processed are not
+ * affected. Each channel's shutdown completes and notifies its owner as usual.
+ *
+ * This function is safe to call from any thread. The work is performed asynchronously on event_loop's thread.
+ */
+AWS_IO_API
+int aws_channel_shutdown_event_loop_channels(
+    struct aws_event_loop *event_loop,
+    const struct aws_channel_bulk_shutdown_options *options);
+
+/**
+ * Returns true if the channel's shutdown was started by an abortive aws_channel_shutdown_event_loop_channels().
+ * Handlers that own a transport should then tear it down without a graceful close. This must be called from the
+ * channel's thread.
+ */
+AWS_IO_API
+bool aws_channel_is_shutdown_abortive(struct aws_channel *channel);
+
 /**
  * Prevent a channel's memory from being freed.
  * Any number of users may acquire a hold to prevent a channel and its handlers from being unexpectedly freed.
@@ -299,13 +359,53 @@ void aws_channel_schedule_task_future(
  * Assigning a statistics handler to a channel is a transfer of ownership -- the channel will clean up
  * the handler appropriately.  Statistics handlers may be changed dynamically (for example, the upgrade
  * from a vanilla http channel to a websocket channel), but this function may only be called from the
- * event loop thread that the channel is a part of.
+ * event loop thread that the channel is a part of. On failure, ownership of handler stays with the caller and the
+ * channel keeps its current handler.
  *
  * The first possible hook to set a statistics handler is the channel's creation callback.
+ *
+ * Channels do not run their own timers: a single task per event loop samples every instrumented channel on the loop.
+ * Report times are aligned to multiples of the handler's report interval on the loop's clock, so channels sharing an
+ * interval are sampled together, and a channel's first sample interval may be shorter than the report interval.
  */
 AWS_IO_API
 int aws_channel_set_statistics_handler(struct aws_channel *channel, struct aws_crt_statistics_handler *handler);
 
+/**
+ * Asks each handler in the channel to release any buffers it is holding but not currently using (see the trim
+ * function in aws_channel_handler_vtable). This function may only be called from the channel's event loop thread.
+ */
+AWS_IO_API
+void aws_channel_trim(struct aws_channel *channel);
+
+/**
+ * Returns memory held by the channels on event_loop to the allocator: cached messages in the loop's message pool are
+ * freed and aws_channel_trim() is invoked on every active channel.
+ *
+ * If options is NULL, this happens once, as soon as possible. This is the hook for an external memory-pressure signal.
+ * Otherwise, options (re)configure the loop's periodic trimmer and no immediate trim is performed.
+ *
+ * This function is safe to call from any thread. The work is performed asynchronously on event_loop's thread.
+ */
+AWS_IO_API
+int aws_channel_trim_event_loop_resources(
+    struct aws_event_loop *event_loop,
+    const struct aws_channel_trim_options *options);
+
+/**
+ * Prepares event_loop for its first channels, so the first connections don't pay for lazy initialization: the shared
+ * message pool used by channels on the loop is created and filled, and its memory pre-faulted. Since the work runs as
+ * a task on the loop, it also wakes the loop's thread and exercises its cross-thread task queue.
+ *
+ * on_completed is optional and is invoked on event_loop's thread when pre-warming finishes or fails.
+ * This function is safe to call from any thread.
+ */
+AWS_IO_API
+int aws_channel_prewarm_event_loop(
+    struct aws_event_loop *event_loop,
+    aws_channel_on_event_loop_prewarmed_fn *on_completed,
+    void *user_data);
+
 /**
  * Returns true if the caller is on the event loop's thread. If false, you likely need to use
  * aws_channel_schedule_task(). This function is safe to call from any thread.
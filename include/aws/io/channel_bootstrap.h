@@ -5,9 +5,12 @@
  * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
  * SPDX-License-Identifier: Apache-2.0.
  */
+#include <aws/common/array_list.h>
+#include <aws/common/atomics.h>
 #include <aws/common/ref_count.h>
 #include <aws/io/channel.h>
 #include <aws/io/host_resolver.h>
+#include <aws/io/socket_channel_handler.h>
 
 struct aws_client_bootstrap;
 struct aws_socket;
@@ -66,6 +69,12 @@ struct aws_client_bootstrap {
     struct aws_ref_count ref_count;
     aws_client_bootstrap_shutdown_complete_fn *on_shutdown_complete;
     void *user_data;
+    /* struct aws_socket_endpoint, the local addresses connections are bound to, by family, see
+     * aws_client_bootstrap_options. Each family takes its own turns. */
+    struct aws_array_list local_ipv4_addresses;
+    struct aws_array_list local_ipv6_addresses;
+    struct aws_atomic_var next_local_ipv4_address;
+    struct aws_atomic_var next_local_ipv6_address;
 };
 
 /**
@@ -89,6 +98,15 @@ struct aws_client_bootstrap_options {
 
     /* Optional. Passed to callbacks */
     void *user_data;
+
+    /* Optional. If set, every event loop in event_loop_group is pre-warmed via aws_channel_prewarm_event_loop(). */
+    bool prewarm_event_loops;
+
+    /* Optional. IPv4 and/or IPv6 addresses to spread outgoing TCP connections across. Each connection attempt is bound
+     * to the next address of its family, round-robin, before connecting, see aws_socket_bind_for_connect(). Attempts
+     * to a family that isn't in the list aren't bound. Not supported on Windows. Copied. */
+    const struct aws_byte_cursor *local_addresses;
+    size_t local_address_count;
 };
 
 struct aws_server_bootstrap;
@@ -155,7 +173,8 @@ struct aws_server_bootstrap {
  * host_name - host to connect to; if a dns address, will be resolved prior to connecting
  * port - port to connect to
  * socket_options - socket properties, including type (tcp vs. udp vs. unix domain) and connect timeout.  TLS
- *   connections are currently restricted to tcp (AWS_SOCKET_STREAM) only.
+ *   connections are currently restricted to tcp (AWS_SOCKET_STREAM) only. A udp (AWS_SOCKET_DGRAM) channel starts with
+ *   a datagram socket handler, see aws_socket_datagram_handler_new(), except on Windows.
  * tls_options - (optional) tls context to apply after connection establishment.  If NULL, the connection will
  *   not be protected by TLS.
  * creation_callback - (optional) callback invoked when the channel is first created.  This is always right after
@@ -178,6 +197,9 @@ struct aws_socket_channel_bootstrap_options {
     aws_client_bootstrap_on_channel_event_fn *setup_callback;
     aws_client_bootstrap_on_channel_event_fn *shutdown_callback;
     bool enable_read_back_pressure;
+    /* if set, the channel's socket handler adapts how much it reads per event-loop tick between these bounds, see
+     * aws_socket_handler_options. Copied. */
+    const struct aws_socket_handler_read_budget_options *adaptive_read_budget;
     void *user_data;
 };
 
@@ -206,6 +228,28 @@ struct aws_server_socket_channel_bootstrap_options {
     aws_server_bootstrap_on_accept_channel_shutdown_fn *shutdown_callback;
     aws_server_bootstrap_on_server_listener_destroy_fn *destroy_callback;
     bool enable_read_back_pressure;
+    /*
+     * TCP only, not supported on Windows. If true, instead of one listener whose event loop accepts every connection
+     * and hands it off, one SO_REUSEPORT listener is opened per event loop in the bootstrap's group. Each loop accepts
+     * its own connections and owns the resulting channels, and the kernel spreads incoming connections across the
+     * listeners. Callbacks for a connection are invoked on the event loop that accepted it. The returned socket is the
+     * first listener; passing it to `aws_server_bootstrap_destroy_socket_listener` tears down all of them.
+     */
+    bool shard_across_event_loops;
+    /*
+     * Linux only, can't be combined with shard_across_event_loops. If true, each accepted connection goes to the event
+     * loop pinned to the CPU that processes its incoming packets (SO_INCOMING_CPU), or the pinned loop closest to that
+     * CPU, so the connection's data stays in that CPU's caches. The bootstrap's event loop group must be pinned to
+     * CPUs, see aws_event_loop_group_new_default_pinned_to_cpus(). Connections whose CPU can't be determined are
+     * spread across the loops as usual.
+     */
+    bool steer_by_incoming_cpu;
+    /* if set, each incoming channel's socket handler adapts how much it reads per event-loop tick between these
+     * bounds, see aws_socket_handler_options. Copied. */
+    const struct aws_socket_handler_read_budget_options *adaptive_read_budget;
+    /* Optional. If set, every event loop in the bootstrap's group is pre-warmed via aws_channel_prewarm_event_loop()
+     * once the listener is up, ahead of the first incoming channels. */
+    bool prewarm_event_loops;
     void *user_data;
 };
 
@@ -8,6 +8,7 @@
 
 #include <aws/common/atomics.h>
 #include <aws/common/hash_table.h>
+#include <aws/common/mutex.h>
 #include <aws/common/ref_count.h>
 #include <aws/io/io.h>
 
@@ -86,6 +87,14 @@ struct aws_event_loop {
     aws_io_clock_fn *clock;
     struct aws_hash_table local_data;
     void *impl_data;
+    /* busy-poll registrations (see aws_event_loop_register_busy_poll()). busy_poll_usec is read by the loop thread
+     * on every iteration; both fields are only modified while holding busy_poll_lock. */
+    struct aws_mutex busy_poll_lock;
+    size_t busy_poll_registrations;
+    struct aws_atomic_var busy_poll_usec;
+    /* the CPU the loop's thread is pinned to, or -1, also when pinning failed. Settled once the loop runs and not
+     * changed after that, see aws_event_loop_group_new_default_pinned_to_cpus(). */
+    int cpu_id;
 };
 
 struct aws_event_loop_local_object;
@@ -104,6 +113,8 @@ struct aws_event_loop_group {
     struct aws_allocator *allocator;
     struct aws_array_list event_loops;
     struct aws_atomic_var current_index;
+    /* rotates aws_event_loop_group_get_loop_for_cpu() among loops on the same CPU */
+    struct aws_atomic_var current_cpu_index;
     struct aws_ref_count ref_count;
     struct aws_shutdown_callback_options shutdown_options;
 };
@@ -314,6 +325,29 @@ bool aws_event_loop_thread_is_callers_thread(struct aws_event_loop *event_loop);
 AWS_IO_API
 int aws_event_loop_current_clock_time(struct aws_event_loop *event_loop, uint64_t *time_nanos);
 
+/**
+ * Registers interest in low-latency polling on this event loop. While at least one registration is active, an event
+ * loop that supports it spins, polling for IO without blocking, for up to spin_usec microseconds (the largest value
+ * registered) before going to sleep in the kernel. This trades CPU for wake-up latency and is meant to pair with
+ * sockets using SO_BUSY_POLL. Every call must be balanced with aws_event_loop_unregister_busy_poll().
+ * This function is thread-safe.
+ */
+AWS_IO_API
+void aws_event_loop_register_busy_poll(struct aws_event_loop *event_loop, uint32_t spin_usec);
+
+/**
+ * Drops a registration made with aws_event_loop_register_busy_poll(). Once the last registration is gone, the event
+ * loop stops spinning. This function is thread-safe.
+ */
+AWS_IO_API
+void aws_event_loop_unregister_busy_poll(struct aws_event_loop *event_loop);
+
+/**
+ * Returns how long, in microseconds, the event loop currently spins before blocking. 0 means it does not spin.
+ */
+AWS_IO_API
+uint32_t aws_event_loop_get_busy_poll_usec(struct aws_event_loop *event_loop);
+
 /**
  * Creates an event loop group, with clock, number of loops to manage, and the function to call for creating a new
  * event loop.
@@ -338,6 +372,18 @@ struct aws_event_loop_group *aws_event_loop_group_new_default(
     uint16_t max_threads,
     const struct aws_shutdown_callback_options *shutdown_options);
 
+/**
+ * Same as aws_event_loop_group_new_default(), except that each loop's thread is pinned to a CPU: loop i runs on CPU i
+ * modulo the number of processors. If max_threads == 0, there is one loop per processor.
+ *
+ * Only supported on Linux, elsewhere AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ */
+AWS_IO_API
+struct aws_event_loop_group *aws_event_loop_group_new_default_pinned_to_cpus(
+    struct aws_allocator *alloc,
+    uint16_t max_threads,
+    const struct aws_shutdown_callback_options *shutdown_options);
+
 /**
  * Increments the reference count on the event loop group, allowing the caller to take a reference to it.
  *
@@ -367,6 +413,13 @@ size_t aws_event_loop_group_get_loop_count(struct aws_event_loop_group *el_group
 AWS_IO_API
 struct aws_event_loop *aws_event_loop_group_get_next_loop(struct aws_event_loop_group *el_group);
 
+/**
+ * Fetches the loop pinned to cpu_id or, when none is, the pinned loop with the CPU number closest to it. When several
+ * loops are pinned to that CPU, they are handed out round-robin. Returns NULL if none of the group's loops are pinned.
+ */
+AWS_IO_API
+struct aws_event_loop *aws_event_loop_group_get_loop_for_cpu(struct aws_event_loop_group *el_group, int cpu_id);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_IO_EVENT_LOOP_H */
@@ -26,6 +26,7 @@ enum aws_io_message_type {
 
 struct aws_io_message;
 struct aws_channel;
+struct aws_socket_endpoint;
 
 typedef void(aws_channel_on_message_write_completed_fn)(
     struct aws_channel *channel,
@@ -63,6 +64,12 @@ struct aws_io_message {
      */
     size_t copy_mark;
 
+    /**
+     * Datagram channels only, see aws_socket_datagram_handler_new(). On a read message, the address the datagram came
+     * from. On a write message, the address to send it to, NULL sends it to the socket's connected peer.
+     */
+    struct aws_socket_endpoint *endpoint;
+
     /**
      * The channel that the message is bound to.
      */
@@ -52,6 +52,19 @@ void *aws_memory_pool_acquire(struct aws_memory_pool *mempool);
 AWS_IO_API
 void aws_memory_pool_release(struct aws_memory_pool *mempool, void *to_release);
 
+/**
+ * Frees cached segments until at most `retain_count` remain in the pool. Returns the number of segments freed.
+ */
+AWS_IO_API
+size_t aws_memory_pool_trim(struct aws_memory_pool *mempool, size_t retain_count);
+
+/**
+ * Refills the pool up to its ideal segment count and touches every cached segment so its pages are resident before
+ * first use.
+ */
+AWS_IO_API
+int aws_memory_pool_prewarm(struct aws_memory_pool *mempool);
+
 /**
  * Initializes message pool using 'msg_pool' as the backing pool, 'args' is copied.
  */
@@ -81,6 +94,20 @@ struct aws_io_message *aws_message_pool_acquire(
 AWS_IO_API
 void aws_message_pool_release(struct aws_message_pool *msg_pool, struct aws_io_message *message);
 
+/**
+ * Returns all cached, currently unused messages to the allocator. Messages that are still in use are unaffected and
+ * the pool refills on demand as they are released. Returns the number of bytes freed.
+ */
+AWS_IO_API
+size_t aws_message_pool_trim(struct aws_message_pool *msg_pool);
+
+/**
+ * Refills the pool and pre-faults the memory of every cached message, so first use doesn't pay for allocation or page
+ * faults.
+ */
+AWS_IO_API
+int aws_message_pool_prewarm(struct aws_message_pool *msg_pool);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_IO_MESSAGE_POOL_H */
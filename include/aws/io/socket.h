@@ -28,6 +28,9 @@ enum aws_socket_type {
     AWS_SOCKET_DGRAM,
 };
 
+/* Matches the kernel's limit on congestion control algorithm names, including the terminating null. */
+#define AWS_SOCKET_CONGESTION_CONTROL_MAX_LEN 16
+
 struct aws_socket_options {
     enum aws_socket_type type;
     enum aws_socket_domain domain;
@@ -41,6 +44,104 @@ struct aws_socket_options {
      * lost. If zero OS defaults are used. On Windows, this option is meaningless until Windows 10 1703.*/
     uint16_t keep_alive_max_failed_probes;
     bool keepalive;
+    /* TCP only, currently Linux only. If non-zero, SO_ZEROCOPY is enabled and writes of at least this many bytes are
+     * sent with MSG_ZEROCOPY: the kernel transmits straight from the caller's buffer instead of copying it. The write's
+     * completion callback is deferred until the kernel reports it no longer references the buffer. If the socket is
+     * closed while such writes are still outstanding, the connection stays open, without the socket, until the kernel
+     * reports them done (at most 30 seconds, it's reset after that) and is then closed gracefully. Their completion
+     * callbacks are invoked then, with a NULL socket. aws_socket_abort() resets the connection and completes them
+     * right away. Zero disables. */
+    uint32_t zero_copy_write_threshold;
+    /* TCP only. Sets TCP_NODELAY, disabling Nagle's algorithm so small writes are sent without waiting for ACKs. */
+    bool no_delay;
+    /* TCP only, Linux only. Sets TCP_QUICKACK, so received data is acknowledged right away instead of delayed. The
+     * kernel clears TCP_QUICKACK on its own, so it is set again after every aws_socket_read() that returns data,
+     * at the cost of one setsockopt() per read. */
+    bool quick_ack;
+    /* TCP only, Linux only. Queued buffer writes that are followed by a file write (aws_socket_write_file()) are sent
+     * with MSG_MORE, so the kernel can fill the last segment of the buffers with the start of the file. Buffer writes
+     * queued together already go out in a single send. */
+    bool cork_queued_writes;
+    /* TCP only. If non-zero, the IPv4 type-of-service or IPv6 traffic class byte (DSCP and ECN bits). */
+    uint8_t type_of_service;
+    /* If non-zero, SO_SNDBUF and SO_RCVBUF in bytes. These are applied before connecting or listening, so that the
+     * receive buffer is accounted for in the window scale negotiated for the connection. */
+    uint32_t send_buffer_size;
+    uint32_t receive_buffer_size;
+    /* TCP only, Linux only. If not empty, the name of the congestion control algorithm to use (TCP_CONGESTION), e.g.
+     * "bbr". The algorithm must be available to, and allowed for, the process. */
+    char congestion_control[AWS_SOCKET_CONGESTION_CONTROL_MAX_LEN];
+    /* If non-zero, low-latency busy polling, in microseconds. The socket sets SO_BUSY_POLL (and SO_PREFER_BUSY_POLL
+     * where available) so blocking reads poll the device queue, and while the socket is assigned to an event loop, the
+     * loop spins for up to this long before sleeping (see aws_event_loop_register_busy_poll()). Costs CPU on that
+     * loop's thread. Raising SO_BUSY_POLL above net.core.busy_read needs CAP_NET_ADMIN; the loop spins regardless. */
+    uint32_t busy_poll_usec;
+    /* Listeners only. The most connections accepted in one pass over the listen backlog. Connections beyond that are
+     * accepted from a follow-up task, so a connection storm can't starve everything else on the listener's event
+     * loop. Zero uses a default of 128. */
+    uint32_t max_accepts_per_tick;
+    /* TCP listeners only, Linux only. If non-zero, TCP_DEFER_ACCEPT: a connection is only handed to accept once the
+     * peer has sent data, or after roughly this many seconds, so connects that never send anything don't wake the
+     * event loop. */
+    uint32_t defer_accept_timeout_sec;
+    /* TCP and UDP only, not supported on Windows. Sets SO_REUSEPORT so several sockets can bind the same address and
+     * port. On Linux the kernel load-balances incoming connections (or datagrams) across them. */
+    bool reuse_port;
+    /* TCP clients only, Linux only. Connects with TCP_FASTOPEN_CONNECT: once the kernel holds a Fast Open cookie for
+     * the peer, the connection completes right away and the first write is carried in the SYN, saving a round trip.
+     * The first connection to a peer does a regular handshake to obtain the cookie. */
+    bool fast_open;
+    /* TCP listeners only. If non-zero, enables TCP Fast Open (TCP_FASTOPEN) with this many pending Fast Open requests
+     * allowed, so clients holding a cookie can send data in their SYN. On Linux, the server side must also be enabled
+     * in net.ipv4.tcp_fastopen. */
+    uint32_t fast_open_queue_length;
+    /* TCP and UDP only, Linux only. Enables SO_TIMESTAMPING software timestamps: the kernel stamps data as it is
+     * received, and sends as they are handed to the device, see aws_socket_get_kernel_timestamps(). */
+    bool kernel_timestamps;
+    /* TCP only. If non-zero, TCP_NOTSENT_LOWAT: the kernel takes no more data, and the socket doesn't report
+     * writable, while this many bytes sit in its send buffer unsent. A write completes once the kernel has taken all
+     * of it, so completions slow down with the peer and queued writes stay in user space until then. */
+    uint32_t notsent_low_watermark;
+};
+
+/**
+ * A sample of the kernel's view of a TCP connection, see aws_socket_get_transport_metrics().
+ */
+struct aws_socket_transport_metrics {
+    /* smoothed round trip time and its mean deviation, in microseconds */
+    uint32_t rtt_usec;
+    uint32_t rtt_variance_usec;
+    /* lowest round trip time seen on the connection, in microseconds. 0 if the kernel doesn't report it. */
+    uint32_t min_rtt_usec;
+    /* congestion window and slow start threshold, in segments of send_mss bytes */
+    uint32_t congestion_window;
+    uint32_t slow_start_threshold;
+    uint32_t send_mss;
+    /* segments in flight, and how many of those are considered lost */
+    uint32_t unacked_segments;
+    uint32_t lost_segments;
+    /* segments retransmitted over the life of the connection */
+    uint32_t total_retransmits;
+    /* the kernel's latest estimate of the connection's delivery rate, in bytes per second. 0 if not reported. */
+    uint64_t delivery_rate;
+    /* MSG_ZEROCOPY sends the kernel has reported done (see zero_copy_write_threshold), and how many of those it
+     * copied anyway, e.g. because the peer is on the same host */
+    uint64_t zero_copy_sends_completed;
+    uint64_t zero_copy_sends_copied;
+};
+
+/**
+ * The latest kernel timestamps of a socket with kernel_timestamps set, see aws_socket_get_kernel_timestamps(). Times
+ * are in nanoseconds since the Unix epoch (CLOCK_REALTIME), 0 until the first one is reported.
+ */
+struct aws_socket_kernel_timestamps {
+    /* when the kernel received the data most recently read from the socket */
+    uint64_t last_rx_ns;
+    /* when the most recently reported send was handed to the device */
+    uint64_t last_tx_ns;
+    /* which send last_tx_ns is for. On stream sockets, the offset of the send's last byte in the stream, counted from
+     * when the connection was established. On datagram sockets, the datagram's index. */
+    uint32_t last_tx_id;
 };
 
 struct aws_socket;
@@ -99,6 +200,26 @@ struct aws_socket_endpoint {
     uint16_t port;
 };
 
+/**
+ * One datagram of aws_socket_receive_batch() or aws_socket_send_batch().
+ */
+struct aws_socket_datagram {
+    /**
+     * Receiving, the datagram is read into the remaining space in the buffer. Sending, the buffer's contents are the
+     * datagram, they have to stay valid until its written_fn is invoked.
+     */
+    struct aws_byte_buf *buffer;
+    /**
+     * Receiving, set to the address the datagram came from, can be NULL. Sending, where the datagram goes, NULL sends
+     * it to the connected peer.
+     */
+    struct aws_socket_endpoint *endpoint;
+    /**
+     * Sending only, passed to written_fn for this datagram.
+     */
+    void *user_data;
+};
+
 struct aws_socket {
     struct aws_allocator *allocator;
     struct aws_socket_endpoint local_endpoint;
@@ -176,6 +297,17 @@ AWS_IO_API int aws_socket_connect(
  */
 AWS_IO_API int aws_socket_bind(struct aws_socket *socket, const struct aws_socket_endpoint *local_endpoint);
 
+/**
+ * TCP only. Binds the socket to a local address before `aws_socket_connect()`, to choose the local IP the connection
+ * is made from. With a port of 0, the kernel is told not to reserve a port at bind time (IP_BIND_ADDRESS_NO_PORT) but
+ * to pick one in connect(), where a port only has to be unique for the whole address 4-tuple. Spreading many
+ * connections to the same few destinations across several local IPs then multiplies the ephemeral ports available,
+ * and connect() doesn't slow down searching for a free one. local_endpoint is copied.
+ *
+ * Not supported on Windows, where AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ */
+AWS_IO_API int aws_socket_bind_for_connect(struct aws_socket *socket, const struct aws_socket_endpoint *local_endpoint);
+
 /**
  * TCP, LOCAL and VSOCK only. Sets up the socket to listen on the address bound to in `aws_socket_bind()`.
  */
@@ -207,10 +339,19 @@ AWS_IO_API int aws_socket_stop_accept(struct aws_socket *socket);
  * from the event-loop's thread unless this is a listening socket. If it's a listening socket it can be called from any
  * non-event-loop thread or the event-loop the socket is currently assigned to. If called from outside the event-loop,
  * this function will block waiting on the socket to close. If this is called from an event-loop thread other than
- * the one it's assigned to, it presents the possibility of a deadlock, so don't do it.
+ * the one it's assigned to, it presents the possibility of a deadlock, so don't do it. Pending writes are completed
+ * with AWS_IO_SOCKET_CLOSED, except for zero-copy writes the kernel is still sending from, see
+ * zero_copy_write_threshold.
  */
 AWS_IO_API int aws_socket_close(struct aws_socket *socket);
 
+/**
+ * Closes the socket abortively: lingering is disabled (SO_LINGER with a timeout of 0) before calling
+ * aws_socket_close(), so unsent data is discarded and a connected peer receives a reset instead of an orderly close.
+ * The same threading rules as aws_socket_close() apply.
+ */
+AWS_IO_API int aws_socket_abort(struct aws_socket *socket);
+
 /**
  * Calls `shutdown()` on the socket based on direction.
  */
@@ -265,6 +406,61 @@ AWS_IO_API int aws_socket_subscribe_to_readable_events(
  */
 AWS_IO_API int aws_socket_read(struct aws_socket *socket, struct aws_byte_buf *buffer, size_t *amount_read);
 
+/**
+ * Like aws_socket_read(), but for DGRAM sockets: reads exactly one datagram into the remaining space in the buffer,
+ * and, if source is not NULL, sets it to the address the datagram came from. A datagram bigger than the remaining space
+ * is truncated, the rest of it is lost. The socket only has to be bound, it doesn't have to be connected.
+ *
+ * Not supported on Windows, where AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ *
+ * NOTE! This function must be called from the event-loop used in aws_socket_assign_to_event_loop
+ */
+AWS_IO_API int aws_socket_receive_from(
+    struct aws_socket *socket,
+    struct aws_byte_buf *buffer,
+    struct aws_socket_endpoint *source,
+    size_t *amount_read);
+
+/**
+ * Like aws_socket_receive_from(), but receives up to count datagrams with as few syscalls as possible (recvmmsg() on
+ * Linux), each into its own aws_socket_datagram. datagrams_read is set to the number received, which fills the first
+ * datagrams_read entries; it can be less than count even when more datagrams are waiting, so keep receiving until
+ * AWS_IO_READ_WOULD_BLOCK is raised. That, or any other error, is only raised when no datagram was received.
+ *
+ * Not supported on Windows, where AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ *
+ * NOTE! This function must be called from the event-loop used in aws_socket_assign_to_event_loop
+ */
+AWS_IO_API int aws_socket_receive_batch(
+    struct aws_socket *socket,
+    struct aws_socket_datagram *datagrams,
+    size_t count,
+    size_t *datagrams_read);
+
+/**
+ * Like aws_socket_read(), but moves up to max_len bytes from the socket into a pipe with splice(), so they never pass
+ * through user space. pipe_fd is the pipe's non-blocking write end, and it must have room for max_len bytes: a full
+ * pipe is reported the same way as an empty socket, with AWS_IO_READ_WOULD_BLOCK.
+ *
+ * Only supported on Linux, elsewhere AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ */
+AWS_IO_API int aws_socket_read_to_pipe(struct aws_socket *socket, int pipe_fd, size_t max_len, size_t *amount_read);
+
+/**
+ * Like aws_socket_read(), but the data read goes into the file `fd` at `offset`, moved with splice() through a pipe
+ * the socket keeps for this, so it never passes through user space. fd is expected to be a regular file, its own
+ * offset is not used or changed. A failure to write the file is raised as an io error, and the data read with it is
+ * lost.
+ *
+ * Only supported on Linux, elsewhere AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ */
+AWS_IO_API int aws_socket_read_to_file(
+    struct aws_socket *socket,
+    int fd,
+    uint64_t offset,
+    size_t max_len,
+    size_t *amount_read);
+
 /**
  * Writes to the socket. This call is non-blocking and will attempt to write as much as it can, but will queue any
  * remaining portion of the data for write when available. written_fn will be invoked once the entire cursor has been
@@ -282,6 +478,106 @@ AWS_IO_API int aws_socket_write(
     aws_socket_on_write_completed_fn *written_fn,
     void *user_data);
 
+/**
+ * Like aws_socket_write(), but for DGRAM sockets: sends the cursor as one datagram to destination, or to the connected
+ * peer if destination is NULL. Datagrams are queued and ordered with the writes from aws_socket_write(), and each is
+ * sent whole or not at all. A datagram that fails to send (too big, unreachable destination, ...) only fails its own
+ * written_fn, the ones behind it are still sent. The socket only has to be bound, unless destination is NULL.
+ *
+ * Not supported on Windows, where AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ *
+ * NOTE! This function must be called from the event-loop used in aws_socket_assign_to_event_loop
+ */
+AWS_IO_API int aws_socket_send_to(
+    struct aws_socket *socket,
+    const struct aws_byte_cursor *cursor,
+    const struct aws_socket_endpoint *destination,
+    aws_socket_on_write_completed_fn *written_fn,
+    void *user_data);
+
+/**
+ * Like aws_socket_send_to(), but queues count datagrams at once, so they go out with as few syscalls as possible
+ * (sendmmsg() on Linux). written_fn is invoked once per datagram, with that datagram's user_data, whether it was sent
+ * or not. If any destination can't be parsed, or the socket can't send, an error is raised and none of the datagrams
+ * are queued.
+ *
+ * Not supported on Windows, where AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ *
+ * NOTE! This function must be called from the event-loop used in aws_socket_assign_to_event_loop
+ */
+AWS_IO_API int aws_socket_send_batch(
+    struct aws_socket *socket,
+    const struct aws_socket_datagram *datagrams,
+    size_t count,
+    aws_socket_on_write_completed_fn *written_fn);
+
+/**
+ * Writes `length` bytes of the file `fd`, starting at `offset`, to the socket with sendfile(), so the data goes from
+ * the page cache to the socket without being copied through user space. The write is queued behind, and ordered with,
+ * the writes from aws_socket_write(); written_fn will be invoked once the whole range has been written, or the write
+ * failed or was cancelled. If it failed, the amount passed to written_fn is how much of the range was written first.
+ * `fd` must stay open, and the range must stay readable, until then. The file's own offset is not used or changed.
+ *
+ * Only stream sockets on Linux support this, elsewhere AWS_ERROR_UNSUPPORTED_OPERATION is raised and the data has to be
+ * read and written with aws_socket_write() instead.
+ *
+ * NOTE! This function must be called from the event-loop used in aws_socket_assign_to_event_loop
+ */
+AWS_IO_API int aws_socket_write_file(
+    struct aws_socket *socket,
+    int fd,
+    uint64_t offset,
+    size_t length,
+    aws_socket_on_write_completed_fn *written_fn,
+    void *user_data);
+
+/**
+ * Writes the next `length` bytes of a pipe to the socket with splice(), the pipe's pages are moved rather than copied.
+ * The write is queued and ordered like aws_socket_write_file(); the bytes must already be in the pipe, or be written to
+ * it before the socket gets to them. pipe_fd is the pipe's non-blocking read end.
+ *
+ * Only stream sockets on Linux support this, elsewhere AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ *
+ * NOTE! This function must be called from the event-loop used in aws_socket_assign_to_event_loop
+ */
+AWS_IO_API int aws_socket_write_from_pipe(
+    struct aws_socket *socket,
+    int pipe_fd,
+    size_t length,
+    aws_socket_on_write_completed_fn *written_fn,
+    void *user_data);
+
+/**
+ * Samples the connection's round trip time, congestion window, retransmits and delivery rate from the kernel
+ * (TCP_INFO). The socket must be a TCP socket, otherwise AWS_IO_SOCKET_INVALID_OPERATION_FOR_TYPE is raised. Can be
+ * called from any thread while the socket is open.
+ *
+ * Only supported on Linux, elsewhere AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ */
+AWS_IO_API int aws_socket_get_transport_metrics(
+    struct aws_socket *socket,
+    struct aws_socket_transport_metrics *metrics);
+
+/**
+ * Gets the latest receive and send timestamps the kernel reported for a socket created with kernel_timestamps set.
+ * Receive timestamps are picked up by aws_socket_read(), send timestamps as the event loop processes them. Call from
+ * the socket's event loop thread.
+ *
+ * Only supported on Linux, elsewhere AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ */
+AWS_IO_API int aws_socket_get_kernel_timestamps(
+    struct aws_socket *socket,
+    struct aws_socket_kernel_timestamps *timestamps);
+
+/**
+ * Gets the CPU that last processed packets received on the socket (SO_INCOMING_CPU). With a multi-queue NIC that is
+ * usually the CPU handling the interrupts of the connection's receive queue. Raises AWS_ERROR_INVALID_STATE if the
+ * kernel hasn't recorded one yet.
+ *
+ * Only supported on Linux, elsewhere AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ */
+AWS_IO_API int aws_socket_get_incoming_cpu(struct aws_socket *socket, int *cpu_id);
+
 /**
  * Gets the latest error from the socket. If no error has occurred AWS_OP_SUCCESS will be returned. This function does
  * not raise any errors to the installed error handlers.
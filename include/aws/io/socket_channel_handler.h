@@ -8,10 +8,103 @@
 #include <aws/io/io.h>
 
 struct aws_socket;
+struct aws_channel;
 struct aws_channel_handler;
 struct aws_channel_slot;
 struct aws_event_loop;
 
+/**
+ * Invoked once the file range passed to aws_channel_slot_send_file() has been written, or the transfer failed.
+ * bytes_sent is how much of the range made it into the channel before a failure.
+ */
+typedef void(aws_channel_on_file_sent_fn)(
+    struct aws_channel *channel,
+    int error_code,
+    size_t bytes_sent,
+    void *user_data);
+
+struct aws_channel_send_file_options {
+    /* file to send from, it must stay open until on_completion is invoked. Its own offset is not used or changed. */
+    int fd;
+    uint64_t offset;
+    size_t length;
+    aws_channel_on_file_sent_fn *on_completion;
+    void *user_data;
+};
+
+/**
+ * Invoked once the file range passed to aws_channel_slot_receive_file() has been filled, or receiving it failed.
+ * bytes_received is how much of the range was written to the file.
+ */
+typedef void(aws_channel_on_file_received_fn)(
+    struct aws_channel *channel,
+    int error_code,
+    size_t bytes_received,
+    void *user_data);
+
+struct aws_channel_receive_file_options {
+    /* file to write to, it must stay open until on_completion is invoked. Its own offset is not used or changed. */
+    int fd;
+    uint64_t offset;
+    size_t length;
+    aws_channel_on_file_received_fn *on_completion;
+    void *user_data;
+};
+
+/**
+ * Invoked once a buffer lent with aws_channel_slot_lend_read_buffer() has been filled to capacity, or the channel
+ * shut down first. Either way the buffer is the caller's again, buffer->len is how much of it holds data.
+ */
+typedef void(aws_channel_on_read_buffer_filled_fn)(
+    struct aws_channel *channel,
+    int error_code,
+    struct aws_byte_buf *buffer,
+    void *user_data);
+
+struct aws_channel_lend_read_buffer_options {
+    /* bytes read from the socket are appended to buffer, from buffer->len up to buffer->capacity */
+    struct aws_byte_buf *buffer;
+    /* if NULL, only what the socket has right now is read, before aws_channel_slot_lend_read_buffer() returns.
+     * Otherwise the buffer stays lent until it is full, and on_filled is invoked then. */
+    aws_channel_on_read_buffer_filled_fn *on_filled;
+    void *user_data;
+};
+
+/**
+ * Bounds of an adaptive read budget, see aws_socket_handler_options.
+ */
+struct aws_socket_handler_read_budget_options {
+    /* the budget never shrinks below min_read_size or grows above max_read_size. 0 picks a default: a quarter of the
+     * handler's max_read_size, and 16 times it, respectively. */
+    size_t min_read_size;
+    size_t max_read_size;
+};
+
+struct aws_socket_handler_options {
+    /* the most bytes read from the socket in one event-loop tick before the handler yields to the rest of the loop, a
+     * task picks the read back up. With an adaptive budget, where the budget starts. */
+    size_t max_read_size;
+    /* if set, the per-tick read budget adapts to the loop: it doubles each time the socket uses up all of it while no
+     * other socket on the loop is doing the same, and halves while other sockets are also waiting to read more. */
+    const struct aws_socket_handler_read_budget_options *adaptive_read_budget;
+};
+
+struct aws_socket_datagram_handler_options {
+    /* the largest datagram read, bigger ones are truncated. 0, or more than a message from the channel's pool holds
+     * next to the datagram's source address, uses as much as that message holds. */
+    size_t max_datagram_size;
+    /* the most datagrams read in one event-loop tick before the handler yields to the rest of the loop, a task picks
+     * the read back up. 0 uses a default of 64. */
+    size_t max_datagrams_per_read;
+    /* the most datagrams read with one syscall, see aws_socket_receive_batch(). 0 uses a default of 32, it is capped at
+     * max_datagrams_per_read. */
+    size_t max_datagrams_per_receive;
+    /* the most write messages sent with one syscall, see aws_socket_send_batch(). Write messages are held until this
+     * many are waiting, or until a task scheduled by the first of them runs, and fail with AWS_IO_SOCKET_CLOSED if the
+     * socket closes first. 1 sends every message right away. 0 uses a default of 32. */
+    size_t max_datagrams_per_send;
+};
+
 AWS_EXTERN_C_BEGIN
 /**
  * Socket handlers should be the first slot/handler in a channel. It interacts directly with the channel's event loop
@@ -24,6 +117,84 @@ AWS_IO_API struct aws_channel_handler *aws_socket_handler_new(
     struct aws_channel_slot *slot,
     size_t max_read_size);
 
+/**
+ * Same as aws_socket_handler_new(), with the read behavior taken from options.
+ */
+AWS_IO_API struct aws_channel_handler *aws_socket_handler_new_with_options(
+    struct aws_allocator *allocator,
+    struct aws_socket *socket,
+    struct aws_channel_slot *slot,
+    const struct aws_socket_handler_options *options);
+
+/**
+ * Like aws_socket_handler_new(), but for a DGRAM socket, and message boundaries are kept: every datagram read is sent
+ * up the channel as a message of its own, with message->endpoint set to the address it came from. Each write message
+ * is sent as one datagram, to message->endpoint if it is set, otherwise to the socket's connected peer. A datagram
+ * that fails to send (too big, unreachable destination, ...) completes its message's on_completion with the error
+ * instead of failing the write, so it doesn't shut the channel down. Only a write after the socket closed raises
+ * AWS_IO_SOCKET_CLOSED. Reads and writes are batched, many datagrams per syscall, see
+ * aws_socket_datagram_handler_options.
+ *
+ * The socket only has to be bound, so one channel can serve many peers. Datagrams are only read while the downstream
+ * read window has room for max_datagram_size, since they can't be split. options may be NULL for the defaults.
+ *
+ * Not supported on Windows, where the socket's reads and writes fail with AWS_ERROR_UNSUPPORTED_OPERATION.
+ */
+AWS_IO_API struct aws_channel_handler *aws_socket_datagram_handler_new(
+    struct aws_allocator *allocator,
+    struct aws_socket *socket,
+    struct aws_channel_slot *slot,
+    const struct aws_socket_datagram_handler_options *options);
+
+/**
+ * Sends a range of a file down the channel, in the write direction from `slot`. When the slot to the left of `slot`
+ * is a socket handler, nothing else in the channel has to see the data, so the socket writes the range with sendfile()
+ * straight from the page cache, queued behind the messages already written. Otherwise (TLS sits in between, for
+ * example), or where the socket can't send files, the range is read into messages from the channel's pool and sent
+ * with aws_channel_slot_send_message(), one message at a time.
+ *
+ * Must be called from the channel's thread. on_completion is always invoked unless this returns AWS_OP_ERR.
+ */
+AWS_IO_API int aws_channel_slot_send_file(
+    struct aws_channel_slot *slot,
+    const struct aws_channel_send_file_options *options);
+
+/**
+ * Writes the next `length` bytes read from the socket into a range of a file, instead of sending them up the channel
+ * as messages. The slot to the left of `slot` must be a socket handler, the bytes are moved from the socket into the
+ * file with splice() and never copied into user space. They count against the read window of `slot` as if they had
+ * been delivered to it, so with read back pressure enabled, the caller opens the window again as it would for
+ * messages. Once the range is filled, reading continues with messages as before.
+ *
+ * Must be called from the channel's thread, and only one range can be received at a time. on_completion is always
+ * invoked unless this returns AWS_OP_ERR, with AWS_ERROR_IO_OPERATION_CANCELLED if the channel shuts down first.
+ *
+ * Only supported on Linux, elsewhere AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ */
+AWS_IO_API int aws_channel_slot_receive_file(
+    struct aws_channel_slot *slot,
+    const struct aws_channel_receive_file_options *options);
+
+/**
+ * Lends the socket handler to the left of `slot` a buffer to read into, so the bytes land where the handler in `slot`
+ * wants them instead of in messages it would copy them out of. Like messages, they count against the read window of
+ * `slot`, and they follow everything already sent up the channel.
+ *
+ * Without options->on_filled, whatever the socket has is read into the buffer right away, up to the read window and
+ * what is left of the socket handler's read budget for this tick, and AWS_IO_READ_WOULD_BLOCK is raised if there's
+ * nothing or the budget is used up. A TLS handler can do this when its TLS library asks for more input than it has
+ * queued. With on_filled, the buffer stays lent and reads go into it until it is full, then
+ * on_filled gives it back and reading continues with messages. A framing handler can do this for a payload of known
+ * size. on_filled is always invoked unless this returns AWS_OP_ERR, with AWS_ERROR_IO_OPERATION_CANCELLED if the
+ * channel shuts down first.
+ *
+ * Must be called from the channel's thread. Only one buffer can be lent at a time, and not while a file range is being
+ * received, see aws_channel_slot_receive_file().
+ */
+AWS_IO_API int aws_channel_slot_lend_read_buffer(
+    struct aws_channel_slot *slot,
+    const struct aws_channel_lend_read_buffer_options *options);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_IO_SOCKET_CHANNEL_HANDLER_H */
@@ -0,0 +1,63 @@
+#ifndef AWS_IO_SOCKET_RELAY_H
+#define AWS_IO_SOCKET_RELAY_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/io/io.h>
+
+struct aws_socket;
+struct aws_socket_relay;
+
+/**
+ * Invoked once the relay has stopped and closed both of its sockets. error_code is AWS_ERROR_SUCCESS when both peers
+ * finished sending and everything was relayed, or aws_socket_relay_shutdown() was called.
+ */
+typedef void(aws_socket_relay_on_shutdown_fn)(struct aws_socket_relay *relay, int error_code, void *user_data);
+
+struct aws_socket_relay_options {
+    /* connected stream sockets, assigned to their event loops and not subscribed to readable events */
+    struct aws_socket *socket_a;
+    struct aws_socket *socket_b;
+    /* how many bytes one direction holds between reading and writing them before it stops reading. 0 for the kernel's
+     * default pipe size, the kernel also rounds this up to a whole number of pages. */
+    size_t max_buffered_bytes;
+    aws_socket_relay_on_shutdown_fn *on_shutdown;
+    void *user_data;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Relays everything read from each socket to the other one, like a pair of socket channels forwarding messages, but
+ * the bytes are moved with splice() through a pipe per direction and never copied into user space. The sockets can be
+ * on the same or on different event loops.
+ *
+ * A direction that has max_buffered_bytes waiting on its writing socket stops reading until they are written, so a
+ * slow peer pushes back on the other one, as with a channel's read window. When a peer finishes sending, the write
+ * direction of the other socket is shut down once everything has been relayed; once both directions are finished, or
+ * on the first error, the relay closes both sockets and invokes on_shutdown. The sockets must not be used until then,
+ * and cleaning them up is left to the caller.
+ *
+ * Only supported on Linux, elsewhere AWS_ERROR_UNSUPPORTED_OPERATION is raised.
+ */
+AWS_IO_API struct aws_socket_relay *aws_socket_relay_new(
+    struct aws_allocator *allocator,
+    const struct aws_socket_relay_options *options);
+
+/**
+ * Stops the relay and closes its sockets, on_shutdown is invoked with AWS_ERROR_SUCCESS unless the relay has already
+ * stopped on its own. Can be called from any thread.
+ */
+AWS_IO_API void aws_socket_relay_shutdown(struct aws_socket_relay *relay);
+
+/**
+ * Releases the caller's reference to the relay, it is freed once anything it has scheduled has run. Call this once,
+ * after on_shutdown has been invoked.
+ */
+AWS_IO_API void aws_socket_relay_release(struct aws_socket_relay *relay);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_IO_SOCKET_RELAY_H */
@@ -9,6 +9,7 @@
 #include <aws/io/io.h>
 
 #include <aws/common/statistics.h>
+#include <aws/io/socket.h>
 #include <aws/io/tls_channel_handler.h>
 
 enum aws_crt_io_statistics_category {
@@ -23,6 +24,22 @@ struct aws_crt_statistics_socket {
     aws_crt_statistics_category_t category;
     uint64_t bytes_read;
     uint64_t bytes_written;
+    /* sampled from the socket each time statistics are gathered, set only for TCP sockets on platforms that support
+     * aws_socket_get_transport_metrics() */
+    bool has_transport_metrics;
+    struct aws_socket_transport_metrics transport_metrics;
+    /* the socket's latest kernel timestamps as of the gather, set only for sockets with kernel_timestamps on
+     * platforms that support aws_socket_get_kernel_timestamps() */
+    bool has_kernel_timestamps;
+    struct aws_socket_kernel_timestamps kernel_timestamps;
+    /* the stream socket handler's read budget as of the gather, and how many times an adaptive budget grew and
+     * shrank since the last reset */
+    uint64_t read_budget;
+    uint32_t read_budget_increases;
+    uint32_t read_budget_decreases;
+    /* bytes read into the event loop's shared scratch buffer and copied into messages, rather than read straight
+     * into a message. Reads that follow one that emptied the socket go there. */
+    uint64_t bytes_read_through_scratch;
 };
 
 /**
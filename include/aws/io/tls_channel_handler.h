@@ -90,6 +90,12 @@ struct aws_tls_connection_options {
     struct aws_tls_ctx *ctx;
     bool advertise_alpn_message;
     uint32_t timeout_ms;
+    /**
+     * Off by default. When set, the handler reads records straight from the socket into the TLS library's buffer
+     * instead of copying them out of messages, see aws_channel_slot_lend_read_buffer(). These reads count against the
+     * socket handler's read budget for the tick. Only the s2n handler does this, others ignore it.
+     */
+    bool lend_read_buffers;
 };
 
 struct aws_tls_ctx_options {
@@ -14,6 +14,11 @@
 #include <aws/io/message_pool.h>
 #include <aws/io/statistics.h>
 
+#if defined(__linux__)
+#    include <stdio.h>
+#    include <unistd.h>
+#endif
+
 #if _MSC_VER
 #    pragma warning(disable : 4204) /* non-constant aggregate initializer */
 #endif
@@ -27,6 +32,7 @@ enum {
 size_t g_aws_channel_max_fragment_size = KB_16;
 
 #define INITIAL_STATISTIC_LIST_SIZE 5
+#define DEFAULT_BULK_SHUTDOWN_BATCH_SIZE 256
 
 enum aws_channel_state {
     AWS_CHANNEL_SETTING_UP,
@@ -60,9 +66,11 @@ struct aws_channel {
     void *shutdown_user_data;
     struct aws_atomic_var refcount;
     struct aws_task deletion_task;
+    struct aws_linked_list_node loop_node;
 
-    struct aws_task statistics_task;
+    struct aws_linked_list_node statistics_node;
     struct aws_crt_statistics_handler *statistics_handler;
+    uint64_t statistics_next_report_time_ns;
     uint64_t statistics_interval_start_time_ms;
     struct aws_array_list statistic_list;
 
@@ -81,6 +89,7 @@ struct aws_channel {
     struct aws_channel_task window_update_task;
     bool read_back_pressure_enabled;
     bool window_update_in_progress;
+    bool shutdown_abortive;
 };
 
 struct channel_setup_args {
@@ -91,81 +100,123 @@ struct channel_setup_args {
     struct aws_task task;
 };
 
-static void s_on_msg_pool_removed(struct aws_event_loop_local_object *object) {
-    struct aws_message_pool *msg_pool = object->object;
+/*
+ * State shared by all channels running on an event loop. It is created by the first channel to complete setup on the
+ * loop and lives in the loop's local storage until the loop is destroyed.
+ */
+struct channel_loop_data {
+    struct aws_allocator *alloc;
+    struct aws_event_loop *loop;
+    struct aws_event_loop_local_object local_object;
+    struct aws_message_pool message_pool;
+    /* channels that have completed setup on this loop, linked through aws_channel.loop_node */
+    struct aws_linked_list channels;
+    struct aws_task trim_task;
+    struct aws_channel_trim_options trim_options;
+    bool trim_task_scheduled;
+    /* channels with a statistics handler, linked through aws_channel.statistics_node. One task serves all of them. */
+    struct aws_linked_list statistics_channels;
+    struct aws_task statistics_task;
+    uint64_t statistics_task_run_at_ns;
+    bool statistics_task_scheduled;
+};
+
+static void s_on_loop_data_removed(struct aws_event_loop_local_object *object) {
+    struct channel_loop_data *loop_data = object->object;
     AWS_LOGF_TRACE(
         AWS_LS_IO_CHANNEL,
         "static: message pool %p has been purged "
         "from the event-loop: likely because of shutdown",
-        (void *)msg_pool);
-    struct aws_allocator *alloc = msg_pool->alloc;
-    aws_message_pool_clean_up(msg_pool);
-    aws_mem_release(alloc, msg_pool);
-    aws_mem_release(alloc, object);
+        (void *)&loop_data->message_pool);
+    aws_message_pool_clean_up(&loop_data->message_pool);
+    aws_mem_release(loop_data->alloc, loop_data);
 }
 
-static void s_on_channel_setup_complete(struct aws_task *task, void *arg, enum aws_task_status task_status) {
+static struct channel_loop_data *s_fetch_loop_data(struct aws_event_loop *loop) {
+    struct aws_event_loop_local_object local_object;
+    AWS_ZERO_STRUCT(local_object);
 
-    (void)task;
-    struct channel_setup_args *setup_args = arg;
-    struct aws_message_pool *message_pool = NULL;
-    struct aws_event_loop_local_object *local_object = NULL;
+    if (aws_event_loop_fetch_local_object(loop, &s_message_pool_key, &local_object)) {
+        return NULL;
+    }
 
-    AWS_LOGF_DEBUG(AWS_LS_IO_CHANNEL, "id=%p: setup complete, notifying caller.", (void *)setup_args->channel);
-    if (task_status == AWS_TASK_STATUS_RUN_READY) {
-        struct aws_event_loop_local_object stack_obj;
-        AWS_ZERO_STRUCT(stack_obj);
-        local_object = &stack_obj;
+    return local_object.object;
+}
 
-        if (aws_event_loop_fetch_local_object(setup_args->channel->loop, &s_message_pool_key, local_object)) {
+static struct channel_loop_data *s_fetch_or_create_loop_data(struct aws_event_loop *loop, struct aws_allocator *alloc) {
+    struct channel_loop_data *loop_data = s_fetch_loop_data(loop);
+    if (loop_data) {
+        return loop_data;
+    }
 
-            local_object = aws_mem_calloc(setup_args->alloc, 1, sizeof(struct aws_event_loop_local_object));
-            if (!local_object) {
-                goto cleanup_setup_args;
-            }
+    loop_data = aws_mem_calloc(alloc, 1, sizeof(struct channel_loop_data));
+    if (!loop_data) {
+        return NULL;
+    }
 
-            message_pool = aws_mem_acquire(setup_args->alloc, sizeof(struct aws_message_pool));
-            if (!message_pool) {
-                goto cleanup_local_obj;
-            }
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_CHANNEL,
+        "id=%p: no message pool is currently stored in the event-loop "
+        "local storage, adding %p with max message size %zu, "
+        "message count 4, with 4 small blocks of 128 bytes.",
+        (void *)loop,
+        (void *)&loop_data->message_pool,
+        g_aws_channel_max_fragment_size);
+
+    struct aws_message_pool_creation_args creation_args = {
+        .application_data_msg_data_size = g_aws_channel_max_fragment_size,
+        .application_data_msg_count = 4,
+        .small_block_msg_count = 4,
+        .small_block_msg_data_size = 128,
+    };
+
+    if (aws_message_pool_init(&loop_data->message_pool, alloc, &creation_args)) {
+        goto cleanup_loop_data;
+    }
 
-            AWS_LOGF_DEBUG(
-                AWS_LS_IO_CHANNEL,
-                "id=%p: no message pool is currently stored in the event-loop "
-                "local storage, adding %p with max message size %zu, "
-                "message count 4, with 4 small blocks of 128 bytes.",
-                (void *)setup_args->channel,
-                (void *)message_pool,
-                g_aws_channel_max_fragment_size);
-
-            struct aws_message_pool_creation_args creation_args = {
-                .application_data_msg_data_size = g_aws_channel_max_fragment_size,
-                .application_data_msg_count = 4,
-                .small_block_msg_count = 4,
-                .small_block_msg_data_size = 128,
-            };
-
-            if (aws_message_pool_init(message_pool, setup_args->alloc, &creation_args)) {
-                goto cleanup_msg_pool_mem;
-            }
+    loop_data->alloc = alloc;
+    loop_data->loop = loop;
+    aws_linked_list_init(&loop_data->channels);
+    aws_linked_list_init(&loop_data->statistics_channels);
 
-            local_object->key = &s_message_pool_key;
-            local_object->object = message_pool;
-            local_object->on_object_removed = s_on_msg_pool_removed;
+    loop_data->local_object.key = &s_message_pool_key;
+    loop_data->local_object.object = loop_data;
+    loop_data->local_object.on_object_removed = s_on_loop_data_removed;
 
-            if (aws_event_loop_put_local_object(setup_args->channel->loop, local_object)) {
-                goto cleanup_msg_pool;
-            }
-        } else {
-            message_pool = local_object->object;
-            AWS_LOGF_DEBUG(
-                AWS_LS_IO_CHANNEL,
-                "id=%p: message pool %p found in event-loop local storage: using it.",
-                (void *)setup_args->channel,
-                (void *)message_pool)
+    if (aws_event_loop_put_local_object(loop, &loop_data->local_object)) {
+        goto cleanup_msg_pool;
+    }
+
+    return loop_data;
+
+cleanup_msg_pool:
+    aws_message_pool_clean_up(&loop_data->message_pool);
+
+cleanup_loop_data:
+    aws_mem_release(alloc, loop_data);
+    return NULL;
+}
+
+static void s_on_channel_setup_complete(struct aws_task *task, void *arg, enum aws_task_status task_status) {
+
+    (void)task;
+    struct channel_setup_args *setup_args = arg;
+
+    AWS_LOGF_DEBUG(AWS_LS_IO_CHANNEL, "id=%p: setup complete, notifying caller.", (void *)setup_args->channel);
+    if (task_status == AWS_TASK_STATUS_RUN_READY) {
+        struct channel_loop_data *loop_data = s_fetch_or_create_loop_data(setup_args->channel->loop, setup_args->alloc);
+        if (!loop_data) {
+            goto cleanup_setup_args;
         }
 
-        setup_args->channel->msg_pool = message_pool;
+        AWS_LOGF_DEBUG(
+            AWS_LS_IO_CHANNEL,
+            "id=%p: using message pool %p from event-loop local storage.",
+            (void *)setup_args->channel,
+            (void *)&loop_data->message_pool);
+
+        setup_args->channel->msg_pool = &loop_data->message_pool;
+        aws_linked_list_push_back(&loop_data->channels, &setup_args->channel->loop_node);
         setup_args->channel->channel_state = AWS_CHANNEL_ACTIVE;
         setup_args->on_setup_completed(setup_args->channel, AWS_OP_SUCCESS, setup_args->user_data);
         aws_channel_release_hold(setup_args->channel);
@@ -173,17 +224,6 @@ static void s_on_channel_setup_complete(struct aws_task *task, void *arg, enum a
         return;
     }
 
-    goto cleanup_setup_args;
-
-cleanup_msg_pool:
-    aws_message_pool_clean_up(message_pool);
-
-cleanup_msg_pool_mem:
-    aws_mem_release(setup_args->alloc, message_pool);
-
-cleanup_local_obj:
-    aws_mem_release(setup_args->alloc, local_object);
-
 cleanup_setup_args:
     setup_args->on_setup_completed(setup_args->channel, AWS_OP_ERR, setup_args->user_data);
     aws_channel_release_hold(setup_args->channel);
@@ -218,8 +258,8 @@ struct aws_channel *aws_channel_new(struct aws_allocator *alloc, const struct aw
     channel->on_shutdown_completed = creation_args->on_shutdown_completed;
     channel->shutdown_user_data = creation_args->shutdown_user_data;
 
-    if (aws_array_list_init_dynamic(
-            &channel->statistic_list, alloc, INITIAL_STATISTIC_LIST_SIZE, sizeof(struct aws_crt_statistics_base *))) {
+    /* Most channels never install a statistics handler, so the list's storage is reserved when one is set. */
+    if (aws_array_list_init_dynamic(&channel->statistic_list, alloc, 0, sizeof(struct aws_crt_statistics_base *))) {
         goto on_error;
     }
 
@@ -297,6 +337,10 @@ static void s_final_channel_deletion_task(struct aws_task *task, void *arg, enum
 
     AWS_ASSERT(channel->channel_state == AWS_CHANNEL_SHUT_DOWN);
 
+    if (channel->loop_node.next) {
+        aws_linked_list_remove(&channel->loop_node);
+    }
+
     while (current) {
         struct aws_channel_slot *tmp = current->adj_right;
         s_cleanup_slot(current);
@@ -416,6 +460,51 @@ int aws_channel_shutdown(struct aws_channel *channel, int error_code) {
     return s_channel_shutdown(channel, error_code, false);
 }
 
+/*
+ * Starts shutdown of the channel from its own thread, running the shutdown task inline instead of scheduling it.
+ * If a shutdown task is already pending, it is left to run, but upgraded to an immediate shutdown if abortive.
+ */
+static void s_channel_shutdown_inline(struct aws_channel *channel, int error_code, bool abortive) {
+    AWS_ASSERT(aws_channel_thread_is_callers_thread(channel));
+
+    if (channel->channel_state >= AWS_CHANNEL_SHUTTING_DOWN) {
+        return;
+    }
+
+    if (abortive) {
+        channel->shutdown_abortive = true;
+    }
+
+    bool already_pending = false;
+    aws_mutex_lock(&channel->cross_thread_tasks.lock);
+    if (channel->cross_thread_tasks.shutdown_task.task.task_fn) {
+        already_pending = true;
+        channel->cross_thread_tasks.shutdown_task.shutdown_immediately |= abortive;
+    } else {
+        aws_channel_task_init(
+            &channel->cross_thread_tasks.shutdown_task.task,
+            s_shutdown_task,
+            &channel->cross_thread_tasks.shutdown_task,
+            "channel_shutdown");
+        channel->cross_thread_tasks.shutdown_task.shutdown_immediately = abortive;
+        channel->cross_thread_tasks.shutdown_task.channel = channel;
+        channel->cross_thread_tasks.shutdown_task.error_code = error_code;
+    }
+    aws_mutex_unlock(&channel->cross_thread_tasks.lock);
+
+    if (!already_pending) {
+        s_shutdown_task(
+            &channel->cross_thread_tasks.shutdown_task.task,
+            &channel->cross_thread_tasks.shutdown_task,
+            AWS_TASK_STATUS_RUN_READY);
+    }
+}
+
+bool aws_channel_is_shutdown_abortive(struct aws_channel *channel) {
+    AWS_ASSERT(aws_channel_thread_is_callers_thread(channel));
+    return channel->shutdown_abortive;
+}
+
 struct aws_io_message *aws_channel_acquire_message_from_pool(
     struct aws_channel *channel,
     enum aws_io_message_type message_type,
@@ -1052,25 +1141,7 @@ static void s_reset_statistics(struct aws_channel *channel) {
     }
 }
 
-static void s_channel_gather_statistics_task(struct aws_task *task, void *arg, enum aws_task_status status) {
-    if (status != AWS_TASK_STATUS_RUN_READY) {
-        return;
-    }
-
-    struct aws_channel *channel = arg;
-    if (channel->statistics_handler == NULL) {
-        return;
-    }
-
-    if (channel->channel_state == AWS_CHANNEL_SHUTTING_DOWN || channel->channel_state == AWS_CHANNEL_SHUT_DOWN) {
-        return;
-    }
-
-    uint64_t now_ns = 0;
-    if (aws_channel_current_clock_time(channel, &now_ns)) {
-        return;
-    }
-
+static void s_channel_gather_statistics(struct aws_channel *channel, uint64_t now_ns) {
     uint64_t now_ms = aws_timestamp_convert(now_ns, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MILLIS, NULL);
 
     struct aws_array_list *statistics_list = &channel->statistic_list;
@@ -1093,52 +1164,465 @@ static void s_channel_gather_statistics_task(struct aws_task *task, void *arg, e
 
     s_reset_statistics(channel);
 
-    uint64_t reschedule_interval_ns = aws_timestamp_convert(
+    channel->statistics_interval_start_time_ms = now_ms;
+}
+
+/*
+ * Report times are aligned to multiples of the report interval on the loop's clock, so every channel on a loop that
+ * uses the same interval is sampled by the same run of the loop's statistics task.
+ */
+static uint64_t s_next_statistics_report_time(struct aws_channel *channel, uint64_t now_ns) {
+    uint64_t interval_ns = aws_timestamp_convert(
         aws_crt_statistics_handler_get_report_interval_ms(channel->statistics_handler),
         AWS_TIMESTAMP_MILLIS,
         AWS_TIMESTAMP_NANOS,
         NULL);
 
-    aws_event_loop_schedule_task_future(channel->loop, task, now_ns + reschedule_interval_ns);
+    if (interval_ns == 0) {
+        return now_ns;
+    }
 
-    channel->statistics_interval_start_time_ms = now_ms;
+    return aws_mul_u64_saturating(now_ns / interval_ns + 1, interval_ns);
 }
 
-int aws_channel_set_statistics_handler(struct aws_channel *channel, struct aws_crt_statistics_handler *handler) {
-    AWS_FATAL_ASSERT(aws_channel_thread_is_callers_thread(channel));
+static void s_loop_statistics_task(struct aws_task *task, void *arg, enum aws_task_status status);
 
-    if (channel->statistics_handler) {
-        aws_crt_statistics_handler_destroy(channel->statistics_handler);
-        aws_event_loop_cancel_task(channel->loop, &channel->statistics_task);
-        channel->statistics_handler = NULL;
+static void s_schedule_loop_statistics_task(struct channel_loop_data *loop_data, uint64_t run_at_ns) {
+    if (loop_data->statistics_task_scheduled) {
+        if (loop_data->statistics_task_run_at_ns <= run_at_ns) {
+            return;
+        }
+
+        aws_event_loop_cancel_task(loop_data->loop, &loop_data->statistics_task);
     }
 
+    aws_task_init(&loop_data->statistics_task, s_loop_statistics_task, loop_data, "gather_statistics");
+    aws_event_loop_schedule_task_future(loop_data->loop, &loop_data->statistics_task, run_at_ns);
+    loop_data->statistics_task_run_at_ns = run_at_ns;
+    loop_data->statistics_task_scheduled = true;
+}
+
+static void s_loop_statistics_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct channel_loop_data *loop_data = arg;
+    loop_data->statistics_task_scheduled = false;
+
+    if (status != AWS_TASK_STATUS_RUN_READY) {
+        return;
+    }
+
+    uint64_t now_ns = 0;
+    if (aws_event_loop_current_clock_time(loop_data->loop, &now_ns)) {
+        return;
+    }
+
+    /*
+     * Work from a private copy of the list: statistics handlers may change a channel's statistics handler, which
+     * re-registers it on the loop's list.
+     */
+    struct aws_linked_list pending;
+    aws_linked_list_init(&pending);
+    aws_linked_list_swap_contents(&pending, &loop_data->statistics_channels);
+
+    uint64_t next_run_ns = UINT64_MAX;
+    while (!aws_linked_list_empty(&pending)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&pending);
+        aws_linked_list_node_reset(node);
+        struct aws_channel *channel = AWS_CONTAINER_OF(node, struct aws_channel, statistics_node);
+
+        /* channels stop reporting once they begin shutting down */
+        if (channel->channel_state == AWS_CHANNEL_SHUTTING_DOWN || channel->channel_state == AWS_CHANNEL_SHUT_DOWN) {
+            continue;
+        }
+
+        if (channel->statistics_next_report_time_ns <= now_ns) {
+            s_channel_gather_statistics(channel, now_ns);
+
+            if (channel->statistics_handler == NULL || channel->statistics_node.next != NULL) {
+                /* the handler was removed or replaced while processing, which already took care of registration. */
+                continue;
+            }
+
+            channel->statistics_next_report_time_ns = s_next_statistics_report_time(channel, now_ns);
+        }
+
+        aws_linked_list_push_back(&loop_data->statistics_channels, &channel->statistics_node);
+        next_run_ns = aws_min_u64(next_run_ns, channel->statistics_next_report_time_ns);
+    }
+
+    if (next_run_ns != UINT64_MAX) {
+        s_schedule_loop_statistics_task(loop_data, next_run_ns);
+    }
+}
+
+int aws_channel_set_statistics_handler(struct aws_channel *channel, struct aws_crt_statistics_handler *handler) {
+    AWS_FATAL_ASSERT(aws_channel_thread_is_callers_thread(channel));
+
+    /* everything that can fail comes first, so a failure leaves the current handler in place */
+    struct channel_loop_data *loop_data = NULL;
+    uint64_t now_ns = 0;
     if (handler != NULL) {
-        aws_task_init(&channel->statistics_task, s_channel_gather_statistics_task, channel, "gather_statistics");
+        loop_data = s_fetch_or_create_loop_data(channel->loop, channel->alloc);
+        if (!loop_data) {
+            return AWS_OP_ERR;
+        }
 
-        uint64_t now_ns = 0;
         if (aws_channel_current_clock_time(channel, &now_ns)) {
             return AWS_OP_ERR;
         }
 
-        uint64_t report_time_ns = now_ns + aws_timestamp_convert(
-                                               aws_crt_statistics_handler_get_report_interval_ms(handler),
-                                               AWS_TIMESTAMP_MILLIS,
-                                               AWS_TIMESTAMP_NANOS,
-                                               NULL);
+        if (aws_array_list_ensure_capacity(&channel->statistic_list, INITIAL_STATISTIC_LIST_SIZE - 1)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    if (channel->statistics_handler) {
+        aws_crt_statistics_handler_destroy(channel->statistics_handler);
+        channel->statistics_handler = NULL;
+    }
+
+    if (channel->statistics_node.next) {
+        aws_linked_list_remove(&channel->statistics_node);
+        aws_linked_list_node_reset(&channel->statistics_node);
+    }
 
+    if (handler != NULL) {
+        channel->statistics_handler = handler;
         channel->statistics_interval_start_time_ms =
             aws_timestamp_convert(now_ns, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MILLIS, NULL);
+        channel->statistics_next_report_time_ns = s_next_statistics_report_time(channel, now_ns);
         s_reset_statistics(channel);
 
-        aws_event_loop_schedule_task_future(channel->loop, &channel->statistics_task, report_time_ns);
+        aws_linked_list_push_back(&loop_data->statistics_channels, &channel->statistics_node);
+        s_schedule_loop_statistics_task(loop_data, channel->statistics_next_report_time_ns);
     }
 
-    channel->statistics_handler = handler;
-
     return AWS_OP_SUCCESS;
 }
 
 struct aws_event_loop *aws_channel_get_event_loop(struct aws_channel *channel) {
     return channel->loop;
 }
+
+void aws_channel_trim(struct aws_channel *channel) {
+    AWS_FATAL_ASSERT(aws_channel_thread_is_callers_thread(channel));
+
+    if (channel->channel_state != AWS_CHANNEL_ACTIVE) {
+        return;
+    }
+
+    struct aws_channel_slot *current_slot = channel->first;
+    while (current_slot) {
+        struct aws_channel_handler *handler = current_slot->handler;
+        if (handler != NULL && handler->vtable->trim != NULL) {
+            handler->vtable->trim(handler);
+        }
+        current_slot = current_slot->adj_right;
+    }
+}
+
+static int s_get_resident_set_size(uint64_t *rss_bytes) {
+#if defined(__linux__)
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+
+    unsigned long long total_pages = 0;
+    unsigned long long resident_pages = 0;
+    int fields_read = fscanf(statm, "%llu %llu", &total_pages, &resident_pages);
+    fclose(statm);
+
+    if (fields_read != 2) {
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+
+    *rss_bytes = aws_mul_u64_saturating(resident_pages, (uint64_t)sysconf(_SC_PAGESIZE));
+    return AWS_OP_SUCCESS;
+#else
+    (void)rss_bytes;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#endif
+}
+
+static void s_trim_loop_data(struct channel_loop_data *loop_data) {
+    size_t pool_bytes_freed = aws_message_pool_trim(&loop_data->message_pool);
+    size_t channel_count = 0;
+
+    struct aws_linked_list_node *node = aws_linked_list_begin(&loop_data->channels);
+    while (node != aws_linked_list_end(&loop_data->channels)) {
+        struct aws_channel *channel = AWS_CONTAINER_OF(node, struct aws_channel, loop_node);
+        node = aws_linked_list_next(node);
+        aws_channel_trim(channel);
+        ++channel_count;
+    }
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_CHANNEL,
+        "id=%p: trimmed %zu bytes from message pool %p and %zu channels.",
+        (void *)loop_data->loop,
+        pool_bytes_freed,
+        (void *)&loop_data->message_pool,
+        channel_count);
+}
+
+static void s_loop_trim_task(struct aws_task *task, void *arg, enum aws_task_status status);
+
+static void s_schedule_loop_trim_task(struct channel_loop_data *loop_data) {
+    uint64_t now_ns = 0;
+    if (aws_event_loop_current_clock_time(loop_data->loop, &now_ns)) {
+        return;
+    }
+
+    uint64_t interval_ns =
+        aws_timestamp_convert(loop_data->trim_options.interval_ms, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL);
+
+    aws_task_init(&loop_data->trim_task, s_loop_trim_task, loop_data, "channel_loop_trim");
+    aws_event_loop_schedule_task_future(
+        loop_data->loop, &loop_data->trim_task, aws_add_u64_saturating(now_ns, interval_ns));
+    loop_data->trim_task_scheduled = true;
+}
+
+static void s_loop_trim_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct channel_loop_data *loop_data = arg;
+    loop_data->trim_task_scheduled = false;
+
+    if (status != AWS_TASK_STATUS_RUN_READY) {
+        return;
+    }
+
+    bool should_trim = true;
+    if (loop_data->trim_options.rss_threshold_bytes > 0) {
+        uint64_t rss_bytes = 0;
+        if (s_get_resident_set_size(&rss_bytes) == AWS_OP_SUCCESS) {
+            should_trim = rss_bytes > loop_data->trim_options.rss_threshold_bytes;
+        }
+    }
+
+    if (should_trim) {
+        s_trim_loop_data(loop_data);
+    }
+
+    s_schedule_loop_trim_task(loop_data);
+}
+
+struct channel_trim_request {
+    struct aws_allocator *alloc;
+    struct aws_event_loop *loop;
+    struct aws_task task;
+    struct aws_channel_trim_options options;
+    bool configure_trimmer;
+};
+
+static void s_channel_trim_request_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct channel_trim_request *request = arg;
+
+    if (status == AWS_TASK_STATUS_RUN_READY) {
+        struct channel_loop_data *loop_data = NULL;
+        if (request->configure_trimmer && request->options.interval_ms > 0) {
+            loop_data = s_fetch_or_create_loop_data(request->loop, request->alloc);
+        } else {
+            loop_data = s_fetch_loop_data(request->loop);
+        }
+
+        if (loop_data && request->configure_trimmer) {
+            if (loop_data->trim_task_scheduled) {
+                aws_event_loop_cancel_task(loop_data->loop, &loop_data->trim_task);
+            }
+
+            loop_data->trim_options = request->options;
+            if (loop_data->trim_options.interval_ms > 0) {
+                s_schedule_loop_trim_task(loop_data);
+            }
+        } else if (loop_data) {
+            s_trim_loop_data(loop_data);
+        }
+    }
+
+    aws_mem_release(request->alloc, request);
+}
+
+int aws_channel_trim_event_loop_resources(
+    struct aws_event_loop *event_loop,
+    const struct aws_channel_trim_options *options) {
+    AWS_PRECONDITION(event_loop);
+
+#if !defined(__linux__)
+    if (options && options->rss_threshold_bytes > 0) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_CHANNEL,
+            "id=%p: trimming based on resident set size is not supported on this platform.",
+            (void *)event_loop);
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+#endif
+
+    struct channel_trim_request *request = aws_mem_calloc(event_loop->alloc, 1, sizeof(struct channel_trim_request));
+    if (!request) {
+        return AWS_OP_ERR;
+    }
+
+    request->alloc = event_loop->alloc;
+    request->loop = event_loop;
+    if (options) {
+        request->options = *options;
+        request->configure_trimmer = true;
+    }
+
+    aws_task_init(&request->task, s_channel_trim_request_task, request, "channel_trim_request");
+    aws_event_loop_schedule_task_now(event_loop, &request->task);
+
+    return AWS_OP_SUCCESS;
+}
+
+struct channel_bulk_shutdown_request {
+    struct aws_allocator *alloc;
+    struct aws_event_loop *loop;
+    struct aws_task task;
+    struct aws_channel_bulk_shutdown_options options;
+    /* channels whose shutdown hasn't been started yet, moved off the loop's channel list on the first run */
+    struct aws_linked_list pending_channels;
+    bool channels_collected;
+};
+
+static void s_channel_bulk_shutdown_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct channel_bulk_shutdown_request *request = arg;
+    struct channel_loop_data *loop_data = s_fetch_loop_data(request->loop);
+
+    if (!loop_data) {
+        aws_mem_release(request->alloc, request);
+        return;
+    }
+
+    if (status == AWS_TASK_STATUS_RUN_READY && !request->channels_collected) {
+        aws_linked_list_swap_contents(&request->pending_channels, &loop_data->channels);
+        request->channels_collected = true;
+    }
+
+    size_t batch_size = request->options.batch_size;
+    size_t shutdown_count = 0;
+    while (!aws_linked_list_empty(&request->pending_channels)) {
+        if (status == AWS_TASK_STATUS_RUN_READY && shutdown_count == batch_size) {
+            AWS_LOGF_TRACE(
+                AWS_LS_IO_CHANNEL,
+                "id=%p: bulk shutdown started for %zu channels, continuing in the next task.",
+                (void *)request->loop,
+                shutdown_count);
+            aws_event_loop_schedule_task_now(request->loop, &request->task);
+            return;
+        }
+
+        /* the channel goes back on the loop's list before its shutdown starts, that's where deletion removes it from */
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&request->pending_channels);
+        aws_linked_list_push_back(&loop_data->channels, node);
+
+        if (status == AWS_TASK_STATUS_RUN_READY) {
+            struct aws_channel *channel = AWS_CONTAINER_OF(node, struct aws_channel, loop_node);
+            s_channel_shutdown_inline(channel, request->options.error_code, request->options.abortive);
+            ++shutdown_count;
+        }
+    }
+
+    AWS_LOGF_DEBUG(AWS_LS_IO_CHANNEL, "id=%p: bulk channel shutdown request processed.", (void *)request->loop);
+    aws_mem_release(request->alloc, request);
+}
+
+int aws_channel_shutdown_event_loop_channels(
+    struct aws_event_loop *event_loop,
+    const struct aws_channel_bulk_shutdown_options *options) {
+    AWS_PRECONDITION(event_loop);
+    AWS_PRECONDITION(options);
+
+    struct channel_bulk_shutdown_request *request =
+        aws_mem_calloc(event_loop->alloc, 1, sizeof(struct channel_bulk_shutdown_request));
+    if (!request) {
+        return AWS_OP_ERR;
+    }
+
+    request->alloc = event_loop->alloc;
+    request->loop = event_loop;
+    request->options = *options;
+    if (request->options.batch_size == 0) {
+        request->options.batch_size = DEFAULT_BULK_SHUTDOWN_BATCH_SIZE;
+    }
+    aws_linked_list_init(&request->pending_channels);
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_CHANNEL,
+        "id=%p: scheduling %s shutdown of all channels with error %d.",
+        (void *)event_loop,
+        request->options.abortive ? "abortive" : "graceful",
+        request->options.error_code);
+
+    aws_task_init(&request->task, s_channel_bulk_shutdown_task, request, "channel_bulk_shutdown");
+    aws_event_loop_schedule_task_now(event_loop, &request->task);
+
+    return AWS_OP_SUCCESS;
+}
+
+struct channel_prewarm_request {
+    struct aws_allocator *alloc;
+    struct aws_event_loop *loop;
+    struct aws_task task;
+    aws_channel_on_event_loop_prewarmed_fn *on_completed;
+    void *user_data;
+};
+
+static void s_channel_prewarm_request_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct channel_prewarm_request *request = arg;
+    int error_code = AWS_IO_EVENT_LOOP_SHUTDOWN;
+
+    if (status == AWS_TASK_STATUS_RUN_READY) {
+        error_code = AWS_ERROR_SUCCESS;
+
+        struct channel_loop_data *loop_data = s_fetch_or_create_loop_data(request->loop, request->alloc);
+        if (!loop_data || aws_message_pool_prewarm(&loop_data->message_pool)) {
+            error_code = aws_last_error();
+            AWS_LOGF_WARN(
+                AWS_LS_IO_CHANNEL,
+                "id=%p: failed to pre-warm event-loop with error %d (%s).",
+                (void *)request->loop,
+                error_code,
+                aws_error_str(error_code));
+        } else {
+            AWS_LOGF_DEBUG(
+                AWS_LS_IO_CHANNEL,
+                "id=%p: pre-warmed message pool %p.",
+                (void *)request->loop,
+                (void *)&loop_data->message_pool);
+        }
+    }
+
+    if (request->on_completed) {
+        request->on_completed(request->loop, error_code, request->user_data);
+    }
+
+    aws_mem_release(request->alloc, request);
+}
+
+int aws_channel_prewarm_event_loop(
+    struct aws_event_loop *event_loop,
+    aws_channel_on_event_loop_prewarmed_fn *on_completed,
+    void *user_data) {
+    AWS_PRECONDITION(event_loop);
+
+    struct channel_prewarm_request *request =
+        aws_mem_calloc(event_loop->alloc, 1, sizeof(struct channel_prewarm_request));
+    if (!request) {
+        return AWS_OP_ERR;
+    }
+
+    request->alloc = event_loop->alloc;
+    request->loop = event_loop;
+    request->on_completed = on_completed;
+    request->user_data = user_data;
+
+    aws_task_init(&request->task, s_channel_prewarm_request_task, request, "channel_prewarm_request");
+    aws_event_loop_schedule_task_now(event_loop, &request->task);
+
+    return AWS_OP_SUCCESS;
+}
@@ -31,6 +31,8 @@ static void s_client_bootstrap_destroy_impl(struct aws_client_bootstrap *bootstr
 
     aws_event_loop_group_release(bootstrap->event_loop_group);
     aws_host_resolver_release(bootstrap->host_resolver);
+    aws_array_list_clean_up(&bootstrap->local_ipv4_addresses);
+    aws_array_list_clean_up(&bootstrap->local_ipv6_addresses);
 
     aws_mem_release(bootstrap->allocator, bootstrap);
 
@@ -54,6 +56,103 @@ void aws_client_bootstrap_release(struct aws_client_bootstrap *bootstrap) {
     }
 }
 
+static int s_copy_local_addresses(
+    struct aws_client_bootstrap *bootstrap,
+    const struct aws_client_bootstrap_options *options) {
+    aws_atomic_init_int(&bootstrap->next_local_ipv4_address, 0);
+    aws_atomic_init_int(&bootstrap->next_local_ipv6_address, 0);
+    if (aws_array_list_init_dynamic(
+            &bootstrap->local_ipv4_addresses,
+            bootstrap->allocator,
+            options->local_address_count,
+            sizeof(struct aws_socket_endpoint)) ||
+        aws_array_list_init_dynamic(
+            &bootstrap->local_ipv6_addresses,
+            bootstrap->allocator,
+            options->local_address_count,
+            sizeof(struct aws_socket_endpoint))) {
+        return AWS_OP_ERR;
+    }
+
+#ifdef _WIN32
+    if (options->local_address_count) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_CHANNEL_BOOTSTRAP,
+            "id=%p: binding connections to local addresses is not supported on this platform",
+            (void *)bootstrap);
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+#endif
+
+    for (size_t i = 0; i < options->local_address_count; ++i) {
+        struct aws_byte_cursor address = options->local_addresses[i];
+        if (!address.len || address.len >= AWS_ADDRESS_MAX_LEN) {
+            return aws_raise_error(AWS_IO_SOCKET_INVALID_ADDRESS);
+        }
+
+        struct aws_socket_endpoint endpoint;
+        AWS_ZERO_STRUCT(endpoint);
+        memcpy(endpoint.address, address.ptr, address.len);
+        bool is_ipv6 = memchr(address.ptr, ':', address.len) != NULL;
+        if (aws_array_list_push_back(
+                is_ipv6 ? &bootstrap->local_ipv6_addresses : &bootstrap->local_ipv4_addresses, &endpoint)) {
+            return AWS_OP_ERR;
+        }
+
+        AWS_LOGF_DEBUG(
+            AWS_LS_IO_CHANNEL_BOOTSTRAP,
+            "id=%p: binding connections to local address %s",
+            (void *)bootstrap,
+            endpoint.address);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Picks the next local address for a connection to the given family, round-robin. NULL if there's none to bind to. */
+static const struct aws_socket_endpoint *s_next_local_address(
+    struct aws_client_bootstrap *bootstrap,
+    enum aws_socket_domain domain) {
+    struct aws_array_list *addresses = NULL;
+    struct aws_atomic_var *next_address = NULL;
+    switch (domain) {
+        case AWS_SOCKET_IPV4:
+            addresses = &bootstrap->local_ipv4_addresses;
+            next_address = &bootstrap->next_local_ipv4_address;
+            break;
+        case AWS_SOCKET_IPV6:
+            addresses = &bootstrap->local_ipv6_addresses;
+            next_address = &bootstrap->next_local_ipv6_address;
+            break;
+        default:
+            return NULL;
+    }
+
+    size_t address_count = aws_array_list_length(addresses);
+    if (!address_count) {
+        return NULL;
+    }
+
+    struct aws_socket_endpoint *endpoint = NULL;
+    aws_array_list_get_at_ptr(addresses, (void **)&endpoint, aws_atomic_fetch_add(next_address, 1) % address_count);
+    return endpoint;
+}
+
+/* pre-warming is only an optimization, so a bootstrap or listener isn't failed over it. */
+static void s_prewarm_event_loops(const void *bootstrap, struct aws_event_loop_group *event_loop_group) {
+    size_t loop_count = aws_event_loop_group_get_loop_count(event_loop_group);
+    for (size_t i = 0; i < loop_count; ++i) {
+        struct aws_event_loop *loop = aws_event_loop_group_get_loop_at(event_loop_group, i);
+        if (aws_channel_prewarm_event_loop(loop, NULL, NULL)) {
+            AWS_LOGF_WARN(
+                AWS_LS_IO_CHANNEL_BOOTSTRAP,
+                "id=%p: failed to schedule pre-warming of event-loop %p",
+                bootstrap,
+                (void *)loop);
+        }
+    }
+}
+
 struct aws_client_bootstrap *aws_client_bootstrap_new(
     struct aws_allocator *allocator,
     const struct aws_client_bootstrap_options *options) {
@@ -73,6 +172,13 @@ struct aws_client_bootstrap *aws_client_bootstrap_new(
         (void *)options->event_loop_group);
 
     bootstrap->allocator = allocator;
+    if (s_copy_local_addresses(bootstrap, options)) {
+        aws_array_list_clean_up(&bootstrap->local_ipv4_addresses);
+        aws_array_list_clean_up(&bootstrap->local_ipv6_addresses);
+        aws_mem_release(allocator, bootstrap);
+        return NULL;
+    }
+
     bootstrap->event_loop_group = aws_event_loop_group_acquire(options->event_loop_group);
     bootstrap->on_protocol_negotiated = NULL;
     aws_ref_count_init(
@@ -91,6 +197,10 @@ struct aws_client_bootstrap *aws_client_bootstrap_new(
         };
     }
 
+    if (options->prewarm_event_loops) {
+        s_prewarm_event_loops(bootstrap, bootstrap->event_loop_group);
+    }
+
     return bootstrap;
 }
 
@@ -131,6 +241,8 @@ struct client_connection_args {
     bool connection_chosen;
     bool setup_called;
     bool enable_read_back_pressure;
+    bool adaptive_read_budget;
+    struct aws_socket_handler_read_budget_options read_budget;
 
     /*
      * It is likely that all reference adjustments to the connection args take place in a single event loop
@@ -346,6 +458,26 @@ static inline int s_setup_client_tls(struct client_connection_args *connection_a
     return AWS_OP_SUCCESS;
 }
 
+static struct aws_channel_handler *s_new_client_socket_handler(
+    struct client_connection_args *connection_args,
+    struct aws_channel_slot *socket_slot) {
+    struct aws_allocator *allocator = connection_args->bootstrap->allocator;
+    struct aws_socket *socket = connection_args->channel_data.socket;
+
+#ifndef _WIN32
+    /* UDP keeps its message boundaries, one datagram per message */
+    if (socket->options.type == AWS_SOCKET_DGRAM) {
+        return aws_socket_datagram_handler_new(allocator, socket, socket_slot, NULL);
+    }
+#endif
+
+    struct aws_socket_handler_options socket_handler_options = {
+        .max_read_size = g_aws_channel_max_fragment_size,
+        .adaptive_read_budget = connection_args->adaptive_read_budget ? &connection_args->read_budget : NULL,
+    };
+    return aws_socket_handler_new_with_options(allocator, socket, socket_slot, &socket_handler_options);
+}
+
 static void s_on_client_channel_on_setup_completed(struct aws_channel *channel, int error_code, void *user_data) {
     struct client_connection_args *connection_args = user_data;
     int err_code = error_code;
@@ -364,11 +496,7 @@ static void s_on_client_channel_on_setup_completed(struct aws_channel *channel,
             goto error;
         }
 
-        struct aws_channel_handler *socket_channel_handler = aws_socket_handler_new(
-            connection_args->bootstrap->allocator,
-            connection_args->channel_data.socket,
-            socket_slot,
-            g_aws_channel_max_fragment_size);
+        struct aws_channel_handler *socket_channel_handler = s_new_client_socket_handler(connection_args, socket_slot);
 
         if (!socket_channel_handler) {
             err_code = aws_last_error();
@@ -565,6 +693,12 @@ static void s_attempt_connection(struct aws_task *task, void *arg, enum aws_task
         goto socket_init_failed;
     }
 
+    const struct aws_socket_endpoint *local_endpoint =
+        s_next_local_address(task_data->args->bootstrap, task_data->options.domain);
+    if (local_endpoint && aws_socket_bind_for_connect(outgoing_socket, local_endpoint)) {
+        goto socket_bind_failed;
+    }
+
     if (aws_socket_connect(
             outgoing_socket,
             &task_data->endpoint,
@@ -579,6 +713,7 @@ static void s_attempt_connection(struct aws_task *task, void *arg, enum aws_task
 
 socket_connect_failed:
     aws_host_resolver_record_connection_failure(task_data->args->bootstrap->host_resolver, &task_data->host_address);
+socket_bind_failed:
     aws_socket_clean_up(outgoing_socket);
 socket_init_failed:
     aws_mem_release(allocator, outgoing_socket);
@@ -736,6 +871,10 @@ int aws_client_bootstrap_new_socket_channel(struct aws_socket_channel_bootstrap_
     client_connection_args->outgoing_options = *socket_options;
     client_connection_args->outgoing_port = port;
     client_connection_args->enable_read_back_pressure = options->enable_read_back_pressure;
+    if (options->adaptive_read_budget) {
+        client_connection_args->adaptive_read_budget = true;
+        client_connection_args->read_budget = *options->adaptive_read_budget;
+    }
 
     if (tls_options) {
         if (aws_tls_connection_options_copy(&client_connection_args->channel_data.tls_options, tls_options)) {
@@ -887,9 +1026,22 @@ struct aws_server_bootstrap *aws_server_bootstrap_new(
     return bootstrap;
 }
 
+/* an additional SO_REUSEPORT listener, when the listener is sharded across the event loop group */
+struct server_listener_shard {
+    struct aws_socket listener;
+    struct aws_task listener_destroy_task;
+    struct server_connection_args *server_connection_args;
+    struct aws_event_loop *event_loop;
+    /* set once the shard is accepting, it then holds a reference on server_connection_args */
+    bool accepting;
+};
+
 struct server_connection_args {
     struct aws_server_bootstrap *bootstrap;
     struct aws_socket listener;
+    /* listeners on the other event loops of the group, only used when sharded */
+    struct server_listener_shard *shards;
+    size_t shard_count;
     aws_server_bootstrap_on_accept_channel_setup_fn *incoming_callback;
     aws_server_bootstrap_on_accept_channel_shutdown_fn *shutdown_callback;
     aws_server_bootstrap_on_server_listener_destroy_fn *destroy_callback;
@@ -903,6 +1055,10 @@ struct server_connection_args {
     void *user_data;
     bool use_tls;
     bool enable_read_back_pressure;
+    bool sharded;
+    bool steer_by_incoming_cpu;
+    bool adaptive_read_budget;
+    struct aws_socket_handler_read_budget_options read_budget;
     struct aws_ref_count ref_count;
 };
 
@@ -937,6 +1093,10 @@ static void s_server_connection_args_destroy(struct server_connection_args *args
         aws_tls_connection_options_clean_up(&args->tls_options);
     }
 
+    if (args->shards) {
+        aws_mem_release(allocator, args->shards);
+    }
+
     aws_mem_release(allocator, args);
 }
 
@@ -1125,11 +1285,14 @@ static void s_on_server_channel_on_setup_completed(struct aws_channel *channel,
         goto error;
     }
 
-    struct aws_channel_handler *socket_channel_handler = aws_socket_handler_new(
-        channel_data->server_connection_args->bootstrap->allocator,
-        channel_data->socket,
-        socket_slot,
-        g_aws_channel_max_fragment_size);
+    struct server_connection_args *server_connection_args = channel_data->server_connection_args;
+    struct aws_socket_handler_options socket_handler_options = {
+        .max_read_size = g_aws_channel_max_fragment_size,
+        .adaptive_read_budget =
+            server_connection_args->adaptive_read_budget ? &server_connection_args->read_budget : NULL,
+    };
+    struct aws_channel_handler *socket_channel_handler = aws_socket_handler_new_with_options(
+        server_connection_args->bootstrap->allocator, channel_data->socket, socket_slot, &socket_handler_options);
 
     if (!socket_channel_handler) {
         err_code = aws_last_error();
@@ -1198,6 +1361,39 @@ static void s_on_server_channel_on_shutdown(struct aws_channel *channel, int err
     aws_mem_release(allocator, channel_data);
 }
 
+/* A sharded listener keeps its connections on the loop that accepted them. With incoming CPU steering, they go to the
+ * loop pinned to the CPU that receives their packets. */
+static struct aws_event_loop *s_get_connection_loop(
+    struct server_connection_args *connection_args,
+    struct aws_socket *listener,
+    struct aws_socket *new_socket) {
+
+    if (connection_args->sharded) {
+        return aws_socket_get_event_loop(listener);
+    }
+
+    struct aws_event_loop_group *el_group = connection_args->bootstrap->event_loop_group;
+    if (connection_args->steer_by_incoming_cpu) {
+        int cpu_id = -1;
+        if (!aws_socket_get_incoming_cpu(new_socket, &cpu_id)) {
+            struct aws_event_loop *loop = aws_event_loop_group_get_loop_for_cpu(el_group, cpu_id);
+            if (loop) {
+                AWS_LOGF_TRACE(
+                    AWS_LS_IO_CHANNEL_BOOTSTRAP,
+                    "id=%p: connection on socket %p arrives on cpu %d, using event loop %p pinned to cpu %d.",
+                    (void *)connection_args->bootstrap,
+                    (void *)new_socket,
+                    cpu_id,
+                    (void *)loop,
+                    loop->cpu_id);
+                return loop;
+            }
+        }
+    }
+
+    return aws_event_loop_group_get_next_loop(el_group);
+}
+
 void s_on_server_connection_result(
     struct aws_socket *socket,
     int error_code,
@@ -1230,8 +1426,7 @@ void s_on_server_connection_result(
         channel_data->socket = new_socket;
         channel_data->server_connection_args = connection_args;
 
-        struct aws_event_loop *event_loop =
-            aws_event_loop_group_get_next_loop(connection_args->bootstrap->event_loop_group);
+        struct aws_event_loop *event_loop = s_get_connection_loop(connection_args, socket, new_socket);
 
         struct aws_channel_options channel_args = {
             .on_setup_completed = s_on_server_channel_on_setup_completed,
@@ -1282,6 +1477,110 @@ static void s_listener_destroy_task(struct aws_task *task, void *arg, enum aws_t
     s_server_connection_args_release(server_connection_args);
 }
 
+static void s_listener_shard_destroy_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)status;
+    (void)task;
+    struct server_listener_shard *shard = arg;
+
+    aws_socket_stop_accept(&shard->listener);
+    aws_socket_clean_up(&shard->listener);
+    s_server_connection_args_release(shard->server_connection_args);
+}
+
+/*
+ * Opens an SO_REUSEPORT listener bound to the same endpoint as the primary listener on every event loop of the group
+ * but the primary's. The shards don't accept yet, see s_start_listener_shards().
+ */
+static int s_open_listener_shards(
+    struct server_connection_args *server_connection_args,
+    const struct aws_socket_options *socket_options,
+    const struct aws_socket_endpoint *endpoint,
+    struct aws_event_loop *primary_loop) {
+
+    struct aws_allocator *allocator = server_connection_args->bootstrap->allocator;
+    struct aws_event_loop_group *el_group = server_connection_args->bootstrap->event_loop_group;
+    size_t loop_count = aws_event_loop_group_get_loop_count(el_group);
+    if (loop_count < 2) {
+        return AWS_OP_SUCCESS;
+    }
+
+    server_connection_args->shards = aws_mem_calloc(allocator, loop_count - 1, sizeof(struct server_listener_shard));
+    if (!server_connection_args->shards) {
+        return AWS_OP_ERR;
+    }
+
+    for (size_t i = 0; i < loop_count; ++i) {
+        struct aws_event_loop *loop = aws_event_loop_group_get_loop_at(el_group, i);
+        if (loop == primary_loop) {
+            continue;
+        }
+
+        struct server_listener_shard *shard = &server_connection_args->shards[server_connection_args->shard_count];
+        shard->server_connection_args = server_connection_args;
+        shard->event_loop = loop;
+        aws_task_init(&shard->listener_destroy_task, s_listener_shard_destroy_task, shard, "listener shard destroy");
+
+        if (aws_socket_init(&shard->listener, allocator, socket_options)) {
+            goto error;
+        }
+
+        if (aws_socket_bind(&shard->listener, endpoint) || aws_socket_listen(&shard->listener, 1024)) {
+            aws_socket_clean_up(&shard->listener);
+            goto error;
+        }
+
+        server_connection_args->shard_count++;
+    }
+
+    return AWS_OP_SUCCESS;
+
+error:
+    /* none of them is accepting yet, so they close right away */
+    for (size_t i = 0; i < server_connection_args->shard_count; ++i) {
+        aws_socket_clean_up(&server_connection_args->shards[i].listener);
+    }
+    server_connection_args->shard_count = 0;
+
+    return AWS_OP_ERR;
+}
+
+/* Starts accepting on every shard. Each shard that starts holds a reference on server_connection_args, released by its
+ * destroy task. */
+static int s_start_listener_shards(struct server_connection_args *server_connection_args) {
+    for (size_t i = 0; i < server_connection_args->shard_count; ++i) {
+        struct server_listener_shard *shard = &server_connection_args->shards[i];
+        if (aws_socket_start_accept(
+                &shard->listener, shard->event_loop, s_on_server_connection_result, server_connection_args)) {
+            return AWS_OP_ERR;
+        }
+
+        s_server_connection_args_acquire(server_connection_args);
+        shard->accepting = true;
+    }
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_CHANNEL_BOOTSTRAP,
+        "id=%p: listener sharded across %zu event loops.",
+        (void *)server_connection_args->bootstrap,
+        server_connection_args->shard_count + 1);
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Closes the shards of a listener that failed to start. Closing a shard that is accepting from another thread blocks
+ * until its event loop has stopped accepting on it, so once this returns, no shard accepts connections anymore. */
+static void s_close_listener_shards(struct server_connection_args *server_connection_args) {
+    for (size_t i = 0; i < server_connection_args->shard_count; ++i) {
+        struct server_listener_shard *shard = &server_connection_args->shards[i];
+        aws_socket_clean_up(&shard->listener);
+        if (shard->accepting) {
+            shard->accepting = false;
+            s_server_connection_args_release(server_connection_args);
+        }
+    }
+    server_connection_args->shard_count = 0;
+}
+
 struct aws_socket *aws_server_bootstrap_new_socket_listener(
     const struct aws_server_socket_channel_bootstrap_options *bootstrap_options) {
     AWS_PRECONDITION(bootstrap_options);
@@ -1314,6 +1613,10 @@ struct aws_socket *aws_server_bootstrap_new_socket_listener(
     server_connection_args->destroy_callback = bootstrap_options->destroy_callback;
     server_connection_args->on_protocol_negotiated = bootstrap_options->bootstrap->on_protocol_negotiated;
     server_connection_args->enable_read_back_pressure = bootstrap_options->enable_read_back_pressure;
+    if (bootstrap_options->adaptive_read_budget) {
+        server_connection_args->adaptive_read_budget = true;
+        server_connection_args->read_budget = *bootstrap_options->adaptive_read_budget;
+    }
 
     aws_task_init(
         &server_connection_args->listener_destroy_task,
@@ -1359,10 +1662,37 @@ struct aws_socket *aws_server_bootstrap_new_socket_listener(
     struct aws_event_loop *connection_loop =
         aws_event_loop_group_get_next_loop(bootstrap_options->bootstrap->event_loop_group);
 
-    if (aws_socket_init(
-            &server_connection_args->listener,
-            bootstrap_options->bootstrap->allocator,
-            bootstrap_options->socket_options)) {
+    struct aws_socket_options socket_options = *bootstrap_options->socket_options;
+    if (bootstrap_options->shard_across_event_loops) {
+        if (socket_options.type != AWS_SOCKET_STREAM ||
+            (socket_options.domain != AWS_SOCKET_IPV4 && socket_options.domain != AWS_SOCKET_IPV6)) {
+            AWS_LOGF_ERROR(
+                AWS_LS_IO_CHANNEL_BOOTSTRAP,
+                "id=%p: only TCP listeners can be sharded across event loops.",
+                (void *)bootstrap_options->bootstrap);
+            aws_raise_error(AWS_IO_SOCKET_INVALID_OPTIONS);
+            goto cleanup_server_connection_args;
+        }
+
+        server_connection_args->sharded = true;
+        socket_options.reuse_port = true;
+    }
+
+    if (bootstrap_options->steer_by_incoming_cpu) {
+        if (bootstrap_options->shard_across_event_loops ||
+            !aws_event_loop_group_get_loop_for_cpu(bootstrap_options->bootstrap->event_loop_group, 0)) {
+            AWS_LOGF_ERROR(
+                AWS_LS_IO_CHANNEL_BOOTSTRAP,
+                "id=%p: steering by incoming cpu needs an event loop group pinned to cpus, and no sharding.",
+                (void *)bootstrap_options->bootstrap);
+            aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            goto cleanup_server_connection_args;
+        }
+
+        server_connection_args->steer_by_incoming_cpu = true;
+    }
+
+    if (aws_socket_init(&server_connection_args->listener, bootstrap_options->bootstrap->allocator, &socket_options)) {
         goto cleanup_server_connection_args;
     }
 
@@ -1384,16 +1714,36 @@ struct aws_socket *aws_server_bootstrap_new_socket_listener(
         goto cleanup_listener;
     }
 
+    if (server_connection_args->sharded) {
+        /* if the caller asked for an ephemeral port, the shards have to share the one the kernel picked */
+        endpoint.port = server_connection_args->listener.local_endpoint.port;
+        if (s_open_listener_shards(server_connection_args, &socket_options, &endpoint, connection_loop)) {
+            goto cleanup_listener;
+        }
+    }
+
+    /* nothing accepts until every listener is open, so failing to open one never races with accepted connections */
     if (aws_socket_start_accept(
             &server_connection_args->listener,
             connection_loop,
             s_on_server_connection_result,
             server_connection_args)) {
-        goto cleanup_listener;
+        goto cleanup_shards;
+    }
+
+    if (s_start_listener_shards(server_connection_args)) {
+        goto cleanup_shards;
+    }
+
+    if (bootstrap_options->prewarm_event_loops) {
+        s_prewarm_event_loops(bootstrap_options->bootstrap, bootstrap_options->bootstrap->event_loop_group);
     }
 
     return &server_connection_args->listener;
 
+cleanup_shards:
+    s_close_listener_shards(server_connection_args);
+
 cleanup_listener:
     aws_socket_clean_up(&server_connection_args->listener);
 
@@ -1408,7 +1758,13 @@ void aws_server_bootstrap_destroy_socket_listener(struct aws_server_bootstrap *b
         AWS_CONTAINER_OF(listener, struct server_connection_args, listener);
 
     AWS_LOGF_DEBUG(AWS_LS_IO_CHANNEL_BOOTSTRAP, "id=%p: releasing bootstrap reference", (void *)bootstrap);
+    /* the shards may be the last to release server_connection_args, so take everything needed from it first */
+    size_t shard_count = server_connection_args->shard_count;
+    struct server_listener_shard *shards = server_connection_args->shards;
     aws_event_loop_schedule_task_now(listener->event_loop, &server_connection_args->listener_destroy_task);
+    for (size_t i = 0; i < shard_count; ++i) {
+        aws_event_loop_schedule_task_now(shards[i].listener.event_loop, &shards[i].listener_destroy_task);
+    }
 }
 
 int aws_server_bootstrap_set_alpn_callback(
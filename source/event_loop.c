@@ -5,10 +5,14 @@
 
 #include <aws/io/event_loop.h>
 
+#include <aws/io/logging.h>
+
 #include <aws/common/clock.h>
 #include <aws/common/system_info.h>
 #include <aws/common/thread.h>
 
+#include <limits.h>
+
 static void s_event_loop_group_thread_exit(void *user_data) {
     struct aws_event_loop_group *el_group = user_data;
 
@@ -86,6 +90,7 @@ struct aws_event_loop_group *aws_event_loop_group_new(
     aws_ref_count_init(
         &el_group->ref_count, el_group, (aws_simple_completion_callback *)s_aws_event_loop_group_shutdown_async);
     aws_atomic_init_int(&el_group->current_index, 0);
+    aws_atomic_init_int(&el_group->current_cpu_index, 0);
 
     if (aws_array_list_init_dynamic(&el_group->event_loops, alloc, el_count, sizeof(struct aws_event_loop *))) {
         goto on_error;
@@ -145,6 +150,56 @@ struct aws_event_loop_group *aws_event_loop_group_new_default(
         alloc, aws_high_res_clock_get_ticks, max_threads, default_new_event_loop, NULL, shutdown_options);
 }
 
+struct pinned_new_loop_args {
+    uint16_t loops_created;
+    size_t cpu_count;
+};
+
+static struct aws_event_loop *s_pinned_new_event_loop(
+    struct aws_allocator *allocator,
+    aws_io_clock_fn *clock,
+    void *user_data) {
+
+    struct pinned_new_loop_args *args = user_data;
+    struct aws_event_loop *loop = aws_event_loop_new_default(allocator, clock);
+    if (loop) {
+        /* the loop's thread pins itself once it starts */
+        loop->cpu_id = (int)(args->loops_created % args->cpu_count);
+        args->loops_created++;
+    }
+
+    return loop;
+}
+
+struct aws_event_loop_group *aws_event_loop_group_new_default_pinned_to_cpus(
+    struct aws_allocator *alloc,
+    uint16_t max_threads,
+    const struct aws_shutdown_callback_options *shutdown_options) {
+#if !defined(__linux__)
+    (void)alloc;
+    (void)max_threads;
+    (void)shutdown_options;
+    AWS_LOGF_ERROR(AWS_LS_IO_EVENT_LOOP, "static: pinning event loops to CPUs is not supported on this platform");
+    aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    return NULL;
+#else
+    struct pinned_new_loop_args args = {
+        .loops_created = 0,
+        .cpu_count = aws_system_info_processor_count(),
+    };
+    if (!args.cpu_count) {
+        args.cpu_count = 1;
+    }
+
+    if (!max_threads) {
+        max_threads = (uint16_t)args.cpu_count;
+    }
+
+    return aws_event_loop_group_new(
+        alloc, aws_high_res_clock_get_ticks, max_threads, s_pinned_new_event_loop, &args, shutdown_options);
+#endif
+}
+
 struct aws_event_loop_group *aws_event_loop_group_acquire(struct aws_event_loop_group *el_group) {
     if (el_group != NULL) {
         aws_ref_count_acquire(&el_group->ref_count);
@@ -191,6 +246,46 @@ struct aws_event_loop *aws_event_loop_group_get_next_loop(struct aws_event_loop_
     return loop;
 }
 
+struct aws_event_loop *aws_event_loop_group_get_loop_for_cpu(struct aws_event_loop_group *el_group, int cpu_id) {
+    int nearest_cpu_id = -1;
+    int nearest_distance = INT_MAX;
+    size_t nearest_count = 0;
+
+    size_t loop_count = aws_array_list_length(&el_group->event_loops);
+    for (size_t i = 0; i < loop_count; ++i) {
+        struct aws_event_loop *loop = NULL;
+        aws_array_list_get_at(&el_group->event_loops, &loop, i);
+        if (loop->cpu_id < 0) {
+            continue;
+        }
+
+        int distance = loop->cpu_id > cpu_id ? loop->cpu_id - cpu_id : cpu_id - loop->cpu_id;
+        if (distance < nearest_distance) {
+            nearest_cpu_id = loop->cpu_id;
+            nearest_distance = distance;
+            nearest_count = 1;
+        } else if (loop->cpu_id == nearest_cpu_id) {
+            nearest_count++;
+        }
+    }
+
+    if (!nearest_count) {
+        return NULL;
+    }
+
+    /* more loops than CPUs, take turns among the ones on this CPU */
+    size_t pick = aws_atomic_fetch_add(&el_group->current_cpu_index, 1) % nearest_count;
+    for (size_t i = 0; i < loop_count; ++i) {
+        struct aws_event_loop *loop = NULL;
+        aws_array_list_get_at(&el_group->event_loops, &loop, i);
+        if (loop->cpu_id == nearest_cpu_id && !pick--) {
+            return loop;
+        }
+    }
+
+    return NULL;
+}
+
 static void s_object_removed(void *value) {
     struct aws_event_loop_local_object *object = (struct aws_event_loop_local_object *)value;
     if (object->on_object_removed) {
@@ -203,15 +298,24 @@ int aws_event_loop_init_base(struct aws_event_loop *event_loop, struct aws_alloc
 
     event_loop->alloc = alloc;
     event_loop->clock = clock;
+    event_loop->cpu_id = -1;
 
     if (aws_hash_table_init(&event_loop->local_data, alloc, 20, aws_hash_ptr, aws_ptr_eq, NULL, s_object_removed)) {
         return AWS_OP_ERR;
     }
 
+    if (aws_mutex_init(&event_loop->busy_poll_lock)) {
+        aws_hash_table_clean_up(&event_loop->local_data);
+        return AWS_OP_ERR;
+    }
+
+    aws_atomic_init_int(&event_loop->busy_poll_usec, 0);
+
     return AWS_OP_SUCCESS;
 }
 
 void aws_event_loop_clean_up_base(struct aws_event_loop *event_loop) {
+    aws_mutex_clean_up(&event_loop->busy_poll_lock);
     aws_hash_table_clean_up(&event_loop->local_data);
 }
 
@@ -365,3 +469,26 @@ int aws_event_loop_current_clock_time(struct aws_event_loop *event_loop, uint64_
     AWS_ASSERT(event_loop->clock);
     return event_loop->clock(time_nanos);
 }
+
+void aws_event_loop_register_busy_poll(struct aws_event_loop *event_loop, uint32_t spin_usec) {
+    aws_mutex_lock(&event_loop->busy_poll_lock);
+    event_loop->busy_poll_registrations++;
+    if (spin_usec > aws_atomic_load_int(&event_loop->busy_poll_usec)) {
+        aws_atomic_store_int(&event_loop->busy_poll_usec, spin_usec);
+    }
+    aws_mutex_unlock(&event_loop->busy_poll_lock);
+}
+
+void aws_event_loop_unregister_busy_poll(struct aws_event_loop *event_loop) {
+    aws_mutex_lock(&event_loop->busy_poll_lock);
+    AWS_ASSERT(event_loop->busy_poll_registrations > 0);
+    /* the spin time stays at the largest value registered until every registration is gone. */
+    if (--event_loop->busy_poll_registrations == 0) {
+        aws_atomic_store_int(&event_loop->busy_poll_usec, 0);
+    }
+    aws_mutex_unlock(&event_loop->busy_poll_lock);
+}
+
+uint32_t aws_event_loop_get_busy_poll_usec(struct aws_event_loop *event_loop) {
+    return (uint32_t)aws_atomic_load_int(&event_loop->busy_poll_usec);
+}
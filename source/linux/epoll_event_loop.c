@@ -3,6 +3,10 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 
+#if !defined(_GNU_SOURCE)
+#    define _GNU_SOURCE /* pthread_setaffinity_np() */
+#endif
+
 #include <aws/io/event_loop.h>
 
 #include <aws/common/atomics.h>
@@ -17,6 +21,8 @@
 
 #include <errno.h>
 #include <limits.h>
+#include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
 
 #if !defined(COMPAT_MODE) && defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 8
@@ -61,6 +67,7 @@ static void s_free_io_event_resources(void *user_data);
 static bool s_is_on_callers_thread(struct aws_event_loop *event_loop);
 
 static void s_main_loop(void *args);
+static void s_pin_to_cpu(struct aws_event_loop *event_loop);
 
 static struct aws_event_loop_vtable s_vtable = {
     .destroy = s_destroy,
@@ -265,6 +272,8 @@ static int s_run(struct aws_event_loop *event_loop) {
         return AWS_OP_ERR;
     }
 
+    s_pin_to_cpu(event_loop);
+
     return AWS_OP_SUCCESS;
 }
 
@@ -531,6 +540,73 @@ static void s_process_task_pre_queue(struct aws_event_loop *event_loop) {
     }
 }
 
+/*
+ * Waits for IO events. If sockets on this loop asked for busy polling, first polls without blocking for up to the
+ * registered spin time, so that a response arriving shortly after a request is picked up without the cost of
+ * sleeping and being woken up again. Falls back to a regular (blocking) epoll_wait() when the spin finds nothing.
+ */
+static int s_wait_for_events(struct aws_event_loop *event_loop, struct epoll_event *events, int timeout) {
+    struct epoll_loop *epoll_loop = event_loop->impl_data;
+
+    uint64_t spin_ns = aws_timestamp_convert(
+        aws_event_loop_get_busy_poll_usec(event_loop), AWS_TIMESTAMP_MICROS, AWS_TIMESTAMP_NANOS, NULL);
+    uint64_t timeout_ns = aws_timestamp_convert((uint64_t)timeout, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL);
+    if (spin_ns > timeout_ns) {
+        spin_ns = timeout_ns;
+    }
+
+    uint64_t start_ns = 0;
+    if (spin_ns == 0 || event_loop->clock(&start_ns)) {
+        return epoll_wait(epoll_loop->epoll_fd, events, MAX_EVENTS, timeout);
+    }
+
+    uint64_t now_ns = start_ns;
+    do {
+        int event_count = epoll_wait(epoll_loop->epoll_fd, events, MAX_EVENTS, 0);
+        if (event_count != 0) {
+            return event_count;
+        }
+
+        if (event_loop->clock(&now_ns)) {
+            break;
+        }
+    } while (now_ns - start_ns < spin_ns);
+
+    uint64_t spun_ms = aws_timestamp_convert(now_ns - start_ns, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MILLIS, NULL);
+    int remaining_timeout = spun_ms >= (uint64_t)timeout ? 0 : timeout - (int)spun_ms;
+    return epoll_wait(epoll_loop->epoll_fd, events, MAX_EVENTS, remaining_timeout);
+}
+
+/* pins the loop's thread to the CPU it was created for, see aws_event_loop_group_new_default_pinned_to_cpus(). Done
+ * from s_run(), before the group hands the loop out, so cpu_id is settled by the time anyone reads it. */
+static void s_pin_to_cpu(struct aws_event_loop *event_loop) {
+    if (event_loop->cpu_id < 0) {
+        return;
+    }
+
+    struct epoll_loop *epoll_loop = event_loop->impl_data;
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(event_loop->cpu_id, &cpu_set);
+
+    int error = pthread_setaffinity_np(epoll_loop->thread_created_on.thread_id, sizeof(cpu_set), &cpu_set);
+    if (error) {
+        /* the CPU may be offline or outside the process's cpuset, the loop still works, it just isn't pinned, and
+         * isn't picked for connections arriving on that CPU either */
+        AWS_LOGF_WARN(
+            AWS_LS_IO_EVENT_LOOP,
+            "id=%p: failed to pin thread to cpu %d with error %d",
+            (void *)event_loop,
+            event_loop->cpu_id,
+            error);
+        event_loop->cpu_id = -1;
+        return;
+    }
+
+    AWS_LOGF_INFO(AWS_LS_IO_EVENT_LOOP, "id=%p: thread pinned to cpu %d", (void *)event_loop, event_loop->cpu_id);
+}
+
 static void s_main_loop(void *args) {
     struct aws_event_loop *event_loop = args;
     AWS_LOGF_INFO(AWS_LS_IO_EVENT_LOOP, "id=%p: main loop started", (void *)event_loop);
@@ -569,7 +645,7 @@ static void s_main_loop(void *args) {
      */
     while (epoll_loop->should_continue) {
         AWS_LOGF_TRACE(AWS_LS_IO_EVENT_LOOP, "id=%p: waiting for a maximum of %d ms", (void *)event_loop, timeout);
-        int event_count = epoll_wait(epoll_loop->epoll_fd, events, MAX_EVENTS, timeout);
+        int event_count = s_wait_for_events(event_loop, events, timeout);
 
         AWS_LOGF_TRACE(
             AWS_LS_IO_EVENT_LOOP, "id=%p: wake up with %d events to process.", (void *)event_loop, event_count);
@@ -77,9 +77,45 @@ void aws_memory_pool_release(struct aws_memory_pool *mempool, void *to_release)
     aws_array_list_push_back(&mempool->stack, &to_release);
 }
 
+size_t aws_memory_pool_trim(struct aws_memory_pool *mempool, size_t retain_count) {
+    size_t freed = 0;
+    void *cur = NULL;
+
+    while (aws_array_list_length(&mempool->stack) > retain_count) {
+        aws_array_list_back(&mempool->stack, &cur);
+        aws_array_list_pop_back(&mempool->stack);
+        aws_mem_release(mempool->alloc, cur);
+        ++freed;
+    }
+
+    return freed;
+}
+
+int aws_memory_pool_prewarm(struct aws_memory_pool *mempool) {
+    while (aws_array_list_length(&mempool->stack) < mempool->ideal_segment_count) {
+        void *memory = aws_mem_acquire(mempool->alloc, mempool->segment_size);
+        if (!memory) {
+            return AWS_OP_ERR;
+        }
+
+        aws_array_list_push_back(&mempool->stack, &memory);
+    }
+
+    for (size_t i = 0; i < aws_array_list_length(&mempool->stack); ++i) {
+        void *segment = NULL;
+        aws_array_list_get_at(&mempool->stack, &segment, i);
+        /* writing the whole segment forces the allocator's pages to be mapped now rather than on first use. */
+        memset(segment, 0, mempool->segment_size);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
 struct message_pool_allocator {
     struct aws_allocator base_allocator;
     struct aws_message_pool *msg_pool;
+    /* the pool the message's memory came from. Its capacity can't tell, a handler is free to shrink it. */
+    struct aws_memory_pool *segment_pool;
 };
 
 void *s_message_pool_mem_acquire(struct aws_allocator *allocator, size_t size) {
@@ -129,6 +165,22 @@ void aws_message_pool_clean_up(struct aws_message_pool *msg_pool) {
     AWS_ZERO_STRUCT(*msg_pool);
 }
 
+size_t aws_message_pool_trim(struct aws_message_pool *msg_pool) {
+    size_t freed =
+        aws_memory_pool_trim(&msg_pool->application_data_pool, 0) * msg_pool->application_data_pool.segment_size;
+    freed += aws_memory_pool_trim(&msg_pool->small_block_pool, 0) * msg_pool->small_block_pool.segment_size;
+
+    return freed;
+}
+
+int aws_message_pool_prewarm(struct aws_message_pool *msg_pool) {
+    if (aws_memory_pool_prewarm(&msg_pool->application_data_pool)) {
+        return AWS_OP_ERR;
+    }
+
+    return aws_memory_pool_prewarm(&msg_pool->small_block_pool);
+}
+
 struct message_wrapper {
     struct aws_io_message message;
     struct message_pool_allocator msg_allocator;
@@ -141,16 +193,15 @@ struct aws_io_message *aws_message_pool_acquire(
     size_t size_hint) {
 
     struct message_wrapper *message_wrapper = NULL;
-    size_t max_size = 0;
+    struct aws_memory_pool *segment_pool = NULL;
     switch (message_type) {
         case AWS_IO_MESSAGE_APPLICATION_DATA:
             if (size_hint > msg_pool->small_block_pool.segment_size - MSG_OVERHEAD) {
-                message_wrapper = aws_memory_pool_acquire(&msg_pool->application_data_pool);
-                max_size = msg_pool->application_data_pool.segment_size - MSG_OVERHEAD;
+                segment_pool = &msg_pool->application_data_pool;
             } else {
-                message_wrapper = aws_memory_pool_acquire(&msg_pool->small_block_pool);
-                max_size = msg_pool->small_block_pool.segment_size - MSG_OVERHEAD;
+                segment_pool = &msg_pool->small_block_pool;
             }
+            message_wrapper = aws_memory_pool_acquire(segment_pool);
             break;
         default:
             AWS_ASSERT(0);
@@ -167,7 +218,9 @@ struct aws_io_message *aws_message_pool_acquire(
     message_wrapper->message.user_data = NULL;
     message_wrapper->message.copy_mark = 0;
     message_wrapper->message.on_completion = NULL;
+    message_wrapper->message.endpoint = NULL;
     /* the buffer shares the allocation with the message. It's the bit at the end. */
+    size_t max_size = segment_pool->segment_size - MSG_OVERHEAD;
     message_wrapper->message.message_data.buffer = message_wrapper->buffer_start;
     message_wrapper->message.message_data.len = 0;
     message_wrapper->message.message_data.capacity = size_hint <= max_size ? size_hint : max_size;
@@ -178,6 +231,7 @@ struct aws_io_message *aws_message_pool_acquire(
     message_wrapper->msg_allocator.base_allocator.mem_realloc = NULL;
     message_wrapper->msg_allocator.base_allocator.mem_release = s_message_pool_mem_release;
     message_wrapper->msg_allocator.msg_pool = msg_pool;
+    message_wrapper->msg_allocator.segment_pool = segment_pool;
 
     message_wrapper->message.allocator = &message_wrapper->msg_allocator.base_allocator;
     return &message_wrapper->message;
@@ -192,11 +246,8 @@ void aws_message_pool_release(struct aws_message_pool *msg_pool, struct aws_io_m
 
     switch (message->message_type) {
         case AWS_IO_MESSAGE_APPLICATION_DATA:
-            if (message->message_data.capacity > msg_pool->small_block_pool.segment_size - MSG_OVERHEAD) {
-                aws_memory_pool_release(&msg_pool->application_data_pool, wrapper);
-            } else {
-                aws_memory_pool_release(&msg_pool->small_block_pool, wrapper);
-            }
+            AWS_ASSERT(wrapper->msg_allocator.msg_pool == msg_pool);
+            aws_memory_pool_release(wrapper->msg_allocator.segment_pool, wrapper);
             break;
         default:
             AWS_ASSERT(0);
@@ -3,6 +3,10 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 
+#if !defined(_GNU_SOURCE)
+#    define _GNU_SOURCE /* accept4(), splice(), sendmmsg() and recvmmsg() */
+#endif
+
 #include <aws/io/socket.h>
 
 #include <aws/common/clock.h>
@@ -17,11 +21,54 @@
 #include <aws/io/io.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#    include <linux/errqueue.h>
+#    define ZERO_COPY_SUPPORTED 1
+#    define ZERO_COPY_FLAG MSG_ZEROCOPY
+#else
+#    define ZERO_COPY_FLAG 0
+#endif
+
+#if defined(__linux__) && defined(SO_TIMESTAMPING)
+#    include <linux/errqueue.h>
+#    include <linux/net_tstamp.h>
+#    define TIMESTAMPING_SUPPORTED 1
+#endif
+
+/* zero-copy completions and send timestamps are both read off the socket's error queue */
+#if defined(ZERO_COPY_SUPPORTED) || defined(TIMESTAMPING_SUPPORTED)
+#    define ERROR_QUEUE_SUPPORTED 1
+#endif
+
+#if defined(__linux__)
+#    include <sys/sendfile.h>
+#    define SENDFILE_SUPPORTED 1
+#    define SPLICE_SUPPORTED 1
+#endif
+
+/* accepted sockets are made non-blocking by accept4() itself, instead of with an extra fcntl() */
+#if !defined(COMPAT_MODE) && defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 10
+#    define ACCEPT4_SUPPORTED 1
+#endif
+
+/* recvmmsg() and sendmmsg(), many datagrams per syscall */
+#if defined(__linux__)
+#    define MMSG_SUPPORTED 1
+#endif
+
+#if defined(MSG_MORE)
+#    define MORE_FLAG MSG_MORE
+#else
+#    define MORE_FLAG 0
+#endif
+
 #if defined(__MACH__)
 #    define NO_SIGNAL SO_NOSIGPIPE
 #    define TCP_KEEPIDLE TCP_KEEPALIVE
@@ -39,6 +86,9 @@
 #    define O_CLOEXEC 02000000
 #endif
 
+/* connections a listener accepts per event-loop tick when the options don't say otherwise */
+#define DEFAULT_MAX_ACCEPTS_PER_TICK 128
+
 #ifdef USE_VSOCK
 #    if defined(__linux__) && defined(AF_VSOCK)
 #        include <linux/vm_sockets.h>
@@ -145,7 +195,12 @@ static int s_create_socket(struct aws_socket *sock, const struct aws_socket_opti
         (void)success;
         sock->io_handle.data.fd = fd;
         sock->io_handle.additional_data = NULL;
-        return aws_socket_set_options(sock, options);
+        if (aws_socket_set_options(sock, options)) {
+            close(fd);
+            sock->io_handle.data.fd = -1;
+            return AWS_OP_ERR;
+        }
+        return AWS_OP_SUCCESS;
     }
 
     int aws_error = s_determine_socket_error(errno);
@@ -161,12 +216,33 @@ struct posix_socket_connect_args {
 struct posix_socket {
     struct aws_linked_list write_queue;
     struct posix_socket_connect_args *connect_args;
+    /* listeners only: picks up where the accept loop left off once it used up its per-tick budget */
+    struct aws_task accept_continuation_task;
     bool write_in_progress;
     bool currently_subscribed;
     bool continue_accept;
+    bool accept_continuation_scheduled;
     bool currently_in_event;
     bool clean_yourself_up;
     bool *close_happened;
+    /* Write requests that were fully handed to the kernel, but whose completion waits on a MSG_ZEROCOPY notification
+     * (either their own, or one for a request ahead of them). */
+    struct aws_linked_list zero_copy_queue;
+    /* id the kernel will assign to the next successful MSG_ZEROCOPY send */
+    uint32_t zero_copy_next_id;
+    /* MSG_ZEROCOPY sends reported done, and those of them the kernel copied anyway */
+    uint64_t zero_copy_sends_completed;
+    uint64_t zero_copy_sends_copied;
+    bool zero_copy_checked;
+    bool zero_copy_enabled;
+    /* true while this socket holds a busy-poll registration on its event loop */
+    bool busy_poll_registered;
+    /* quick_ack is set on a TCP socket. TCP_QUICKACK doesn't stick, so it is set again after each read. */
+    bool rearm_quick_ack;
+    /* pipe aws_socket_read_to_file() moves data through, created on first use. Empty between calls. */
+    int splice_pipe[2];
+    /* latest SO_TIMESTAMPING timestamps, when the socket has kernel_timestamps set */
+    struct aws_socket_kernel_timestamps kernel_timestamps;
 };
 
 static int s_socket_init(
@@ -204,6 +280,7 @@ static int s_socket_init(
     }
 
     aws_linked_list_init(&posix_socket->write_queue);
+    aws_linked_list_init(&posix_socket->zero_copy_queue);
     posix_socket->write_in_progress = false;
     posix_socket->currently_subscribed = false;
     posix_socket->continue_accept = false;
@@ -211,6 +288,10 @@ static int s_socket_init(
     posix_socket->clean_yourself_up = false;
     posix_socket->connect_args = NULL;
     posix_socket->close_happened = NULL;
+    posix_socket->splice_pipe[0] = -1;
+    posix_socket->splice_pipe[1] = -1;
+    posix_socket->rearm_quick_ack = options->quick_ack && options->type == AWS_SOCKET_STREAM &&
+                                    (options->domain == AWS_SOCKET_IPV4 || options->domain == AWS_SOCKET_IPV6);
     socket->impl = posix_socket;
     return AWS_OP_SUCCESS;
 }
@@ -220,6 +301,15 @@ int aws_socket_init(struct aws_socket *socket, struct aws_allocator *alloc, cons
     return s_socket_init(socket, alloc, options, -1);
 }
 
+static void s_close_splice_pipe(struct posix_socket *socket_impl) {
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(socket_impl->splice_pipe); ++i) {
+        if (socket_impl->splice_pipe[i] != -1) {
+            close(socket_impl->splice_pipe[i]);
+            socket_impl->splice_pipe[i] = -1;
+        }
+    }
+}
+
 void aws_socket_clean_up(struct aws_socket *socket) {
     if (!socket->impl) {
         /* protect from double clean */
@@ -231,6 +321,7 @@ void aws_socket_clean_up(struct aws_socket *socket) {
         aws_socket_close(socket);
     }
     struct posix_socket *socket_impl = socket->impl;
+    s_close_splice_pipe(socket_impl);
 
     if (!socket_impl->currently_in_event) {
         aws_mem_release(socket->allocator, socket->impl);
@@ -247,6 +338,35 @@ void aws_socket_clean_up(struct aws_socket *socket) {
     socket->io_handle.data.fd = -1;
 }
 
+/* Enables software SO_TIMESTAMPING. Send timestamps are tagged with an id, but for stream sockets the kernel only
+ * starts counting once connected, until then the timestamps go without one and this is called again on connect. */
+static void s_enable_kernel_timestamps(struct aws_socket *socket) {
+#ifdef TIMESTAMPING_SUPPORTED
+    int flags = SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_TX_SOFTWARE |
+                SOF_TIMESTAMPING_OPT_TSONLY;
+    int flags_with_id = flags | SOF_TIMESTAMPING_OPT_ID;
+    if (!setsockopt(socket->io_handle.data.fd, SOL_SOCKET, SO_TIMESTAMPING, &flags_with_id, sizeof(flags_with_id))) {
+        return;
+    }
+
+    if (errno != EINVAL ||
+        setsockopt(socket->io_handle.data.fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags))) {
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: setsockopt() for SO_TIMESTAMPING failed with errno %d.",
+            (void *)socket,
+            socket->io_handle.data.fd,
+            errno);
+    }
+#else
+    AWS_LOGF_WARN(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: kernel timestamps are not supported on this platform, ignoring them.",
+        (void *)socket,
+        socket->io_handle.data.fd);
+#endif
+}
+
 static void s_on_connection_error(struct aws_socket *socket, int error);
 
 static int s_on_connection_success(struct aws_socket *socket) {
@@ -292,6 +412,10 @@ static int s_on_connection_success(struct aws_socket *socket) {
 
     AWS_LOGF_INFO(AWS_LS_IO_SOCKET, "id=%p fd=%d: connection success", (void *)socket, socket->io_handle.data.fd);
 
+    if (socket->options.kernel_timestamps && socket->options.type == AWS_SOCKET_STREAM) {
+        s_enable_kernel_timestamps(socket);
+    }
+
     struct sockaddr_storage address;
     AWS_ZERO_STRUCT(address);
     socklen_t address_size = sizeof(address);
@@ -550,6 +674,8 @@ static int parse_cid(const char *cid_str, unsigned int *value) {
 }
 #endif
 
+static void s_set_int_socket_option(struct aws_socket *socket, int level, int option, int value, const char *name);
+
 int aws_socket_connect(
     struct aws_socket *socket,
     const struct aws_socket_endpoint *remote_endpoint,
@@ -567,7 +693,8 @@ int aws_socket_connect(
 
     if (socket->options.type != AWS_SOCKET_DGRAM) {
         AWS_ASSERT(on_connection_result);
-        if (socket->state != INIT) {
+        /* bound by aws_socket_bind_for_connect() */
+        if (socket->state != INIT && socket->state != BOUND) {
             return aws_raise_error(AWS_IO_SOCKET_ILLEGAL_OPERATION_FOR_STATE);
         }
     } else { /* UDP socket */
@@ -649,6 +776,21 @@ int aws_socket_connect(
     socket_impl->connect_args->task.fn = s_handle_socket_timeout;
     socket_impl->connect_args->task.arg = socket_impl->connect_args;
 
+    if (socket->options.fast_open && socket->options.type == AWS_SOCKET_STREAM &&
+        (socket->options.domain == AWS_SOCKET_IPV4 || socket->options.domain == AWS_SOCKET_IPV6)) {
+#ifdef TCP_FASTOPEN_CONNECT
+        /* with a cached cookie for the peer, connect() returns right away and the SYN goes out with the first write.
+         * Otherwise, the kernel falls back to a regular handshake and requests a cookie for next time. */
+        s_set_int_socket_option(socket, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, 1, "TCP_FASTOPEN_CONNECT");
+#else
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: TCP_FASTOPEN_CONNECT is not supported on this platform, using a regular handshake.",
+            (void *)socket,
+            socket->io_handle.data.fd);
+#endif
+    }
+
     int error_code = connect(socket->io_handle.data.fd, (struct sockaddr *)&address.sock_addr_types, sock_size);
     socket->event_loop = event_loop;
 
@@ -800,6 +942,20 @@ int aws_socket_bind(struct aws_socket *socket, const struct aws_socket_endpoint
     error_code = bind(socket->io_handle.data.fd, (struct sockaddr *)&address.sock_addr_types, sock_size);
 
     if (!error_code) {
+        if (local_endpoint->port == 0 &&
+            (socket->options.domain == AWS_SOCKET_IPV4 || socket->options.domain == AWS_SOCKET_IPV6)) {
+            /* let callers find out which ephemeral port the kernel picked */
+            struct sockaddr_storage bound_address;
+            socklen_t bound_address_size = sizeof(bound_address);
+            if (!getsockname(socket->io_handle.data.fd, (struct sockaddr *)&bound_address, &bound_address_size)) {
+                if (bound_address.ss_family == AF_INET) {
+                    socket->local_endpoint.port = ntohs(((struct sockaddr_in *)&bound_address)->sin_port);
+                } else if (bound_address.ss_family == AF_INET6) {
+                    socket->local_endpoint.port = ntohs(((struct sockaddr_in6 *)&bound_address)->sin6_port);
+                }
+            }
+        }
+
         if (socket->options.type == AWS_SOCKET_STREAM) {
             socket->state = BOUND;
         } else {
@@ -824,6 +980,27 @@ int aws_socket_bind(struct aws_socket *socket, const struct aws_socket_endpoint
     return aws_raise_error(aws_error);
 }
 
+int aws_socket_bind_for_connect(struct aws_socket *socket, const struct aws_socket_endpoint *local_endpoint) {
+    if (socket->options.type != AWS_SOCKET_STREAM ||
+        (socket->options.domain != AWS_SOCKET_IPV4 && socket->options.domain != AWS_SOCKET_IPV6)) {
+        return aws_raise_error(AWS_IO_SOCKET_INVALID_OPERATION_FOR_TYPE);
+    }
+
+    if (local_endpoint->port == 0 && socket->state == INIT) {
+#ifdef IP_BIND_ADDRESS_NO_PORT
+        s_set_int_socket_option(socket, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, 1, "IP_BIND_ADDRESS_NO_PORT");
+#else
+        AWS_LOGF_DEBUG(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: IP_BIND_ADDRESS_NO_PORT is not supported on this platform, the port is picked at bind time.",
+            (void *)socket,
+            socket->io_handle.data.fd);
+#endif
+    }
+
+    return aws_socket_bind(socket, local_endpoint);
+}
+
 int aws_socket_listen(struct aws_socket *socket, int backlog_size) {
     if (socket->state != BOUND) {
         AWS_LOGF_ERROR(
@@ -834,6 +1011,34 @@ int aws_socket_listen(struct aws_socket *socket, int backlog_size) {
         return aws_raise_error(AWS_IO_SOCKET_ILLEGAL_OPERATION_FOR_STATE);
     }
 
+    if (socket->options.defer_accept_timeout_sec && socket->options.type == AWS_SOCKET_STREAM &&
+        (socket->options.domain == AWS_SOCKET_IPV4 || socket->options.domain == AWS_SOCKET_IPV6)) {
+#ifdef TCP_DEFER_ACCEPT
+        s_set_int_socket_option(
+            socket, IPPROTO_TCP, TCP_DEFER_ACCEPT, (int)socket->options.defer_accept_timeout_sec, "TCP_DEFER_ACCEPT");
+#else
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: TCP_DEFER_ACCEPT is not supported on this platform, ignoring it.",
+            (void *)socket,
+            socket->io_handle.data.fd);
+#endif
+    }
+
+    if (socket->options.fast_open_queue_length && socket->options.type == AWS_SOCKET_STREAM &&
+        (socket->options.domain == AWS_SOCKET_IPV4 || socket->options.domain == AWS_SOCKET_IPV6)) {
+#ifdef TCP_FASTOPEN
+        s_set_int_socket_option(
+            socket, IPPROTO_TCP, TCP_FASTOPEN, (int)socket->options.fast_open_queue_length, "TCP_FASTOPEN");
+#else
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: TCP_FASTOPEN is not supported on this platform, ignoring it.",
+            (void *)socket,
+            socket->io_handle.data.fd);
+#endif
+    }
+
     int error_code = listen(socket->io_handle.data.fd, backlog_size);
 
     if (!error_code) {
@@ -856,28 +1061,40 @@ int aws_socket_listen(struct aws_socket *socket, int backlog_size) {
 }
 
 /* this is called by the event loop handler that was installed in start_accept(). It runs once the FD goes readable,
- * accepts as many as it can and then returns control to the event loop. */
-static void s_socket_accept_event(
-    struct aws_event_loop *event_loop,
-    struct aws_io_handle *handle,
-    int events,
-    void *user_data) {
-
-    (void)event_loop;
-
-    struct aws_socket *socket = user_data;
+ * accepts up to max_accepts_per_tick connections and then returns control to the event loop. */
+static void s_accept_incoming_connections(struct aws_socket *socket) {
     struct posix_socket *socket_impl = socket->impl;
 
-    AWS_LOGF_DEBUG(
-        AWS_LS_IO_SOCKET, "id=%p fd=%d: listening event received", (void *)socket, socket->io_handle.data.fd);
+    size_t max_accepts = socket->options.max_accepts_per_tick ? socket->options.max_accepts_per_tick
+                                                              : DEFAULT_MAX_ACCEPTS_PER_TICK;
+    size_t accepted = 0;
 
-    if (socket_impl->continue_accept && events & AWS_IO_EVENT_TYPE_READABLE) {
+    if (socket_impl->continue_accept) {
         int in_fd = 0;
         while (socket_impl->continue_accept && in_fd != -1) {
+            if (accepted == max_accepts) {
+                /* the listener is edge-triggered, so the event loop won't tell us again about connections that are
+                 * already queued. Let everything else on the loop run, then pick up where we left off. */
+                AWS_LOGF_DEBUG(
+                    AWS_LS_IO_SOCKET,
+                    "id=%p fd=%d: accepted %zu connections this tick, continuing in a new task",
+                    (void *)socket,
+                    socket->io_handle.data.fd,
+                    accepted);
+                socket_impl->accept_continuation_scheduled = true;
+                aws_event_loop_schedule_task_now(socket->event_loop, &socket_impl->accept_continuation_task);
+                return;
+            }
+
             struct sockaddr_storage in_addr;
             socklen_t in_len = sizeof(struct sockaddr_storage);
 
-            in_fd = accept(handle->data.fd, (struct sockaddr *)&in_addr, &in_len);
+#ifdef ACCEPT4_SUPPORTED
+            in_fd = accept4(
+                socket->io_handle.data.fd, (struct sockaddr *)&in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+            in_fd = accept(socket->io_handle.data.fd, (struct sockaddr *)&in_addr, &in_len);
+#endif
             if (in_fd == -1) {
                 int error = errno;
 
@@ -891,6 +1108,7 @@ static void s_socket_accept_event(
                 break;
             }
 
+            ++accepted;
             AWS_LOGF_DEBUG(
                 AWS_LS_IO_SOCKET, "id=%p fd=%d: incoming connection", (void *)socket, socket->io_handle.data.fd);
 
@@ -963,10 +1181,12 @@ static void s_socket_accept_event(
                 new_sock->remote_endpoint.port,
                 in_fd);
 
+#ifndef ACCEPT4_SUPPORTED
             int flags = fcntl(in_fd, F_GETFL, 0);
 
             flags |= O_NONBLOCK | O_CLOEXEC;
             fcntl(in_fd, F_SETFL, flags);
+#endif
 
             bool close_occurred = false;
             socket_impl->close_happened = &close_occurred;
@@ -988,6 +1208,39 @@ static void s_socket_accept_event(
         socket->io_handle.data.fd);
 }
 
+static void s_socket_accept_continuation_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+
+    struct aws_socket *socket = arg;
+    struct posix_socket *socket_impl = socket->impl;
+    socket_impl->accept_continuation_scheduled = false;
+
+    if (status == AWS_TASK_STATUS_RUN_READY) {
+        s_accept_incoming_connections(socket);
+    }
+}
+
+static void s_socket_accept_event(
+    struct aws_event_loop *event_loop,
+    struct aws_io_handle *handle,
+    int events,
+    void *user_data) {
+
+    (void)event_loop;
+    (void)handle;
+
+    struct aws_socket *socket = user_data;
+    struct posix_socket *socket_impl = socket->impl;
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET, "id=%p fd=%d: listening event received", (void *)socket, socket->io_handle.data.fd);
+
+    /* a continuation is already queued up, it will drain the backlog including whatever this event is about. */
+    if (events & AWS_IO_EVENT_TYPE_READABLE && !socket_impl->accept_continuation_scheduled) {
+        s_accept_incoming_connections(socket);
+    }
+}
+
 int aws_socket_start_accept(
     struct aws_socket *socket,
     struct aws_event_loop *accept_loop,
@@ -1021,6 +1274,11 @@ int aws_socket_start_accept(
     struct posix_socket *socket_impl = socket->impl;
     socket_impl->continue_accept = true;
     socket_impl->currently_subscribed = true;
+    aws_task_init(
+        &socket_impl->accept_continuation_task,
+        s_socket_accept_continuation_task,
+        socket,
+        "socket_accept_continuation");
 
     if (aws_event_loop_subscribe_to_io_events(
             socket->event_loop, &socket->io_handle, AWS_IO_EVENT_TYPE_READABLE, s_socket_accept_event, socket)) {
@@ -1121,12 +1379,27 @@ int aws_socket_stop_accept(struct aws_socket *socket) {
         ret_val = aws_event_loop_unsubscribe_from_io_events(socket->event_loop, &socket->io_handle);
         socket_impl->currently_subscribed = false;
         socket_impl->continue_accept = false;
+        if (socket_impl->accept_continuation_scheduled) {
+            aws_event_loop_cancel_task(socket->event_loop, &socket_impl->accept_continuation_task);
+        }
         socket->event_loop = NULL;
     }
 
     return ret_val;
 }
 
+static void s_set_int_socket_option(struct aws_socket *socket, int level, int option, int value, const char *name) {
+    if (AWS_UNLIKELY(setsockopt(socket->io_handle.data.fd, level, option, &value, sizeof(value)))) {
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: setsockopt() for %s failed with errno %d.",
+            (void *)socket,
+            socket->io_handle.data.fd,
+            name,
+            errno);
+    }
+}
+
 int aws_socket_set_options(struct aws_socket *socket, const struct aws_socket_options *options) {
     if (socket->options.domain != options->domain || socket->options.type != options->type) {
         return aws_raise_error(AWS_IO_SOCKET_INVALID_OPTIONS);
@@ -1168,6 +1441,27 @@ int aws_socket_set_options(struct aws_socket *socket, const struct aws_socket_op
             errno);
     }
 
+    if (options->reuse_port && options->domain != AWS_SOCKET_LOCAL) {
+#ifdef SO_REUSEPORT
+        if (AWS_UNLIKELY(setsockopt(socket->io_handle.data.fd, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(int)))) {
+            AWS_LOGF_ERROR(
+                AWS_LS_IO_SOCKET,
+                "id=%p fd=%d: setsockopt() for SO_REUSEPORT failed with errno %d.",
+                (void *)socket,
+                socket->io_handle.data.fd,
+                errno);
+            return aws_raise_error(s_determine_socket_error(errno));
+        }
+#else
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: SO_REUSEPORT is not supported on this platform.",
+            (void *)socket,
+            socket->io_handle.data.fd);
+        return aws_raise_error(AWS_IO_SOCKET_INVALID_OPTIONS);
+#endif
+    }
+
     if (options->type == AWS_SOCKET_STREAM && options->domain != AWS_SOCKET_LOCAL) {
         if (socket->options.keepalive) {
             int keep_alive = 1;
@@ -1220,17 +1514,176 @@ int aws_socket_set_options(struct aws_socket *socket, const struct aws_socket_op
         }
     }
 
+    if (options->send_buffer_size) {
+        s_set_int_socket_option(socket, SOL_SOCKET, SO_SNDBUF, (int)options->send_buffer_size, "SO_SNDBUF");
+    }
+
+    if (options->receive_buffer_size) {
+        s_set_int_socket_option(socket, SOL_SOCKET, SO_RCVBUF, (int)options->receive_buffer_size, "SO_RCVBUF");
+    }
+
+    if (options->type == AWS_SOCKET_STREAM &&
+        (options->domain == AWS_SOCKET_IPV4 || options->domain == AWS_SOCKET_IPV6)) {
+        if (options->no_delay) {
+            s_set_int_socket_option(socket, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+        }
+
+        if (options->type_of_service) {
+            if (options->domain == AWS_SOCKET_IPV4) {
+                s_set_int_socket_option(socket, IPPROTO_IP, IP_TOS, options->type_of_service, "IP_TOS");
+            } else {
+                s_set_int_socket_option(socket, IPPROTO_IPV6, IPV6_TCLASS, options->type_of_service, "IPV6_TCLASS");
+            }
+        }
+
+#if defined(TCP_QUICKACK) && defined(TCP_CONGESTION)
+        /* options are also applied before the socket is fully initialized, s_socket_init() sets this then. */
+        struct posix_socket *socket_impl = socket->impl;
+        if (socket_impl) {
+            socket_impl->rearm_quick_ack = options->quick_ack;
+        }
+        if (options->quick_ack) {
+            s_set_int_socket_option(socket, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+        }
+
+        size_t congestion_control_len = strnlen(options->congestion_control, sizeof(options->congestion_control));
+        if (congestion_control_len > 0) {
+            if (AWS_UNLIKELY(setsockopt(
+                    socket->io_handle.data.fd,
+                    IPPROTO_TCP,
+                    TCP_CONGESTION,
+                    options->congestion_control,
+                    (socklen_t)congestion_control_len))) {
+                AWS_LOGF_WARN(
+                    AWS_LS_IO_SOCKET,
+                    "id=%p fd=%d: setsockopt() for TCP_CONGESTION \"%.*s\" failed with errno %d.",
+                    (void *)socket,
+                    socket->io_handle.data.fd,
+                    (int)congestion_control_len,
+                    options->congestion_control,
+                    errno);
+            }
+        }
+#else
+        if (options->quick_ack || options->congestion_control[0]) {
+            AWS_LOGF_WARN(
+                AWS_LS_IO_SOCKET,
+                "id=%p fd=%d: TCP_QUICKACK and TCP_CONGESTION are not supported on this platform, ignoring them.",
+                (void *)socket,
+                socket->io_handle.data.fd);
+        }
+#endif
+    }
+
+    if (options->notsent_low_watermark && options->type == AWS_SOCKET_STREAM &&
+        (options->domain == AWS_SOCKET_IPV4 || options->domain == AWS_SOCKET_IPV6)) {
+#ifdef TCP_NOTSENT_LOWAT
+        s_set_int_socket_option(
+            socket, IPPROTO_TCP, TCP_NOTSENT_LOWAT, (int)options->notsent_low_watermark, "TCP_NOTSENT_LOWAT");
+#else
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: TCP_NOTSENT_LOWAT is not supported on this platform, ignoring it.",
+            (void *)socket,
+            socket->io_handle.data.fd);
+#endif
+    }
+
+    if (options->busy_poll_usec) {
+#ifdef SO_BUSY_POLL
+        s_set_int_socket_option(socket, SOL_SOCKET, SO_BUSY_POLL, (int)options->busy_poll_usec, "SO_BUSY_POLL");
+#    ifdef SO_PREFER_BUSY_POLL
+        s_set_int_socket_option(socket, SOL_SOCKET, SO_PREFER_BUSY_POLL, 1, "SO_PREFER_BUSY_POLL");
+#    endif
+#else
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: SO_BUSY_POLL is not supported on this platform, only the event loop will spin.",
+            (void *)socket,
+            socket->io_handle.data.fd);
+#endif
+    }
+
+    if (options->zero_copy_write_threshold && options->type == AWS_SOCKET_STREAM &&
+        (options->domain == AWS_SOCKET_IPV4 || options->domain == AWS_SOCKET_IPV6)) {
+#ifdef ZERO_COPY_SUPPORTED
+        /* accepted sockets inherit the setting from their listener, and older kernels refuse to change it once a
+         * socket is connected. */
+        int zero_copy = 1;
+        if (AWS_UNLIKELY(
+                setsockopt(socket->io_handle.data.fd, SOL_SOCKET, SO_ZEROCOPY, &zero_copy, sizeof(zero_copy))) &&
+            errno != EBUSY) {
+            AWS_LOGF_WARN(
+                AWS_LS_IO_SOCKET,
+                "id=%p fd=%d: setsockopt() for enabling SO_ZEROCOPY failed with errno %d, writes will be copied.",
+                (void *)socket,
+                socket->io_handle.data.fd,
+                errno);
+        }
+#else
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: zero-copy writes are not supported on this platform, writes will be copied.",
+            (void *)socket,
+            socket->io_handle.data.fd);
+#endif
+    }
+
+    if (options->kernel_timestamps &&
+        (options->domain == AWS_SOCKET_IPV4 || options->domain == AWS_SOCKET_IPV6)) {
+        s_enable_kernel_timestamps(socket);
+    }
+
+    /* options are also applied before the socket is fully initialized. */
+    struct posix_socket *socket_impl = socket->impl;
+    if (socket_impl) {
+        socket_impl->zero_copy_checked = false;
+    }
+
     return AWS_OP_SUCCESS;
 }
 
+/* Upper bound on the number of queued write requests gathered into a single sendmsg() call. */
+#if defined(IOV_MAX) && IOV_MAX < 128
+#    define MAX_WRITE_IOVECS IOV_MAX
+#else
+#    define MAX_WRITE_IOVECS 128
+#endif
+
+/* Upper bound on the number of datagrams sent or received with a single sendmmsg() or recvmmsg() call. */
+#define MAX_DATAGRAM_BATCH 64
+
 struct write_request {
+    /* for a file request, ptr is NULL and len is the number of bytes of the file range left to write */
     struct aws_byte_cursor cursor_cpy;
+    /* -1 unless the request writes a file range, starting at file_offset, with sendfile(). Or, when file_is_pipe is
+     * set, the next bytes of a pipe with splice(), file_offset isn't used then. */
+    int file_fd;
+    off_t file_offset;
+    bool file_is_pipe;
     aws_socket_on_write_completed_fn *written_fn;
     void *write_user_data;
     struct aws_linked_list_node node;
     size_t original_buffer_len;
+    /* ids of the MSG_ZEROCOPY sends of this request the kernel hasn't reported as done yet */
+    uint32_t zero_copy_first_id;
+    uint32_t zero_copy_last_id;
+    uint32_t zero_copy_outstanding;
+    /* set by aws_socket_send_to(), where the datagram goes. destination_len is 0 for the connected peer. */
+    struct socket_address destination;
+    socklen_t destination_len;
 };
 
+/* what a request that didn't complete reports as written: the part of a file range that went out. A buffer reports 0,
+ * it can't be resumed from the middle anyway. */
+static size_t s_write_request_partial_length(const struct write_request *write_request) {
+    if (write_request->file_fd == -1) {
+        return 0;
+    }
+
+    return write_request->original_buffer_len - write_request->cursor_cpy.len;
+}
+
 struct posix_socket_close_args {
     struct aws_mutex mutex;
     struct aws_condition_variable condition_variable;
@@ -1261,8 +1714,41 @@ static void s_close_task(struct aws_task *task, void *arg, enum aws_task_status
     aws_mutex_unlock(&close_args->mutex);
 }
 
-int aws_socket_close(struct aws_socket *socket) {
+/* Sets SO_LINGER to 0, so the close that follows discards unsent data and resets the connection. */
+static void s_reset_on_close(struct aws_socket *socket) {
+    struct linger linger_option = {.l_onoff = 1, .l_linger = 0};
+    if (AWS_UNLIKELY(
+            setsockopt(socket->io_handle.data.fd, SOL_SOCKET, SO_LINGER, &linger_option, sizeof(linger_option)))) {
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: setsockopt() for SO_LINGER failed with errno %d, the socket will be closed gracefully.",
+            (void *)socket,
+            socket->io_handle.data.fd,
+            errno);
+    }
+}
+
+/* True if the kernel may still transmit from the buffer of a write that hasn't completed yet. */
+static bool s_has_outstanding_zero_copy_writes(struct aws_socket *socket) {
+    struct posix_socket *socket_impl = socket->impl;
+    if (!aws_linked_list_empty(&socket_impl->zero_copy_queue)) {
+        return true;
+    }
+
+    if (!aws_linked_list_empty(&socket_impl->write_queue)) {
+        struct aws_linked_list_node *node = aws_linked_list_front(&socket_impl->write_queue);
+        return AWS_CONTAINER_OF(node, struct write_request, node)->zero_copy_outstanding > 0;
+    }
+
+    return false;
+}
+
+static int s_zero_copy_drain_start(struct aws_socket *socket, struct aws_event_loop *event_loop);
+
+/* resetting is set by aws_socket_abort(), the connection then goes away along with whatever it hadn't sent. */
+static int s_socket_close(struct aws_socket *socket, bool resetting) {
     struct posix_socket *socket_impl = socket->impl;
+    struct aws_event_loop *event_loop = socket->event_loop;
     AWS_LOGF_DEBUG(AWS_LS_IO_SOCKET, "id=%p fd=%d: closing", (void *)socket, socket->io_handle.data.fd);
     if (socket->event_loop) {
         /* don't freak out on me, this almost never happens, and never occurs inside a channel
@@ -1315,6 +1801,11 @@ int aws_socket_close(struct aws_socket *socket) {
                     return AWS_OP_ERR;
                 }
             }
+
+            if (socket_impl->busy_poll_registered) {
+                aws_event_loop_unregister_busy_poll(socket->event_loop);
+                socket_impl->busy_poll_registered = false;
+            }
             socket_impl->currently_subscribed = false;
             socket->event_loop = NULL;
         }
@@ -1330,7 +1821,19 @@ int aws_socket_close(struct aws_socket *socket) {
     }
 
     if (aws_socket_is_open(socket)) {
-        close(socket->io_handle.data.fd);
+        bool handed_over = false;
+        if (!resetting && s_has_outstanding_zero_copy_writes(socket)) {
+            /* the kernel may still transmit from the buffers of these writes, so the connection stays open until it's
+             * done with them. If it can't, it's reset, which stops the kernel from using them. */
+            handed_over = !s_zero_copy_drain_start(socket, event_loop);
+            if (!handed_over) {
+                s_reset_on_close(socket);
+            }
+        }
+
+        if (!handed_over) {
+            close(socket->io_handle.data.fd);
+        }
         socket->io_handle.data.fd = -1;
         socket->state = CLOSED;
 
@@ -1340,8 +1843,19 @@ int aws_socket_close(struct aws_socket *socket) {
             struct aws_linked_list_node *node = aws_linked_list_pop_front(&socket_impl->write_queue);
             struct write_request *write_request = AWS_CONTAINER_OF(node, struct write_request, node);
 
-            write_request->written_fn(
-                socket, AWS_IO_SOCKET_CLOSED, write_request->original_buffer_len, write_request->write_user_data);
+            size_t amount_written = write_request->file_fd == -1 ? write_request->original_buffer_len
+                                                                 : s_write_request_partial_length(write_request);
+            write_request->written_fn(socket, AWS_IO_SOCKET_CLOSED, amount_written, write_request->write_user_data);
+            aws_mem_release(socket->allocator, write_request);
+        }
+
+        /* only left here if the connection was reset, so the kernel won't transmit anything more from these buffers */
+        while (!aws_linked_list_empty(&socket_impl->zero_copy_queue)) {
+            struct aws_linked_list_node *node = aws_linked_list_pop_front(&socket_impl->zero_copy_queue);
+            struct write_request *write_request = AWS_CONTAINER_OF(node, struct write_request, node);
+
+            write_request->written_fn(
+                socket, AWS_IO_SOCKET_CLOSED, write_request->original_buffer_len, write_request->write_user_data);
             aws_mem_release(socket->allocator, write_request);
         }
     }
@@ -1349,6 +1863,18 @@ int aws_socket_close(struct aws_socket *socket) {
     return AWS_OP_SUCCESS;
 }
 
+int aws_socket_close(struct aws_socket *socket) {
+    return s_socket_close(socket, false);
+}
+
+int aws_socket_abort(struct aws_socket *socket) {
+    if (socket->options.type == AWS_SOCKET_STREAM && socket->io_handle.data.fd >= 0) {
+        s_reset_on_close(socket);
+    }
+
+    return s_socket_close(socket, true);
+}
+
 int aws_socket_shutdown_dir(struct aws_socket *socket, enum aws_channel_direction dir) {
     int how = dir == AWS_CHANNEL_DIR_READ ? 0 : 1;
     AWS_LOGF_DEBUG(
@@ -1367,365 +1893,1648 @@ int aws_socket_shutdown_dir(struct aws_socket *socket, enum aws_channel_directio
     return AWS_OP_SUCCESS;
 }
 
-/* this gets called in two scenarios.
- * 1st scenario, someone called aws_socket_write() and we want to try writing now, so an error can be returned
- * immediately if something bad has happened to the socket. In this case, `parent_request` is set.
- * 2nd scenario, the event loop notified us that the socket went writable. In this case `parent_request` is NULL */
-static int s_process_write_requests(struct aws_socket *socket, struct write_request *parent_request) {
+static bool s_write_request_uses_zero_copy(struct aws_socket *socket, const struct write_request *write_request) {
+#ifdef ZERO_COPY_SUPPORTED
+    uint32_t threshold = socket->options.zero_copy_write_threshold;
+    if (!threshold || write_request->cursor_cpy.len < threshold || socket->options.type != AWS_SOCKET_STREAM ||
+        write_request->file_fd != -1) {
+        return false;
+    }
+
+    /* MSG_ZEROCOPY is silently ignored, with no notification ever sent, unless SO_ZEROCOPY is actually enabled. */
     struct posix_socket *socket_impl = socket->impl;
-    struct aws_allocator *allocator = socket->allocator;
+    if (!socket_impl->zero_copy_checked) {
+        int enabled = 0;
+        socklen_t enabled_len = sizeof(enabled);
+        socket_impl->zero_copy_enabled =
+            !getsockopt(socket->io_handle.data.fd, SOL_SOCKET, SO_ZEROCOPY, &enabled, &enabled_len) && enabled;
+        socket_impl->zero_copy_checked = true;
+    }
 
-    AWS_LOGF_TRACE(
-        AWS_LS_IO_SOCKET, "id=%p fd=%d: processing write requests.", (void *)socket, socket->io_handle.data.fd);
+    return socket_impl->zero_copy_enabled;
+#else
+    (void)socket;
+    (void)write_request;
+    return false;
+#endif
+}
 
-    /* there's a potential deadlock where we notify the user that we wrote some data, the user
-     * says, "cool, now I can write more and then immediately calls aws_socket_write(). We need to make sure
-     * that we don't allow reentrancy in that case. */
-    socket_impl->write_in_progress = true;
+/* Called once the kernel has accepted every byte of write_request. Completions are delivered in write order, so the
+ * request waits if it, or any request ahead of it, is still referenced by the kernel for a zero-copy send. */
+static void s_on_write_request_written(struct aws_socket *socket, struct write_request *write_request) {
+    struct posix_socket *socket_impl = socket->impl;
 
-    if (parent_request) {
-        AWS_LOGF_TRACE(
-            AWS_LS_IO_SOCKET,
-            "id=%p fd=%d: processing write requests, called from aws_socket_write",
-            (void *)socket,
-            socket->io_handle.data.fd);
-        socket_impl->currently_in_event = true;
-    } else {
+    if (write_request->zero_copy_outstanding || !aws_linked_list_empty(&socket_impl->zero_copy_queue)) {
         AWS_LOGF_TRACE(
             AWS_LS_IO_SOCKET,
-            "id=%p fd=%d: processing write requests, invoked by the event-loop",
+            "id=%p fd=%d: write request written, waiting on zero-copy completion",
             (void *)socket,
             socket->io_handle.data.fd);
+        aws_linked_list_push_back(&socket_impl->zero_copy_queue, &write_request->node);
+        return;
     }
 
-    bool purge = false;
-    int aws_error = AWS_OP_SUCCESS;
-    bool parent_request_failed = false;
+    /* the callback may clean the socket up. */
+    struct aws_allocator *allocator = socket->allocator;
+    AWS_LOGF_TRACE(AWS_LS_IO_SOCKET, "id=%p fd=%d: write request completed", (void *)socket, socket->io_handle.data.fd);
+    write_request->written_fn(
+        socket, AWS_OP_SUCCESS, write_request->original_buffer_len, write_request->write_user_data);
+    aws_mem_release(allocator, write_request);
+}
 
-    /* if a close call happens in the middle, this queue will have been cleaned out from under us. */
-    while (!aws_linked_list_empty(&socket_impl->write_queue)) {
+#ifdef ZERO_COPY_SUPPORTED
+/* Ids are compared modulo 2^32, the kernel's counter wraps. */
+static void s_on_zero_copy_ids_done(struct write_request *write_request, uint32_t lo, uint32_t hi) {
+    if (!write_request->zero_copy_outstanding) {
+        return;
+    }
+
+    uint32_t start = (int32_t)(write_request->zero_copy_first_id - lo) > 0 ? write_request->zero_copy_first_id : lo;
+    uint32_t end = (int32_t)(write_request->zero_copy_last_id - hi) < 0 ? write_request->zero_copy_last_id : hi;
+    if ((int32_t)(end - start) >= 0) {
+        write_request->zero_copy_outstanding -= end - start + 1;
+    }
+}
+
+static void s_on_zero_copy_notification(struct aws_socket *socket, const struct sock_extended_err *error_report) {
+    struct posix_socket *socket_impl = socket->impl;
+    uint32_t lo = error_report->ee_info;
+    uint32_t hi = error_report->ee_data;
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: zero-copy sends %u to %u done%s",
+        (void *)socket,
+        socket->io_handle.data.fd,
+        lo,
+        hi,
+        error_report->ee_code & SO_EE_CODE_ZEROCOPY_COPIED ? " (kernel fell back to copying)" : "");
+
+    uint32_t sends_done = hi - lo + 1;
+    socket_impl->zero_copy_sends_completed += sends_done;
+    if (error_report->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+        socket_impl->zero_copy_sends_copied += sends_done;
+    }
+
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&socket_impl->zero_copy_queue);
+         node != aws_linked_list_end(&socket_impl->zero_copy_queue);
+         node = aws_linked_list_next(node)) {
+        s_on_zero_copy_ids_done(AWS_CONTAINER_OF(node, struct write_request, node), lo, hi);
+    }
+
+    /* only the request at the front of the write queue can have been partially sent */
+    if (!aws_linked_list_empty(&socket_impl->write_queue)) {
         struct aws_linked_list_node *node = aws_linked_list_front(&socket_impl->write_queue);
-        struct write_request *write_request = AWS_CONTAINER_OF(node, struct write_request, node);
+        s_on_zero_copy_ids_done(AWS_CONTAINER_OF(node, struct write_request, node), lo, hi);
+    }
+}
+#endif
 
-        AWS_LOGF_TRACE(
-            AWS_LS_IO_SOCKET,
-            "id=%p fd=%d: dequeued write request of size %llu, remaining to write %llu",
-            (void *)socket,
-            socket->io_handle.data.fd,
-            (unsigned long long)write_request->original_buffer_len,
-            (unsigned long long)write_request->cursor_cpy.len);
+#ifdef TIMESTAMPING_SUPPORTED
+/* Returns the software timestamp of a SCM_TIMESTAMPING control message, 0 for any other message. */
+static uint64_t s_software_timestamp_ns(struct cmsghdr *cmsg) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING) {
+        return 0;
+    }
 
-        ssize_t written =
-            send(socket->io_handle.data.fd, write_request->cursor_cpy.ptr, write_request->cursor_cpy.len, NO_SIGNAL);
+    struct scm_timestamping timestamps;
+    memcpy(&timestamps, CMSG_DATA(cmsg), sizeof(timestamps));
+    return (uint64_t)timestamps.ts[0].tv_sec * AWS_TIMESTAMP_NANOS + (uint64_t)timestamps.ts[0].tv_nsec;
+}
+#endif
 
-        AWS_LOGF_TRACE(
-            AWS_LS_IO_SOCKET,
-            "id=%p fd=%d: send written size %d",
-            (void *)socket,
-            socket->io_handle.data.fd,
-            (int)written);
+#ifdef ERROR_QUEUE_SUPPORTED
+/* Returns the extended error of an IP_RECVERR or IPV6_RECVERR control message, NULL for any other message. */
+static const struct sock_extended_err *s_error_report(struct cmsghdr *cmsg) {
+    bool is_error_report = (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                           (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+    return is_error_report ? (const struct sock_extended_err *)CMSG_DATA(cmsg) : NULL;
+}
 
-        if (written < 0) {
-            int error = errno;
-            if (error == EAGAIN) {
-                AWS_LOGF_TRACE(
-                    AWS_LS_IO_SOCKET, "id=%p fd=%d: returned would block", (void *)socket, socket->io_handle.data.fd);
-                break;
+/* Reads zero-copy completion notifications and send timestamps off the socket's error queue. Returns true if any
+ * were found. */
+static bool s_read_error_queue(struct aws_socket *socket) {
+    bool notified = false;
+
+    for (;;) {
+        uint8_t control[CMSG_SPACE(sizeof(struct sock_extended_err)) + CMSG_SPACE(sizeof(struct sockaddr_in6)) +
+                        CMSG_SPACE(sizeof(struct scm_timestamping))];
+        struct msghdr message;
+        AWS_ZERO_STRUCT(message);
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        if (recvmsg(socket->io_handle.data.fd, &message, MSG_ERRQUEUE) < 0) {
+            break;
+        }
+
+        uint64_t timestamp_ns = 0;
+        const struct sock_extended_err *timestamp_report = NULL;
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+#    ifdef TIMESTAMPING_SUPPORTED
+            uint64_t software_timestamp_ns = s_software_timestamp_ns(cmsg);
+            if (software_timestamp_ns) {
+                timestamp_ns = software_timestamp_ns;
+                continue;
             }
+#    endif
 
-            if (error == EPIPE) {
-                AWS_LOGF_DEBUG(
-                    AWS_LS_IO_SOCKET,
-                    "id=%p fd=%d: already closed before write",
-                    (void *)socket,
-                    socket->io_handle.data.fd);
-                aws_error = AWS_IO_SOCKET_CLOSED;
-                aws_raise_error(aws_error);
-                purge = true;
-                break;
+            const struct sock_extended_err *error_report = s_error_report(cmsg);
+            if (!error_report) {
+                continue;
             }
 
-            purge = true;
-            AWS_LOGF_DEBUG(
+#    ifdef TIMESTAMPING_SUPPORTED
+            /* timestamps are reported as ENOMSG */
+            if (error_report->ee_origin == SO_EE_ORIGIN_TIMESTAMPING) {
+                timestamp_report = error_report;
+                continue;
+            }
+#    endif
+#    ifdef ZERO_COPY_SUPPORTED
+            if (error_report->ee_errno == 0 && error_report->ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+                notified = true;
+                s_on_zero_copy_notification(socket, error_report);
+            }
+#    endif
+        }
+
+        if (timestamp_report && timestamp_ns) {
+            struct posix_socket *socket_impl = socket->impl;
+            notified = true;
+            socket_impl->kernel_timestamps.last_tx_ns = timestamp_ns;
+            socket_impl->kernel_timestamps.last_tx_id = timestamp_report->ee_data;
+            AWS_LOGF_TRACE(
                 AWS_LS_IO_SOCKET,
-                "id=%p fd=%d: write error with error code %d",
+                "id=%p fd=%d: send %u timestamped at %llu",
                 (void *)socket,
                 socket->io_handle.data.fd,
-                error);
-            aws_error = s_determine_socket_error(error);
-            aws_raise_error(aws_error);
-            break;
+                timestamp_report->ee_data,
+                (unsigned long long)timestamp_ns);
         }
+    }
 
-        size_t remaining_to_write = write_request->cursor_cpy.len;
-
-        aws_byte_cursor_advance(&write_request->cursor_cpy, (size_t)written);
-        AWS_LOGF_TRACE(
-            AWS_LS_IO_SOCKET,
-            "id=%p fd=%d: remaining write request to write %llu",
-            (void *)socket,
-            socket->io_handle.data.fd,
-            (unsigned long long)write_request->cursor_cpy.len);
+    return notified;
+}
+#endif
 
-        if ((size_t)written == remaining_to_write) {
-            AWS_LOGF_TRACE(
-                AWS_LS_IO_SOCKET, "id=%p fd=%d: write request completed", (void *)socket, socket->io_handle.data.fd);
+/* Processes zero-copy notifications and send timestamps, and completes the writes they release. Returns false if
+ * there were none. */
+static bool s_process_error_queue(struct aws_socket *socket) {
+#ifdef ERROR_QUEUE_SUPPORTED
+    struct posix_socket *socket_impl = socket->impl;
+    struct aws_allocator *allocator = socket->allocator;
+    if (!s_read_error_queue(socket)) {
+        return false;
+    }
 
-            aws_linked_list_remove(node);
-            write_request->written_fn(
-                socket, AWS_OP_SUCCESS, write_request->original_buffer_len, write_request->write_user_data);
-            aws_mem_release(allocator, write_request);
+    /* a completion callback can close the socket, which empties the queue, so always go back to its front. */
+    while (!aws_linked_list_empty(&socket_impl->zero_copy_queue)) {
+        struct aws_linked_list_node *node = aws_linked_list_front(&socket_impl->zero_copy_queue);
+        struct write_request *write_request = AWS_CONTAINER_OF(node, struct write_request, node);
+        if (write_request->zero_copy_outstanding) {
+            break;
         }
+
+        aws_linked_list_remove(node);
+        AWS_LOGF_TRACE(
+            AWS_LS_IO_SOCKET, "id=%p fd=%d: write request completed", (void *)socket, socket->io_handle.data.fd);
+        write_request->written_fn(
+            socket, AWS_OP_SUCCESS, write_request->original_buffer_len, write_request->write_user_data);
+        aws_mem_release(allocator, write_request);
     }
 
-    if (purge) {
-        while (!aws_linked_list_empty(&socket_impl->write_queue)) {
-            struct aws_linked_list_node *node = aws_linked_list_pop_front(&socket_impl->write_queue);
-            struct write_request *write_request = AWS_CONTAINER_OF(node, struct write_request, node);
+    return true;
+#else
+    (void)socket;
+    return false;
+#endif
+}
 
-            /* If this fn was invoked directly from aws_socket_write(), don't invoke the error callback
-             * as the user will be able to rely on the return value from aws_socket_write() */
-            if (write_request == parent_request) {
-                parent_request_failed = true;
-            } else {
-                write_request->written_fn(socket, aws_error, 0, write_request->write_user_data);
-            }
+#ifdef ZERO_COPY_SUPPORTED
+/* How long a closed connection is kept open for the kernel to be done with the buffers of its zero-copy writes, before
+ * it's reset instead. */
+#    define ZERO_COPY_DRAIN_TIMEOUT_SECS 30
 
-            aws_mem_release(socket->allocator, write_request);
+/* Takes over the connection of a socket closed while the kernel still referenced the buffers of some of its writes,
+ * and closes it once the kernel reports them done. The socket is gone by then, so the writes complete with a NULL
+ * socket. */
+struct zero_copy_drain {
+    struct aws_allocator *allocator;
+    struct aws_event_loop *event_loop;
+    struct aws_io_handle io_handle;
+    /* in write order, the same requests the socket's zero_copy_queue and write queue front held */
+    struct aws_linked_list write_requests;
+    struct aws_task timeout_task;
+};
+
+/* Completes the requests at the front the kernel is done with, or all of them once the connection was reset. A request
+ * the socket hadn't finished sending fails either way. */
+static void s_zero_copy_drain_complete_writes(struct zero_copy_drain *drain, bool reset) {
+    while (!aws_linked_list_empty(&drain->write_requests)) {
+        struct aws_linked_list_node *node = aws_linked_list_front(&drain->write_requests);
+        struct write_request *write_request = AWS_CONTAINER_OF(node, struct write_request, node);
+        if (write_request->zero_copy_outstanding && !reset) {
+            break;
         }
-    }
 
-    socket_impl->write_in_progress = false;
+        aws_linked_list_remove(node);
+        int error_code = reset || write_request->cursor_cpy.len ? AWS_IO_SOCKET_CLOSED : AWS_OP_SUCCESS;
+        write_request->written_fn(
+            NULL, error_code, write_request->original_buffer_len, write_request->write_user_data);
+        aws_mem_release(drain->allocator, write_request);
+    }
+}
 
-    if (parent_request) {
-        socket_impl->currently_in_event = false;
+static void s_zero_copy_drain_close(struct zero_copy_drain *drain, bool reset) {
+    int fd = drain->io_handle.data.fd;
+    if (reset) {
+        struct linger linger_option = {.l_onoff = 1, .l_linger = 0};
+        setsockopt(fd, SOL_SOCKET, SO_LINGER, &linger_option, sizeof(linger_option));
     }
 
-    if (socket_impl->clean_yourself_up) {
-        aws_mem_release(allocator, socket_impl);
+    aws_event_loop_unsubscribe_from_io_events(drain->event_loop, &drain->io_handle);
+    close(fd);
+    drain->io_handle.data.fd = -1;
+    s_zero_copy_drain_complete_writes(drain, reset);
+}
+
+/* Also runs, canceled, once the drain closed the connection itself, or when the event loop shuts down. */
+static void s_zero_copy_drain_timeout_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct zero_copy_drain *drain = arg;
+
+    if (drain->io_handle.data.fd != -1) {
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "fd=%d: zero-copy writes still outstanding %s, resetting the connection.",
+            drain->io_handle.data.fd,
+            status == AWS_TASK_STATUS_RUN_READY ? "after the close timeout" : "as the event loop shuts down");
+        s_zero_copy_drain_close(drain, true);
     }
 
-    /* Only report error if aws_socket_write() invoked this function and its write_request failed */
-    if (!parent_request_failed) {
-        return AWS_OP_SUCCESS;
+    aws_mem_release(drain->allocator, drain);
+}
+
+static void s_zero_copy_drain_process(struct zero_copy_drain *drain) {
+    for (;;) {
+        uint8_t control[CMSG_SPACE(sizeof(struct sock_extended_err)) + CMSG_SPACE(sizeof(struct sockaddr_in6)) +
+                        CMSG_SPACE(sizeof(struct scm_timestamping))];
+        struct msghdr message;
+        AWS_ZERO_STRUCT(message);
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        if (recvmsg(drain->io_handle.data.fd, &message, MSG_ERRQUEUE) < 0) {
+            break;
+        }
+
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            const struct sock_extended_err *error_report = s_error_report(cmsg);
+            if (!error_report || error_report->ee_errno != 0 || error_report->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+
+            for (struct aws_linked_list_node *node = aws_linked_list_begin(&drain->write_requests);
+                 node != aws_linked_list_end(&drain->write_requests);
+                 node = aws_linked_list_next(node)) {
+                s_on_zero_copy_ids_done(
+                    AWS_CONTAINER_OF(node, struct write_request, node), error_report->ee_info, error_report->ee_data);
+            }
+        }
     }
 
-    aws_raise_error(aws_error);
-    return AWS_OP_ERR;
+    s_zero_copy_drain_complete_writes(drain, false);
+    if (aws_linked_list_empty(&drain->write_requests)) {
+        AWS_LOGF_DEBUG(
+            AWS_LS_IO_SOCKET, "fd=%d: zero-copy writes done, closing the connection.", drain->io_handle.data.fd);
+        s_zero_copy_drain_close(drain, false);
+        /* frees the drain */
+        aws_event_loop_cancel_task(drain->event_loop, &drain->timeout_task);
+    }
 }
 
-static void s_on_socket_io_event(
+static void s_on_zero_copy_drain_event(
     struct aws_event_loop *event_loop,
     struct aws_io_handle *handle,
     int events,
     void *user_data) {
     (void)event_loop;
     (void)handle;
-    /* this is to handle a race condition when an error kicks off a cleanup, or the user decides
-     * to close the socket based on something they read (SSL validation failed for example).
-     * if clean_up happens when currently_in_event is true, socket_impl is kept dangling but currently
-     * subscribed is set to false. */
-    struct aws_socket *socket = user_data;
+    (void)events;
+
+    s_zero_copy_drain_process(user_data);
+}
+
+/* Hands the socket's connection, and the writes the kernel isn't done with, over to a drain. The socket must have been
+ * unsubscribed already. On failure nothing was taken over. */
+static int s_zero_copy_drain_start(struct aws_socket *socket, struct aws_event_loop *event_loop) {
     struct posix_socket *socket_impl = socket->impl;
-    struct aws_allocator *allocator = socket->allocator;
+    if (!event_loop) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
 
-    socket_impl->currently_in_event = true;
+    struct zero_copy_drain *drain = aws_mem_calloc(socket->allocator, 1, sizeof(struct zero_copy_drain));
+    if (!drain) {
+        return AWS_OP_ERR;
+    }
 
-    if (events & AWS_IO_EVENT_TYPE_REMOTE_HANG_UP || events & AWS_IO_EVENT_TYPE_CLOSED) {
-        aws_raise_error(AWS_IO_SOCKET_CLOSED);
-        AWS_LOGF_TRACE(AWS_LS_IO_SOCKET, "id=%p fd=%d: closed remotely", (void *)socket, socket->io_handle.data.fd);
-        if (socket->readable_fn) {
-            socket->readable_fn(socket, AWS_IO_SOCKET_CLOSED, socket->readable_user_data);
-        }
-        goto end_check;
+    drain->allocator = socket->allocator;
+    drain->event_loop = event_loop;
+    drain->io_handle.data.fd = socket->io_handle.data.fd;
+    aws_linked_list_init(&drain->write_requests);
+
+    /* the error queue signals readiness as an error, which is always reported */
+    if (aws_event_loop_subscribe_to_io_events(
+            event_loop, &drain->io_handle, AWS_IO_EVENT_TYPE_READABLE, s_on_zero_copy_drain_event, drain)) {
+        aws_mem_release(drain->allocator, drain);
+        return AWS_OP_ERR;
     }
 
-    if (socket_impl->currently_subscribed && events & AWS_IO_EVENT_TYPE_ERROR) {
-        int aws_error = aws_socket_get_error(socket);
-        aws_raise_error(aws_error);
-        AWS_LOGF_TRACE(
-            AWS_LS_IO_SOCKET, "id=%p fd=%d: error event occurred", (void *)socket, socket->io_handle.data.fd);
-        if (socket->readable_fn) {
-            socket->readable_fn(socket, aws_error, socket->readable_user_data);
+    aws_linked_list_move_all_back(&drain->write_requests, &socket_impl->zero_copy_queue);
+    if (!aws_linked_list_empty(&socket_impl->write_queue)) {
+        struct aws_linked_list_node *node = aws_linked_list_front(&socket_impl->write_queue);
+        if (AWS_CONTAINER_OF(node, struct write_request, node)->zero_copy_outstanding) {
+            aws_linked_list_remove(node);
+            aws_linked_list_push_back(&drain->write_requests, node);
         }
-        goto end_check;
     }
 
-    if (socket_impl->currently_subscribed && events & AWS_IO_EVENT_TYPE_READABLE) {
-        AWS_LOGF_TRACE(AWS_LS_IO_SOCKET, "id=%p fd=%d: is readable", (void *)socket, socket->io_handle.data.fd);
-        if (socket->readable_fn) {
-            socket->readable_fn(socket, AWS_OP_SUCCESS, socket->readable_user_data);
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: zero-copy writes outstanding, the connection closes once the kernel is done with them.",
+        (void *)socket,
+        socket->io_handle.data.fd);
+
+    uint64_t now = 0;
+    aws_event_loop_current_clock_time(event_loop, &now);
+    aws_task_init(&drain->timeout_task, s_zero_copy_drain_timeout_task, drain, "zero_copy_drain_timeout");
+    aws_event_loop_schedule_task_future(
+        event_loop,
+        &drain->timeout_task,
+        now + aws_timestamp_convert(ZERO_COPY_DRAIN_TIMEOUT_SECS, AWS_TIMESTAMP_SECS, AWS_TIMESTAMP_NANOS, NULL));
+
+    /* notifications that arrived before the socket was closed were read by it, what's left may already be done */
+    s_zero_copy_drain_process(drain);
+    return AWS_OP_SUCCESS;
+}
+#else
+static int s_zero_copy_drain_start(struct aws_socket *socket, struct aws_event_loop *event_loop) {
+    (void)socket;
+    (void)event_loop;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+#endif
+
+/* gathers the queued buffer write requests, up to the first file request, so they go out with a single syscall
+ * instead of one each. Zero-copy requests are sent on their own, each send gets an id the kernel reports completion
+ * for. Returns what sendmsg() returned, with errno set on failure. */
+static ssize_t s_send_buffer_requests(struct aws_socket *socket, bool zero_copy, bool zero_copy_backoff) {
+    struct posix_socket *socket_impl = socket->impl;
+
+    struct iovec iovecs[MAX_WRITE_IOVECS];
+    size_t iovec_count = 0;
+    size_t gathered_len = 0;
+
+    bool file_request_follows = false;
+    struct aws_linked_list_node *gather_node = aws_linked_list_begin(&socket_impl->write_queue);
+    for (; gather_node != aws_linked_list_end(&socket_impl->write_queue) && iovec_count < MAX_WRITE_IOVECS;
+         gather_node = aws_linked_list_next(gather_node)) {
+        struct write_request *write_request = AWS_CONTAINER_OF(gather_node, struct write_request, node);
+        if (write_request->file_fd != -1) {
+            file_request_follows = true;
+            break;
         }
-    }
-    /* if socket closed in between these branches, the currently_subscribed will be false and socket_impl will not
-     * have been cleaned up, so this next branch is safe. */
-    if (socket_impl->currently_subscribed && events & AWS_IO_EVENT_TYPE_WRITABLE) {
-        AWS_LOGF_TRACE(AWS_LS_IO_SOCKET, "id=%p fd=%d: is writable", (void *)socket, socket->io_handle.data.fd);
-        s_process_write_requests(socket, NULL);
+
+        if (iovec_count &&
+            (zero_copy || (!zero_copy_backoff && s_write_request_uses_zero_copy(socket, write_request)))) {
+            break;
+        }
+
+        iovecs[iovec_count].iov_base = write_request->cursor_cpy.ptr;
+        iovecs[iovec_count].iov_len = write_request->cursor_cpy.len;
+        gathered_len += write_request->cursor_cpy.len;
+        ++iovec_count;
     }
 
-end_check:
-    socket_impl->currently_in_event = false;
+    int send_flags = NO_SIGNAL;
+    if (zero_copy) {
+        send_flags |= ZERO_COPY_FLAG;
+    }
 
-    if (socket_impl->clean_yourself_up) {
-        aws_mem_release(allocator, socket_impl);
+    /* a file's data goes out next with its own syscall, let the kernel hold a partial segment back for it. Queued
+     * buffers left behind by the iovec cap or a zero-copy split go out right after this, they don't need it. */
+    if (socket->options.cork_queued_writes && file_request_follows) {
+        send_flags |= MORE_FLAG;
     }
-}
 
-int aws_socket_assign_to_event_loop(struct aws_socket *socket, struct aws_event_loop *event_loop) {
-    if (!socket->event_loop) {
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: gathered %zu write requests, total size %llu",
+        (void *)socket,
+        socket->io_handle.data.fd,
+        iovec_count,
+        (unsigned long long)gathered_len);
+
+    struct msghdr message;
+    AWS_ZERO_STRUCT(message);
+    message.msg_iov = iovecs;
+    message.msg_iovlen = iovec_count;
+
+    return sendmsg(socket->io_handle.data.fd, &message, send_flags);
+}
+
+static void s_init_datagram_message(struct msghdr *message, struct iovec *iov, struct write_request *write_request) {
+    AWS_ZERO_STRUCT(*message);
+    iov->iov_base = write_request->cursor_cpy.ptr;
+    iov->iov_len = write_request->cursor_cpy.len;
+    message->msg_iov = iov;
+    message->msg_iovlen = 1;
+    if (write_request->destination_len) {
+        message->msg_name = &write_request->destination;
+        message->msg_namelen = write_request->destination_len;
+    }
+}
+
+/* sends the queued buffer write requests of a datagram socket, up to the first file request, each as a datagram of its
+ * own. Returns the number of datagrams sent, each of them whole, or -1 with errno set when the first one failed. */
+static ssize_t s_send_datagram_requests(struct aws_socket *socket) {
+    struct posix_socket *socket_impl = socket->impl;
+
+#ifdef MMSG_SUPPORTED
+    struct mmsghdr messages[MAX_DATAGRAM_BATCH];
+    struct iovec iovecs[MAX_DATAGRAM_BATCH];
+    unsigned int message_count = 0;
+
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&socket_impl->write_queue);
+         node != aws_linked_list_end(&socket_impl->write_queue) && message_count < MAX_DATAGRAM_BATCH;
+         node = aws_linked_list_next(node)) {
+        struct write_request *write_request = AWS_CONTAINER_OF(node, struct write_request, node);
+        if (write_request->file_fd != -1) {
+            break;
+        }
+
+        s_init_datagram_message(&messages[message_count].msg_hdr, &iovecs[message_count], write_request);
+        messages[message_count].msg_len = 0;
+        ++message_count;
+    }
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: sending %u datagrams",
+        (void *)socket,
+        socket->io_handle.data.fd,
+        message_count);
+
+    return sendmmsg(socket->io_handle.data.fd, messages, message_count, NO_SIGNAL);
+#else
+    struct write_request *front_request =
+        AWS_CONTAINER_OF(aws_linked_list_front(&socket_impl->write_queue), struct write_request, node);
+    struct msghdr message;
+    struct iovec iov;
+    s_init_datagram_message(&message, &iov, front_request);
+
+    return sendmsg(socket->io_handle.data.fd, &message, NO_SIGNAL) < 0 ? -1 : 1;
+#endif
+}
+
+/* sends as much of a file request's remaining range as the socket takes. Returns what sendfile() or splice() returned,
+ * with errno set on failure, 0 with bytes left to send means the file is shorter than the range. */
+static ssize_t s_send_file_request(struct aws_socket *socket, struct write_request *write_request) {
+#ifdef SPLICE_SUPPORTED
+    if (write_request->file_is_pipe) {
+        AWS_LOGF_TRACE(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: splicing %llu bytes from pipe fd=%d",
+            (void *)socket,
+            socket->io_handle.data.fd,
+            (unsigned long long)write_request->cursor_cpy.len,
+            write_request->file_fd);
+        return splice(
+            write_request->file_fd,
+            NULL,
+            socket->io_handle.data.fd,
+            NULL,
+            write_request->cursor_cpy.len,
+            SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    }
+#endif
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: sending %llu bytes of file fd=%d from offset %lld",
+        (void *)socket,
+        socket->io_handle.data.fd,
+        (unsigned long long)write_request->cursor_cpy.len,
+        write_request->file_fd,
+        (long long)write_request->file_offset);
+
+#ifdef SENDFILE_SUPPORTED
+    /* sendfile() advances the offset it is handed, the request's offset is advanced with the other requests' cursors */
+    off_t offset = write_request->file_offset;
+    return sendfile(socket->io_handle.data.fd, write_request->file_fd, &offset, write_request->cursor_cpy.len);
+#else
+    (void)socket;
+    errno = EOPNOTSUPP;
+    return -1;
+#endif
+}
+
+static void s_write_request_advance(struct write_request *write_request, size_t len) {
+    AWS_ASSERT(len <= write_request->cursor_cpy.len);
+    if (write_request->file_fd != -1) {
+        write_request->file_offset += (off_t)len;
+        write_request->cursor_cpy.len -= len;
+    } else {
+        aws_byte_cursor_advance(&write_request->cursor_cpy, len);
+    }
+}
+
+/* this gets called in two scenarios.
+ * 1st scenario, someone called aws_socket_write() and we want to try writing now, so an error can be returned
+ * immediately if something bad has happened to the socket. In this case, `from_write_call` is set, and so is
+ * `parent_request`, except for aws_socket_send_batch(), whose datagrams all report through their written_fn.
+ * 2nd scenario, the event loop notified us that the socket went writable. In this case `parent_request` is NULL */
+static int s_process_write_requests(
+    struct aws_socket *socket,
+    struct write_request *parent_request,
+    bool from_write_call) {
+    struct posix_socket *socket_impl = socket->impl;
+    struct aws_allocator *allocator = socket->allocator;
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET, "id=%p fd=%d: processing write requests.", (void *)socket, socket->io_handle.data.fd);
+
+    /* there's a potential deadlock where we notify the user that we wrote some data, the user
+     * says, "cool, now I can write more and then immediately calls aws_socket_write(). We need to make sure
+     * that we don't allow reentrancy in that case. */
+    socket_impl->write_in_progress = true;
+
+    if (from_write_call) {
+        AWS_LOGF_TRACE(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: processing write requests, called from aws_socket_write",
+            (void *)socket,
+            socket->io_handle.data.fd);
+        socket_impl->currently_in_event = true;
+    } else {
+        AWS_LOGF_TRACE(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: processing write requests, invoked by the event-loop",
+            (void *)socket,
+            socket->io_handle.data.fd);
+    }
+
+    bool purge = false;
+    int aws_error = AWS_OP_SUCCESS;
+    bool parent_request_failed = false;
+    bool zero_copy_backoff = false;
+
+    /* if a close call happens in the middle, this queue will have been cleaned out from under us. */
+    while (!aws_linked_list_empty(&socket_impl->write_queue)) {
+        struct write_request *front_request =
+            AWS_CONTAINER_OF(aws_linked_list_front(&socket_impl->write_queue), struct write_request, node);
+        bool zero_copy = !zero_copy_backoff && s_write_request_uses_zero_copy(socket, front_request);
+        bool file_request = front_request->file_fd != -1;
+        bool datagram_request = !file_request && socket->options.type == AWS_SOCKET_DGRAM;
+
+        ssize_t written = 0;
+        if (file_request) {
+            written = s_send_file_request(socket, front_request);
+        } else if (datagram_request) {
+            written = s_send_datagram_requests(socket);
+        } else {
+            written = s_send_buffer_requests(socket, zero_copy, zero_copy_backoff);
+        }
+
+        AWS_LOGF_TRACE(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: send written size %d",
+            (void *)socket,
+            socket->io_handle.data.fd,
+            (int)written);
+
+        if (written < 0) {
+            int error = errno;
+            /* EINPROGRESS: a Fast Open connection whose SYN didn't carry any data, it is writable once established */
+            if (error == EAGAIN || error == EINPROGRESS) {
+                AWS_LOGF_TRACE(
+                    AWS_LS_IO_SOCKET, "id=%p fd=%d: returned would block", (void *)socket, socket->io_handle.data.fd);
+                break;
+            }
+
+            /* a datagram that can't be sent doesn't take the ones queued behind it down with it */
+            if (socket->options.type == AWS_SOCKET_DGRAM) {
+                int datagram_error = s_determine_socket_error(error);
+                AWS_LOGF_DEBUG(
+                    AWS_LS_IO_SOCKET,
+                    "id=%p fd=%d: datagram send failed with error code %d",
+                    (void *)socket,
+                    socket->io_handle.data.fd,
+                    error);
+                aws_linked_list_remove(&front_request->node);
+                if (front_request == parent_request) {
+                    parent_request_failed = true;
+                    aws_error = datagram_error;
+                } else {
+                    front_request->written_fn(socket, datagram_error, 0, front_request->write_user_data);
+                }
+
+                aws_mem_release(allocator, front_request);
+                continue;
+            }
+
+            if (zero_copy && error == ENOBUFS) {
+                AWS_LOGF_DEBUG(
+                    AWS_LS_IO_SOCKET,
+                    "id=%p fd=%d: out of memory for zero-copy sends, copying for the rest of this pass",
+                    (void *)socket,
+                    socket->io_handle.data.fd);
+                zero_copy_backoff = true;
+                continue;
+            }
+
+            if (error == EPIPE) {
+                AWS_LOGF_DEBUG(
+                    AWS_LS_IO_SOCKET,
+                    "id=%p fd=%d: already closed before write",
+                    (void *)socket,
+                    socket->io_handle.data.fd);
+                aws_error = AWS_IO_SOCKET_CLOSED;
+                aws_raise_error(aws_error);
+                purge = true;
+                break;
+            }
+
+            purge = true;
+            AWS_LOGF_DEBUG(
+                AWS_LS_IO_SOCKET,
+                "id=%p fd=%d: write error with error code %d",
+                (void *)socket,
+                socket->io_handle.data.fd,
+                error);
+            aws_error = s_determine_socket_error(error);
+            aws_raise_error(aws_error);
+            break;
+        }
+
+        if (file_request && written == 0 && front_request->cursor_cpy.len) {
+            AWS_LOGF_ERROR(
+                AWS_LS_IO_SOCKET,
+                "id=%p fd=%d: file fd=%d ended before the range being written did",
+                (void *)socket,
+                socket->io_handle.data.fd,
+                front_request->file_fd);
+            aws_error = AWS_IO_STREAM_READ_FAILED;
+            aws_raise_error(aws_error);
+            purge = true;
+            break;
+        }
+
+        /* datagrams go out whole, so a datagram send counts requests rather than bytes. Counting bytes would also
+         * complete an empty datagram that wasn't sent yet. */
+        if (datagram_request) {
+            for (ssize_t i = 0; i < written && !aws_linked_list_empty(&socket_impl->write_queue); ++i) {
+                struct aws_linked_list_node *node = aws_linked_list_pop_front(&socket_impl->write_queue);
+                struct write_request *write_request = AWS_CONTAINER_OF(node, struct write_request, node);
+                s_write_request_advance(write_request, write_request->cursor_cpy.len);
+                s_on_write_request_written(socket, write_request);
+            }
+
+            continue;
+        }
+
+        if (zero_copy && written > 0) {
+            if (!front_request->zero_copy_outstanding) {
+                front_request->zero_copy_first_id = socket_impl->zero_copy_next_id;
+            }
+            front_request->zero_copy_last_id = socket_impl->zero_copy_next_id++;
+            front_request->zero_copy_outstanding++;
+        }
+
+        /* hand the written bytes out to the requests in queue order, completing every request that was fully written.
+         * A completion callback can close the socket, which empties the queue, so always go back to its front. */
+        size_t remaining_written = (size_t)written;
+        while (!aws_linked_list_empty(&socket_impl->write_queue)) {
+            struct aws_linked_list_node *node = aws_linked_list_front(&socket_impl->write_queue);
+            struct write_request *write_request = AWS_CONTAINER_OF(node, struct write_request, node);
+
+            if (write_request->cursor_cpy.len > remaining_written) {
+                s_write_request_advance(write_request, remaining_written);
+                AWS_LOGF_TRACE(
+                    AWS_LS_IO_SOCKET,
+                    "id=%p fd=%d: remaining write request to write %llu",
+                    (void *)socket,
+                    socket->io_handle.data.fd,
+                    (unsigned long long)write_request->cursor_cpy.len);
+                break;
+            }
+
+            remaining_written -= write_request->cursor_cpy.len;
+            s_write_request_advance(write_request, write_request->cursor_cpy.len);
+
+            aws_linked_list_remove(node);
+            s_on_write_request_written(socket, write_request);
+        }
+    }
+
+    if (purge) {
+        while (!aws_linked_list_empty(&socket_impl->write_queue)) {
+            struct aws_linked_list_node *node = aws_linked_list_pop_front(&socket_impl->write_queue);
+            struct write_request *write_request = AWS_CONTAINER_OF(node, struct write_request, node);
+
+            /* If this fn was invoked directly from aws_socket_write(), don't invoke the error callback
+             * as the user will be able to rely on the return value from aws_socket_write(). Unless part of a file
+             * range already went out, the callback is the only way to report how much. */
+            size_t amount_written = s_write_request_partial_length(write_request);
+            if (write_request == parent_request && !amount_written) {
+                parent_request_failed = true;
+            } else {
+                write_request->written_fn(socket, aws_error, amount_written, write_request->write_user_data);
+            }
+
+            aws_mem_release(socket->allocator, write_request);
+        }
+    }
+
+    socket_impl->write_in_progress = false;
+
+    if (from_write_call) {
+        socket_impl->currently_in_event = false;
+    }
+
+    if (socket_impl->clean_yourself_up) {
+        aws_mem_release(allocator, socket_impl);
+    }
+
+    /* Only report error if aws_socket_write() invoked this function and its write_request failed */
+    if (!parent_request_failed) {
+        return AWS_OP_SUCCESS;
+    }
+
+    aws_raise_error(aws_error);
+    return AWS_OP_ERR;
+}
+
+static void s_on_socket_io_event(
+    struct aws_event_loop *event_loop,
+    struct aws_io_handle *handle,
+    int events,
+    void *user_data) {
+    (void)event_loop;
+    (void)handle;
+    /* this is to handle a race condition when an error kicks off a cleanup, or the user decides
+     * to close the socket based on something they read (SSL validation failed for example).
+     * if clean_up happens when currently_in_event is true, socket_impl is kept dangling but currently
+     * subscribed is set to false. */
+    struct aws_socket *socket = user_data;
+    struct posix_socket *socket_impl = socket->impl;
+    struct aws_allocator *allocator = socket->allocator;
+
+    socket_impl->currently_in_event = true;
+
+    if (events & AWS_IO_EVENT_TYPE_REMOTE_HANG_UP || events & AWS_IO_EVENT_TYPE_CLOSED) {
+        aws_raise_error(AWS_IO_SOCKET_CLOSED);
+        AWS_LOGF_TRACE(AWS_LS_IO_SOCKET, "id=%p fd=%d: closed remotely", (void *)socket, socket->io_handle.data.fd);
+        if (socket->readable_fn) {
+            socket->readable_fn(socket, AWS_IO_SOCKET_CLOSED, socket->readable_user_data);
+        }
+        goto end_check;
+    }
+
+    if (socket_impl->currently_subscribed && events & AWS_IO_EVENT_TYPE_ERROR) {
+        int aws_error = aws_socket_get_error(socket);
+        /* zero-copy completions and send timestamps arrive on the socket's error queue, which raises an error event on
+         * a healthy socket */
+        if (aws_error || !s_process_error_queue(socket)) {
+            aws_raise_error(aws_error);
+            AWS_LOGF_TRACE(
+                AWS_LS_IO_SOCKET, "id=%p fd=%d: error event occurred", (void *)socket, socket->io_handle.data.fd);
+            if (socket->readable_fn) {
+                socket->readable_fn(socket, aws_error, socket->readable_user_data);
+            }
+            goto end_check;
+        }
+    }
+
+    if (socket_impl->currently_subscribed && events & AWS_IO_EVENT_TYPE_READABLE) {
+        AWS_LOGF_TRACE(AWS_LS_IO_SOCKET, "id=%p fd=%d: is readable", (void *)socket, socket->io_handle.data.fd);
+        if (socket->readable_fn) {
+            socket->readable_fn(socket, AWS_OP_SUCCESS, socket->readable_user_data);
+        }
+    }
+    /* if socket closed in between these branches, the currently_subscribed will be false and socket_impl will not
+     * have been cleaned up, so this next branch is safe. */
+    if (socket_impl->currently_subscribed && events & AWS_IO_EVENT_TYPE_WRITABLE) {
+        AWS_LOGF_TRACE(AWS_LS_IO_SOCKET, "id=%p fd=%d: is writable", (void *)socket, socket->io_handle.data.fd);
+        s_process_write_requests(socket, NULL, false);
+    }
+
+end_check:
+    socket_impl->currently_in_event = false;
+
+    if (socket_impl->clean_yourself_up) {
+        aws_mem_release(allocator, socket_impl);
+    }
+}
+
+int aws_socket_assign_to_event_loop(struct aws_socket *socket, struct aws_event_loop *event_loop) {
+    if (!socket->event_loop) {
         AWS_LOGF_DEBUG(
             AWS_LS_IO_SOCKET,
-            "id=%p fd=%d: assigning to event loop %p",
+            "id=%p fd=%d: assigning to event loop %p",
+            (void *)socket,
+            socket->io_handle.data.fd,
+            (void *)event_loop);
+        socket->event_loop = event_loop;
+        struct posix_socket *socket_impl = socket->impl;
+        socket_impl->currently_subscribed = true;
+        if (aws_event_loop_subscribe_to_io_events(
+                event_loop,
+                &socket->io_handle,
+                AWS_IO_EVENT_TYPE_WRITABLE | AWS_IO_EVENT_TYPE_READABLE,
+                s_on_socket_io_event,
+                socket)) {
+            AWS_LOGF_ERROR(
+                AWS_LS_IO_SOCKET,
+                "id=%p fd=%d: assigning to event loop %p failed with error %d",
+                (void *)socket,
+                socket->io_handle.data.fd,
+                (void *)event_loop,
+                aws_last_error());
+            socket_impl->currently_subscribed = false;
+            socket->event_loop = NULL;
+            return AWS_OP_ERR;
+        }
+
+        if (socket->options.busy_poll_usec) {
+            aws_event_loop_register_busy_poll(event_loop, socket->options.busy_poll_usec);
+            socket_impl->busy_poll_registered = true;
+        }
+
+        return AWS_OP_SUCCESS;
+    }
+
+    return aws_raise_error(AWS_IO_EVENT_LOOP_ALREADY_ASSIGNED);
+}
+
+struct aws_event_loop *aws_socket_get_event_loop(struct aws_socket *socket) {
+    return socket->event_loop;
+}
+
+int aws_socket_subscribe_to_readable_events(
+    struct aws_socket *socket,
+    aws_socket_on_readable_fn *on_readable,
+    void *user_data) {
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET, " id=%p fd=%d: subscribing to readable events", (void *)socket, socket->io_handle.data.fd);
+    if (!(socket->state & CONNECTED_READ)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: can't subscribe to readable events since the socket is not connected",
+            (void *)socket,
+            socket->io_handle.data.fd);
+        return aws_raise_error(AWS_IO_SOCKET_NOT_CONNECTED);
+    }
+
+    if (socket->readable_fn) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: can't subscribe to readable events since it is already subscribed",
+            (void *)socket,
+            socket->io_handle.data.fd);
+        return aws_raise_error(AWS_ERROR_IO_ALREADY_SUBSCRIBED);
+    }
+
+    AWS_ASSERT(on_readable);
+    socket->readable_user_data = user_data;
+    socket->readable_fn = on_readable;
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_raise_read_error(struct aws_socket *socket, int error) {
+#if defined(EWOULDBLOCK)
+    if (error == EAGAIN || error == EWOULDBLOCK) {
+#else
+    if (error == EAGAIN) {
+#endif
+        AWS_LOGF_TRACE(AWS_LS_IO_SOCKET, "id=%p fd=%d: read would block", (void *)socket, socket->io_handle.data.fd);
+        return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+    }
+
+    if (error == EPIPE) {
+        AWS_LOGF_INFO(AWS_LS_IO_SOCKET, "id=%p fd=%d: socket is closed.", (void *)socket, socket->io_handle.data.fd);
+        return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+    }
+
+    if (error == ETIMEDOUT) {
+        AWS_LOGF_ERROR(AWS_LS_IO_SOCKET, "id=%p fd=%d: socket timed out.", (void *)socket, socket->io_handle.data.fd);
+        return aws_raise_error(AWS_IO_SOCKET_TIMEOUT);
+    }
+
+    AWS_LOGF_ERROR(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: read failed with error: %s",
+        (void *)socket,
+        socket->io_handle.data.fd,
+        strerror(error));
+    return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+}
+
+#ifdef TIMESTAMPING_SUPPORTED
+/* keeps the receive timestamp that came along with a read as a control message */
+static void s_record_receive_timestamp(struct aws_socket *socket, struct msghdr *message) {
+    struct posix_socket *socket_impl = socket->impl;
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(message); cmsg; cmsg = CMSG_NXTHDR(message, cmsg)) {
+        uint64_t timestamp_ns = s_software_timestamp_ns(cmsg);
+        if (timestamp_ns) {
+            socket_impl->kernel_timestamps.last_rx_ns = timestamp_ns;
+        }
+    }
+}
+#endif
+
+/* read(), but with kernel timestamps on, the receive timestamp comes along as a control message and is kept. */
+static ssize_t s_read_with_timestamp(struct aws_socket *socket, uint8_t *dest, size_t len) {
+#ifdef TIMESTAMPING_SUPPORTED
+    if (socket->options.kernel_timestamps) {
+        struct iovec iov = {.iov_base = dest, .iov_len = len};
+        uint8_t control[CMSG_SPACE(sizeof(struct scm_timestamping))];
+        struct msghdr message;
+        AWS_ZERO_STRUCT(message);
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        ssize_t read_val = recvmsg(socket->io_handle.data.fd, &message, 0);
+        if (read_val > 0) {
+            s_record_receive_timestamp(socket, &message);
+        }
+
+        return read_val;
+    }
+#endif
+
+    return read(socket->io_handle.data.fd, dest, len);
+}
+
+int aws_socket_read(struct aws_socket *socket, struct aws_byte_buf *buffer, size_t *amount_read) {
+    AWS_ASSERT(amount_read);
+
+    if (!aws_event_loop_thread_is_callers_thread(socket->event_loop)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: cannot read from a different thread than event loop %p",
             (void *)socket,
             socket->io_handle.data.fd,
-            (void *)event_loop);
-        socket->event_loop = event_loop;
+            (void *)socket->event_loop);
+        return aws_raise_error(AWS_ERROR_IO_EVENT_LOOP_THREAD_ONLY);
+    }
+
+    if (!(socket->state & CONNECTED_READ)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: cannot read because it is not connected",
+            (void *)socket,
+            socket->io_handle.data.fd);
+        return aws_raise_error(AWS_IO_SOCKET_NOT_CONNECTED);
+    }
+
+    ssize_t read_val = s_read_with_timestamp(socket, buffer->buffer + buffer->len, buffer->capacity - buffer->len);
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET, "id=%p fd=%d: read of %d", (void *)socket, socket->io_handle.data.fd, (int)read_val);
+
+    if (read_val > 0) {
+        *amount_read = (size_t)read_val;
+        buffer->len += *amount_read;
+#if defined(TCP_QUICKACK)
+        /* the kernel falls back to delayed ACKs once it sees a request/response pattern, so ask again. A failure was
+         * already reported when the option was first set. */
         struct posix_socket *socket_impl = socket->impl;
-        socket_impl->currently_subscribed = true;
-        if (aws_event_loop_subscribe_to_io_events(
-                event_loop,
-                &socket->io_handle,
-                AWS_IO_EVENT_TYPE_WRITABLE | AWS_IO_EVENT_TYPE_READABLE,
-                s_on_socket_io_event,
-                socket)) {
-            AWS_LOGF_ERROR(
+        if (socket_impl->rearm_quick_ack) {
+            int quick_ack = 1;
+            setsockopt(socket->io_handle.data.fd, IPPROTO_TCP, TCP_QUICKACK, &quick_ack, sizeof(quick_ack));
+        }
+#endif
+        return AWS_OP_SUCCESS;
+    }
+
+    /* read_val of 0 means EOF which we'll treat as AWS_IO_SOCKET_CLOSED */
+    if (read_val == 0) {
+        AWS_LOGF_INFO(
+            AWS_LS_IO_SOCKET, "id=%p fd=%d: zero read, socket is closed", (void *)socket, socket->io_handle.data.fd);
+        *amount_read = 0;
+
+        if (buffer->capacity - buffer->len > 0) {
+            return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+        }
+
+        return AWS_OP_SUCCESS;
+    }
+
+    return s_raise_read_error(socket, errno);
+}
+
+/* the address a datagram came from, as an endpoint. Left empty for anything but IPv4 and IPv6. */
+static void s_endpoint_from_address(const struct sockaddr_storage *address, struct aws_socket_endpoint *endpoint) {
+    AWS_ZERO_STRUCT(*endpoint);
+
+    if (address->ss_family == AF_INET) {
+        const struct sockaddr_in *s = (const struct sockaddr_in *)address;
+        endpoint->port = ntohs(s->sin_port);
+        inet_ntop(AF_INET, &s->sin_addr, endpoint->address, sizeof(endpoint->address));
+    } else if (address->ss_family == AF_INET6) {
+        const struct sockaddr_in6 *s = (const struct sockaddr_in6 *)address;
+        endpoint->port = ntohs(s->sin6_port);
+        inet_ntop(AF_INET6, &s->sin6_addr, endpoint->address, sizeof(endpoint->address));
+    }
+}
+
+int aws_socket_receive_from(
+    struct aws_socket *socket,
+    struct aws_byte_buf *buffer,
+    struct aws_socket_endpoint *source,
+    size_t *amount_read) {
+    AWS_ASSERT(amount_read);
+
+    if (!aws_event_loop_thread_is_callers_thread(socket->event_loop)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: cannot read from a different thread than event loop %p",
+            (void *)socket,
+            socket->io_handle.data.fd,
+            (void *)socket->event_loop);
+        return aws_raise_error(AWS_ERROR_IO_EVENT_LOOP_THREAD_ONLY);
+    }
+
+    if (socket->options.type != AWS_SOCKET_DGRAM) {
+        return aws_raise_error(AWS_IO_SOCKET_INVALID_OPERATION_FOR_TYPE);
+    }
+
+    if (!(socket->state & CONNECTED_READ)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: cannot receive because it is not bound",
+            (void *)socket,
+            socket->io_handle.data.fd);
+        return aws_raise_error(AWS_IO_SOCKET_NOT_CONNECTED);
+    }
+
+    struct sockaddr_storage address;
+    AWS_ZERO_STRUCT(address);
+    struct iovec iov = {.iov_base = buffer->buffer + buffer->len, .iov_len = buffer->capacity - buffer->len};
+    struct msghdr message;
+    AWS_ZERO_STRUCT(message);
+    message.msg_name = &address;
+    message.msg_namelen = sizeof(address);
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+#ifdef TIMESTAMPING_SUPPORTED
+    uint8_t control[CMSG_SPACE(sizeof(struct scm_timestamping))];
+    if (socket->options.kernel_timestamps) {
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+    }
+#endif
+
+    ssize_t read_val = recvmsg(socket->io_handle.data.fd, &message, 0);
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: received datagram of %d",
+        (void *)socket,
+        socket->io_handle.data.fd,
+        (int)read_val);
+
+    /* unlike a stream read, 0 is an empty datagram rather than the end of the stream */
+    if (read_val < 0) {
+        return s_raise_read_error(socket, errno);
+    }
+
+#ifdef TIMESTAMPING_SUPPORTED
+    if (socket->options.kernel_timestamps) {
+        s_record_receive_timestamp(socket, &message);
+    }
+#endif
+
+    if (message.msg_flags & MSG_TRUNC) {
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: datagram truncated to the %zu bytes left in the buffer",
+            (void *)socket,
+            socket->io_handle.data.fd,
+            iov.iov_len);
+    }
+
+    if (source) {
+        s_endpoint_from_address(&address, source);
+    }
+
+    *amount_read = (size_t)read_val;
+    buffer->len += *amount_read;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_socket_receive_batch(
+    struct aws_socket *socket,
+    struct aws_socket_datagram *datagrams,
+    size_t count,
+    size_t *datagrams_read) {
+    AWS_ASSERT(datagrams_read);
+    *datagrams_read = 0;
+
+#ifdef MMSG_SUPPORTED
+    if (!aws_event_loop_thread_is_callers_thread(socket->event_loop)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: cannot read from a different thread than event loop %p",
+            (void *)socket,
+            socket->io_handle.data.fd,
+            (void *)socket->event_loop);
+        return aws_raise_error(AWS_ERROR_IO_EVENT_LOOP_THREAD_ONLY);
+    }
+
+    if (socket->options.type != AWS_SOCKET_DGRAM) {
+        return aws_raise_error(AWS_IO_SOCKET_INVALID_OPERATION_FOR_TYPE);
+    }
+
+    if (!(socket->state & CONNECTED_READ)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: cannot receive because it is not bound",
+            (void *)socket,
+            socket->io_handle.data.fd);
+        return aws_raise_error(AWS_IO_SOCKET_NOT_CONNECTED);
+    }
+
+    if (!count) {
+        return AWS_OP_SUCCESS;
+    }
+
+    unsigned int message_count = count < MAX_DATAGRAM_BATCH ? (unsigned int)count : MAX_DATAGRAM_BATCH;
+    struct mmsghdr messages[MAX_DATAGRAM_BATCH];
+    struct iovec iovecs[MAX_DATAGRAM_BATCH];
+    struct sockaddr_storage addresses[MAX_DATAGRAM_BATCH];
+#    ifdef TIMESTAMPING_SUPPORTED
+    /* only the last datagram's timestamp is kept, but the kernel attaches one to each of them */
+    uint8_t controls[MAX_DATAGRAM_BATCH][CMSG_SPACE(sizeof(struct scm_timestamping))];
+#    endif
+
+    for (unsigned int i = 0; i < message_count; ++i) {
+        struct aws_byte_buf *buffer = datagrams[i].buffer;
+        iovecs[i].iov_base = buffer->buffer + buffer->len;
+        iovecs[i].iov_len = buffer->capacity - buffer->len;
+
+        struct msghdr *message = &messages[i].msg_hdr;
+        AWS_ZERO_STRUCT(*message);
+        message->msg_name = &addresses[i];
+        message->msg_namelen = sizeof(addresses[i]);
+        message->msg_iov = &iovecs[i];
+        message->msg_iovlen = 1;
+#    ifdef TIMESTAMPING_SUPPORTED
+        if (socket->options.kernel_timestamps) {
+            message->msg_control = controls[i];
+            message->msg_controllen = sizeof(controls[i]);
+        }
+#    endif
+        messages[i].msg_len = 0;
+    }
+
+    int received = recvmmsg(socket->io_handle.data.fd, messages, message_count, 0, NULL);
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: received %d datagrams of up to %u",
+        (void *)socket,
+        socket->io_handle.data.fd,
+        received,
+        message_count);
+
+    if (received < 0) {
+        return s_raise_read_error(socket, errno);
+    }
+
+    for (int i = 0; i < received; ++i) {
+        struct msghdr *message = &messages[i].msg_hdr;
+        if (message->msg_flags & MSG_TRUNC) {
+            AWS_LOGF_WARN(
                 AWS_LS_IO_SOCKET,
-                "id=%p fd=%d: assigning to event loop %p failed with error %d",
+                "id=%p fd=%d: datagram truncated to the %zu bytes left in the buffer",
                 (void *)socket,
                 socket->io_handle.data.fd,
-                (void *)event_loop,
-                aws_last_error());
-            socket_impl->currently_subscribed = false;
-            socket->event_loop = NULL;
-            return AWS_OP_ERR;
+                iovecs[i].iov_len);
+        }
+
+        if (datagrams[i].endpoint) {
+            s_endpoint_from_address(&addresses[i], datagrams[i].endpoint);
+        }
+
+        datagrams[i].buffer->len += messages[i].msg_len;
+    }
+
+#    ifdef TIMESTAMPING_SUPPORTED
+    if (socket->options.kernel_timestamps && received > 0) {
+        s_record_receive_timestamp(socket, &messages[received - 1].msg_hdr);
+    }
+#    endif
+
+    *datagrams_read = (size_t)received;
+    return AWS_OP_SUCCESS;
+#else
+    /* one datagram per syscall, stopping at the first that can't be received */
+    for (size_t i = 0; i < count; ++i) {
+        size_t amount_read = 0;
+        if (aws_socket_receive_from(socket, datagrams[i].buffer, datagrams[i].endpoint, &amount_read)) {
+            return i ? AWS_OP_SUCCESS : AWS_OP_ERR;
+        }
+
+        *datagrams_read = i + 1;
+    }
+
+    return AWS_OP_SUCCESS;
+#endif
+}
+
+int aws_socket_read_to_pipe(struct aws_socket *socket, int pipe_fd, size_t max_len, size_t *amount_read) {
+    AWS_ASSERT(amount_read);
+
+    if (!aws_event_loop_thread_is_callers_thread(socket->event_loop)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: cannot read from a different thread than event loop %p",
+            (void *)socket,
+            socket->io_handle.data.fd,
+            (void *)socket->event_loop);
+        return aws_raise_error(AWS_ERROR_IO_EVENT_LOOP_THREAD_ONLY);
+    }
+
+#ifdef SPLICE_SUPPORTED
+    if (!(socket->state & CONNECTED_READ)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: cannot read because it is not connected",
+            (void *)socket,
+            socket->io_handle.data.fd);
+        return aws_raise_error(AWS_IO_SOCKET_NOT_CONNECTED);
+    }
+
+    *amount_read = 0;
+    ssize_t read_val =
+        splice(socket->io_handle.data.fd, NULL, pipe_fd, NULL, max_len, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: splice of %d into pipe fd=%d",
+        (void *)socket,
+        socket->io_handle.data.fd,
+        (int)read_val,
+        pipe_fd);
+
+    if (read_val > 0) {
+        *amount_read = (size_t)read_val;
+        return AWS_OP_SUCCESS;
+    }
+
+    if (read_val == 0) {
+        AWS_LOGF_INFO(
+            AWS_LS_IO_SOCKET, "id=%p fd=%d: zero read, socket is closed", (void *)socket, socket->io_handle.data.fd);
+        return max_len ? aws_raise_error(AWS_IO_SOCKET_CLOSED) : AWS_OP_SUCCESS;
+    }
+
+    return s_raise_read_error(socket, errno);
+#else
+    (void)pipe_fd;
+    (void)max_len;
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: reads into a pipe are not supported on this platform",
+        (void *)socket,
+        socket->io_handle.data.fd);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#endif
+}
+
+int aws_socket_read_to_file(
+    struct aws_socket *socket,
+    int fd,
+    uint64_t offset,
+    size_t max_len,
+    size_t *amount_read) {
+    AWS_ASSERT(amount_read);
+    *amount_read = 0;
+
+#ifdef SPLICE_SUPPORTED
+    if (fd < 0 || offset > (uint64_t)INT64_MAX - max_len) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct posix_socket *socket_impl = socket->impl;
+    if (socket_impl->splice_pipe[0] == -1 && pipe2(socket_impl->splice_pipe, O_NONBLOCK | O_CLOEXEC)) {
+        socket_impl->splice_pipe[0] = -1;
+        socket_impl->splice_pipe[1] = -1;
+        return aws_translate_and_raise_io_error(errno);
+    }
+
+    size_t spliced = 0;
+    if (aws_socket_read_to_pipe(socket, socket_impl->splice_pipe[1], max_len, &spliced)) {
+        return AWS_OP_ERR;
+    }
+
+    /* file writes don't return short for lack of room, a failure here is the file's */
+    loff_t file_offset = (loff_t)offset;
+    size_t drained = 0;
+    while (drained < spliced) {
+        ssize_t written =
+            splice(socket_impl->splice_pipe[0], NULL, fd, &file_offset, spliced - drained, SPLICE_F_MOVE);
+        if (written <= 0) {
+            int error = written < 0 ? errno : EIO;
+            AWS_LOGF_ERROR(
+                AWS_LS_IO_SOCKET,
+                "id=%p fd=%d: failed to write to file fd=%d with errno %d",
+                (void *)socket,
+                socket->io_handle.data.fd,
+                fd,
+                error);
+            /* whatever is left in the pipe is lost, start over with an empty one */
+            s_close_splice_pipe(socket_impl);
+            return aws_translate_and_raise_io_error(error);
         }
+        drained += (size_t)written;
+    }
 
-        return AWS_OP_SUCCESS;
+    *amount_read = spliced;
+    return AWS_OP_SUCCESS;
+#else
+    (void)fd;
+    (void)offset;
+    (void)max_len;
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: reads into a file are not supported on this platform",
+        (void *)socket,
+        socket->io_handle.data.fd);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#endif
+}
+
+static struct write_request *s_new_buffer_write_request(
+    struct aws_socket *socket,
+    const struct aws_byte_cursor *cursor,
+    const struct socket_address *destination,
+    socklen_t destination_len,
+    aws_socket_on_write_completed_fn *written_fn,
+    void *user_data) {
+
+    AWS_ASSERT(written_fn);
+    struct write_request *write_request = aws_mem_calloc(socket->allocator, 1, sizeof(struct write_request));
+
+    if (!write_request) {
+        return NULL;
     }
 
-    return aws_raise_error(AWS_IO_EVENT_LOOP_ALREADY_ASSIGNED);
+    write_request->original_buffer_len = cursor->len;
+    write_request->written_fn = written_fn;
+    write_request->write_user_data = user_data;
+    write_request->cursor_cpy = *cursor;
+    write_request->file_fd = -1;
+    if (destination) {
+        write_request->destination = *destination;
+        write_request->destination_len = destination_len;
+    }
+
+    return write_request;
 }
 
-struct aws_event_loop *aws_socket_get_event_loop(struct aws_socket *socket) {
-    return socket->event_loop;
+static int s_queue_buffer_write(
+    struct aws_socket *socket,
+    const struct aws_byte_cursor *cursor,
+    const struct socket_address *destination,
+    socklen_t destination_len,
+    aws_socket_on_write_completed_fn *written_fn,
+    void *user_data) {
+
+    struct posix_socket *socket_impl = socket->impl;
+    struct write_request *write_request =
+        s_new_buffer_write_request(socket, cursor, destination, destination_len, written_fn, user_data);
+
+    if (!write_request) {
+        return AWS_OP_ERR;
+    }
+
+    aws_linked_list_push_back(&socket_impl->write_queue, &write_request->node);
+
+    /* avoid reentrancy when a user calls write after receiving their completion callback. */
+    if (!socket_impl->write_in_progress) {
+        return s_process_write_requests(socket, write_request, true);
+    }
+
+    return AWS_OP_SUCCESS;
 }
 
-int aws_socket_subscribe_to_readable_events(
+int aws_socket_write(
     struct aws_socket *socket,
-    aws_socket_on_readable_fn *on_readable,
+    const struct aws_byte_cursor *cursor,
+    aws_socket_on_write_completed_fn *written_fn,
     void *user_data) {
+    if (!aws_event_loop_thread_is_callers_thread(socket->event_loop)) {
+        return aws_raise_error(AWS_ERROR_IO_EVENT_LOOP_THREAD_ONLY);
+    }
 
-    AWS_LOGF_TRACE(
-        AWS_LS_IO_SOCKET, " id=%p fd=%d: subscribing to readable events", (void *)socket, socket->io_handle.data.fd);
-    if (!(socket->state & CONNECTED_READ)) {
+    if (!(socket->state & CONNECTED_WRITE)) {
         AWS_LOGF_ERROR(
             AWS_LS_IO_SOCKET,
-            "id=%p fd=%d: can't subscribe to readable events since the socket is not connected",
+            "id=%p fd=%d: cannot write to because it is not connected",
             (void *)socket,
             socket->io_handle.data.fd);
         return aws_raise_error(AWS_IO_SOCKET_NOT_CONNECTED);
     }
 
-    if (socket->readable_fn) {
+    return s_queue_buffer_write(socket, cursor, NULL, 0, written_fn, user_data);
+}
+
+/* parses an IPv4 or IPv6 endpoint for the socket's domain */
+static int s_parse_inet_endpoint(
+    struct aws_socket *socket,
+    const struct aws_socket_endpoint *endpoint,
+    struct socket_address *address,
+    socklen_t *address_len) {
+
+    size_t address_strlen;
+    if (aws_secure_strlen(endpoint->address, AWS_ADDRESS_MAX_LEN, &address_strlen)) {
+        return AWS_OP_ERR;
+    }
+
+    AWS_ZERO_STRUCT(*address);
+    int pton_err = 1;
+    if (socket->options.domain == AWS_SOCKET_IPV4) {
+        pton_err = inet_pton(AF_INET, endpoint->address, &address->sock_addr_types.addr_in.sin_addr);
+        address->sock_addr_types.addr_in.sin_port = htons(endpoint->port);
+        address->sock_addr_types.addr_in.sin_family = AF_INET;
+        *address_len = sizeof(address->sock_addr_types.addr_in);
+    } else if (socket->options.domain == AWS_SOCKET_IPV6) {
+        pton_err = inet_pton(AF_INET6, endpoint->address, &address->sock_addr_types.addr_in6.sin6_addr);
+        address->sock_addr_types.addr_in6.sin6_port = htons(endpoint->port);
+        address->sock_addr_types.addr_in6.sin6_family = AF_INET6;
+        *address_len = sizeof(address->sock_addr_types.addr_in6);
+    } else {
+        return aws_raise_error(AWS_IO_SOCKET_UNSUPPORTED_ADDRESS_FAMILY);
+    }
+
+    if (pton_err != 1) {
         AWS_LOGF_ERROR(
             AWS_LS_IO_SOCKET,
-            "id=%p fd=%d: can't subscribe to readable events since it is already subscribed",
+            "id=%p fd=%d: failed to parse address %s:%d.",
             (void *)socket,
-            socket->io_handle.data.fd);
-        return aws_raise_error(AWS_ERROR_IO_ALREADY_SUBSCRIBED);
+            socket->io_handle.data.fd,
+            endpoint->address,
+            (int)endpoint->port);
+        return aws_raise_error(s_convert_pton_error(pton_err));
     }
 
-    AWS_ASSERT(on_readable);
-    socket->readable_user_data = user_data;
-    socket->readable_fn = on_readable;
-
     return AWS_OP_SUCCESS;
 }
 
-int aws_socket_read(struct aws_socket *socket, struct aws_byte_buf *buffer, size_t *amount_read) {
-    AWS_ASSERT(amount_read);
-
-    if (!aws_event_loop_thread_is_callers_thread(socket->event_loop)) {
+/* a datagram to a destination only needs a bound socket, one to the connected peer a connected socket */
+static int s_check_datagram_send_state(struct aws_socket *socket, const struct aws_socket_endpoint *destination) {
+    int required_state = destination ? CONNECTED_READ | CONNECTED_WRITE : CONNECTED_WRITE;
+    if (!(socket->state & required_state)) {
         AWS_LOGF_ERROR(
             AWS_LS_IO_SOCKET,
-            "id=%p fd=%d: cannot read from a different thread than event loop %p",
+            "id=%p fd=%d: cannot send because it is not %s",
             (void *)socket,
             socket->io_handle.data.fd,
-            (void *)socket->event_loop);
+            destination ? "bound" : "connected");
+        return aws_raise_error(AWS_IO_SOCKET_NOT_CONNECTED);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_socket_send_to(
+    struct aws_socket *socket,
+    const struct aws_byte_cursor *cursor,
+    const struct aws_socket_endpoint *destination,
+    aws_socket_on_write_completed_fn *written_fn,
+    void *user_data) {
+    if (!aws_event_loop_thread_is_callers_thread(socket->event_loop)) {
         return aws_raise_error(AWS_ERROR_IO_EVENT_LOOP_THREAD_ONLY);
     }
 
-    if (!(socket->state & CONNECTED_READ)) {
-        AWS_LOGF_ERROR(
-            AWS_LS_IO_SOCKET,
-            "id=%p fd=%d: cannot read because it is not connected",
-            (void *)socket,
-            socket->io_handle.data.fd);
-        return aws_raise_error(AWS_IO_SOCKET_NOT_CONNECTED);
+    if (socket->options.type != AWS_SOCKET_DGRAM) {
+        return aws_raise_error(AWS_IO_SOCKET_INVALID_OPERATION_FOR_TYPE);
     }
 
-    ssize_t read_val = read(socket->io_handle.data.fd, buffer->buffer + buffer->len, buffer->capacity - buffer->len);
-    AWS_LOGF_TRACE(
-        AWS_LS_IO_SOCKET, "id=%p fd=%d: read of %d", (void *)socket, socket->io_handle.data.fd, (int)read_val);
+    if (s_check_datagram_send_state(socket, destination)) {
+        return AWS_OP_ERR;
+    }
 
-    if (read_val > 0) {
-        *amount_read = (size_t)read_val;
-        buffer->len += *amount_read;
-        return AWS_OP_SUCCESS;
+    if (!destination) {
+        return s_queue_buffer_write(socket, cursor, NULL, 0, written_fn, user_data);
     }
 
-    /* read_val of 0 means EOF which we'll treat as AWS_IO_SOCKET_CLOSED */
-    if (read_val == 0) {
-        AWS_LOGF_INFO(
-            AWS_LS_IO_SOCKET, "id=%p fd=%d: zero read, socket is closed", (void *)socket, socket->io_handle.data.fd);
-        *amount_read = 0;
+    struct socket_address address;
+    socklen_t address_len = 0;
+    if (s_parse_inet_endpoint(socket, destination, &address, &address_len)) {
+        return AWS_OP_ERR;
+    }
 
-        if (buffer->capacity - buffer->len > 0) {
-            return aws_raise_error(AWS_IO_SOCKET_CLOSED);
-        }
+    return s_queue_buffer_write(socket, cursor, &address, address_len, written_fn, user_data);
+}
 
-        return AWS_OP_SUCCESS;
+int aws_socket_send_batch(
+    struct aws_socket *socket,
+    const struct aws_socket_datagram *datagrams,
+    size_t count,
+    aws_socket_on_write_completed_fn *written_fn) {
+    if (!aws_event_loop_thread_is_callers_thread(socket->event_loop)) {
+        return aws_raise_error(AWS_ERROR_IO_EVENT_LOOP_THREAD_ONLY);
     }
 
-    int error = errno;
-#if defined(EWOULDBLOCK)
-    if (error == EAGAIN || error == EWOULDBLOCK) {
-#else
-    if (error == EAGAIN) {
-#endif
-        AWS_LOGF_TRACE(AWS_LS_IO_SOCKET, "id=%p fd=%d: read would block", (void *)socket, socket->io_handle.data.fd);
-        return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+    if (socket->options.type != AWS_SOCKET_DGRAM) {
+        return aws_raise_error(AWS_IO_SOCKET_INVALID_OPERATION_FOR_TYPE);
     }
 
-    if (error == EPIPE) {
-        AWS_LOGF_INFO(AWS_LS_IO_SOCKET, "id=%p fd=%d: socket is closed.", (void *)socket, socket->io_handle.data.fd);
-        return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+    /* every datagram gets its request before any is queued, so a failure leaves nothing half queued */
+    struct aws_linked_list batch;
+    aws_linked_list_init(&batch);
+
+    for (size_t i = 0; i < count; ++i) {
+        const struct aws_socket_datagram *datagram = &datagrams[i];
+        if (s_check_datagram_send_state(socket, datagram->endpoint)) {
+            goto error;
+        }
+
+        struct socket_address address;
+        socklen_t address_len = 0;
+        if (datagram->endpoint && s_parse_inet_endpoint(socket, datagram->endpoint, &address, &address_len)) {
+            goto error;
+        }
+
+        struct aws_byte_cursor cursor = aws_byte_cursor_from_buf(datagram->buffer);
+        struct write_request *write_request = s_new_buffer_write_request(
+            socket, &cursor, datagram->endpoint ? &address : NULL, address_len, written_fn, datagram->user_data);
+        if (!write_request) {
+            goto error;
+        }
+
+        aws_linked_list_push_back(&batch, &write_request->node);
     }
 
-    if (error == ETIMEDOUT) {
-        AWS_LOGF_ERROR(AWS_LS_IO_SOCKET, "id=%p fd=%d: socket timed out.", (void *)socket, socket->io_handle.data.fd);
-        return aws_raise_error(AWS_IO_SOCKET_TIMEOUT);
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET, "id=%p fd=%d: queueing %zu datagrams", (void *)socket, socket->io_handle.data.fd, count);
+
+    struct posix_socket *socket_impl = socket->impl;
+    aws_linked_list_move_all_back(&socket_impl->write_queue, &batch);
+
+    /* avoid reentrancy when a user calls send after receiving their completion callback. */
+    if (!socket_impl->write_in_progress) {
+        return s_process_write_requests(socket, NULL, true);
     }
 
-    AWS_LOGF_ERROR(
-        AWS_LS_IO_SOCKET,
-        "id=%p fd=%d: read failed with error: %s",
-        (void *)socket,
-        socket->io_handle.data.fd,
-        strerror(error));
-    return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    return AWS_OP_SUCCESS;
+
+error:
+    while (!aws_linked_list_empty(&batch)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&batch);
+        aws_mem_release(socket->allocator, AWS_CONTAINER_OF(node, struct write_request, node));
+    }
+
+    return AWS_OP_ERR;
 }
 
-int aws_socket_write(
+static int s_write_from_fd(
     struct aws_socket *socket,
-    const struct aws_byte_cursor *cursor,
+    int fd,
+    uint64_t offset,
+    size_t length,
+    bool is_pipe,
     aws_socket_on_write_completed_fn *written_fn,
     void *user_data) {
     if (!aws_event_loop_thread_is_callers_thread(socket->event_loop)) {
         return aws_raise_error(AWS_ERROR_IO_EVENT_LOOP_THREAD_ONLY);
     }
 
+#ifdef SENDFILE_SUPPORTED
+    if (socket->options.type != AWS_SOCKET_STREAM) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: file writes are only supported on stream sockets",
+            (void *)socket,
+            socket->io_handle.data.fd);
+        return aws_raise_error(AWS_IO_SOCKET_INVALID_OPERATION_FOR_TYPE);
+    }
+#else
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: file writes are not supported on this platform",
+        (void *)socket,
+        socket->io_handle.data.fd);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#endif
+
+    if (fd < 0 || offset > (uint64_t)INT64_MAX - length) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
     if (!(socket->state & CONNECTED_WRITE)) {
         AWS_LOGF_ERROR(
             AWS_LS_IO_SOCKET,
@@ -1743,18 +3552,186 @@ int aws_socket_write(
         return AWS_OP_ERR;
     }
 
-    write_request->original_buffer_len = cursor->len;
+    write_request->original_buffer_len = length;
     write_request->written_fn = written_fn;
     write_request->write_user_data = user_data;
-    write_request->cursor_cpy = *cursor;
+    write_request->cursor_cpy.len = length;
+    write_request->file_fd = fd;
+    write_request->file_offset = (off_t)offset;
+    write_request->file_is_pipe = is_pipe;
     aws_linked_list_push_back(&socket_impl->write_queue, &write_request->node);
 
-    /* avoid reentrancy when a user calls write after receiving their completion callback. */
     if (!socket_impl->write_in_progress) {
-        return s_process_write_requests(socket, write_request);
+        return s_process_write_requests(socket, write_request, true);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_socket_write_file(
+    struct aws_socket *socket,
+    int fd,
+    uint64_t offset,
+    size_t length,
+    aws_socket_on_write_completed_fn *written_fn,
+    void *user_data) {
+    return s_write_from_fd(socket, fd, offset, length, false, written_fn, user_data);
+}
+
+int aws_socket_write_from_pipe(
+    struct aws_socket *socket,
+    int pipe_fd,
+    size_t length,
+    aws_socket_on_write_completed_fn *written_fn,
+    void *user_data) {
+    return s_write_from_fd(socket, pipe_fd, 0, length, true, written_fn, user_data);
+}
+
+#if defined(__linux__) && defined(TCP_INFO)
+/* The kernel's struct tcp_info, up to tcpi_delivery_rate. The libc's version may stop well short of that, and the
+ * kernel fills in as much of it as it knows about, older kernels report less. */
+struct kernel_tcp_info {
+    uint8_t state;
+    uint8_t ca_state;
+    uint8_t retransmits;
+    uint8_t probes;
+    uint8_t backoff;
+    uint8_t options;
+    uint8_t wscale;
+    uint8_t flags;
+    uint32_t rto;
+    uint32_t ato;
+    uint32_t snd_mss;
+    uint32_t rcv_mss;
+    uint32_t unacked;
+    uint32_t sacked;
+    uint32_t lost;
+    uint32_t retrans;
+    uint32_t fackets;
+    uint32_t last_data_sent;
+    uint32_t last_ack_sent;
+    uint32_t last_data_recv;
+    uint32_t last_ack_recv;
+    uint32_t pmtu;
+    uint32_t rcv_ssthresh;
+    uint32_t rtt;
+    uint32_t rttvar;
+    uint32_t snd_ssthresh;
+    uint32_t snd_cwnd;
+    uint32_t advmss;
+    uint32_t reordering;
+    uint32_t rcv_rtt;
+    uint32_t rcv_space;
+    uint32_t total_retrans;
+    uint64_t pacing_rate;
+    uint64_t max_pacing_rate;
+    uint64_t bytes_acked;
+    uint64_t bytes_received;
+    uint32_t segs_out;
+    uint32_t segs_in;
+    uint32_t notsent_bytes;
+    uint32_t min_rtt;
+    uint32_t data_segs_in;
+    uint32_t data_segs_out;
+    uint64_t delivery_rate;
+};
+#endif
+
+int aws_socket_get_transport_metrics(struct aws_socket *socket, struct aws_socket_transport_metrics *metrics) {
+    AWS_ZERO_STRUCT(*metrics);
+
+    if (socket->options.type != AWS_SOCKET_STREAM ||
+        (socket->options.domain != AWS_SOCKET_IPV4 && socket->options.domain != AWS_SOCKET_IPV6)) {
+        return aws_raise_error(AWS_IO_SOCKET_INVALID_OPERATION_FOR_TYPE);
+    }
+
+#if defined(__linux__) && defined(TCP_INFO)
+    struct kernel_tcp_info info;
+    AWS_ZERO_STRUCT(info);
+    socklen_t info_len = sizeof(info);
+    if (getsockopt(socket->io_handle.data.fd, IPPROTO_TCP, TCP_INFO, &info, &info_len)) {
+        int error = errno;
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: getsockopt() for TCP_INFO failed with errno %d.",
+            (void *)socket,
+            socket->io_handle.data.fd,
+            error);
+        return aws_translate_and_raise_io_error(error);
+    }
+
+    /* whatever the kernel didn't fill in is left zeroed */
+    metrics->rtt_usec = info.rtt;
+    metrics->rtt_variance_usec = info.rttvar;
+    metrics->min_rtt_usec = info.min_rtt;
+    metrics->congestion_window = info.snd_cwnd;
+    metrics->slow_start_threshold = info.snd_ssthresh;
+    metrics->send_mss = info.snd_mss;
+    metrics->unacked_segments = info.unacked;
+    metrics->lost_segments = info.lost;
+    metrics->total_retransmits = info.total_retrans;
+    metrics->delivery_rate = info.delivery_rate;
+
+    struct posix_socket *socket_impl = socket->impl;
+    metrics->zero_copy_sends_completed = socket_impl->zero_copy_sends_completed;
+    metrics->zero_copy_sends_copied = socket_impl->zero_copy_sends_copied;
+    return AWS_OP_SUCCESS;
+#else
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: transport metrics are not supported on this platform",
+        (void *)socket,
+        socket->io_handle.data.fd);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#endif
+}
+
+int aws_socket_get_kernel_timestamps(struct aws_socket *socket, struct aws_socket_kernel_timestamps *timestamps) {
+#ifdef TIMESTAMPING_SUPPORTED
+    struct posix_socket *socket_impl = socket->impl;
+    *timestamps = socket_impl->kernel_timestamps;
+    return AWS_OP_SUCCESS;
+#else
+    AWS_ZERO_STRUCT(*timestamps);
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: kernel timestamps are not supported on this platform",
+        (void *)socket,
+        socket->io_handle.data.fd);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#endif
+}
+
+int aws_socket_get_incoming_cpu(struct aws_socket *socket, int *cpu_id) {
+#ifdef SO_INCOMING_CPU
+    int incoming_cpu = -1;
+    socklen_t option_length = sizeof(incoming_cpu);
+    if (getsockopt(socket->io_handle.data.fd, SOL_SOCKET, SO_INCOMING_CPU, &incoming_cpu, &option_length)) {
+        int error = errno;
+        AWS_LOGF_DEBUG(
+            AWS_LS_IO_SOCKET,
+            "id=%p fd=%d: getsockopt() for SO_INCOMING_CPU failed with errno %d",
+            (void *)socket,
+            socket->io_handle.data.fd,
+            error);
+        return aws_raise_error(s_determine_socket_error(error));
     }
 
+    if (incoming_cpu < 0) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    *cpu_id = incoming_cpu;
     return AWS_OP_SUCCESS;
+#else
+    (void)cpu_id;
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p fd=%d: SO_INCOMING_CPU is not supported on this platform",
+        (void *)socket,
+        socket->io_handle.data.fd);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#endif
 }
 
 int aws_socket_get_error(struct aws_socket *socket) {
@@ -0,0 +1,465 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#if !defined(_GNU_SOURCE)
+#    define _GNU_SOURCE /* splice(), pipe2() and F_SETPIPE_SZ */
+#endif
+
+#include <aws/io/socket_relay.h>
+
+#include <aws/common/mutex.h>
+#include <aws/common/ref_count.h>
+#include <aws/common/task_scheduler.h>
+
+#include <aws/io/event_loop.h>
+#include <aws/io/logging.h>
+#include <aws/io/socket.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+#ifndef O_CLOEXEC
+#    define O_CLOEXEC 02000000
+#endif
+
+/*
+ * Each direction reads from its source socket into a pipe on the source's event loop, and the destination socket
+ * writes the pipe out on its own event loop. The two sides hand byte counts to each other through synced_data:
+ * `to_write` is what the source has put in the pipe and the destination hasn't queued yet, `written` is what the
+ * destination has written and the source hasn't taken out of its buffered count yet.
+ */
+struct relay_direction {
+    struct aws_socket_relay *relay;
+    struct aws_socket *source;
+    struct aws_socket *dest;
+    /* [0] is the read end, written out by dest. [1] is the write end, filled from source. */
+    int pipe_fds[2];
+    size_t capacity;
+
+    struct aws_task start_task;
+    struct aws_task resume_task;
+    struct aws_task write_task;
+
+    /* only touched on source's event loop */
+    struct {
+        size_t buffered;
+        bool read_finished;
+    } source_data;
+
+    /* only touched on dest's event loop */
+    struct {
+        size_t writes_in_flight;
+        bool write_shut_down;
+    } dest_data;
+
+    /* requires the relay's lock */
+    struct {
+        size_t to_write;
+        size_t written;
+        bool source_finished;
+        bool write_task_scheduled;
+        bool resume_task_scheduled;
+    } synced_data;
+};
+
+struct aws_socket_relay {
+    struct aws_allocator *allocator;
+    struct aws_ref_count ref_count;
+    struct aws_mutex lock;
+    /* directions[0] relays socket_a to socket_b, directions[1] socket_b to socket_a. */
+    struct relay_direction directions[2];
+    /* close_tasks[i] closes directions[i].source */
+    struct aws_task close_tasks[2];
+    aws_socket_relay_on_shutdown_fn *on_shutdown;
+    void *user_data;
+
+    /* requires lock */
+    struct {
+        int error_code;
+        size_t directions_finished;
+        size_t sockets_closed;
+        bool shutting_down;
+    } synced_data;
+};
+
+static void s_relay_schedule_task(struct aws_socket_relay *relay, struct aws_socket *socket, struct aws_task *task) {
+    /* every scheduled task holds a reference, it can run after the relay has been shut down and released. */
+    aws_ref_count_acquire(&relay->ref_count);
+    aws_event_loop_schedule_task_now(aws_socket_get_event_loop(socket), task);
+}
+
+static void s_relay_shutdown(struct aws_socket_relay *relay, int error_code) {
+    aws_mutex_lock(&relay->lock);
+    if (relay->synced_data.shutting_down) {
+        aws_mutex_unlock(&relay->lock);
+        return;
+    }
+    relay->synced_data.shutting_down = true;
+    relay->synced_data.error_code = error_code;
+    aws_mutex_unlock(&relay->lock);
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p: socket relay shutting down with error %d (%s)",
+        (void *)relay,
+        error_code,
+        aws_error_name(error_code));
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(relay->directions); ++i) {
+        s_relay_schedule_task(relay, relay->directions[i].source, &relay->close_tasks[i]);
+    }
+}
+
+static bool s_relay_is_shutting_down(struct aws_socket_relay *relay) {
+    aws_mutex_lock(&relay->lock);
+    bool shutting_down = relay->synced_data.shutting_down;
+    aws_mutex_unlock(&relay->lock);
+    return shutting_down;
+}
+
+static void s_relay_close_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)status;
+    struct aws_socket_relay *relay = arg;
+    struct relay_direction *direction = &relay->directions[task == &relay->close_tasks[0] ? 0 : 1];
+
+    /* purges the socket's queued writes, their callbacks run before this returns */
+    aws_socket_close(direction->source);
+
+    aws_mutex_lock(&relay->lock);
+    bool closed = ++relay->synced_data.sockets_closed == AWS_ARRAY_SIZE(relay->close_tasks);
+    int error_code = relay->synced_data.error_code;
+    aws_mutex_unlock(&relay->lock);
+
+    if (closed && relay->on_shutdown) {
+        relay->on_shutdown(relay, error_code, relay->user_data);
+    }
+
+    aws_ref_count_release(&relay->ref_count);
+}
+
+/* on dest's event loop: once source has finished and everything it read has been written, pass the end on. */
+static void s_direction_try_finish(struct relay_direction *direction) {
+    struct aws_socket_relay *relay = direction->relay;
+    if (direction->dest_data.write_shut_down || direction->dest_data.writes_in_flight) {
+        return;
+    }
+
+    aws_mutex_lock(&relay->lock);
+    bool finished = direction->synced_data.source_finished && !direction->synced_data.to_write &&
+                    !relay->synced_data.shutting_down;
+    bool all_finished = false;
+    if (finished) {
+        all_finished = ++relay->synced_data.directions_finished == AWS_ARRAY_SIZE(relay->directions);
+    }
+    aws_mutex_unlock(&relay->lock);
+
+    if (!finished) {
+        return;
+    }
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET,
+        "id=%p: relay from socket %p finished, shutting down writes to socket %p",
+        (void *)relay,
+        (void *)direction->source,
+        (void *)direction->dest);
+
+    direction->dest_data.write_shut_down = true;
+    if (aws_socket_shutdown_dir(direction->dest, AWS_CHANNEL_DIR_WRITE)) {
+        s_relay_shutdown(relay, aws_last_error());
+        return;
+    }
+
+    if (all_finished) {
+        s_relay_shutdown(relay, AWS_ERROR_SUCCESS);
+    }
+}
+
+/* on source's event loop: fill the pipe up, and hand whatever was read to dest. */
+static void s_direction_read(struct relay_direction *direction) {
+    struct aws_socket_relay *relay = direction->relay;
+    if (direction->source_data.read_finished) {
+        return;
+    }
+
+    size_t newly_read = 0;
+    int error_code = AWS_ERROR_SUCCESS;
+    while (direction->source_data.buffered < direction->capacity) {
+        size_t amount_read = 0;
+        if (aws_socket_read_to_pipe(
+                direction->source,
+                direction->pipe_fds[1],
+                direction->capacity - direction->source_data.buffered,
+                &amount_read)) {
+            error_code = aws_last_error();
+            break;
+        }
+
+        direction->source_data.buffered += amount_read;
+        newly_read += amount_read;
+    }
+
+    if (error_code == AWS_IO_READ_WOULD_BLOCK) {
+        error_code = AWS_ERROR_SUCCESS;
+    } else if (error_code == AWS_IO_SOCKET_CLOSED) {
+        AWS_LOGF_TRACE(
+            AWS_LS_IO_SOCKET, "id=%p: socket %p finished sending", (void *)relay, (void *)direction->source);
+        direction->source_data.read_finished = true;
+        error_code = AWS_ERROR_SUCCESS;
+    }
+
+    if (newly_read || direction->source_data.read_finished) {
+        aws_mutex_lock(&relay->lock);
+        direction->synced_data.to_write += newly_read;
+        direction->synced_data.source_finished = direction->source_data.read_finished;
+        bool schedule_write = !direction->synced_data.write_task_scheduled && !relay->synced_data.shutting_down;
+        direction->synced_data.write_task_scheduled |= schedule_write;
+        aws_mutex_unlock(&relay->lock);
+
+        if (schedule_write) {
+            s_relay_schedule_task(relay, direction->dest, &direction->write_task);
+        }
+    }
+
+    if (error_code) {
+        s_relay_shutdown(relay, error_code);
+    }
+}
+
+static void s_on_source_readable(struct aws_socket *socket, int error_code, void *user_data) {
+    (void)socket;
+    struct relay_direction *direction = user_data;
+
+    if (error_code && error_code != AWS_IO_SOCKET_CLOSED) {
+        s_relay_shutdown(direction->relay, error_code);
+        return;
+    }
+
+    s_direction_read(direction);
+}
+
+static void s_on_dest_written(struct aws_socket *socket, int error_code, size_t amount_written, void *user_data) {
+    (void)socket;
+    struct relay_direction *direction = user_data;
+    struct aws_socket_relay *relay = direction->relay;
+
+    AWS_ASSERT(direction->dest_data.writes_in_flight);
+    direction->dest_data.writes_in_flight--;
+
+    if (error_code) {
+        s_relay_shutdown(relay, error_code);
+        return;
+    }
+
+    /* hand the pipe space back to source, it may have stopped reading for the lack of it. */
+    aws_mutex_lock(&relay->lock);
+    direction->synced_data.written += amount_written;
+    bool schedule_resume = !direction->synced_data.resume_task_scheduled && !relay->synced_data.shutting_down;
+    direction->synced_data.resume_task_scheduled |= schedule_resume;
+    aws_mutex_unlock(&relay->lock);
+
+    if (schedule_resume) {
+        s_relay_schedule_task(relay, direction->source, &direction->resume_task);
+    }
+
+    s_direction_try_finish(direction);
+}
+
+static void s_direction_write_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct relay_direction *direction = arg;
+    struct aws_socket_relay *relay = direction->relay;
+
+    aws_mutex_lock(&relay->lock);
+    size_t to_write = direction->synced_data.to_write;
+    direction->synced_data.to_write = 0;
+    direction->synced_data.write_task_scheduled = false;
+    bool shutting_down = relay->synced_data.shutting_down;
+    aws_mutex_unlock(&relay->lock);
+
+    if (status == AWS_TASK_STATUS_RUN_READY && !shutting_down) {
+        if (to_write) {
+            direction->dest_data.writes_in_flight++;
+            if (aws_socket_write_from_pipe(
+                    direction->dest, direction->pipe_fds[0], to_write, s_on_dest_written, direction)) {
+                direction->dest_data.writes_in_flight--;
+                s_relay_shutdown(relay, aws_last_error());
+            }
+        }
+
+        s_direction_try_finish(direction);
+    }
+
+    aws_ref_count_release(&relay->ref_count);
+}
+
+static void s_direction_resume_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct relay_direction *direction = arg;
+    struct aws_socket_relay *relay = direction->relay;
+
+    aws_mutex_lock(&relay->lock);
+    size_t written = direction->synced_data.written;
+    direction->synced_data.written = 0;
+    direction->synced_data.resume_task_scheduled = false;
+    bool shutting_down = relay->synced_data.shutting_down;
+    aws_mutex_unlock(&relay->lock);
+
+    if (status == AWS_TASK_STATUS_RUN_READY && !shutting_down) {
+        AWS_ASSERT(written <= direction->source_data.buffered);
+        direction->source_data.buffered -= written;
+        s_direction_read(direction);
+    }
+
+    aws_ref_count_release(&relay->ref_count);
+}
+
+static void s_direction_start_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct relay_direction *direction = arg;
+    struct aws_socket_relay *relay = direction->relay;
+
+    if (status == AWS_TASK_STATUS_RUN_READY && !s_relay_is_shutting_down(relay)) {
+        if (aws_socket_subscribe_to_readable_events(direction->source, s_on_source_readable, direction)) {
+            s_relay_shutdown(relay, aws_last_error());
+        } else {
+            /* the socket's readable edge can have come and gone before anyone was subscribed */
+            s_direction_read(direction);
+        }
+    }
+
+    aws_ref_count_release(&relay->ref_count);
+}
+
+static void s_relay_destroy(void *user_data) {
+    struct aws_socket_relay *relay = user_data;
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(relay->directions); ++i) {
+        for (size_t j = 0; j < AWS_ARRAY_SIZE(relay->directions[i].pipe_fds); ++j) {
+            if (relay->directions[i].pipe_fds[j] != -1) {
+                close(relay->directions[i].pipe_fds[j]);
+            }
+        }
+    }
+
+    aws_mutex_clean_up(&relay->lock);
+    aws_mem_release(relay->allocator, relay);
+}
+
+static int s_direction_init_pipe(struct relay_direction *direction, size_t max_buffered_bytes) {
+#ifdef __linux__
+    if (pipe2(direction->pipe_fds, O_NONBLOCK | O_CLOEXEC)) {
+        direction->pipe_fds[0] = -1;
+        direction->pipe_fds[1] = -1;
+        return aws_translate_and_raise_io_error(errno);
+    }
+
+    if (max_buffered_bytes && max_buffered_bytes <= INT_MAX &&
+        fcntl(direction->pipe_fds[1], F_SETPIPE_SZ, (int)max_buffered_bytes) < 0) {
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "id=%p: failed to size the relay pipe to %zu bytes, errno %d, using its default",
+            (void *)direction->relay,
+            max_buffered_bytes,
+            errno);
+    }
+
+    int capacity = fcntl(direction->pipe_fds[1], F_GETPIPE_SZ);
+    if (capacity <= 0) {
+        return aws_translate_and_raise_io_error(errno);
+    }
+
+    direction->capacity = (size_t)capacity;
+    return AWS_OP_SUCCESS;
+#else
+    (void)direction;
+    (void)max_buffered_bytes;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#endif
+}
+
+struct aws_socket_relay *aws_socket_relay_new(
+    struct aws_allocator *allocator,
+    const struct aws_socket_relay_options *options) {
+
+    if (!options->socket_a || !options->socket_b || options->socket_a == options->socket_b ||
+        !aws_socket_get_event_loop(options->socket_a) || !aws_socket_get_event_loop(options->socket_b)) {
+        AWS_LOGF_ERROR(AWS_LS_IO_SOCKET, "static: a socket relay needs two distinct sockets assigned to event loops");
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    if (options->socket_a->options.type != AWS_SOCKET_STREAM || options->socket_b->options.type != AWS_SOCKET_STREAM) {
+        aws_raise_error(AWS_IO_SOCKET_INVALID_OPERATION_FOR_TYPE);
+        return NULL;
+    }
+
+    struct aws_socket_relay *relay = aws_mem_calloc(allocator, 1, sizeof(struct aws_socket_relay));
+    if (!relay) {
+        return NULL;
+    }
+
+    relay->allocator = allocator;
+    relay->on_shutdown = options->on_shutdown;
+    relay->user_data = options->user_data;
+    aws_ref_count_init(&relay->ref_count, relay, s_relay_destroy);
+
+    struct aws_socket *sockets[2] = {options->socket_a, options->socket_b};
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(relay->directions); ++i) {
+        struct relay_direction *direction = &relay->directions[i];
+        direction->relay = relay;
+        direction->source = sockets[i];
+        direction->dest = sockets[1 - i];
+        direction->pipe_fds[0] = -1;
+        direction->pipe_fds[1] = -1;
+        aws_task_init(&direction->start_task, s_direction_start_task, direction, "socket_relay_start");
+        aws_task_init(&direction->resume_task, s_direction_resume_task, direction, "socket_relay_resume");
+        aws_task_init(&direction->write_task, s_direction_write_task, direction, "socket_relay_write");
+        aws_task_init(&relay->close_tasks[i], s_relay_close_task, relay, "socket_relay_close");
+    }
+
+    if (aws_mutex_init(&relay->lock)) {
+        aws_mem_release(allocator, relay);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(relay->directions); ++i) {
+        if (s_direction_init_pipe(&relay->directions[i], options->max_buffered_bytes)) {
+            AWS_LOGF_ERROR(
+                AWS_LS_IO_SOCKET,
+                "id=%p: failed to create the relay's pipes with error %s",
+                (void *)relay,
+                aws_error_name(aws_last_error()));
+            s_relay_destroy(relay);
+            return NULL;
+        }
+    }
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p: relaying between sockets %p and %p, %zu bytes buffered per direction",
+        (void *)relay,
+        (void *)options->socket_a,
+        (void *)options->socket_b,
+        relay->directions[0].capacity);
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(relay->directions); ++i) {
+        s_relay_schedule_task(relay, relay->directions[i].source, &relay->directions[i].start_task);
+    }
+
+    return relay;
+}
+
+void aws_socket_relay_shutdown(struct aws_socket_relay *relay) {
+    s_relay_shutdown(relay, AWS_ERROR_SUCCESS);
+}
+
+void aws_socket_relay_release(struct aws_socket_relay *relay) {
+    if (relay) {
+        aws_ref_count_release(&relay->ref_count);
+    }
+}
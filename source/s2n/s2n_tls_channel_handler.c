@@ -10,6 +10,7 @@
 #include <aws/io/logging.h>
 #include <aws/io/pki_utils.h>
 #include <aws/io/private/tls_channel_handler_shared.h>
+#include <aws/io/socket_channel_handler.h>
 #include <aws/io/statistics.h>
 
 #include <aws/common/encoding.h>
@@ -49,6 +50,9 @@ struct s2n_handler {
     void *user_data;
     bool advertise_alpn_message;
     bool negotiation_finished;
+    /* from the connection options, and cleared once the slot before ours turns out not to take lent buffers, see
+     * s_s2n_handler_recv() */
+    bool lend_read_buffers;
 };
 
 struct s2n_ctx {
@@ -197,6 +201,26 @@ static int s_generic_read(struct s2n_handler *handler, struct aws_byte_buf *buf)
 static int s_s2n_handler_recv(void *io_context, uint8_t *buf, uint32_t len) {
     struct s2n_handler *handler = (struct s2n_handler *)io_context;
 
+    /* With nothing queued, read what the socket has straight into s2n's buffer, rather than into a message that would
+     * get copied into it here later. */
+    if (handler->negotiation_finished && handler->lend_read_buffers && aws_linked_list_empty(&handler->input_queue)) {
+        struct aws_byte_buf lent_buffer = aws_byte_buf_from_empty_array(buf, len);
+        struct aws_channel_lend_read_buffer_options lend_options = {
+            .buffer = &lent_buffer,
+        };
+
+        if (!aws_channel_slot_lend_read_buffer(handler->slot, &lend_options)) {
+            return (int)lent_buffer.len;
+        }
+
+        if (aws_last_error() == AWS_ERROR_UNSUPPORTED_OPERATION) {
+            handler->lend_read_buffers = false;
+        }
+
+        errno = EAGAIN;
+        return -1;
+    }
+
     struct aws_byte_buf read_buffer = aws_byte_buf_from_array(buf, len);
     return s_generic_read(handler, &read_buffer);
 }
@@ -616,6 +640,15 @@ static void s_s2n_handler_gather_statistics(struct aws_channel_handler *handler,
     aws_array_list_push_back(stats, &stats_base);
 }
 
+static void s_s2n_handler_trim(struct aws_channel_handler *handler) {
+    struct s2n_handler *s2n_handler = handler->impl;
+
+    /* s2n refuses to release its record buffers while they still hold data, so this only frees idle connections. */
+    if (s2n_handler->negotiation_finished && aws_linked_list_empty(&s2n_handler->input_queue)) {
+        s2n_connection_release_buffers(s2n_handler->connection);
+    }
+}
+
 struct aws_byte_buf aws_tls_handler_protocol(struct aws_channel_handler *handler) {
     struct s2n_handler *s2n_handler = (struct s2n_handler *)handler->impl;
     return s2n_handler->protocol;
@@ -636,6 +669,7 @@ static struct aws_channel_handler_vtable s_handler_vtable = {
     .message_overhead = s_s2n_handler_message_overhead,
     .reset_statistics = s_s2n_handler_reset_statistics,
     .gather_statistics = s_s2n_handler_gather_statistics,
+    .trim = s_s2n_handler_trim,
 };
 
 static int s_parse_protocol_preferences(
@@ -763,6 +797,7 @@ static struct aws_channel_handler *s_new_tls_handler(
     }
 
     s2n_handler->negotiation_finished = false;
+    s2n_handler->lend_read_buffers = options->lend_read_buffers;
 
     s2n_connection_set_recv_cb(s2n_handler->connection, s_s2n_handler_recv);
     s2n_connection_set_recv_ctx(s2n_handler->connection, s2n_handler);
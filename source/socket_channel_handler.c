@@ -7,24 +7,78 @@
 #include <aws/common/error.h>
 #include <aws/common/task_scheduler.h>
 
+#include <aws/io/channel.h>
 #include <aws/io/event_loop.h>
 #include <aws/io/logging.h>
 #include <aws/io/socket.h>
 #include <aws/io/statistics.h>
 
+#ifdef _WIN32
+#    include <io.h>
+#    include <windows.h>
+#else
+#    include <errno.h>
+#    include <unistd.h>
+#endif
+
 #if _MSC_VER
 #    pragma warning(disable : 4204) /* non-constant aggregate initializer */
 #endif
 
+/*
+ * State shared by the socket handlers on an event loop. It is created by the first of them that needs it and lives in
+ * the loop's local storage until the loop is destroyed.
+ */
+struct socket_handler_loop_data {
+    struct aws_allocator *alloc;
+    struct aws_event_loop_local_object local_object;
+    /* handlers on the loop that used up their read budget and have a task queued to read more */
+    size_t contending_readers;
+    /* reads that are expected to find the socket empty go here instead of into a message, see s_do_read() */
+    struct aws_byte_buf scratch;
+    bool scratch_in_use;
+};
+
+static size_t s_loop_data_key = 0;
+
 struct socket_handler {
     struct aws_socket *socket;
     struct aws_channel_slot *slot;
+    /* the read budget: how much is read per tick. Fixed, unless adaptive_read_budget is set. */
     size_t max_rw_size;
+    size_t min_read_budget;
+    size_t max_read_budget;
+    /* read on this tick so far against max_rw_size, including what a handler downstream read into a buffer it lent,
+     * see aws_channel_slot_lend_read_buffer(). Starts over with each of the handler's own reads. */
+    size_t tick_bytes_read;
+    struct socket_handler_loop_data *loop_data;
+    bool adaptive_read_budget;
+    /* counted in loop_data->contending_readers */
+    bool contending;
     struct aws_channel_task read_task_storage;
     struct aws_channel_task shutdown_task_storage;
     struct aws_crt_statistics_socket stats;
+    /* set by aws_channel_slot_receive_file(), reads go into the file while on_completion is set */
+    struct {
+        int fd;
+        uint64_t offset;
+        size_t remaining;
+        size_t bytes_received;
+        aws_channel_on_file_received_fn *on_completion;
+        void *user_data;
+    } file_sink;
+    /* set by aws_channel_slot_lend_read_buffer(), reads go into the buffer while on_filled is set */
+    struct {
+        struct aws_byte_buf *buffer;
+        aws_channel_on_read_buffer_filled_fn *on_filled;
+        void *user_data;
+    } lent_buffer;
+    /* message writes the socket hasn't completed. A write the kernel is still sending from can complete after the
+     * socket was closed, so the write direction's shutdown waits for them (shutdown_complete_pending). */
+    size_t writes_in_flight;
     int shutdown_err_code;
     bool shutdown_in_progress;
+    bool shutdown_complete_pending;
 };
 
 static int s_socket_process_read_message(
@@ -63,12 +117,20 @@ static void s_on_socket_write_complete(
             (unsigned long long)amount_written,
             (void *)channel);
 
+        /* writes that complete after the socket was closed come without it, the handler is always in the first
+         * slot. */
+        struct socket_handler *socket_handler = NULL;
+        if (socket && socket->handler) {
+            socket_handler = socket->handler->impl;
+        } else if (!socket) {
+            socket_handler = aws_channel_get_first_slot(channel)->handler->impl;
+        }
+
         if (message->on_completion) {
             message->on_completion(channel, message, error_code, message->user_data);
         }
 
-        if (socket && socket->handler) {
-            struct socket_handler *socket_handler = socket->handler->impl;
+        if (socket_handler) {
             socket_handler->stats.bytes_written += amount_written;
         }
 
@@ -77,6 +139,12 @@ static void s_on_socket_write_complete(
         if (error_code) {
             aws_channel_shutdown(channel, error_code);
         }
+
+        if (socket_handler && --socket_handler->writes_in_flight == 0 && socket_handler->shutdown_complete_pending) {
+            socket_handler->shutdown_complete_pending = false;
+            aws_channel_slot_on_handler_shutdown_complete(
+                socket_handler->slot, AWS_CHANNEL_DIR_WRITE, socket_handler->shutdown_err_code, false);
+        }
     }
 }
 
@@ -98,7 +166,9 @@ static int s_socket_process_write_message(
     }
 
     struct aws_byte_cursor cursor = aws_byte_cursor_from_buf(&message->message_data);
+    socket_handler->writes_in_flight++;
     if (aws_socket_write(socket_handler->socket, &cursor, s_on_socket_write_complete, message)) {
+        socket_handler->writes_in_flight--;
         return AWS_OP_ERR;
     }
 
@@ -109,6 +179,267 @@ static void s_read_task(struct aws_channel_task *task, void *arg, aws_task_statu
 
 static void s_on_readable_notification(struct aws_socket *socket, int error_code, void *user_data);
 
+static void s_file_sink_complete(struct socket_handler *socket_handler, int error_code) {
+    aws_channel_on_file_received_fn *on_completion = socket_handler->file_sink.on_completion;
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: received %llu bytes into file fd=%d with error_code %d",
+        (void *)socket_handler->slot->handler,
+        (unsigned long long)socket_handler->file_sink.bytes_received,
+        socket_handler->file_sink.fd,
+        error_code);
+
+    /* cleared first, so the callback can arm another range */
+    socket_handler->file_sink.on_completion = NULL;
+    on_completion(
+        socket_handler->slot->channel,
+        error_code,
+        socket_handler->file_sink.bytes_received,
+        socket_handler->file_sink.user_data);
+}
+
+/* Reads into the armed file range, the bytes count against the downstream window as a message of the same size
+ * would have. */
+static int s_read_into_file_sink(struct socket_handler *socket_handler, size_t max_read, size_t *amount_read) {
+    size_t to_read = aws_min_size(max_read, socket_handler->file_sink.remaining);
+
+    if (aws_socket_read_to_file(
+            socket_handler->socket,
+            socket_handler->file_sink.fd,
+            socket_handler->file_sink.offset,
+            to_read,
+            amount_read)) {
+        int error_code = aws_last_error();
+        if (error_code != AWS_IO_READ_WOULD_BLOCK) {
+            s_file_sink_complete(socket_handler, error_code);
+            aws_raise_error(error_code);
+        }
+        return AWS_OP_ERR;
+    }
+
+    socket_handler->slot->adj_right->window_size -= *amount_read;
+    socket_handler->file_sink.offset += *amount_read;
+    socket_handler->file_sink.remaining -= *amount_read;
+    socket_handler->file_sink.bytes_received += *amount_read;
+
+    if (!socket_handler->file_sink.remaining) {
+        s_file_sink_complete(socket_handler, AWS_ERROR_SUCCESS);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Appends to buffer, the bytes count against the downstream window as a message of the same size would have. */
+static int s_read_into_buffer(
+    struct socket_handler *socket_handler,
+    struct aws_byte_buf *buffer,
+    size_t max_read,
+    size_t *amount_read) {
+
+    struct aws_byte_buf dest = aws_byte_buf_from_empty_array(
+        buffer->buffer + buffer->len, aws_min_size(max_read, buffer->capacity - buffer->len));
+    if (aws_socket_read(socket_handler->socket, &dest, amount_read)) {
+        return AWS_OP_ERR;
+    }
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: read %llu from socket into a lent buffer",
+        (void *)socket_handler->slot->handler,
+        (unsigned long long)*amount_read);
+
+    socket_handler->slot->adj_right->window_size -= *amount_read;
+    buffer->len += *amount_read;
+    return AWS_OP_SUCCESS;
+}
+
+static void s_lent_buffer_complete(struct socket_handler *socket_handler, int error_code) {
+    aws_channel_on_read_buffer_filled_fn *on_filled = socket_handler->lent_buffer.on_filled;
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: returning lent buffer with %llu bytes and error_code %d",
+        (void *)socket_handler->slot->handler,
+        (unsigned long long)socket_handler->lent_buffer.buffer->len,
+        error_code);
+
+    /* cleared first, so the callback can lend another buffer */
+    socket_handler->lent_buffer.on_filled = NULL;
+    on_filled(
+        socket_handler->slot->channel,
+        error_code,
+        socket_handler->lent_buffer.buffer,
+        socket_handler->lent_buffer.user_data);
+}
+
+static int s_read_into_lent_buffer(struct socket_handler *socket_handler, size_t max_read, size_t *amount_read) {
+    struct aws_byte_buf *buffer = socket_handler->lent_buffer.buffer;
+
+    if (s_read_into_buffer(socket_handler, buffer, max_read, amount_read)) {
+        int error_code = aws_last_error();
+        if (error_code != AWS_IO_READ_WOULD_BLOCK) {
+            s_lent_buffer_complete(socket_handler, error_code);
+            aws_raise_error(error_code);
+        }
+        return AWS_OP_ERR;
+    }
+
+    if (buffer->len == buffer->capacity) {
+        s_lent_buffer_complete(socket_handler, AWS_ERROR_SUCCESS);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static void s_on_loop_data_removed(struct aws_event_loop_local_object *object) {
+    struct socket_handler_loop_data *loop_data = object->object;
+    aws_byte_buf_clean_up(&loop_data->scratch);
+    aws_mem_release(loop_data->alloc, loop_data);
+}
+
+static struct socket_handler_loop_data *s_fetch_or_create_loop_data(struct socket_handler *socket_handler) {
+    struct aws_channel *channel = socket_handler->slot->channel;
+    struct aws_event_loop_local_object local_object;
+    AWS_ZERO_STRUCT(local_object);
+
+    if (!aws_channel_fetch_local_object(channel, &s_loop_data_key, &local_object)) {
+        return local_object.object;
+    }
+
+    struct aws_allocator *alloc = socket_handler->slot->handler->alloc;
+    struct socket_handler_loop_data *loop_data = aws_mem_calloc(alloc, 1, sizeof(struct socket_handler_loop_data));
+    if (!loop_data) {
+        return NULL;
+    }
+
+    loop_data->alloc = alloc;
+    loop_data->local_object.key = &s_loop_data_key;
+    loop_data->local_object.object = loop_data;
+    loop_data->local_object.on_object_removed = s_on_loop_data_removed;
+
+    if (aws_channel_put_local_object(channel, &s_loop_data_key, &loop_data->local_object)) {
+        aws_mem_release(alloc, loop_data);
+        return NULL;
+    }
+
+    return loop_data;
+}
+
+static struct socket_handler_loop_data *s_get_loop_data(struct socket_handler *socket_handler) {
+    if (!socket_handler->loop_data) {
+        socket_handler->loop_data = s_fetch_or_create_loop_data(socket_handler);
+    }
+
+    return socket_handler->loop_data;
+}
+
+static void s_stop_contending(struct socket_handler *socket_handler) {
+    if (socket_handler->contending) {
+        socket_handler->contending = false;
+        socket_handler->loop_data->contending_readers--;
+    }
+}
+
+/* Adapts the read budget after a read that either used all of it, meaning more data is waiting, or didn't. Alone on
+ * the loop, a socket that keeps using up its budget gets a bigger one so bulk transfers aren't chopped into small
+ * ticks. With other sockets also waiting to read more, it gets a smaller one so they take turns sooner. */
+static void s_update_read_budget(struct socket_handler *socket_handler, bool budget_used_up) {
+    if (!socket_handler->adaptive_read_budget) {
+        return;
+    }
+
+    if (!budget_used_up) {
+        s_stop_contending(socket_handler);
+        return;
+    }
+
+    struct socket_handler_loop_data *loop_data = s_get_loop_data(socket_handler);
+    if (!loop_data) {
+        return;
+    }
+
+    size_t other_readers = loop_data->contending_readers - (socket_handler->contending ? 1 : 0);
+    size_t budget = socket_handler->max_rw_size;
+    if (!other_readers) {
+        budget = aws_min_size(aws_mul_size_saturating(budget, 2), socket_handler->max_read_budget);
+    } else {
+        budget = aws_max_size(budget / 2, socket_handler->min_read_budget);
+    }
+
+    if (budget != socket_handler->max_rw_size) {
+        AWS_LOGF_TRACE(
+            AWS_LS_IO_SOCKET_HANDLER,
+            "id=%p: read budget changed from %llu to %llu, %llu other sockets waiting to read",
+            (void *)socket_handler->slot->handler,
+            (unsigned long long)socket_handler->max_rw_size,
+            (unsigned long long)budget,
+            (unsigned long long)other_readers);
+        if (budget > socket_handler->max_rw_size) {
+            socket_handler->stats.read_budget_increases++;
+        } else {
+            socket_handler->stats.read_budget_decreases++;
+        }
+        socket_handler->max_rw_size = budget;
+    }
+
+    if (!socket_handler->contending) {
+        socket_handler->contending = true;
+        loop_data->contending_readers++;
+    }
+}
+
+/* Sends the data up the channel in as many messages as it takes. */
+static int s_send_read_data(struct socket_handler *socket_handler, struct aws_byte_cursor data) {
+    while (data.len) {
+        struct aws_io_message *message = aws_channel_acquire_message_from_pool(
+            socket_handler->slot->channel, AWS_IO_MESSAGE_APPLICATION_DATA, data.len);
+        if (!message) {
+            return AWS_OP_ERR;
+        }
+
+        aws_byte_buf_write_to_capacity(&message->message_data, &data);
+        if (aws_channel_slot_send_message(socket_handler->slot, message, AWS_CHANNEL_DIR_READ)) {
+            aws_mem_release(message->allocator, message);
+            return AWS_OP_ERR;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Reads into the loop's scratch buffer and only takes messages from the pool for what actually arrived. Used once a
+ * read came up short, when the next one will most likely find the socket empty, so the usual end of a read cycle
+ * doesn't acquire a message just to release it again. */
+static int s_read_through_scratch(struct socket_handler *socket_handler, size_t max_read, size_t *amount_read) {
+    struct socket_handler_loop_data *loop_data = s_get_loop_data(socket_handler);
+    if (!loop_data || loop_data->scratch_in_use ||
+        (!loop_data->scratch.buffer &&
+         aws_byte_buf_init(&loop_data->scratch, loop_data->alloc, g_aws_channel_max_fragment_size))) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    struct aws_byte_buf scratch =
+        aws_byte_buf_from_empty_array(loop_data->scratch.buffer, aws_min_size(loop_data->scratch.capacity, max_read));
+    if (aws_socket_read(socket_handler->socket, &scratch, amount_read)) {
+        return AWS_OP_ERR;
+    }
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: read %llu from socket",
+        (void *)socket_handler->slot->handler,
+        (unsigned long long)*amount_read);
+
+    socket_handler->stats.bytes_read_through_scratch += *amount_read;
+
+    /* a handler downstream could get another socket on this loop to read */
+    loop_data->scratch_in_use = true;
+    int result = s_send_read_data(socket_handler, aws_byte_cursor_from_buf(&scratch));
+    loop_data->scratch_in_use = false;
+    return result;
+}
+
 /* Ok this next function is VERY important for how back pressure works. Here's what it's supposed to be doing:
  *
  * See how much data downstream is willing to accept.
@@ -122,6 +453,8 @@ static void s_on_readable_notification(struct aws_socket *socket, int error_code
  */
 static void s_do_read(struct socket_handler *socket_handler) {
 
+    socket_handler->tick_bytes_read = 0;
+
     size_t downstream_window = aws_channel_slot_downstream_read_window(socket_handler->slot);
     size_t max_to_read =
         downstream_window > socket_handler->max_rw_size ? socket_handler->max_rw_size : downstream_window;
@@ -134,14 +467,65 @@ static void s_do_read(struct socket_handler *socket_handler) {
         (unsigned long long)max_to_read);
 
     if (max_to_read == 0) {
+        s_update_read_budget(socket_handler, false);
         return;
     }
 
     size_t total_read = 0;
     size_t read = 0;
+    /* the socket's receive queue was emptied by the last read, so the next one is expected to find it empty */
+    bool came_up_short = false;
     while (total_read < max_to_read && !socket_handler->shutdown_in_progress) {
+        /* a handler downstream can read from the socket itself in the middle of this, see
+         * aws_channel_slot_lend_read_buffer(), and that uses up its window and this tick's budget too. */
+        size_t window_left = aws_channel_slot_downstream_read_window(socket_handler->slot);
+        size_t budget_left =
+            socket_handler->max_rw_size - aws_min_size(socket_handler->tick_bytes_read, socket_handler->max_rw_size);
+        size_t left = aws_min_size(window_left, budget_left);
+        if (left < max_to_read - total_read) {
+            max_to_read = total_read + left;
+            if (!left) {
+                break;
+            }
+        }
+
         size_t iter_max_read = max_to_read - total_read;
 
+        if (socket_handler->file_sink.on_completion) {
+            if (s_read_into_file_sink(socket_handler, iter_max_read, &read)) {
+                break;
+            }
+
+            total_read += read;
+            socket_handler->tick_bytes_read += read;
+            continue;
+        }
+
+        if (socket_handler->lent_buffer.on_filled) {
+            if (s_read_into_lent_buffer(socket_handler, iter_max_read, &read)) {
+                break;
+            }
+
+            total_read += read;
+            socket_handler->tick_bytes_read += read;
+            continue;
+        }
+
+        if (came_up_short) {
+            if (!s_read_through_scratch(socket_handler, iter_max_read, &read)) {
+                /* more data showed up in the meantime, the next read goes straight into a message again */
+                came_up_short = read < aws_min_size(socket_handler->loop_data->scratch.capacity, iter_max_read);
+                total_read += read;
+                socket_handler->tick_bytes_read += read;
+                continue;
+            }
+
+            if (aws_last_error() != AWS_ERROR_INVALID_STATE) {
+                break;
+            }
+            /* the scratch buffer isn't available, read into a message as usual */
+        }
+
         struct aws_io_message *message = aws_channel_acquire_message_from_pool(
             socket_handler->slot->channel, AWS_IO_MESSAGE_APPLICATION_DATA, iter_max_read);
 
@@ -154,7 +538,9 @@ static void s_do_read(struct socket_handler *socket_handler) {
             break;
         }
 
+        came_up_short = read < message->message_data.capacity;
         total_read += read;
+        socket_handler->tick_bytes_read += read;
         AWS_LOGF_TRACE(
             AWS_LS_IO_SOCKET_HANDLER,
             "id=%p: read %llu from socket",
@@ -175,6 +561,9 @@ static void s_do_read(struct socket_handler *socket_handler) {
 
     socket_handler->stats.bytes_read += total_read;
 
+    bool budget_used_up = socket_handler->tick_bytes_read >= socket_handler->max_rw_size;
+    s_update_read_budget(socket_handler, budget_used_up && !socket_handler->shutdown_in_progress);
+
     /* resubscribe as long as there's no error, just return if we're in a would block scenario. */
     if (total_read < max_to_read) {
         int last_error = aws_last_error();
@@ -192,8 +581,7 @@ static void s_do_read(struct socket_handler *socket_handler) {
     }
     /* in this case, everything was fine, but there's still pending reads. We need to schedule a task to do the read
      * again. */
-    if (!socket_handler->shutdown_in_progress && total_read == socket_handler->max_rw_size &&
-        !socket_handler->read_task_storage.task_fn) {
+    if (!socket_handler->shutdown_in_progress && budget_used_up && !socket_handler->read_task_storage.task_fn) {
 
         AWS_LOGF_TRACE(
             AWS_LS_IO_SOCKET_HANDLER,
@@ -271,6 +659,16 @@ static void s_close_task(struct aws_channel_task *task, void *arg, aws_task_stat
      * finish shutting down properly
      */
 
+    if (socket_handler->writes_in_flight) {
+        AWS_LOGF_DEBUG(
+            AWS_LS_IO_SOCKET_HANDLER,
+            "id=%p: waiting on %zu writes the kernel is still sending from before completing shutdown",
+            (void *)handler,
+            socket_handler->writes_in_flight);
+        socket_handler->shutdown_complete_pending = true;
+        return;
+    }
+
     /* this only happens in write direction. */
     /* we also don't care about the free_scarce_resource_immediately
      * code since we're always the last one in the shutdown sequence. */
@@ -278,6 +676,15 @@ static void s_close_task(struct aws_channel_task *task, void *arg, aws_task_stat
         socket_handler->slot, AWS_CHANNEL_DIR_WRITE, socket_handler->shutdown_err_code, false);
 }
 
+/* A channel that is being torn down abortively resets its connection instead of closing it gracefully. */
+static int s_close_socket(struct socket_handler *socket_handler) {
+    if (aws_channel_is_shutdown_abortive(socket_handler->slot->channel)) {
+        return aws_socket_abort(socket_handler->socket);
+    }
+
+    return aws_socket_close(socket_handler->socket);
+}
+
 static int s_socket_shutdown(
     struct aws_channel_handler *handler,
     struct aws_channel_slot *slot,
@@ -287,14 +694,23 @@ static int s_socket_shutdown(
     struct socket_handler *socket_handler = (struct socket_handler *)handler->impl;
 
     socket_handler->shutdown_in_progress = true;
+    s_stop_contending(socket_handler);
     if (dir == AWS_CHANNEL_DIR_READ) {
         AWS_LOGF_TRACE(
             AWS_LS_IO_SOCKET_HANDLER,
             "id=%p: shutting down read direction with error_code %d",
             (void *)handler,
             error_code);
+        if (socket_handler->file_sink.on_completion) {
+            s_file_sink_complete(socket_handler, error_code ? error_code : AWS_ERROR_IO_OPERATION_CANCELLED);
+        }
+
+        if (socket_handler->lent_buffer.on_filled) {
+            s_lent_buffer_complete(socket_handler, error_code ? error_code : AWS_ERROR_IO_OPERATION_CANCELLED);
+        }
+
         if (free_scarce_resource_immediately && aws_socket_is_open(socket_handler->socket)) {
-            if (aws_socket_close(socket_handler->socket)) {
+            if (s_close_socket(socket_handler)) {
                 return AWS_OP_ERR;
             }
         }
@@ -308,7 +724,7 @@ static int s_socket_shutdown(
         (void *)handler,
         error_code);
     if (aws_socket_is_open(socket_handler->socket)) {
-        aws_socket_close(socket_handler->socket);
+        s_close_socket(socket_handler);
     }
 
     /* Schedule a task to complete the shutdown, in case a do_read task is currently pending.
@@ -351,6 +767,21 @@ static void s_reset_statistics(struct aws_channel_handler *handler) {
 void s_gather_statistics(struct aws_channel_handler *handler, struct aws_array_list *stats_list) {
     struct socket_handler *socket_handler = (struct socket_handler *)handler->impl;
 
+    struct aws_socket *socket = socket_handler->socket;
+    if (socket->options.type == AWS_SOCKET_STREAM &&
+        (socket->options.domain == AWS_SOCKET_IPV4 || socket->options.domain == AWS_SOCKET_IPV6) &&
+        aws_socket_is_open(socket)) {
+        socket_handler->stats.has_transport_metrics =
+            aws_socket_get_transport_metrics(socket, &socket_handler->stats.transport_metrics) == AWS_OP_SUCCESS;
+    }
+
+    if (socket->options.kernel_timestamps && aws_socket_is_open(socket)) {
+        socket_handler->stats.has_kernel_timestamps =
+            aws_socket_get_kernel_timestamps(socket, &socket_handler->stats.kernel_timestamps) == AWS_OP_SUCCESS;
+    }
+
+    socket_handler->stats.read_budget = socket_handler->max_rw_size;
+
     void *stats_base = &socket_handler->stats;
     aws_array_list_push_back(stats_list, &stats_base);
 }
@@ -373,6 +804,18 @@ struct aws_channel_handler *aws_socket_handler_new(
     struct aws_channel_slot *slot,
     size_t max_read_size) {
 
+    struct aws_socket_handler_options options = {
+        .max_read_size = max_read_size,
+    };
+    return aws_socket_handler_new_with_options(allocator, socket, slot, &options);
+}
+
+struct aws_channel_handler *aws_socket_handler_new_with_options(
+    struct aws_allocator *allocator,
+    struct aws_socket *socket,
+    struct aws_channel_slot *slot,
+    const struct aws_socket_handler_options *options) {
+
     /* make sure something has assigned this socket to an event loop, in client mode this will already have occurred.
        In server mode, someone should have assigned it before calling us.*/
     AWS_ASSERT(aws_socket_get_event_loop(socket));
@@ -388,19 +831,42 @@ struct aws_channel_handler *aws_socket_handler_new(
 
     impl->socket = socket;
     impl->slot = slot;
-    impl->max_rw_size = max_read_size;
+    impl->max_rw_size = options->max_read_size;
+    impl->min_read_budget = options->max_read_size;
+    impl->max_read_budget = options->max_read_size;
+    impl->tick_bytes_read = 0;
+    impl->loop_data = NULL;
+    impl->adaptive_read_budget = options->adaptive_read_budget != NULL;
+    impl->contending = false;
+    if (options->adaptive_read_budget) {
+        const struct aws_socket_handler_read_budget_options *budget = options->adaptive_read_budget;
+        impl->min_read_budget =
+            budget->min_read_size ? budget->min_read_size : aws_max_size(options->max_read_size / 4, 1);
+        impl->max_read_budget =
+            budget->max_read_size ? budget->max_read_size : aws_mul_size_saturating(options->max_read_size, 16);
+        if (impl->min_read_budget > impl->max_read_budget) {
+            aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            goto cleanup_handler;
+        }
+        impl->max_rw_size = aws_min_size(aws_max_size(impl->max_rw_size, impl->min_read_budget), impl->max_read_budget);
+    }
     AWS_ZERO_STRUCT(impl->read_task_storage);
     AWS_ZERO_STRUCT(impl->shutdown_task_storage);
+    AWS_ZERO_STRUCT(impl->file_sink);
+    AWS_ZERO_STRUCT(impl->lent_buffer);
+    impl->writes_in_flight = 0;
     impl->shutdown_in_progress = false;
+    impl->shutdown_complete_pending = false;
     if (aws_crt_statistics_socket_init(&impl->stats)) {
         goto cleanup_handler;
     }
 
     AWS_LOGF_DEBUG(
         AWS_LS_IO_SOCKET_HANDLER,
-        "id=%p: Socket handler created with max_read_size of %llu",
+        "id=%p: Socket handler created with max_read_size of %llu%s",
         (void *)handler,
-        (unsigned long long)max_read_size);
+        (unsigned long long)impl->max_rw_size,
+        impl->adaptive_read_budget ? ", adaptive" : "");
 
     handler->alloc = allocator;
     handler->impl = impl;
@@ -419,3 +885,385 @@ cleanup_handler:
 
     return NULL;
 }
+
+struct channel_file_send {
+    struct aws_allocator *allocator;
+    struct aws_channel_slot *slot;
+    struct aws_channel_task send_task;
+    int fd;
+    uint64_t offset;
+    size_t remaining;
+    size_t in_flight;
+    size_t bytes_sent;
+    aws_channel_on_file_sent_fn *on_completion;
+    void *user_data;
+};
+
+static void s_file_send_complete(struct channel_file_send *file_send, int error_code) {
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: file send finished after %llu bytes with error %d (%s)",
+        (void *)file_send->slot->handler,
+        (unsigned long long)file_send->bytes_sent,
+        error_code,
+        aws_error_name(error_code));
+
+    file_send->on_completion(file_send->slot->channel, error_code, file_send->bytes_sent, file_send->user_data);
+    aws_mem_release(file_send->allocator, file_send);
+}
+
+/* invoked by the socket when a file range written with sendfile() has completed or failed. */
+static void s_on_socket_file_written(
+    struct aws_socket *socket,
+    int error_code,
+    size_t amount_written,
+    void *user_data) {
+    struct channel_file_send *file_send = user_data;
+    struct aws_channel *channel = file_send->slot->channel;
+
+    if (socket && socket->handler) {
+        struct socket_handler *socket_handler = socket->handler->impl;
+        socket_handler->stats.bytes_written += amount_written;
+    }
+
+    file_send->bytes_sent = amount_written;
+    s_file_send_complete(file_send, error_code);
+
+    if (error_code) {
+        aws_channel_shutdown(channel, error_code);
+    }
+}
+
+static int s_read_file_range(int fd, uint64_t offset, struct aws_byte_buf *buffer, size_t length) {
+#ifdef _WIN32
+    HANDLE file = (HANDLE)_get_osfhandle(fd);
+    if (file == INVALID_HANDLE_VALUE) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    /* ReadFile() still moves the file pointer of a handle that wasn't opened for overlapped I/O, put it back after */
+    LARGE_INTEGER file_pointer = {.QuadPart = 0};
+    LARGE_INTEGER zero = {.QuadPart = 0};
+    if (!SetFilePointerEx(file, zero, &file_pointer, FILE_CURRENT)) {
+        return aws_raise_error(AWS_IO_STREAM_READ_FAILED);
+    }
+
+    OVERLAPPED overlapped;
+    AWS_ZERO_STRUCT(overlapped);
+    overlapped.Offset = (DWORD)offset;
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+    DWORD amount_read = 0;
+    BOOL read_succeeded = ReadFile(file, buffer->buffer + buffer->len, (DWORD)length, &amount_read, &overlapped);
+    DWORD read_error = read_succeeded ? ERROR_SUCCESS : GetLastError();
+    SetFilePointerEx(file, file_pointer, NULL, FILE_BEGIN);
+
+    if (!read_succeeded && read_error != ERROR_HANDLE_EOF) {
+        AWS_LOGF_ERROR(AWS_LS_IO_SOCKET_HANDLER, "static: reading file fd=%d failed with %lu", fd, read_error);
+        return aws_raise_error(AWS_IO_STREAM_READ_FAILED);
+    }
+#else
+    ssize_t amount_read = pread(fd, buffer->buffer + buffer->len, length, (off_t)offset);
+    if (amount_read < 0) {
+        return aws_translate_and_raise_io_error(errno);
+    }
+#endif
+
+    /* the file is shorter than the range being sent */
+    if (amount_read == 0) {
+        return aws_raise_error(AWS_IO_STREAM_READ_FAILED);
+    }
+
+    buffer->len += (size_t)amount_read;
+    return AWS_OP_SUCCESS;
+}
+
+static void s_on_file_send_message_written(
+    struct aws_channel *channel,
+    struct aws_io_message *message,
+    int err_code,
+    void *user_data) {
+    (void)message;
+    struct channel_file_send *file_send = user_data;
+
+    if (err_code) {
+        s_file_send_complete(file_send, err_code);
+        return;
+    }
+
+    file_send->bytes_sent += file_send->in_flight;
+    file_send->in_flight = 0;
+
+    if (!file_send->remaining) {
+        s_file_send_complete(file_send, AWS_ERROR_SUCCESS);
+        return;
+    }
+
+    /* the completion can be invoked from within the write, don't recurse once per message */
+    aws_channel_schedule_task_now(channel, &file_send->send_task);
+}
+
+/* reads the next part of the range into a message and sends it, the next one goes once that has been written. */
+static void s_file_send_task(struct aws_channel_task *task, void *arg, aws_task_status status) {
+    (void)task;
+    struct channel_file_send *file_send = arg;
+
+    if (status != AWS_TASK_STATUS_RUN_READY) {
+        s_file_send_complete(file_send, AWS_ERROR_IO_OPERATION_CANCELLED);
+        return;
+    }
+
+    if (!file_send->remaining) {
+        s_file_send_complete(file_send, AWS_ERROR_SUCCESS);
+        return;
+    }
+
+    struct aws_io_message *message = aws_channel_slot_acquire_max_message_for_write(file_send->slot);
+    if (!message) {
+        s_file_send_complete(file_send, aws_last_error());
+        return;
+    }
+
+    size_t to_read = aws_min_size(file_send->remaining, message->message_data.capacity);
+    if (s_read_file_range(file_send->fd, file_send->offset, &message->message_data, to_read)) {
+        goto error;
+    }
+
+    size_t amount_read = message->message_data.len;
+    message->on_completion = s_on_file_send_message_written;
+    message->user_data = file_send;
+    file_send->in_flight = amount_read;
+    file_send->offset += amount_read;
+    file_send->remaining -= amount_read;
+
+    if (aws_channel_slot_send_message(file_send->slot, message, AWS_CHANNEL_DIR_WRITE)) {
+        goto error;
+    }
+
+    return;
+
+error:;
+    int error_code = aws_last_error();
+    aws_mem_release(message->allocator, message);
+    s_file_send_complete(file_send, error_code);
+}
+
+int aws_channel_slot_send_file(struct aws_channel_slot *slot, const struct aws_channel_send_file_options *options) {
+    AWS_ASSERT(aws_channel_thread_is_callers_thread(slot->channel));
+
+    if (options->fd < 0 || !options->on_completion || options->offset > (uint64_t)INT64_MAX - options->length) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct channel_file_send *file_send = aws_mem_calloc(slot->alloc, 1, sizeof(struct channel_file_send));
+    if (!file_send) {
+        return AWS_OP_ERR;
+    }
+
+    file_send->allocator = slot->alloc;
+    file_send->slot = slot;
+    file_send->fd = options->fd;
+    file_send->offset = options->offset;
+    file_send->remaining = options->length;
+    file_send->on_completion = options->on_completion;
+    file_send->user_data = options->user_data;
+    aws_channel_task_init(&file_send->send_task, s_file_send_task, file_send, "channel_file_send");
+
+    struct aws_channel_slot *socket_slot = slot->adj_left;
+    if (socket_slot && socket_slot->handler && socket_slot->handler->vtable == &s_vtable) {
+        struct socket_handler *socket_handler = socket_slot->handler->impl;
+
+        if (!aws_socket_is_open(socket_handler->socket)) {
+            aws_mem_release(file_send->allocator, file_send);
+            return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+        }
+
+        if (!aws_socket_write_file(
+                socket_handler->socket,
+                options->fd,
+                options->offset,
+                options->length,
+                s_on_socket_file_written,
+                file_send)) {
+            return AWS_OP_SUCCESS;
+        }
+
+        if (aws_last_error() != AWS_ERROR_UNSUPPORTED_OPERATION) {
+            aws_mem_release(file_send->allocator, file_send);
+            return AWS_OP_ERR;
+        }
+
+        AWS_LOGF_DEBUG(
+            AWS_LS_IO_SOCKET_HANDLER,
+            "id=%p: socket can't send files, copying the range through messages instead",
+            (void *)socket_slot->handler);
+    }
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: sending %llu bytes of file fd=%d through channel messages",
+        (void *)slot->handler,
+        (unsigned long long)options->length,
+        options->fd);
+
+    aws_channel_schedule_task_now(slot->channel, &file_send->send_task);
+    return AWS_OP_SUCCESS;
+}
+
+int aws_channel_slot_receive_file(
+    struct aws_channel_slot *slot,
+    const struct aws_channel_receive_file_options *options) {
+    AWS_ASSERT(aws_channel_thread_is_callers_thread(slot->channel));
+
+    if (options->fd < 0 || !options->on_completion || !options->length ||
+        options->offset > (uint64_t)INT64_MAX - options->length) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct aws_channel_slot *socket_slot = slot->adj_left;
+    if (!socket_slot || !socket_slot->handler || socket_slot->handler->vtable != &s_vtable) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET_HANDLER,
+            "id=%p: files can only be received right after a socket handler",
+            (void *)slot->handler);
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+#if !defined(__linux__)
+    AWS_LOGF_ERROR(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: receiving into a file is not supported on this platform",
+        (void *)socket_slot->handler);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#else
+    struct socket_handler *socket_handler = socket_slot->handler->impl;
+
+    if (socket_handler->file_sink.on_completion || socket_handler->lent_buffer.on_filled) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    if (socket_handler->shutdown_in_progress || !aws_socket_is_open(socket_handler->socket)) {
+        return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+    }
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: receiving %llu bytes into file fd=%d",
+        (void *)socket_slot->handler,
+        (unsigned long long)options->length,
+        options->fd);
+
+    socket_handler->file_sink.fd = options->fd;
+    socket_handler->file_sink.offset = options->offset;
+    socket_handler->file_sink.remaining = options->length;
+    socket_handler->file_sink.bytes_received = 0;
+    socket_handler->file_sink.on_completion = options->on_completion;
+    socket_handler->file_sink.user_data = options->user_data;
+
+    /* data may already be waiting on the socket, and there won't be another readable notification for it. */
+    if (!socket_handler->read_task_storage.task_fn) {
+        aws_channel_task_init(
+            &socket_handler->read_task_storage, s_read_task, socket_handler, "socket_handler_read_into_file");
+        aws_channel_schedule_task_now(slot->channel, &socket_handler->read_task_storage);
+    }
+
+    return AWS_OP_SUCCESS;
+#endif
+}
+
+/* Reads what the socket has right now into the buffer, for a lender that doesn't wait for it to fill. */
+static int s_read_into_buffer_now(struct socket_handler *socket_handler, struct aws_byte_buf *buffer) {
+    size_t window = aws_channel_slot_downstream_read_window(socket_handler->slot);
+    if (!window) {
+        return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+    }
+
+    /* these reads count against the handler's budget like its own, so a handler reading this way on every tick can't
+     * keep the other sockets on the loop waiting. What's left is read on a later tick. */
+    if (socket_handler->tick_bytes_read >= socket_handler->max_rw_size) {
+        AWS_LOGF_TRACE(
+            AWS_LS_IO_SOCKET_HANDLER,
+            "id=%p: read budget for this tick used up, not reading into the lent buffer",
+            (void *)socket_handler->slot->handler);
+        if (!socket_handler->read_task_storage.task_fn) {
+            aws_channel_task_init(
+                &socket_handler->read_task_storage, s_read_task, socket_handler, "socket_handler_re_read");
+            aws_channel_schedule_task_now(socket_handler->slot->channel, &socket_handler->read_task_storage);
+        }
+        return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+    }
+
+    size_t budget_left = socket_handler->max_rw_size - socket_handler->tick_bytes_read;
+    size_t to_read = aws_min_size(aws_min_size(window, budget_left), buffer->capacity - buffer->len);
+    size_t read = 0;
+    int result = s_read_into_buffer(socket_handler, buffer, to_read, &read);
+    if (result && aws_last_error() == AWS_IO_READ_WOULD_BLOCK) {
+        return AWS_OP_ERR;
+    }
+
+    socket_handler->tick_bytes_read += read;
+    socket_handler->stats.bytes_read += read;
+
+    /* Whatever else is on the socket, or an error on it, is left to the handler's own read. Notifications are
+     * edge-triggered, so there won't be another one for it, and that read shuts the channel down on an error. */
+    if ((result || read == to_read) && !socket_handler->read_task_storage.task_fn) {
+        aws_channel_task_init(
+            &socket_handler->read_task_storage, s_read_task, socket_handler, "socket_handler_read_after_lent_buffer");
+        aws_channel_schedule_task_now(socket_handler->slot->channel, &socket_handler->read_task_storage);
+    }
+
+    return result;
+}
+
+int aws_channel_slot_lend_read_buffer(
+    struct aws_channel_slot *slot,
+    const struct aws_channel_lend_read_buffer_options *options) {
+    AWS_ASSERT(aws_channel_thread_is_callers_thread(slot->channel));
+
+    struct aws_byte_buf *buffer = options->buffer;
+    if (!buffer || !buffer->buffer || buffer->len >= buffer->capacity) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct aws_channel_slot *socket_slot = slot->adj_left;
+    if (!socket_slot || !socket_slot->handler || socket_slot->handler->vtable != &s_vtable) {
+        AWS_LOGF_DEBUG(
+            AWS_LS_IO_SOCKET_HANDLER,
+            "id=%p: buffers can only be lent to a socket handler right before them",
+            (void *)slot->handler);
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    struct socket_handler *socket_handler = socket_slot->handler->impl;
+
+    if (socket_handler->file_sink.on_completion || socket_handler->lent_buffer.on_filled) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    if (socket_handler->shutdown_in_progress || !aws_socket_is_open(socket_handler->socket)) {
+        return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+    }
+
+    if (!options->on_filled) {
+        return s_read_into_buffer_now(socket_handler, buffer);
+    }
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: lent a buffer with room for %llu bytes",
+        (void *)socket_slot->handler,
+        (unsigned long long)(buffer->capacity - buffer->len));
+
+    socket_handler->lent_buffer.buffer = buffer;
+    socket_handler->lent_buffer.on_filled = options->on_filled;
+    socket_handler->lent_buffer.user_data = options->user_data;
+
+    /* data may already be waiting on the socket, and there won't be another readable notification for it. */
+    if (!socket_handler->read_task_storage.task_fn) {
+        aws_channel_task_init(
+            &socket_handler->read_task_storage, s_read_task, socket_handler, "socket_handler_read_into_lent_buffer");
+        aws_channel_schedule_task_now(slot->channel, &socket_handler->read_task_storage);
+    }
+
+    return AWS_OP_SUCCESS;
+}
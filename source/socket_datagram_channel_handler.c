@@ -0,0 +1,560 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/io/socket_channel_handler.h>
+
+#include <aws/common/error.h>
+#include <aws/common/task_scheduler.h>
+
+#include <aws/io/channel.h>
+#include <aws/io/event_loop.h>
+#include <aws/io/logging.h>
+#include <aws/io/socket.h>
+#include <aws/io/statistics.h>
+
+#if _MSC_VER
+#    pragma warning(disable : 4204) /* non-constant aggregate initializer */
+#endif
+
+enum {
+    DEFAULT_MAX_DATAGRAMS_PER_READ = 64,
+    DEFAULT_MAX_DATAGRAMS_PER_RECEIVE = 32,
+    DEFAULT_MAX_DATAGRAMS_PER_SEND = 32,
+};
+
+/* a read message keeps its datagram's source address at the start of its buffer, ahead of the datagram itself. Rounded
+ * up so the datagram that follows stays pointer aligned. */
+#define ENDPOINT_RESERVE ((sizeof(struct aws_socket_endpoint) + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *))
+
+struct datagram_handler {
+    struct aws_socket *socket;
+    struct aws_channel_slot *slot;
+    size_t max_datagram_size;
+    size_t max_datagrams_per_read;
+    size_t max_datagrams_per_receive;
+    size_t max_datagrams_per_send;
+    /* one batch each way, sized at creation */
+    struct aws_io_message **receive_messages;
+    struct aws_socket_datagram *receive_datagrams;
+    struct aws_socket_datagram *send_datagrams;
+    /* write messages waiting to be sent with the next batch, linked through their queueing_handle */
+    struct aws_linked_list pending_writes;
+    size_t pending_write_count;
+    bool flush_in_progress;
+    struct aws_channel_task read_task_storage;
+    struct aws_channel_task flush_task_storage;
+    struct aws_channel_task shutdown_task_storage;
+    struct aws_crt_statistics_socket stats;
+    int shutdown_err_code;
+    bool shutdown_in_progress;
+};
+
+static int s_datagram_process_read_message(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    struct aws_io_message *message) {
+    (void)slot;
+    (void)message;
+
+    AWS_LOGF_FATAL(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: process_read_message called on datagram socket handler. This should never happen",
+        (void *)handler);
+
+    /* like the stream socket handler, this one is always the first handler in its channel. */
+    AWS_ASSERT(0);
+    return aws_raise_error(AWS_IO_CHANNEL_ERROR_ERROR_CANT_ACCEPT_INPUT);
+}
+
+/* invoked by the socket when a datagram has been sent or failed to. Either way it only concerns its own message. */
+static void s_on_datagram_written(struct aws_socket *socket, int error_code, size_t amount_written, void *user_data) {
+    struct aws_io_message *message = user_data;
+    struct aws_channel *channel = message->owning_channel;
+
+    if (error_code) {
+        AWS_LOGF_DEBUG(
+            AWS_LS_IO_SOCKET_HANDLER,
+            "static: datagram of size %llu on channel %p failed to send with error %d",
+            (unsigned long long)message->message_data.len,
+            (void *)channel,
+            error_code);
+    }
+
+    if (message->on_completion) {
+        message->on_completion(channel, message, error_code, message->user_data);
+    }
+
+    if (socket && socket->handler) {
+        struct datagram_handler *datagram_handler = socket->handler->impl;
+        datagram_handler->stats.bytes_written += amount_written;
+    }
+
+    aws_mem_release(message->allocator, message);
+}
+
+/* sends the pending write messages, max_datagrams_per_send at a time. A message written by a completion callback while
+ * this runs is picked up by the same flush. */
+static void s_flush_writes(struct datagram_handler *datagram_handler) {
+    if (datagram_handler->flush_in_progress) {
+        return;
+    }
+
+    datagram_handler->flush_in_progress = true;
+    while (!aws_linked_list_empty(&datagram_handler->pending_writes)) {
+        /* a read shutdown that frees resources immediately closes the socket, the messages still held fail */
+        if (!aws_socket_is_open(datagram_handler->socket)) {
+            struct aws_linked_list_node *node = aws_linked_list_pop_front(&datagram_handler->pending_writes);
+            datagram_handler->pending_write_count--;
+            s_on_datagram_written(
+                datagram_handler->socket,
+                AWS_IO_SOCKET_CLOSED,
+                0,
+                AWS_CONTAINER_OF(node, struct aws_io_message, queueing_handle));
+            continue;
+        }
+
+        size_t count = 0;
+        while (count < datagram_handler->max_datagrams_per_send &&
+               !aws_linked_list_empty(&datagram_handler->pending_writes)) {
+            struct aws_linked_list_node *node = aws_linked_list_pop_front(&datagram_handler->pending_writes);
+            struct aws_io_message *message = AWS_CONTAINER_OF(node, struct aws_io_message, queueing_handle);
+            datagram_handler->send_datagrams[count++] = (struct aws_socket_datagram){
+                .buffer = &message->message_data,
+                .endpoint = message->endpoint,
+                .user_data = message,
+            };
+        }
+        datagram_handler->pending_write_count -= count;
+
+        AWS_LOGF_TRACE(
+            AWS_LS_IO_SOCKET_HANDLER,
+            "id=%p: sending a batch of %llu datagrams",
+            (void *)datagram_handler->slot->handler,
+            (unsigned long long)count);
+
+        struct aws_socket_datagram *batch = datagram_handler->send_datagrams;
+        if (aws_socket_send_batch(datagram_handler->socket, batch, count, s_on_datagram_written)) {
+            /* nothing was queued, fail every message of the batch */
+            int error_code = aws_last_error();
+            for (size_t i = 0; i < count; ++i) {
+                s_on_datagram_written(datagram_handler->socket, error_code, 0, batch[i].user_data);
+            }
+        }
+    }
+    datagram_handler->flush_in_progress = false;
+}
+
+static void s_flush_task(struct aws_channel_task *task, void *arg, aws_task_status status) {
+    (void)status;
+    task->task_fn = NULL;
+    task->arg = NULL;
+
+    /* run regardless of status, the pending messages have to be completed either way */
+    s_flush_writes(arg);
+}
+
+static int s_datagram_process_write_message(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    struct aws_io_message *message) {
+    struct datagram_handler *datagram_handler = handler->impl;
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: sending datagram of size %llu",
+        (void *)handler,
+        (unsigned long long)message->message_data.len);
+
+    if (!aws_socket_is_open(datagram_handler->socket)) {
+        return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+    }
+
+    if (datagram_handler->max_datagrams_per_send == 1) {
+        struct aws_byte_cursor cursor = aws_byte_cursor_from_buf(&message->message_data);
+        if (aws_socket_send_to(datagram_handler->socket, &cursor, message->endpoint, s_on_datagram_written, message)) {
+            /* a datagram that failed to send right away wasn't queued, it fails its own message like the others */
+            s_on_datagram_written(datagram_handler->socket, aws_last_error(), 0, message);
+        }
+
+        return AWS_OP_SUCCESS;
+    }
+
+    aws_linked_list_push_back(&datagram_handler->pending_writes, &message->queueing_handle);
+    if (++datagram_handler->pending_write_count >= datagram_handler->max_datagrams_per_send) {
+        s_flush_writes(datagram_handler);
+    } else if (!datagram_handler->flush_task_storage.task_fn) {
+        aws_channel_task_init(
+            &datagram_handler->flush_task_storage, s_flush_task, datagram_handler, "datagram_handler_flush_writes");
+        aws_channel_schedule_task_now(slot->channel, &datagram_handler->flush_task_storage);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_io_message *s_acquire_datagram_message(struct datagram_handler *datagram_handler) {
+    struct aws_io_message *message = aws_channel_acquire_message_from_pool(
+        datagram_handler->slot->channel,
+        AWS_IO_MESSAGE_APPLICATION_DATA,
+        datagram_handler->max_datagram_size + ENDPOINT_RESERVE);
+
+    if (!message) {
+        return NULL;
+    }
+
+    AWS_ASSERT(message->message_data.capacity > ENDPOINT_RESERVE);
+    message->endpoint = (struct aws_socket_endpoint *)message->message_data.buffer;
+    message->message_data.buffer += ENDPOINT_RESERVE;
+    message->message_data.capacity -= ENDPOINT_RESERVE;
+    return message;
+}
+
+static void s_read_task(struct aws_channel_task *task, void *arg, aws_task_status status);
+
+static void s_schedule_read(struct datagram_handler *datagram_handler, const char *type_tag) {
+    if (!datagram_handler->shutdown_in_progress && !datagram_handler->read_task_storage.task_fn) {
+        aws_channel_task_init(&datagram_handler->read_task_storage, s_read_task, datagram_handler, type_tag);
+        aws_channel_schedule_task_now(datagram_handler->slot->channel, &datagram_handler->read_task_storage);
+    }
+}
+
+/* receives up to batch_size datagrams with one syscall and sends them up the channel in order. received is set to the
+ * number sent up, the messages left over go back to the pool. */
+static int s_receive_batch(struct datagram_handler *datagram_handler, size_t batch_size, size_t *received) {
+    struct aws_channel_handler *handler = datagram_handler->slot->handler;
+    *received = 0;
+
+    size_t acquired = 0;
+    for (; acquired < batch_size; ++acquired) {
+        struct aws_io_message *message = s_acquire_datagram_message(datagram_handler);
+        if (!message) {
+            break;
+        }
+
+        datagram_handler->receive_messages[acquired] = message;
+        datagram_handler->receive_datagrams[acquired] = (struct aws_socket_datagram){
+            .buffer = &message->message_data,
+            .endpoint = message->endpoint,
+        };
+    }
+
+    if (!acquired) {
+        return AWS_OP_ERR;
+    }
+
+    size_t datagrams_read = 0;
+    int result = aws_socket_receive_batch(
+        datagram_handler->socket, datagram_handler->receive_datagrams, acquired, &datagrams_read);
+
+    size_t next = 0;
+    for (; result == AWS_OP_SUCCESS && next < datagrams_read; ++next) {
+        struct aws_io_message *message = datagram_handler->receive_messages[next];
+        datagram_handler->stats.bytes_read += message->message_data.len;
+        AWS_LOGF_TRACE(
+            AWS_LS_IO_SOCKET_HANDLER,
+            "id=%p: received datagram of %llu bytes from %s:%d",
+            (void *)handler,
+            (unsigned long long)message->message_data.len,
+            message->endpoint->address,
+            (int)message->endpoint->port);
+
+        if (aws_channel_slot_send_message(datagram_handler->slot, message, AWS_CHANNEL_DIR_READ)) {
+            result = AWS_OP_ERR;
+            break;
+        }
+
+        ++*received;
+    }
+
+    /* the release doesn't touch the error a failure raised */
+    for (; next < acquired; ++next) {
+        struct aws_io_message *message = datagram_handler->receive_messages[next];
+        aws_mem_release(message->allocator, message);
+    }
+
+    return result;
+}
+
+static void s_do_read(struct datagram_handler *datagram_handler) {
+    struct aws_channel_handler *handler = datagram_handler->slot->handler;
+    size_t datagrams_read = 0;
+    int error_code = AWS_ERROR_SUCCESS;
+
+    /* keeps receiving until the socket is drained, a batch that comes back short doesn't mean it is */
+    while (datagrams_read < datagram_handler->max_datagrams_per_read && !datagram_handler->shutdown_in_progress) {
+        /* a datagram can't be split, so only read as many as the window has room for at their biggest */
+        size_t batch_size =
+            aws_channel_slot_downstream_read_window(datagram_handler->slot) / datagram_handler->max_datagram_size;
+        if (!batch_size) {
+            AWS_LOGF_TRACE(
+                AWS_LS_IO_SOCKET_HANDLER,
+                "id=%p: downstream window is smaller than a datagram, waiting for it to open",
+                (void *)handler);
+            return;
+        }
+
+        batch_size = aws_min_size(batch_size, datagram_handler->max_datagrams_per_receive);
+        batch_size = aws_min_size(batch_size, datagram_handler->max_datagrams_per_read - datagrams_read);
+
+        size_t received = 0;
+        int result = s_receive_batch(datagram_handler, batch_size, &received);
+        datagrams_read += received;
+        if (result) {
+            error_code = aws_last_error();
+            break;
+        }
+    }
+
+    if (datagram_handler->shutdown_in_progress) {
+        return;
+    }
+
+    if (datagrams_read < datagram_handler->max_datagrams_per_read) {
+        if (error_code != AWS_IO_READ_WOULD_BLOCK) {
+            aws_channel_shutdown(datagram_handler->slot->channel, error_code);
+        }
+
+        return;
+    }
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: read %llu datagrams on this tick, scheduling a task to read more on the next one",
+        (void *)handler,
+        (unsigned long long)datagrams_read);
+    s_schedule_read(datagram_handler, "datagram_handler_re_read");
+}
+
+static void s_on_readable_notification(struct aws_socket *socket, int error_code, void *user_data) {
+    (void)socket;
+    struct datagram_handler *datagram_handler = user_data;
+
+    AWS_LOGF_TRACE(AWS_LS_IO_SOCKET_HANDLER, "id=%p: socket is now readable", (void *)datagram_handler->slot->handler);
+
+    s_do_read(datagram_handler);
+
+    if (error_code && !datagram_handler->shutdown_in_progress) {
+        aws_channel_shutdown(datagram_handler->slot->channel, error_code);
+    }
+}
+
+static void s_read_task(struct aws_channel_task *task, void *arg, aws_task_status status) {
+    task->task_fn = NULL;
+    task->arg = NULL;
+
+    if (status == AWS_TASK_STATUS_RUN_READY) {
+        s_do_read(arg);
+    }
+}
+
+static int s_datagram_increment_read_window(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    size_t size) {
+    (void)slot;
+    (void)size;
+
+    s_schedule_read(handler->impl, "datagram_handler_read_on_window_increment");
+    return AWS_OP_SUCCESS;
+}
+
+static void s_close_task(struct aws_channel_task *task, void *arg, aws_task_status status) {
+    (void)task;
+    (void)status;
+
+    struct datagram_handler *datagram_handler = arg;
+
+    /* run regardless of status, the channel can't finish shutting down otherwise */
+    aws_channel_slot_on_handler_shutdown_complete(
+        datagram_handler->slot, AWS_CHANNEL_DIR_WRITE, datagram_handler->shutdown_err_code, false);
+}
+
+static int s_datagram_shutdown(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    enum aws_channel_direction dir,
+    int error_code,
+    bool free_scarce_resource_immediately) {
+    struct datagram_handler *datagram_handler = handler->impl;
+
+    datagram_handler->shutdown_in_progress = true;
+    if (dir == AWS_CHANNEL_DIR_READ) {
+        AWS_LOGF_TRACE(
+            AWS_LS_IO_SOCKET_HANDLER,
+            "id=%p: shutting down read direction with error_code %d",
+            (void *)handler,
+            error_code);
+
+        if (free_scarce_resource_immediately && aws_socket_is_open(datagram_handler->socket)) {
+            if (aws_socket_close(datagram_handler->socket)) {
+                return AWS_OP_ERR;
+            }
+        }
+
+        return aws_channel_slot_on_handler_shutdown_complete(slot, dir, error_code, free_scarce_resource_immediately);
+    }
+
+    AWS_LOGF_TRACE(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: shutting down write direction with error_code %d",
+        (void *)handler,
+        error_code);
+
+    /* the held write messages get their chance to go out, closing the socket fails whatever it couldn't send yet */
+    s_flush_writes(datagram_handler);
+    if (aws_socket_is_open(datagram_handler->socket)) {
+        aws_socket_close(datagram_handler->socket);
+    }
+
+    /* completed from a task, in case a read task is still pending. */
+    aws_channel_task_init(
+        &datagram_handler->shutdown_task_storage, s_close_task, datagram_handler, "datagram_handler_close");
+    datagram_handler->shutdown_err_code = error_code;
+    aws_channel_schedule_task_now(slot->channel, &datagram_handler->shutdown_task_storage);
+    return AWS_OP_SUCCESS;
+}
+
+static size_t s_datagram_message_overhead(struct aws_channel_handler *handler) {
+    (void)handler;
+    return 0;
+}
+
+static size_t s_datagram_initial_window_size(struct aws_channel_handler *handler) {
+    (void)handler;
+    return SIZE_MAX;
+}
+
+static void s_datagram_destroy(struct aws_channel_handler *handler) {
+    struct datagram_handler *datagram_handler = handler->impl;
+    aws_crt_statistics_socket_cleanup(&datagram_handler->stats);
+    aws_mem_release(handler->alloc, handler);
+}
+
+static void s_datagram_reset_statistics(struct aws_channel_handler *handler) {
+    struct datagram_handler *datagram_handler = handler->impl;
+    aws_crt_statistics_socket_reset(&datagram_handler->stats);
+}
+
+static void s_datagram_gather_statistics(struct aws_channel_handler *handler, struct aws_array_list *stats_list) {
+    struct datagram_handler *datagram_handler = handler->impl;
+
+    struct aws_socket *socket = datagram_handler->socket;
+    if (socket->options.kernel_timestamps && aws_socket_is_open(socket)) {
+        datagram_handler->stats.has_kernel_timestamps =
+            aws_socket_get_kernel_timestamps(socket, &datagram_handler->stats.kernel_timestamps) == AWS_OP_SUCCESS;
+    }
+
+    void *stats_base = &datagram_handler->stats;
+    aws_array_list_push_back(stats_list, &stats_base);
+}
+
+static struct aws_channel_handler_vtable s_vtable = {
+    .process_read_message = s_datagram_process_read_message,
+    .destroy = s_datagram_destroy,
+    .process_write_message = s_datagram_process_write_message,
+    .initial_window_size = s_datagram_initial_window_size,
+    .increment_read_window = s_datagram_increment_read_window,
+    .shutdown = s_datagram_shutdown,
+    .message_overhead = s_datagram_message_overhead,
+    .reset_statistics = s_datagram_reset_statistics,
+    .gather_statistics = s_datagram_gather_statistics,
+};
+
+struct aws_channel_handler *aws_socket_datagram_handler_new(
+    struct aws_allocator *allocator,
+    struct aws_socket *socket,
+    struct aws_channel_slot *slot,
+    const struct aws_socket_datagram_handler_options *options) {
+
+    AWS_ASSERT(aws_socket_get_event_loop(socket));
+
+    if (socket->options.type != AWS_SOCKET_DGRAM) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET_HANDLER,
+            "static: datagram socket handlers need a DGRAM socket, socket %p isn't one",
+            (void *)socket);
+        aws_raise_error(AWS_IO_SOCKET_INVALID_OPERATION_FOR_TYPE);
+        return NULL;
+    }
+
+    size_t max_datagrams_per_read = options && options->max_datagrams_per_read ? options->max_datagrams_per_read
+                                                                                 : DEFAULT_MAX_DATAGRAMS_PER_READ;
+    size_t max_datagrams_per_receive = options && options->max_datagrams_per_receive
+                                           ? options->max_datagrams_per_receive
+                                           : DEFAULT_MAX_DATAGRAMS_PER_RECEIVE;
+    max_datagrams_per_receive = aws_min_size(max_datagrams_per_receive, max_datagrams_per_read);
+    size_t max_datagrams_per_send = options && options->max_datagrams_per_send ? options->max_datagrams_per_send
+                                                                               : DEFAULT_MAX_DATAGRAMS_PER_SEND;
+
+    struct aws_channel_handler *handler = NULL;
+    struct datagram_handler *impl = NULL;
+    struct aws_io_message **receive_messages = NULL;
+    struct aws_socket_datagram *receive_datagrams = NULL;
+    struct aws_socket_datagram *send_datagrams = NULL;
+
+    if (!aws_mem_acquire_many(
+            allocator,
+            5,
+            &handler,
+            sizeof(struct aws_channel_handler),
+            &impl,
+            sizeof(struct datagram_handler),
+            &receive_messages,
+            max_datagrams_per_receive * sizeof(struct aws_io_message *),
+            &receive_datagrams,
+            max_datagrams_per_receive * sizeof(struct aws_socket_datagram),
+            &send_datagrams,
+            max_datagrams_per_send * sizeof(struct aws_socket_datagram))) {
+        return NULL;
+    }
+
+    AWS_ZERO_STRUCT(*impl);
+    impl->socket = socket;
+    impl->slot = slot;
+
+    /* the datagram and its source address share a message from the channel's pool */
+    size_t max_datagram_size = g_aws_channel_max_fragment_size - ENDPOINT_RESERVE;
+    if (options && options->max_datagram_size && options->max_datagram_size < max_datagram_size) {
+        max_datagram_size = options->max_datagram_size;
+    }
+    impl->max_datagram_size = max_datagram_size;
+    impl->max_datagrams_per_read = max_datagrams_per_read;
+    impl->max_datagrams_per_receive = max_datagrams_per_receive;
+    impl->max_datagrams_per_send = max_datagrams_per_send;
+    impl->receive_messages = receive_messages;
+    impl->receive_datagrams = receive_datagrams;
+    impl->send_datagrams = send_datagrams;
+    aws_linked_list_init(&impl->pending_writes);
+
+    if (aws_crt_statistics_socket_init(&impl->stats)) {
+        goto cleanup_handler;
+    }
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET_HANDLER,
+        "id=%p: Datagram socket handler created with max_datagram_size of %llu, reading up to %llu per tick, "
+        "batches of %llu received and %llu sent",
+        (void *)handler,
+        (unsigned long long)impl->max_datagram_size,
+        (unsigned long long)impl->max_datagrams_per_read,
+        (unsigned long long)impl->max_datagrams_per_receive,
+        (unsigned long long)impl->max_datagrams_per_send);
+
+    handler->alloc = allocator;
+    handler->impl = impl;
+    handler->vtable = &s_vtable;
+    handler->slot = slot;
+    if (aws_socket_subscribe_to_readable_events(socket, s_on_readable_notification, impl)) {
+        aws_crt_statistics_socket_cleanup(&impl->stats);
+        goto cleanup_handler;
+    }
+
+    socket->handler = handler;
+
+    return handler;
+
+cleanup_handler:
+    aws_mem_release(allocator, handler);
+
+    return NULL;
+}
@@ -22,6 +22,13 @@ void aws_crt_statistics_socket_cleanup(struct aws_crt_statistics_socket *stats)
 void aws_crt_statistics_socket_reset(struct aws_crt_statistics_socket *stats) {
     stats->bytes_read = 0;
     stats->bytes_written = 0;
+    stats->has_transport_metrics = false;
+    AWS_ZERO_STRUCT(stats->transport_metrics);
+    stats->has_kernel_timestamps = false;
+    AWS_ZERO_STRUCT(stats->kernel_timestamps);
+    stats->read_budget_increases = 0;
+    stats->read_budget_decreases = 0;
+    stats->bytes_read_through_scratch = 0;
 }
 
 int aws_crt_statistics_tls_init(struct aws_crt_statistics_tls *stats) {
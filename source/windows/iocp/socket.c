@@ -473,6 +473,30 @@ int aws_socket_close(struct aws_socket *socket) {
     return socket_impl->vtable->close(socket);
 }
 
+int aws_socket_abort(struct aws_socket *socket) {
+    /* local sockets are named pipes on windows, there's no lingering to disable. */
+    if (socket->options.type == AWS_SOCKET_STREAM && socket->options.domain != AWS_SOCKET_LOCAL &&
+        socket->io_handle.data.handle != INVALID_HANDLE_VALUE) {
+        struct linger linger_option = {.l_onoff = 1, .l_linger = 0};
+        if (setsockopt(
+                (SOCKET)socket->io_handle.data.handle,
+                SOL_SOCKET,
+                SO_LINGER,
+                (char *)&linger_option,
+                sizeof(linger_option))) {
+            AWS_LOGF_WARN(
+                AWS_LS_IO_SOCKET,
+                "id=%p handle=%p: setsockopt() call for SO_LINGER failed with WSAError %d, the socket will be closed "
+                "gracefully.",
+                (void *)socket,
+                (void *)socket->io_handle.data.handle,
+                WSAGetLastError());
+        }
+    }
+
+    return aws_socket_close(socket);
+}
+
 int aws_socket_shutdown_dir(struct aws_socket *socket, enum aws_channel_direction dir) {
     int how = dir == AWS_CHANNEL_DIR_READ ? 0 : 1;
 
@@ -2219,6 +2243,15 @@ int aws_socket_set_options(struct aws_socket *socket, const struct aws_socket_op
         return aws_raise_error(AWS_IO_SOCKET_INVALID_OPTIONS);
     }
 
+    if (options->reuse_port) {
+        AWS_LOGF_ERROR(
+            AWS_LS_IO_SOCKET,
+            "id=%p handle=%p: SO_REUSEPORT is not supported on this platform.",
+            (void *)socket,
+            (void *)socket->io_handle.data.handle);
+        return aws_raise_error(AWS_IO_SOCKET_INVALID_OPTIONS);
+    }
+
     AWS_LOGF_DEBUG(
         AWS_LS_IO_SOCKET,
         "id=%p handle=%p: setting socket options to: keep-alive %d, keep idle %d, keep-alive interval %d, max failed "
@@ -2301,6 +2334,79 @@ int aws_socket_set_options(struct aws_socket *socket, const struct aws_socket_op
             }
         }
 #endif
+
+        if (socket->options.no_delay) {
+            int no_delay = 1;
+            if (setsockopt(
+                    (SOCKET)socket->io_handle.data.handle,
+                    IPPROTO_TCP,
+                    TCP_NODELAY,
+                    (char *)&no_delay,
+                    sizeof(no_delay))) {
+                AWS_LOGF_WARN(
+                    AWS_LS_IO_SOCKET,
+                    "id=%p handle=%p: setsockopt() call for enabling TCP_NODELAY failed with WSAError %d",
+                    (void *)socket,
+                    (void *)socket->io_handle.data.handle,
+                    WSAGetLastError());
+            }
+        }
+
+        if (socket->options.quick_ack || socket->options.cork_queued_writes || socket->options.type_of_service ||
+            socket->options.congestion_control[0] || socket->options.fast_open ||
+            socket->options.fast_open_queue_length || socket->options.notsent_low_watermark) {
+            AWS_LOGF_WARN(
+                AWS_LS_IO_SOCKET,
+                "id=%p handle=%p: quick-ack, write corking, type-of-service, congestion control, fast open and "
+                "not-sent low watermark options are not supported on this platform, ignoring them.",
+                (void *)socket,
+                (void *)socket->io_handle.data.handle);
+        }
+    }
+
+    /* local sockets are named pipes on windows, they don't have socket buffers. */
+    if (socket->options.domain != AWS_SOCKET_LOCAL) {
+        if (socket->options.send_buffer_size) {
+            int send_buffer_size = (int)socket->options.send_buffer_size;
+            if (setsockopt(
+                    (SOCKET)socket->io_handle.data.handle,
+                    SOL_SOCKET,
+                    SO_SNDBUF,
+                    (char *)&send_buffer_size,
+                    sizeof(send_buffer_size))) {
+                AWS_LOGF_WARN(
+                    AWS_LS_IO_SOCKET,
+                    "id=%p handle=%p: setsockopt() call for setting SO_SNDBUF failed with WSAError %d",
+                    (void *)socket,
+                    (void *)socket->io_handle.data.handle,
+                    WSAGetLastError());
+            }
+        }
+
+        if (socket->options.receive_buffer_size) {
+            int receive_buffer_size = (int)socket->options.receive_buffer_size;
+            if (setsockopt(
+                    (SOCKET)socket->io_handle.data.handle,
+                    SOL_SOCKET,
+                    SO_RCVBUF,
+                    (char *)&receive_buffer_size,
+                    sizeof(receive_buffer_size))) {
+                AWS_LOGF_WARN(
+                    AWS_LS_IO_SOCKET,
+                    "id=%p handle=%p: setsockopt() call for setting SO_RCVBUF failed with WSAError %d",
+                    (void *)socket,
+                    (void *)socket->io_handle.data.handle,
+                    WSAGetLastError());
+            }
+        }
+    }
+
+    if (socket->options.busy_poll_usec) {
+        AWS_LOGF_WARN(
+            AWS_LS_IO_SOCKET,
+            "id=%p handle=%p: busy polling is not supported on this platform, ignoring it.",
+            (void *)socket,
+            (void *)socket->io_handle.data.handle);
     }
 
     return AWS_OP_SUCCESS;
@@ -3180,6 +3286,193 @@ int aws_socket_write(
     return AWS_OP_SUCCESS;
 }
 
+int aws_socket_write_file(
+    struct aws_socket *socket,
+    int fd,
+    uint64_t offset,
+    size_t length,
+    aws_socket_on_write_completed_fn *written_fn,
+    void *user_data) {
+    (void)fd;
+    (void)offset;
+    (void)length;
+    (void)written_fn;
+    (void)user_data;
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p handle=%p: file writes are not supported on this platform",
+        (void *)socket,
+        (void *)socket->io_handle.data.handle);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_socket_write_from_pipe(
+    struct aws_socket *socket,
+    int pipe_fd,
+    size_t length,
+    aws_socket_on_write_completed_fn *written_fn,
+    void *user_data) {
+    (void)pipe_fd;
+    (void)length;
+    (void)written_fn;
+    (void)user_data;
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p handle=%p: pipe writes are not supported on this platform",
+        (void *)socket,
+        (void *)socket->io_handle.data.handle);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_socket_read_to_pipe(struct aws_socket *socket, int pipe_fd, size_t max_len, size_t *amount_read) {
+    (void)pipe_fd;
+    (void)max_len;
+    (void)amount_read;
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p handle=%p: reads into a pipe are not supported on this platform",
+        (void *)socket,
+        (void *)socket->io_handle.data.handle);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_socket_read_to_file(
+    struct aws_socket *socket,
+    int fd,
+    uint64_t offset,
+    size_t max_len,
+    size_t *amount_read) {
+    (void)fd;
+    (void)offset;
+    (void)max_len;
+    (void)amount_read;
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p handle=%p: reads into a file are not supported on this platform",
+        (void *)socket,
+        (void *)socket->io_handle.data.handle);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_socket_get_transport_metrics(struct aws_socket *socket, struct aws_socket_transport_metrics *metrics) {
+    AWS_ZERO_STRUCT(*metrics);
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p handle=%p: transport metrics are not supported on this platform",
+        (void *)socket,
+        (void *)socket->io_handle.data.handle);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_socket_get_kernel_timestamps(struct aws_socket *socket, struct aws_socket_kernel_timestamps *timestamps) {
+    AWS_ZERO_STRUCT(*timestamps);
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p handle=%p: kernel timestamps are not supported on this platform",
+        (void *)socket,
+        (void *)socket->io_handle.data.handle);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_socket_bind_for_connect(struct aws_socket *socket, const struct aws_socket_endpoint *local_endpoint) {
+    (void)local_endpoint;
+
+    /* ConnectEx() needs the socket bound, so aws_socket_connect() binds it itself */
+    AWS_LOGF_ERROR(
+        AWS_LS_IO_SOCKET,
+        "id=%p handle=%p: binding before connect is not supported on this platform",
+        (void *)socket,
+        (void *)socket->io_handle.data.handle);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_socket_get_incoming_cpu(struct aws_socket *socket, int *cpu_id) {
+    (void)cpu_id;
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_IO_SOCKET,
+        "id=%p handle=%p: SO_INCOMING_CPU is not supported on this platform",
+        (void *)socket,
+        (void *)socket->io_handle.data.handle);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_socket_receive_from(
+    struct aws_socket *socket,
+    struct aws_byte_buf *buffer,
+    struct aws_socket_endpoint *source,
+    size_t *amount_read) {
+    (void)buffer;
+    (void)source;
+    (void)amount_read;
+
+    AWS_LOGF_ERROR(
+        AWS_LS_IO_SOCKET,
+        "id=%p handle=%p: datagram receives are not supported on this platform",
+        (void *)socket,
+        (void *)socket->io_handle.data.handle);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_socket_send_to(
+    struct aws_socket *socket,
+    const struct aws_byte_cursor *cursor,
+    const struct aws_socket_endpoint *destination,
+    aws_socket_on_write_completed_fn *written_fn,
+    void *user_data) {
+    (void)cursor;
+    (void)destination;
+    (void)written_fn;
+    (void)user_data;
+
+    AWS_LOGF_ERROR(
+        AWS_LS_IO_SOCKET,
+        "id=%p handle=%p: datagram sends are not supported on this platform",
+        (void *)socket,
+        (void *)socket->io_handle.data.handle);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_socket_receive_batch(
+    struct aws_socket *socket,
+    struct aws_socket_datagram *datagrams,
+    size_t count,
+    size_t *datagrams_read) {
+    (void)datagrams;
+    (void)count;
+    *datagrams_read = 0;
+
+    AWS_LOGF_ERROR(
+        AWS_LS_IO_SOCKET,
+        "id=%p handle=%p: datagram receives are not supported on this platform",
+        (void *)socket,
+        (void *)socket->io_handle.data.handle);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_socket_send_batch(
+    struct aws_socket *socket,
+    const struct aws_socket_datagram *datagrams,
+    size_t count,
+    aws_socket_on_write_completed_fn *written_fn) {
+    (void)datagrams;
+    (void)count;
+    (void)written_fn;
+
+    AWS_LOGF_ERROR(
+        AWS_LS_IO_SOCKET,
+        "id=%p handle=%p: datagram sends are not supported on this platform",
+        (void *)socket,
+        (void *)socket->io_handle.data.handle);
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
 int aws_socket_get_error(struct aws_socket *socket) {
     if (socket->options.domain != AWS_SOCKET_LOCAL) {
         int connect_result;
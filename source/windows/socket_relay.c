@@ -0,0 +1,27 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/io/socket_relay.h>
+
+#include <aws/io/logging.h>
+
+struct aws_socket_relay *aws_socket_relay_new(
+    struct aws_allocator *allocator,
+    const struct aws_socket_relay_options *options) {
+    (void)allocator;
+    (void)options;
+
+    AWS_LOGF_ERROR(AWS_LS_IO_SOCKET, "static: socket relays are not supported on this platform");
+    aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    return NULL;
+}
+
+void aws_socket_relay_shutdown(struct aws_socket_relay *relay) {
+    (void)relay;
+}
+
+void aws_socket_relay_release(struct aws_socket_relay *relay) {
+    (void)relay;
+}
@@ -11,6 +11,7 @@
 #include <aws/io/channel.h>
 #include <aws/io/channel_bootstrap.h>
 #include <aws/io/event_loop.h>
+#include <aws/io/message_pool.h>
 #include <aws/io/socket.h>
 #include <aws/testing/aws_test_harness.h>
 
@@ -588,6 +589,344 @@ static int s_test_channel_duplicate_shutdown(struct aws_allocator *allocator, vo
 
 AWS_TEST_CASE(channel_duplicate_shutdown, s_test_channel_duplicate_shutdown)
 
+static int s_test_channel_trim_event_loop_resources(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    struct aws_event_loop *event_loop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+
+    ASSERT_NOT_NULL(event_loop, "Event loop creation failed with error: %s", aws_error_debug_str(aws_last_error()));
+    ASSERT_SUCCESS(aws_event_loop_run(event_loop));
+
+    struct aws_channel *channel = NULL;
+
+    struct channel_setup_test_args test_args = {
+        .error_code = 0,
+        .mutex = AWS_MUTEX_INIT,
+        .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+        .setup_completed = false,
+        .shutdown_completed = false,
+    };
+
+    struct aws_channel_options args = {
+        .on_setup_completed = s_channel_setup_test_on_setup_completed,
+        .setup_user_data = &test_args,
+        .on_shutdown_completed = s_channel_test_shutdown,
+        .shutdown_user_data = &test_args,
+        .event_loop = event_loop,
+    };
+
+    ASSERT_SUCCESS(s_channel_setup_create_and_wait(allocator, &args, &test_args, &channel));
+
+    struct aws_channel_slot *slot = aws_channel_slot_new(channel);
+    ASSERT_NOT_NULL(slot);
+    struct aws_channel_handler *handler = rw_handler_new(allocator, NULL, NULL, false, 10000, NULL);
+    ASSERT_SUCCESS(aws_channel_slot_set_handler(slot, handler));
+
+    /* a one-off trim, as a memory-pressure signal would request */
+    ASSERT_SUCCESS(aws_channel_trim_event_loop_resources(event_loop, NULL));
+    while (rw_handler_trim_count(handler) < 1) {
+        ; /* block until trimmed */
+    }
+
+    /* the periodic trimmer keeps trimming until it is disabled */
+    struct aws_channel_trim_options trim_options = {
+        .interval_ms = 10,
+    };
+    ASSERT_SUCCESS(aws_channel_trim_event_loop_resources(event_loop, &trim_options));
+    while (rw_handler_trim_count(handler) < 3) {
+        ; /* block until trimmed a few more times */
+    }
+
+    trim_options.interval_ms = 0;
+    ASSERT_SUCCESS(aws_channel_trim_event_loop_resources(event_loop, &trim_options));
+
+    ASSERT_SUCCESS(aws_channel_shutdown(channel, AWS_ERROR_SUCCESS));
+    ASSERT_SUCCESS(aws_mutex_lock(&test_args.mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &test_args.condition_variable, &test_args.mutex, s_channel_test_shutdown_predicate, &test_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&test_args.mutex));
+
+    aws_channel_destroy(channel);
+    aws_event_loop_destroy(event_loop);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(channel_trim_event_loop_resources, s_test_channel_trim_event_loop_resources)
+
+static int s_test_message_pool_trim_and_prewarm(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_message_pool_creation_args creation_args = {
+        .application_data_msg_data_size = 1024,
+        .application_data_msg_count = 4,
+        .small_block_msg_count = 2,
+        .small_block_msg_data_size = 128,
+    };
+
+    struct aws_message_pool msg_pool;
+    ASSERT_SUCCESS(aws_message_pool_init(&msg_pool, allocator, &creation_args));
+    ASSERT_UINT_EQUALS(4, aws_array_list_length(&msg_pool.application_data_pool.stack));
+    ASSERT_UINT_EQUALS(2, aws_array_list_length(&msg_pool.small_block_pool.stack));
+
+    struct aws_io_message *message = aws_message_pool_acquire(&msg_pool, AWS_IO_MESSAGE_APPLICATION_DATA, 1024);
+    ASSERT_NOT_NULL(message);
+
+    size_t expected_freed =
+        3 * msg_pool.application_data_pool.segment_size + 2 * msg_pool.small_block_pool.segment_size;
+    ASSERT_UINT_EQUALS(expected_freed, aws_message_pool_trim(&msg_pool));
+    ASSERT_UINT_EQUALS(0, aws_array_list_length(&msg_pool.application_data_pool.stack));
+    ASSERT_UINT_EQUALS(0, aws_array_list_length(&msg_pool.small_block_pool.stack));
+
+    /* messages in use are unaffected by trimming and return to the pool as usual */
+    aws_mem_release(message->allocator, message);
+    ASSERT_UINT_EQUALS(1, aws_array_list_length(&msg_pool.application_data_pool.stack));
+
+    ASSERT_SUCCESS(aws_message_pool_prewarm(&msg_pool));
+    ASSERT_UINT_EQUALS(4, aws_array_list_length(&msg_pool.application_data_pool.stack));
+    ASSERT_UINT_EQUALS(2, aws_array_list_length(&msg_pool.small_block_pool.stack));
+
+    aws_message_pool_clean_up(&msg_pool);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(message_pool_trim_and_prewarm, s_test_message_pool_trim_and_prewarm)
+
+struct channel_prewarm_test_args {
+    struct aws_mutex mutex;
+    struct aws_condition_variable condition_variable;
+    bool prewarm_completed; /* protected by mutex */
+    int error_code;         /* protected by mutex */
+};
+
+static void s_channel_test_on_prewarmed(struct aws_event_loop *event_loop, int error_code, void *user_data) {
+    (void)event_loop;
+    struct channel_prewarm_test_args *prewarm_args = user_data;
+
+    aws_mutex_lock(&prewarm_args->mutex);
+    prewarm_args->error_code = error_code;
+    prewarm_args->prewarm_completed = true;
+    aws_mutex_unlock(&prewarm_args->mutex);
+    aws_condition_variable_notify_one(&prewarm_args->condition_variable);
+}
+
+static bool s_channel_test_prewarm_predicate(void *arg) {
+    struct channel_prewarm_test_args *prewarm_args = arg;
+    return prewarm_args->prewarm_completed;
+}
+
+/* sets a channel up on a new loop, pre-warmed or not, and reports how much its setup allocated through the channel's
+ * allocator. The loop's shared message pool comes out of that allocator if the channel has to create it. */
+static int s_channel_prewarm_test_setup_bytes(struct aws_allocator *allocator, bool prewarm, size_t *setup_bytes) {
+    struct aws_event_loop *event_loop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+
+    ASSERT_NOT_NULL(event_loop, "Event loop creation failed with error: %s", aws_error_debug_str(aws_last_error()));
+    ASSERT_SUCCESS(aws_event_loop_run(event_loop));
+
+    if (prewarm) {
+        struct channel_prewarm_test_args prewarm_args = {
+            .mutex = AWS_MUTEX_INIT,
+            .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+            .prewarm_completed = false,
+            .error_code = 0,
+        };
+
+        ASSERT_SUCCESS(aws_channel_prewarm_event_loop(event_loop, s_channel_test_on_prewarmed, &prewarm_args));
+        ASSERT_SUCCESS(aws_mutex_lock(&prewarm_args.mutex));
+        ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+            &prewarm_args.condition_variable, &prewarm_args.mutex, s_channel_test_prewarm_predicate, &prewarm_args));
+        ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, prewarm_args.error_code);
+        ASSERT_SUCCESS(aws_mutex_unlock(&prewarm_args.mutex));
+    }
+
+    struct aws_allocator *tracer = aws_mem_tracer_new(allocator, NULL, AWS_MEMTRACE_BYTES, 0);
+    ASSERT_NOT_NULL(tracer);
+
+    struct aws_channel *channel = NULL;
+
+    struct channel_setup_test_args test_args = {
+        .error_code = 0,
+        .mutex = AWS_MUTEX_INIT,
+        .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+        .setup_completed = false,
+        .shutdown_completed = false,
+    };
+
+    struct aws_channel_options args = {
+        .on_setup_completed = s_channel_setup_test_on_setup_completed,
+        .setup_user_data = &test_args,
+        .on_shutdown_completed = NULL,
+        .shutdown_user_data = NULL,
+        .event_loop = event_loop,
+    };
+
+    ASSERT_SUCCESS(s_channel_setup_create_and_wait(tracer, &args, &test_args, &channel));
+    *setup_bytes = aws_mem_tracer_bytes(tracer);
+
+    /* the loop frees a pool the channel created, so the tracer has to outlive it */
+    aws_channel_destroy(channel);
+    aws_event_loop_destroy(event_loop);
+    aws_mem_tracer_destroy(tracer);
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_test_channel_prewarm_event_loop(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    size_t cold_bytes = 0;
+    ASSERT_SUCCESS(s_channel_prewarm_test_setup_bytes(allocator, false, &cold_bytes));
+
+    size_t prewarmed_bytes = 0;
+    ASSERT_SUCCESS(s_channel_prewarm_test_setup_bytes(allocator, true, &prewarmed_bytes));
+
+    /* a channel on a cold loop creates the message pool, one on a pre-warmed loop uses the pool that's there */
+    ASSERT_TRUE(cold_bytes >= g_aws_channel_max_fragment_size);
+    ASSERT_TRUE(prewarmed_bytes < g_aws_channel_max_fragment_size);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(channel_prewarm_event_loop, s_test_channel_prewarm_event_loop)
+
+static struct aws_atomic_var s_statistics_test_time_ns;
+
+static int s_statistics_test_clock_fn(uint64_t *timestamp) {
+    *timestamp = aws_atomic_load_int(&s_statistics_test_time_ns);
+    return AWS_OP_SUCCESS;
+}
+
+struct channel_statistics_test_impl {
+    struct aws_atomic_var report_count;
+    struct aws_atomic_var last_end_time_ms;
+};
+
+static void s_channel_statistics_test_process(
+    struct aws_crt_statistics_handler *handler,
+    struct aws_crt_statistics_sample_interval *interval,
+    struct aws_array_list *stats_list,
+    void *context) {
+    (void)stats_list;
+    (void)context;
+
+    struct channel_statistics_test_impl *impl = handler->impl;
+    aws_atomic_store_int(&impl->last_end_time_ms, (size_t)interval->end_time_ms);
+    aws_atomic_fetch_add(&impl->report_count, 1);
+}
+
+static void s_channel_statistics_test_destroy(struct aws_crt_statistics_handler *handler) {
+    aws_mem_release(handler->allocator, handler);
+}
+
+static uint64_t s_channel_statistics_test_interval_ms(struct aws_crt_statistics_handler *handler) {
+    (void)handler;
+    return 100;
+}
+
+static struct aws_crt_statistics_handler_vtable s_channel_statistics_test_vtable = {
+    .process_statistics = s_channel_statistics_test_process,
+    .destroy = s_channel_statistics_test_destroy,
+    .get_report_interval_ms = s_channel_statistics_test_interval_ms,
+};
+
+static struct aws_crt_statistics_handler *s_channel_statistics_test_handler_new(
+    struct aws_allocator *allocator,
+    struct channel_statistics_test_impl *impl) {
+
+    struct aws_crt_statistics_handler *handler =
+        aws_mem_calloc(allocator, 1, sizeof(struct aws_crt_statistics_handler));
+    if (handler) {
+        handler->vtable = &s_channel_statistics_test_vtable;
+        handler->allocator = allocator;
+        handler->impl = impl;
+    }
+
+    return handler;
+}
+
+struct channel_statistics_test_args {
+    struct aws_allocator *allocator;
+    struct aws_channel *channels[2];
+    struct channel_statistics_test_impl impls[2];
+    struct aws_atomic_var handlers_set;
+};
+
+static void s_set_statistics_handlers_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct channel_statistics_test_args *stats_args = arg;
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(stats_args->channels); ++i) {
+        aws_channel_set_statistics_handler(
+            stats_args->channels[i],
+            s_channel_statistics_test_handler_new(stats_args->allocator, &stats_args->impls[i]));
+    }
+
+    aws_atomic_store_int(&stats_args->handlers_set, 1);
+}
+
+static int s_test_channel_statistics_shared_loop_task(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_atomic_store_int(&s_statistics_test_time_ns, 0);
+    struct aws_event_loop *event_loop = aws_event_loop_new_default(allocator, s_statistics_test_clock_fn);
+
+    ASSERT_NOT_NULL(event_loop, "Event loop creation failed with error: %s", aws_error_debug_str(aws_last_error()));
+    ASSERT_SUCCESS(aws_event_loop_run(event_loop));
+
+    struct channel_setup_test_args test_args = {
+        .error_code = 0,
+        .mutex = AWS_MUTEX_INIT,
+        .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+        .setup_completed = false,
+        .shutdown_completed = false,
+    };
+
+    struct aws_channel_options args = {
+        .on_setup_completed = s_channel_setup_test_on_setup_completed,
+        .setup_user_data = &test_args,
+        .on_shutdown_completed = NULL,
+        .shutdown_user_data = NULL,
+        .event_loop = event_loop,
+    };
+
+    struct channel_statistics_test_args stats_args;
+    AWS_ZERO_STRUCT(stats_args);
+    stats_args.allocator = allocator;
+
+    ASSERT_SUCCESS(s_channel_setup_create_and_wait(allocator, &args, &test_args, &stats_args.channels[0]));
+    test_args.setup_completed = false;
+    ASSERT_SUCCESS(s_channel_setup_create_and_wait(allocator, &args, &test_args, &stats_args.channels[1]));
+
+    struct aws_task set_handlers_task;
+    aws_task_init(&set_handlers_task, s_set_statistics_handlers_task, &stats_args, "set_statistics_handlers");
+    aws_event_loop_schedule_task_now(event_loop, &set_handlers_task);
+    while (!aws_atomic_load_int(&stats_args.handlers_set)) {
+        ; /* block until signaled */
+    }
+
+    /* both channels are due at the same aligned report time and are sampled by the same run of the loop's task */
+    uint64_t report_time_ns = aws_timestamp_convert(100, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL);
+    aws_atomic_store_int(&s_statistics_test_time_ns, (size_t)report_time_ns);
+    while (aws_atomic_load_int(&stats_args.impls[0].report_count) < 1 ||
+           aws_atomic_load_int(&stats_args.impls[1].report_count) < 1) {
+        ; /* block until both channels reported */
+    }
+
+    ASSERT_UINT_EQUALS(100, aws_atomic_load_int(&stats_args.impls[0].last_end_time_ms));
+    ASSERT_UINT_EQUALS(100, aws_atomic_load_int(&stats_args.impls[1].last_end_time_ms));
+
+    aws_channel_destroy(stats_args.channels[0]);
+    aws_channel_destroy(stats_args.channels[1]);
+    aws_event_loop_destroy(event_loop);
+
+    ASSERT_UINT_EQUALS(1, aws_atomic_load_int(&stats_args.impls[0].report_count));
+    ASSERT_UINT_EQUALS(1, aws_atomic_load_int(&stats_args.impls[1].report_count));
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(channel_statistics_shared_loop_task, s_test_channel_statistics_shared_loop_task)
+
 struct channel_connect_test_args {
     struct aws_mutex *mutex;
     struct aws_condition_variable cv;
@@ -811,3 +1150,137 @@ static int s_test_channel_connect_some_hosts_timeout(struct aws_allocator *alloc
 }
 
 AWS_TEST_CASE(channel_connect_some_hosts_timeout, s_test_channel_connect_some_hosts_timeout);
+
+#define BULK_SHUTDOWN_TEST_CHANNEL_COUNT 3
+
+struct bulk_shutdown_test_args {
+    struct aws_event_loop *event_loop;
+    struct aws_channel_bulk_shutdown_options options;
+    struct aws_channel *channels[BULK_SHUTDOWN_TEST_CHANNEL_COUNT];
+    struct aws_channel_handler *handlers[BULK_SHUTDOWN_TEST_CHANNEL_COUNT];
+    struct aws_task start_task;
+    struct aws_task probe_task;
+    struct aws_mutex mutex;
+    struct aws_condition_variable condition_variable;
+    size_t shutdowns_seen_by_probe;
+    bool shutdown_seen_as_abortive;
+    bool probe_ran;
+};
+
+static bool s_bulk_shutdown_probe_ran_predicate(void *arg) {
+    struct bulk_shutdown_test_args *test_args = arg;
+    return test_args->probe_ran;
+}
+
+/* runs right behind the first run of the bulk shutdown request, so it sees how many channels one batch started */
+static void s_bulk_shutdown_probe_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct bulk_shutdown_test_args *test_args = arg;
+
+    size_t shutdowns = 0;
+    bool abortive = false;
+    for (size_t i = 0; i < BULK_SHUTDOWN_TEST_CHANNEL_COUNT; ++i) {
+        if (rw_handler_shutdown_called(test_args->handlers[i])) {
+            ++shutdowns;
+            abortive = aws_channel_is_shutdown_abortive(test_args->channels[i]);
+        }
+    }
+
+    aws_mutex_lock(&test_args->mutex);
+    test_args->shutdowns_seen_by_probe = shutdowns;
+    test_args->shutdown_seen_as_abortive = abortive;
+    test_args->probe_ran = true;
+    aws_condition_variable_notify_one(&test_args->condition_variable);
+    aws_mutex_unlock(&test_args->mutex);
+}
+
+static void s_bulk_shutdown_start_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct bulk_shutdown_test_args *test_args = arg;
+
+    /* both land in the loop's scheduler in order, so the probe runs before the request's continuation */
+    aws_channel_shutdown_event_loop_channels(test_args->event_loop, &test_args->options);
+    aws_event_loop_schedule_task_now(test_args->event_loop, &test_args->probe_task);
+}
+
+static int s_test_channel_bulk_shutdown(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    struct aws_event_loop *event_loop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+
+    ASSERT_NOT_NULL(event_loop, "Event loop creation failed with error: %s", aws_error_debug_str(aws_last_error()));
+    ASSERT_SUCCESS(aws_event_loop_run(event_loop));
+
+    struct bulk_shutdown_test_args bulk_args = {
+        .event_loop = event_loop,
+        /* a batch size of 1 makes the request continue across several loop tasks */
+        .options =
+            {
+                .error_code = AWS_IO_EVENT_LOOP_SHUTDOWN,
+                .abortive = true,
+                .batch_size = 1,
+            },
+        .mutex = AWS_MUTEX_INIT,
+        .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+    };
+    aws_task_init(&bulk_args.start_task, s_bulk_shutdown_start_task, &bulk_args, "bulk_shutdown_test_start");
+    aws_task_init(&bulk_args.probe_task, s_bulk_shutdown_probe_task, &bulk_args, "bulk_shutdown_test_probe");
+
+    struct channel_setup_test_args test_args[BULK_SHUTDOWN_TEST_CHANNEL_COUNT];
+
+    for (size_t i = 0; i < BULK_SHUTDOWN_TEST_CHANNEL_COUNT; ++i) {
+        struct channel_setup_test_args *channel_test_args = &test_args[i];
+        struct aws_mutex mutex = AWS_MUTEX_INIT;
+        struct aws_condition_variable condition_variable = AWS_CONDITION_VARIABLE_INIT;
+        AWS_ZERO_STRUCT(*channel_test_args);
+        channel_test_args->mutex = mutex;
+        channel_test_args->condition_variable = condition_variable;
+
+        struct aws_channel_options args = {
+            .on_setup_completed = s_channel_setup_test_on_setup_completed,
+            .setup_user_data = channel_test_args,
+            .on_shutdown_completed = s_channel_test_shutdown,
+            .shutdown_user_data = channel_test_args,
+            .event_loop = event_loop,
+        };
+
+        ASSERT_SUCCESS(s_channel_setup_create_and_wait(allocator, &args, channel_test_args, &bulk_args.channels[i]));
+
+        struct aws_channel_slot *slot = aws_channel_slot_new(bulk_args.channels[i]);
+        ASSERT_NOT_NULL(slot);
+        bulk_args.handlers[i] = rw_handler_new(allocator, NULL, NULL, false, 10000, NULL);
+        ASSERT_SUCCESS(aws_channel_slot_set_handler(slot, bulk_args.handlers[i]));
+    }
+
+    aws_event_loop_schedule_task_now(event_loop, &bulk_args.start_task);
+
+    ASSERT_SUCCESS(aws_mutex_lock(&bulk_args.mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &bulk_args.condition_variable, &bulk_args.mutex, s_bulk_shutdown_probe_ran_predicate, &bulk_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&bulk_args.mutex));
+
+    /* the first batch started exactly one channel's shutdown, and started it abortively */
+    ASSERT_UINT_EQUALS(1, bulk_args.shutdowns_seen_by_probe);
+    ASSERT_TRUE(bulk_args.shutdown_seen_as_abortive);
+
+    for (size_t i = 0; i < BULK_SHUTDOWN_TEST_CHANNEL_COUNT; ++i) {
+        ASSERT_SUCCESS(aws_mutex_lock(&test_args[i].mutex));
+        ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+            &test_args[i].condition_variable, &test_args[i].mutex, s_channel_test_shutdown_predicate, &test_args[i]));
+        ASSERT_SUCCESS(aws_mutex_unlock(&test_args[i].mutex));
+        ASSERT_TRUE(rw_handler_shutdown_called(bulk_args.handlers[i]));
+    }
+
+    /* the channels are already shut down, so shutting them down again is a no-op */
+    ASSERT_SUCCESS(aws_channel_shutdown_event_loop_channels(event_loop, &bulk_args.options));
+
+    for (size_t i = 0; i < BULK_SHUTDOWN_TEST_CHANNEL_COUNT; ++i) {
+        aws_channel_destroy(bulk_args.channels[i]);
+    }
+    aws_event_loop_destroy(event_loop);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(channel_bulk_shutdown, s_test_channel_bulk_shutdown)
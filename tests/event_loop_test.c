@@ -13,6 +13,10 @@
 #include <aws/common/thread.h>
 #include <aws/testing/aws_test_harness.h>
 
+#ifdef __linux__
+#    include <sched.h>
+#endif
+
 struct task_args {
     bool invoked;
     bool was_in_thread;
@@ -1026,6 +1030,59 @@ static int s_event_loop_test_multiple_stops(struct aws_allocator *allocator, voi
 
 AWS_TEST_CASE(event_loop_multiple_stops, s_event_loop_test_multiple_stops)
 
+/*
+ * Test that busy-poll registrations are counted, that the loop spins for the largest registered time until the last
+ * registration is dropped, and that tasks scheduled from another thread still run while it spins.
+ */
+static int s_event_loop_test_busy_poll(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_event_loop *event_loop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+
+    ASSERT_NOT_NULL(event_loop, "Event loop creation failed with error: %s", aws_error_debug_str(aws_last_error()));
+    ASSERT_SUCCESS(aws_event_loop_run(event_loop));
+    ASSERT_UINT_EQUALS(0, aws_event_loop_get_busy_poll_usec(event_loop));
+
+    aws_event_loop_register_busy_poll(event_loop, 50);
+    aws_event_loop_register_busy_poll(event_loop, 200);
+    ASSERT_UINT_EQUALS(200, aws_event_loop_get_busy_poll_usec(event_loop));
+
+    struct task_args task_args = {
+        .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+        .mutex = AWS_MUTEX_INIT,
+        .invoked = false,
+        .was_in_thread = false,
+        .status = -1,
+        .loop = event_loop,
+        .thread_id = 0,
+    };
+
+    struct aws_task task;
+    aws_task_init(&task, s_test_task, &task_args, "busy_poll_task");
+
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_SUCCESS(aws_mutex_lock(&task_args.mutex));
+        task_args.invoked = false;
+        aws_event_loop_schedule_task_now(event_loop, &task);
+        ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+            &task_args.condition_variable, &task_args.mutex, s_task_ran_predicate, &task_args));
+        ASSERT_TRUE(task_args.was_in_thread);
+        ASSERT_INT_EQUALS(AWS_TASK_STATUS_RUN_READY, task_args.status);
+        ASSERT_SUCCESS(aws_mutex_unlock(&task_args.mutex));
+    }
+
+    aws_event_loop_unregister_busy_poll(event_loop);
+    ASSERT_UINT_EQUALS(200, aws_event_loop_get_busy_poll_usec(event_loop));
+    aws_event_loop_unregister_busy_poll(event_loop);
+    ASSERT_UINT_EQUALS(0, aws_event_loop_get_busy_poll_usec(event_loop));
+
+    aws_event_loop_destroy(event_loop);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(event_loop_busy_poll, s_event_loop_test_busy_poll)
+
 static int test_event_loop_group_setup_and_shutdown(struct aws_allocator *allocator, void *ctx) {
 
     (void)ctx;
@@ -1064,6 +1121,80 @@ static int test_event_loop_group_setup_and_shutdown(struct aws_allocator *alloca
 
 AWS_TEST_CASE(event_loop_group_setup_and_shutdown, test_event_loop_group_setup_and_shutdown)
 
+static int test_event_loop_group_pinned_to_cpus(struct aws_allocator *allocator, void *ctx) {
+
+    (void)ctx;
+    aws_io_library_init(allocator);
+
+    struct aws_event_loop_group *event_loop_group = aws_event_loop_group_new_default_pinned_to_cpus(allocator, 0, NULL);
+#ifndef __linux__
+    ASSERT_NULL(event_loop_group);
+    ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error());
+#else
+    ASSERT_NOT_NULL(event_loop_group);
+
+    /* loops can only be pinned to CPUs the process may run on, the others are left unpinned */
+    cpu_set_t allowed_cpus;
+    CPU_ZERO(&allowed_cpus);
+    ASSERT_SUCCESS(sched_getaffinity(0, sizeof(allowed_cpus), &allowed_cpus));
+
+    size_t cpu_count = aws_system_info_processor_count();
+    ASSERT_INT_EQUALS(cpu_count, aws_event_loop_group_get_loop_count(event_loop_group));
+
+    struct aws_event_loop *last_pinned_loop = NULL;
+    for (size_t i = 0; i < cpu_count; ++i) {
+        struct aws_event_loop *event_loop = aws_event_loop_group_get_loop_at(event_loop_group, i);
+        if (!CPU_ISSET(i, &allowed_cpus)) {
+            ASSERT_INT_EQUALS(-1, event_loop->cpu_id);
+            continue;
+        }
+
+        ASSERT_INT_EQUALS((int)i, event_loop->cpu_id);
+        ASSERT_PTR_EQUALS(event_loop, aws_event_loop_group_get_loop_for_cpu(event_loop_group, (int)i));
+        last_pinned_loop = event_loop;
+    }
+
+    /* CPUs without a loop of their own map to the closest one */
+    ASSERT_NOT_NULL(last_pinned_loop);
+    ASSERT_PTR_EQUALS(last_pinned_loop, aws_event_loop_group_get_loop_for_cpu(event_loop_group, (int)cpu_count + 3));
+    int cpu_id = last_pinned_loop->cpu_id;
+
+    aws_event_loop_group_release(event_loop_group);
+
+    /* with more loops than CPUs, the loops on the same CPU take turns */
+    event_loop_group = aws_event_loop_group_new_default_pinned_to_cpus(allocator, (uint16_t)(2 * cpu_count), NULL);
+    ASSERT_NOT_NULL(event_loop_group);
+
+    struct aws_event_loop *first_loop = aws_event_loop_group_get_loop_at(event_loop_group, (size_t)cpu_id);
+    struct aws_event_loop *second_loop = aws_event_loop_group_get_loop_at(event_loop_group, cpu_id + cpu_count);
+    ASSERT_INT_EQUALS(cpu_id, first_loop->cpu_id);
+    ASSERT_INT_EQUALS(cpu_id, second_loop->cpu_id);
+
+    struct aws_event_loop *picked_loop = aws_event_loop_group_get_loop_for_cpu(event_loop_group, cpu_id);
+    ASSERT_TRUE(picked_loop == first_loop || picked_loop == second_loop);
+    ASSERT_PTR_EQUALS(
+        picked_loop == first_loop ? second_loop : first_loop,
+        aws_event_loop_group_get_loop_for_cpu(event_loop_group, cpu_id));
+    ASSERT_PTR_EQUALS(picked_loop, aws_event_loop_group_get_loop_for_cpu(event_loop_group, cpu_id));
+
+    aws_event_loop_group_release(event_loop_group);
+#endif
+
+    /* loops that aren't pinned aren't picked for any CPU */
+    struct aws_event_loop_group *unpinned_group = aws_event_loop_group_new_default(allocator, 1, NULL);
+    ASSERT_NOT_NULL(unpinned_group);
+    ASSERT_NULL(aws_event_loop_group_get_loop_for_cpu(unpinned_group, 0));
+    aws_event_loop_group_release(unpinned_group);
+
+    ASSERT_SUCCESS(aws_global_thread_creator_shutdown_wait_for(10));
+
+    aws_io_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(event_loop_group_pinned_to_cpus, test_event_loop_group_pinned_to_cpus)
+
 static void s_async_shutdown_complete_callback(void *user_data) {
 
     struct task_args *args = user_data;
@@ -28,6 +28,7 @@ struct rw_test_handler_impl {
     struct aws_condition_variable condition_variable;
     struct aws_mutex mutex;
     struct aws_atomic_var shutdown_error;
+    struct aws_atomic_var trim_count;
     void *ctx;
 };
 
@@ -124,6 +125,11 @@ static void s_rw_handler_destroy(struct aws_channel_handler *handler) {
     aws_mem_release(handler->alloc, handler);
 }
 
+static void s_rw_handler_trim(struct aws_channel_handler *handler) {
+    struct rw_test_handler_impl *handler_impl = handler->impl;
+    aws_atomic_fetch_add(&handler_impl->trim_count, 1);
+}
+
 struct aws_channel_handler_vtable s_rw_test_vtable = {
     .shutdown = s_rw_handler_shutdown,
     .increment_read_window = s_rw_handler_increment_read_window,
@@ -132,6 +138,7 @@ struct aws_channel_handler_vtable s_rw_test_vtable = {
     .process_write_message = s_rw_handler_process_write_message,
     .destroy = s_rw_handler_destroy,
     .message_overhead = s_rw_handler_message_overhead,
+    .trim = s_rw_handler_trim,
 };
 
 struct aws_channel_handler *rw_handler_new(
@@ -292,3 +299,8 @@ int rw_handler_last_error_code(struct aws_channel_handler *handler) {
     struct rw_test_handler_impl *handler_impl = handler->impl;
     return aws_atomic_load_int(&handler_impl->shutdown_error);
 }
+
+size_t rw_handler_trim_count(struct aws_channel_handler *handler) {
+    struct rw_test_handler_impl *handler_impl = handler->impl;
+    return aws_atomic_load_int(&handler_impl->trim_count);
+}
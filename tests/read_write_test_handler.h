@@ -51,4 +51,6 @@ void increment_read_window_task(void *arg, enum aws_task_status task_status);
 
 int rw_handler_last_error_code(struct aws_channel_handler *handler);
 
+size_t rw_handler_trim_count(struct aws_channel_handler *handler);
+
 #endif /* AWS_READ_WRITE_TEST_HANDLER */
@@ -17,6 +17,20 @@
 #include "statistics_handler_test.h"
 #include <read_write_test_handler.h>
 
+#ifndef _WIN32
+#    include <arpa/inet.h>
+#    include <errno.h>
+#    include <netinet/in.h>
+#    include <stdlib.h>
+#    include <sys/socket.h>
+#    include <sys/un.h>
+#    include <unistd.h>
+#endif
+
+#ifdef __linux__
+#    include <linux/filter.h>
+#endif
+
 #ifdef _WIN32
 #    define LOCAL_SOCK_TEST_PATTERN "\\\\.\\pipe\\testsock%llu"
 #else
@@ -49,11 +63,14 @@ struct socket_common_tester {
 
 static struct socket_common_tester c_tester;
 
-static int s_socket_common_tester_init(struct aws_allocator *allocator, struct socket_common_tester *tester) {
+static int s_socket_common_tester_init_ex(
+    struct aws_allocator *allocator,
+    struct socket_common_tester *tester,
+    uint16_t el_count) {
     AWS_ZERO_STRUCT(*tester);
     aws_io_library_init(allocator);
 
-    tester->el_group = aws_event_loop_group_new_default(allocator, 0, NULL);
+    tester->el_group = aws_event_loop_group_new_default(allocator, el_count, NULL);
     struct aws_mutex mutex = AWS_MUTEX_INIT;
     struct aws_condition_variable condition_variable = AWS_CONDITION_VARIABLE_INIT;
     tester->mutex = mutex;
@@ -64,6 +81,10 @@ static int s_socket_common_tester_init(struct aws_allocator *allocator, struct s
     return AWS_OP_SUCCESS;
 }
 
+static int s_socket_common_tester_init(struct aws_allocator *allocator, struct socket_common_tester *tester) {
+    return s_socket_common_tester_init_ex(allocator, tester, 0);
+}
+
 static int s_socket_common_tester_clean_up(struct socket_common_tester *tester) {
     aws_event_loop_group_release(tester->el_group);
     ASSERT_SUCCESS(aws_global_thread_creator_shutdown_wait_for(10));
@@ -276,12 +297,13 @@ static int s_socket_test_args_init(
     return AWS_OP_SUCCESS;
 }
 
-static int s_local_server_tester_init(
+static int s_local_server_tester_init_ex(
     struct aws_allocator *allocator,
     struct local_server_tester *tester,
     struct socket_test_args *args,
     struct socket_common_tester *s_c_tester,
-    bool enable_back_pressure) {
+    bool enable_back_pressure,
+    const struct aws_socket_handler_read_budget_options *adaptive_read_budget) {
     AWS_ZERO_STRUCT(*tester);
     tester->socket_options.connect_timeout_ms = 3000;
     tester->socket_options.type = AWS_SOCKET_STREAM;
@@ -305,6 +327,7 @@ static int s_local_server_tester_init(
         .incoming_callback = s_socket_handler_test_server_setup_callback,
         .shutdown_callback = s_socket_handler_test_server_shutdown_callback,
         .destroy_callback = s_socket_handler_test_server_listener_destroy_callback,
+        .adaptive_read_budget = adaptive_read_budget,
         .user_data = args,
     };
     tester->listener = aws_server_bootstrap_new_socket_listener(&bootstrap_options);
@@ -313,11 +336,199 @@ static int s_local_server_tester_init(
     return AWS_OP_SUCCESS;
 }
 
+static int s_local_server_tester_init(
+    struct aws_allocator *allocator,
+    struct local_server_tester *tester,
+    struct socket_test_args *args,
+    struct socket_common_tester *s_c_tester,
+    bool enable_back_pressure) {
+    return s_local_server_tester_init_ex(allocator, tester, args, s_c_tester, enable_back_pressure, NULL);
+}
+
 static int s_local_server_tester_clean_up(struct local_server_tester *tester) {
     aws_server_bootstrap_release(tester->server_bootstrap);
     return AWS_OP_SUCCESS;
 }
 
+/* two connected socket channels over a local socket, with a rw handler at the end of each */
+struct socket_channel_pair_tester {
+    struct socket_test_rw_args incoming_rw_args;
+    struct socket_test_rw_args outgoing_rw_args;
+    struct socket_test_args incoming_args;
+    struct socket_test_args outgoing_args;
+    struct local_server_tester local_server_tester;
+    struct aws_client_bootstrap *client_bootstrap;
+};
+
+struct socket_channel_pair_tester_options {
+    /* what the incoming end reads goes here, until expected_read bytes have been read */
+    struct aws_byte_buf incoming_received_message;
+    size_t incoming_expected_read;
+    /* the incoming end starts with this read window when set, instead of an unbounded one */
+    bool incoming_read_back_pressure;
+    size_t incoming_read_window;
+    /* what the outgoing end reads goes here, until expected_read bytes have been read */
+    struct aws_byte_buf outgoing_received_message;
+    size_t outgoing_expected_read;
+    /* both ends read with an adaptive budget when set */
+    const struct aws_socket_handler_read_budget_options *adaptive_read_budget;
+    /* both channels run on one event loop when set, instead of on one of a loop per core */
+    bool single_event_loop;
+};
+
+/* sets up c_tester and both channels, and returns with c_tester's mutex held, the test waits on it from then on */
+static int s_socket_channel_pair_tester_init(
+    struct aws_allocator *allocator,
+    struct socket_channel_pair_tester *tester,
+    const struct socket_channel_pair_tester_options *options) {
+
+    AWS_ZERO_STRUCT(*tester);
+    s_socket_common_tester_init_ex(allocator, &c_tester, options->single_event_loop ? 1 : 0);
+
+    ASSERT_SUCCESS(s_rw_args_init(
+        &tester->incoming_rw_args,
+        &c_tester,
+        options->incoming_received_message,
+        (int)options->incoming_expected_read));
+    ASSERT_SUCCESS(s_rw_args_init(
+        &tester->outgoing_rw_args,
+        &c_tester,
+        options->outgoing_received_message,
+        (int)options->outgoing_expected_read));
+
+    struct aws_channel_handler *outgoing_rw_handler = rw_handler_new(
+        allocator, s_socket_test_handle_read, s_socket_test_handle_write, true, SIZE_MAX, &tester->outgoing_rw_args);
+    ASSERT_NOT_NULL(outgoing_rw_handler);
+
+    struct aws_channel_handler *incoming_rw_handler = rw_handler_new(
+        allocator,
+        s_socket_test_handle_read,
+        s_socket_test_handle_write,
+        true,
+        options->incoming_read_back_pressure ? options->incoming_read_window : SIZE_MAX,
+        &tester->incoming_rw_args);
+    ASSERT_NOT_NULL(incoming_rw_handler);
+
+    ASSERT_SUCCESS(s_socket_test_args_init(&tester->incoming_args, &c_tester, incoming_rw_handler));
+    ASSERT_SUCCESS(s_socket_test_args_init(&tester->outgoing_args, &c_tester, outgoing_rw_handler));
+
+    ASSERT_SUCCESS(s_local_server_tester_init_ex(
+        allocator,
+        &tester->local_server_tester,
+        &tester->incoming_args,
+        &c_tester,
+        options->incoming_read_back_pressure,
+        options->adaptive_read_budget));
+
+    struct aws_client_bootstrap_options bootstrap_options = {
+        .event_loop_group = c_tester.el_group,
+        .host_resolver = NULL,
+    };
+    tester->client_bootstrap = aws_client_bootstrap_new(allocator, &bootstrap_options);
+    ASSERT_NOT_NULL(tester->client_bootstrap);
+
+    struct aws_socket_channel_bootstrap_options channel_options;
+    AWS_ZERO_STRUCT(channel_options);
+    channel_options.bootstrap = tester->client_bootstrap;
+    channel_options.host_name = tester->local_server_tester.endpoint.address;
+    channel_options.port = 0;
+    channel_options.socket_options = &tester->local_server_tester.socket_options;
+    channel_options.setup_callback = s_socket_handler_test_client_setup_callback;
+    channel_options.shutdown_callback = s_socket_handler_test_client_shutdown_callback;
+    channel_options.adaptive_read_budget = options->adaptive_read_budget;
+    channel_options.user_data = &tester->outgoing_args;
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+    ASSERT_SUCCESS(aws_client_bootstrap_new_socket_channel(&channel_options));
+
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_setup_predicate, &tester->incoming_args));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_setup_predicate, &tester->outgoing_args));
+
+    return AWS_OP_SUCCESS;
+}
+
+/* shuts both channels and the listener down, releases c_tester's mutex and cleans c_tester up */
+static int s_socket_channel_pair_tester_clean_up(struct socket_channel_pair_tester *tester) {
+    ASSERT_SUCCESS(aws_channel_shutdown(tester->incoming_args.channel, AWS_OP_SUCCESS));
+    ASSERT_SUCCESS(aws_channel_shutdown(tester->outgoing_args.channel, AWS_OP_SUCCESS));
+
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_shutdown_predicate, &tester->incoming_args));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_shutdown_predicate, &tester->outgoing_args));
+    aws_server_bootstrap_destroy_socket_listener(
+        tester->local_server_tester.server_bootstrap, tester->local_server_tester.listener);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_listener_destroy_predicate, &tester->incoming_args));
+
+    aws_mutex_unlock(&c_tester.mutex);
+
+    ASSERT_SUCCESS(s_local_server_tester_clean_up(&tester->local_server_tester));
+    aws_client_bootstrap_release(tester->client_bootstrap);
+    return s_socket_common_tester_clean_up(&c_tester);
+}
+
+/*
+ * A call on a channel slot that completes through a callback, such as aws_channel_slot_send_file(). The call is made
+ * from a task on the slot's channel: `started` is set once it returned successfully, `completed` once its callback
+ * ran or the call failed.
+ */
+struct channel_call_test_args {
+    struct aws_mutex *mutex;
+    struct aws_condition_variable *condition_variable;
+    struct aws_channel_task task;
+    struct aws_channel_slot *slot;
+    int error_code;
+    size_t amount;
+    bool started;
+    bool completed;
+};
+
+static void s_channel_call_test_args_init(
+    struct channel_call_test_args *call_args,
+    struct aws_channel_slot *slot,
+    aws_channel_task_fn *call_task_fn,
+    void *call_task_arg) {
+
+    AWS_ZERO_STRUCT(*call_args);
+    call_args->mutex = &c_tester.mutex;
+    call_args->condition_variable = &c_tester.condition_variable;
+    call_args->slot = slot;
+    aws_channel_task_init(&call_args->task, call_task_fn, call_task_arg, "channel_call_test");
+}
+
+static void s_channel_call_test_schedule(struct channel_call_test_args *call_args) {
+    aws_channel_schedule_task_now(call_args->slot->channel, &call_args->task);
+}
+
+static void s_channel_call_test_started(struct channel_call_test_args *call_args) {
+    aws_mutex_lock(call_args->mutex);
+    call_args->started = true;
+    aws_condition_variable_notify_one(call_args->condition_variable);
+    aws_mutex_unlock(call_args->mutex);
+}
+
+static void s_channel_call_test_completed(struct channel_call_test_args *call_args, int error_code, size_t amount) {
+    aws_mutex_lock(call_args->mutex);
+    call_args->error_code = error_code;
+    call_args->amount = amount;
+    call_args->completed = true;
+    aws_condition_variable_notify_one(call_args->condition_variable);
+    aws_mutex_unlock(call_args->mutex);
+}
+
+static bool s_channel_call_started_predicate(void *user_data) {
+    struct channel_call_test_args *call_args = user_data;
+    return call_args->started || call_args->completed;
+}
+
+static bool s_channel_call_completed_predicate(void *user_data) {
+    struct channel_call_test_args *call_args = user_data;
+    return call_args->completed;
+}
+
 static int s_socket_echo_and_backpressure_test(struct aws_allocator *allocator, void *ctx) {
     (void)ctx;
 
@@ -458,165 +669,1000 @@ static int s_socket_echo_and_backpressure_test(struct aws_allocator *allocator,
 
 AWS_TEST_CASE(socket_handler_echo_and_backpressure, s_socket_echo_and_backpressure_test)
 
-static int s_socket_close_test(struct aws_allocator *allocator, void *ctx) {
-    (void)ctx;
+#ifndef _WIN32
+struct send_file_test_args {
+    struct channel_call_test_args call;
+    struct aws_channel_send_file_options options;
+};
 
-    s_socket_common_tester_init(allocator, &c_tester);
+static void s_send_file_test_on_completion(
+    struct aws_channel *channel,
+    int error_code,
+    size_t bytes_sent,
+    void *user_data) {
+    (void)channel;
 
-    uint8_t outgoing_received_message[128];
-    uint8_t incoming_received_message[128];
+    struct send_file_test_args *send_args = user_data;
+    s_channel_call_test_completed(&send_args->call, error_code, bytes_sent);
+}
 
-    struct socket_test_rw_args incoming_rw_args;
-    ASSERT_SUCCESS(s_rw_args_init(
-        &incoming_rw_args,
-        &c_tester,
-        aws_byte_buf_from_empty_array(incoming_received_message, sizeof(incoming_received_message)),
-        0));
+static void s_send_file_test_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
 
-    struct socket_test_rw_args outgoing_rw_args;
-    ASSERT_SUCCESS(s_rw_args_init(
-        &outgoing_rw_args,
-        &c_tester,
-        aws_byte_buf_from_empty_array(outgoing_received_message, sizeof(outgoing_received_message)),
-        0));
+    struct send_file_test_args *send_args = arg;
+    if (aws_channel_slot_send_file(send_args->call.slot, &send_args->options)) {
+        s_channel_call_test_completed(&send_args->call, aws_last_error(), 0);
+    }
+}
 
-    struct aws_channel_handler *outgoing_rw_handler = rw_handler_new(
-        allocator, s_socket_test_handle_read, s_socket_test_handle_write, true, 10000, &outgoing_rw_args);
-    ASSERT_NOT_NULL(outgoing_rw_handler);
+/* a handler that passes every message on untouched. Between the socket handler and a file sender, it keeps the range
+ * from going to the socket with sendfile(). */
+static int s_pass_through_process_read_message(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    struct aws_io_message *message) {
+    (void)handler;
+    return aws_channel_slot_send_message(slot, message, AWS_CHANNEL_DIR_READ);
+}
 
-    struct aws_channel_handler *incoming_rw_handler = rw_handler_new(
-        allocator, s_socket_test_handle_read, s_socket_test_handle_write, true, 10000, &incoming_rw_args);
-    ASSERT_NOT_NULL(outgoing_rw_handler);
+static int s_pass_through_process_write_message(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    struct aws_io_message *message) {
+    (void)handler;
+    return aws_channel_slot_send_message(slot, message, AWS_CHANNEL_DIR_WRITE);
+}
 
-    struct socket_test_args incoming_args;
-    ASSERT_SUCCESS(s_socket_test_args_init(&incoming_args, &c_tester, incoming_rw_handler));
+static int s_pass_through_increment_read_window(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    size_t size) {
+    (void)handler;
+    return aws_channel_slot_increment_read_window(slot, size);
+}
 
-    struct socket_test_args outgoing_args;
-    ASSERT_SUCCESS(s_socket_test_args_init(&outgoing_args, &c_tester, outgoing_rw_handler));
+static int s_pass_through_shutdown(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    enum aws_channel_direction dir,
+    int error_code,
+    bool free_scarce_resources_immediately) {
+    (void)handler;
+    return aws_channel_slot_on_handler_shutdown_complete(slot, dir, error_code, free_scarce_resources_immediately);
+}
 
-    struct local_server_tester local_server_tester;
-    ASSERT_SUCCESS(s_local_server_tester_init(allocator, &local_server_tester, &incoming_args, &c_tester, false));
+static size_t s_pass_through_initial_window_size(struct aws_channel_handler *handler) {
+    (void)handler;
+    return SIZE_MAX;
+}
 
-    struct aws_client_bootstrap_options bootstrap_options = {
-        .event_loop_group = c_tester.el_group,
-        .host_resolver = NULL,
-    };
-    struct aws_client_bootstrap *client_bootstrap = aws_client_bootstrap_new(allocator, &bootstrap_options);
-    ASSERT_NOT_NULL(client_bootstrap);
+static size_t s_pass_through_message_overhead(struct aws_channel_handler *handler) {
+    (void)handler;
+    return 0;
+}
 
-    struct aws_socket_channel_bootstrap_options channel_options;
-    AWS_ZERO_STRUCT(channel_options);
-    channel_options.bootstrap = client_bootstrap;
-    channel_options.host_name = local_server_tester.endpoint.address;
-    channel_options.port = 0;
-    channel_options.socket_options = &local_server_tester.socket_options;
-    channel_options.setup_callback = s_socket_handler_test_client_setup_callback;
-    channel_options.shutdown_callback = s_socket_handler_test_client_shutdown_callback;
-    channel_options.user_data = &outgoing_args;
+static void s_pass_through_destroy(struct aws_channel_handler *handler) {
+    aws_mem_release(handler->alloc, handler);
+}
 
-    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
-    ASSERT_SUCCESS(aws_client_bootstrap_new_socket_channel(&channel_options));
+static struct aws_channel_handler_vtable s_pass_through_vtable = {
+    .process_read_message = s_pass_through_process_read_message,
+    .process_write_message = s_pass_through_process_write_message,
+    .increment_read_window = s_pass_through_increment_read_window,
+    .shutdown = s_pass_through_shutdown,
+    .initial_window_size = s_pass_through_initial_window_size,
+    .message_overhead = s_pass_through_message_overhead,
+    .destroy = s_pass_through_destroy,
+};
 
-    /* wait for both ends to setup */
-    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
-        &c_tester.condition_variable, &c_tester.mutex, s_channel_setup_predicate, &incoming_args));
-    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
-        &c_tester.condition_variable, &c_tester.mutex, s_channel_setup_predicate, &outgoing_args));
+/* puts a pass-through handler in front of the sender, then sends the file */
+static void s_send_file_through_messages_test_task(
+    struct aws_channel_task *task,
+    void *arg,
+    enum aws_task_status status) {
+    struct send_file_test_args *send_args = arg;
+    struct aws_channel_slot *slot = send_args->call.slot;
 
-    aws_channel_shutdown(incoming_args.channel, AWS_OP_SUCCESS);
+    struct aws_channel_handler *pass_through = aws_mem_calloc(slot->alloc, 1, sizeof(*pass_through));
+    pass_through->alloc = slot->alloc;
+    pass_through->vtable = &s_pass_through_vtable;
 
-    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
-        &c_tester.condition_variable, &c_tester.mutex, s_channel_shutdown_predicate, &incoming_args));
-    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
-        &c_tester.condition_variable, &c_tester.mutex, s_channel_shutdown_predicate, &outgoing_args));
+    struct aws_channel_slot *pass_through_slot = aws_channel_slot_new(slot->channel);
+    aws_channel_slot_insert_left(slot, pass_through_slot);
+    aws_channel_slot_set_handler(pass_through_slot, pass_through);
+
+    s_send_file_test_task(task, arg, status);
+}
+
+/* sends `length` bytes of `fd` from `offset` on the outgoing channel, and waits until the send completed */
+static int s_send_file_and_wait(
+    struct socket_channel_pair_tester *tester,
+    aws_channel_task_fn *send_task_fn,
+    int fd,
+    uint64_t offset,
+    size_t length,
+    struct channel_call_test_args *result) {
+
+    struct send_file_test_args send_args = {
+        .options =
+            {
+                .fd = fd,
+                .offset = offset,
+                .length = length,
+                .on_completion = s_send_file_test_on_completion,
+            },
+    };
+    send_args.options.user_data = &send_args;
+    s_channel_call_test_args_init(
+        &send_args.call, aws_atomic_load_ptr(&tester->outgoing_args.rw_slot), send_task_fn, &send_args);
+    s_channel_call_test_schedule(&send_args.call);
 
-    ASSERT_INT_EQUALS(AWS_OP_SUCCESS, incoming_args.error_code);
-    ASSERT_TRUE(
-        AWS_IO_SOCKET_CLOSED == outgoing_args.error_code || AWS_IO_SOCKET_NOT_CONNECTED == outgoing_args.error_code);
-    aws_server_bootstrap_destroy_socket_listener(local_server_tester.server_bootstrap, local_server_tester.listener);
     ASSERT_SUCCESS(aws_condition_variable_wait_pred(
-        &c_tester.condition_variable, &c_tester.mutex, s_listener_destroy_predicate, &incoming_args));
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_call_completed_predicate, &send_args.call));
+    *result = send_args.call;
+    return AWS_OP_SUCCESS;
+}
 
-    aws_mutex_unlock(&c_tester.mutex);
+struct send_file_test_options {
+    /* the range is read from the file and sent as messages, instead of going to the socket with sendfile() */
+    bool through_messages;
+    /* the range runs this far past the end of the file, so the send fails once the file runs out */
+    size_t past_end_of_file;
+};
 
-    /* clean up */
-    ASSERT_SUCCESS(s_local_server_tester_clean_up(&local_server_tester));
+static int s_socket_handler_send_file_test_ex(
+    struct aws_allocator *allocator,
+    const struct send_file_test_options *test_options) {
+
+    /* big enough to take several writes, and several messages where the range is copied */
+    const size_t file_size = 256 * 1024;
+    const size_t range_offset = 1000;
+    const size_t range_length =
+        test_options->past_end_of_file ? file_size - range_offset + test_options->past_end_of_file : 200 * 1024;
+    const size_t expected_length = aws_min_size(range_length, file_size - range_offset);
+
+    char file_path[] = "aws_io_send_file_XXXXXX";
+    int fd = mkstemp(file_path);
+    ASSERT_TRUE(fd >= 0);
+    unlink(file_path);
+
+    struct aws_byte_buf file_contents;
+    ASSERT_SUCCESS(aws_byte_buf_init(&file_contents, allocator, file_size));
+    for (size_t i = 0; i < file_size; ++i) {
+        file_contents.buffer[i] = (uint8_t)(i * 31 + i / 256);
+    }
+    file_contents.len = file_size;
+    ASSERT_INT_EQUALS(file_size, (size_t)write(fd, file_contents.buffer, file_contents.len));
+
+    struct aws_byte_buf incoming_received_message;
+    ASSERT_SUCCESS(aws_byte_buf_init(&incoming_received_message, allocator, range_length));
+
+    struct socket_channel_pair_tester tester;
+    struct socket_channel_pair_tester_options tester_options = {
+        .incoming_received_message = incoming_received_message,
+        .incoming_expected_read = expected_length,
+    };
+    ASSERT_SUCCESS(s_socket_channel_pair_tester_init(allocator, &tester, &tester_options));
+
+    struct channel_call_test_args send_result;
+    ASSERT_SUCCESS(s_send_file_and_wait(
+        &tester,
+        test_options->through_messages ? s_send_file_through_messages_test_task : s_send_file_test_task,
+        fd,
+        range_offset,
+        range_length,
+        &send_result));
+    ASSERT_INT_EQUALS(
+        test_options->past_end_of_file ? AWS_IO_STREAM_READ_FAILED : AWS_ERROR_SUCCESS, send_result.error_code);
+    ASSERT_INT_EQUALS(expected_length, send_result.amount);
+
+    /* everything before the end of the file made it across either way */
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_socket_test_full_read_predicate, &tester.incoming_rw_args));
+    ASSERT_BIN_ARRAYS_EQUALS(
+        file_contents.buffer + range_offset,
+        expected_length,
+        tester.incoming_rw_args.received_message.buffer,
+        tester.incoming_rw_args.received_message.len);
 
-    aws_client_bootstrap_release(client_bootstrap);
-    ASSERT_SUCCESS(s_socket_common_tester_clean_up(&c_tester));
+    ASSERT_SUCCESS(s_socket_channel_pair_tester_clean_up(&tester));
 
+    aws_byte_buf_clean_up(&incoming_received_message);
+    aws_byte_buf_clean_up(&file_contents);
+    close(fd);
     return AWS_OP_SUCCESS;
 }
 
-AWS_TEST_CASE(socket_handler_close, s_socket_close_test)
+static int s_socket_handler_send_file_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
 
-static void s_creation_callback_test_channel_creation_callback(
-    struct aws_client_bootstrap *bootstrap,
-    int error_code,
-    struct aws_channel *channel,
-    void *user_data) {
+    struct send_file_test_options test_options = {0};
+    return s_socket_handler_send_file_test_ex(allocator, &test_options);
+}
 
-    (void)bootstrap;
-    (void)error_code;
+AWS_TEST_CASE(socket_handler_send_file, s_socket_handler_send_file_test)
 
-    struct socket_test_args *setup_test_args = (struct socket_test_args *)user_data;
+static int s_socket_handler_send_file_through_messages_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
 
-    setup_test_args->creation_callback_invoked = true;
+    struct send_file_test_options test_options = {.through_messages = true};
+    return s_socket_handler_send_file_test_ex(allocator, &test_options);
+}
 
-    struct aws_crt_statistics_handler *stats_handler = aws_statistics_handler_new_test(bootstrap->allocator);
-    aws_atomic_store_ptr(&c_tester.stats_handler, stats_handler);
+AWS_TEST_CASE(socket_handler_send_file_through_messages, s_socket_handler_send_file_through_messages_test)
 
-    aws_channel_set_statistics_handler(channel, stats_handler);
+/* the callback reports how much of the range went out before the file ran out */
+static int s_socket_handler_send_file_past_end_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct send_file_test_options test_options = {.past_end_of_file = 1000};
+    return s_socket_handler_send_file_test_ex(allocator, &test_options);
 }
 
-static struct aws_event_loop *s_default_new_event_loop(
-    struct aws_allocator *allocator,
-    aws_io_clock_fn *clock,
-    void *user_data) {
+AWS_TEST_CASE(socket_handler_send_file_past_end, s_socket_handler_send_file_past_end_test)
 
-    (void)user_data;
-    return aws_event_loop_new_default(allocator, clock);
+static int s_socket_handler_send_file_through_messages_past_end_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct send_file_test_options test_options = {.through_messages = true, .past_end_of_file = 1000};
+    return s_socket_handler_send_file_test_ex(allocator, &test_options);
 }
 
-static int s_statistic_test_clock_fn(uint64_t *timestamp) {
-    *timestamp = aws_atomic_load_int(&c_tester.current_time_ns);
+AWS_TEST_CASE(
+    socket_handler_send_file_through_messages_past_end,
+    s_socket_handler_send_file_through_messages_past_end_test)
 
-    return AWS_OP_SUCCESS;
+struct write_payload_test_args {
+    struct channel_call_test_args call;
+    struct aws_byte_cursor payload;
+};
+
+/* writes the whole payload from the slot, in as many messages as it takes */
+static void s_write_payload_test_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+
+    struct write_payload_test_args *write_args = arg;
+    struct aws_channel_slot *slot = write_args->call.slot;
+    struct aws_byte_cursor payload = write_args->payload;
+    while (payload.len) {
+        struct aws_io_message *message =
+            aws_channel_acquire_message_from_pool(slot->channel, AWS_IO_MESSAGE_APPLICATION_DATA, payload.len);
+        if (!message) {
+            s_channel_call_test_completed(&write_args->call, aws_last_error(), write_args->payload.len - payload.len);
+            return;
+        }
+
+        struct aws_byte_cursor chunk =
+            aws_byte_cursor_advance(&payload, aws_min_size(payload.len, message->message_data.capacity));
+        aws_byte_buf_append(&message->message_data, &chunk);
+        if (aws_channel_slot_send_message(slot, message, AWS_CHANNEL_DIR_WRITE)) {
+            aws_mem_release(message->allocator, message);
+            s_channel_call_test_completed(&write_args->call, aws_last_error(), write_args->payload.len - payload.len);
+            return;
+        }
+    }
+
+    s_channel_call_test_completed(&write_args->call, AWS_ERROR_SUCCESS, write_args->payload.len);
 }
 
-static int s_socket_common_tester_statistics_init(
-    struct aws_allocator *allocator,
-    struct socket_common_tester *tester) {
+struct gather_statistics_test_args {
+    struct channel_call_test_args call;
+    struct aws_crt_statistics_socket stats;
+};
 
-    aws_io_library_init(allocator);
+/* copies out the statistics of the channel's socket handler */
+static void s_gather_statistics_test_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+
+    struct gather_statistics_test_args *gather_args = arg;
+    struct aws_channel_handler *socket_handler = aws_channel_get_first_slot(gather_args->call.slot->channel)->handler;
+
+    void *stats_storage[1];
+    struct aws_array_list stats_list;
+    aws_array_list_init_static(&stats_list, stats_storage, AWS_ARRAY_SIZE(stats_storage), sizeof(void *));
+    socket_handler->vtable->gather_statistics(socket_handler, &stats_list);
+
+    struct aws_crt_statistics_socket *stats = NULL;
+    aws_array_list_get_at(&stats_list, &stats, 0);
+    aws_mutex_lock(gather_args->call.mutex);
+    gather_args->stats = *stats;
+    aws_mutex_unlock(gather_args->call.mutex);
+    s_channel_call_test_completed(&gather_args->call, AWS_ERROR_SUCCESS, 0);
+}
 
-    AWS_ZERO_STRUCT(*tester);
-    tester->el_group =
-        aws_event_loop_group_new(allocator, s_statistic_test_clock_fn, 1, s_default_new_event_loop, NULL, NULL);
-    struct aws_mutex mutex = AWS_MUTEX_INIT;
-    struct aws_condition_variable condition_variable = AWS_CONDITION_VARIABLE_INIT;
-    tester->mutex = mutex;
-    tester->condition_variable = condition_variable;
-    aws_atomic_store_int(&tester->current_time_ns, 0);
-    aws_atomic_store_ptr(&tester->stats_handler, NULL);
+static int s_run_channel_call_and_wait(struct channel_call_test_args *call) {
+    s_channel_call_test_schedule(call);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_call_completed_predicate, call));
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, call->error_code);
+    return AWS_OP_SUCCESS;
+}
 
+static int s_gather_socket_statistics(struct socket_test_args *args, struct aws_crt_statistics_socket *stats) {
+    struct gather_statistics_test_args gather_args;
+    AWS_ZERO_STRUCT(gather_args);
+    s_channel_call_test_args_init(
+        &gather_args.call, aws_atomic_load_ptr(&args->rw_slot), s_gather_statistics_test_task, &gather_args);
+    ASSERT_SUCCESS(s_run_channel_call_and_wait(&gather_args.call));
+    *stats = gather_args.stats;
     return AWS_OP_SUCCESS;
 }
 
-static bool s_stats_processed_predicate(void *user_data) {
-    struct aws_crt_statistics_handler *stats_handler = user_data;
-    struct aws_statistics_handler_test_impl *stats_impl = stats_handler->impl;
+/*
+ * Both ends read with an adaptive budget, on one event loop. While only the incoming end has data waiting, its budget
+ * grows past where it started. Once both ends have data waiting at once, they take turns on the loop and the budgets
+ * shrink, though never below the minimum.
+ */
+static int s_socket_handler_adaptive_read_budget_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
 
-    return stats_impl->total_bytes_read > 0 && stats_impl->total_bytes_written > 0;
+    const size_t payload_size = 1024 * 1024;
+    struct aws_byte_buf payload;
+    ASSERT_SUCCESS(aws_byte_buf_init(&payload, allocator, payload_size));
+    for (size_t i = 0; i < payload_size; ++i) {
+        payload.buffer[i] = (uint8_t)(i * 31 + i / 256);
+    }
+    payload.len = payload_size;
+
+    struct aws_byte_buf incoming_received_message;
+    ASSERT_SUCCESS(aws_byte_buf_init(&incoming_received_message, allocator, 2 * payload_size));
+    struct aws_byte_buf outgoing_received_message;
+    ASSERT_SUCCESS(aws_byte_buf_init(&outgoing_received_message, allocator, payload_size));
+
+    struct aws_socket_handler_read_budget_options read_budget = {
+        .min_read_size = 4 * 1024,
+        .max_read_size = 128 * 1024,
+    };
+    struct socket_channel_pair_tester tester;
+    struct socket_channel_pair_tester_options tester_options = {
+        .incoming_received_message = incoming_received_message,
+        .incoming_expected_read = payload_size,
+        .outgoing_received_message = outgoing_received_message,
+        .outgoing_expected_read = payload_size,
+        .adaptive_read_budget = &read_budget,
+        .single_event_loop = true,
+    };
+    ASSERT_SUCCESS(s_socket_channel_pair_tester_init(allocator, &tester, &tester_options));
+
+    struct aws_crt_statistics_socket incoming_stats;
+    ASSERT_SUCCESS(s_gather_socket_statistics(&tester.incoming_args, &incoming_stats));
+    const uint64_t starting_budget = incoming_stats.read_budget;
+    ASSERT_TRUE(starting_budget < read_budget.max_read_size);
+
+    /* only the incoming end has anything to read, so its budget grows */
+    struct write_payload_test_args outgoing_write = {.payload = aws_byte_cursor_from_buf(&payload)};
+    s_channel_call_test_args_init(
+        &outgoing_write.call,
+        aws_atomic_load_ptr(&tester.outgoing_args.rw_slot),
+        s_write_payload_test_task,
+        &outgoing_write);
+    ASSERT_SUCCESS(s_run_channel_call_and_wait(&outgoing_write.call));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_socket_test_full_read_predicate, &tester.incoming_rw_args));
+
+    ASSERT_SUCCESS(s_gather_socket_statistics(&tester.incoming_args, &incoming_stats));
+    ASSERT_TRUE(incoming_stats.read_budget_increases > 0);
+    ASSERT_INT_EQUALS(0, incoming_stats.read_budget_decreases);
+    ASSERT_TRUE(incoming_stats.read_budget > starting_budget);
+    ASSERT_TRUE(incoming_stats.read_budget <= read_budget.max_read_size);
+
+    /* both ends have data waiting now, so the budgets shrink */
+    tester.incoming_rw_args.expected_read += payload_size;
+    struct write_payload_test_args incoming_write = {.payload = aws_byte_cursor_from_buf(&payload)};
+    s_channel_call_test_args_init(
+        &incoming_write.call,
+        aws_atomic_load_ptr(&tester.incoming_args.rw_slot),
+        s_write_payload_test_task,
+        &incoming_write);
+    s_channel_call_test_args_init(
+        &outgoing_write.call,
+        aws_atomic_load_ptr(&tester.outgoing_args.rw_slot),
+        s_write_payload_test_task,
+        &outgoing_write);
+    s_channel_call_test_schedule(&incoming_write.call);
+    ASSERT_SUCCESS(s_run_channel_call_and_wait(&outgoing_write.call));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_call_completed_predicate, &incoming_write.call));
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, incoming_write.call.error_code);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_socket_test_full_read_predicate, &tester.incoming_rw_args));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_socket_test_full_read_predicate, &tester.outgoing_rw_args));
+
+    struct aws_crt_statistics_socket outgoing_stats;
+    ASSERT_SUCCESS(s_gather_socket_statistics(&tester.incoming_args, &incoming_stats));
+    ASSERT_SUCCESS(s_gather_socket_statistics(&tester.outgoing_args, &outgoing_stats));
+    ASSERT_TRUE(incoming_stats.read_budget_decreases + outgoing_stats.read_budget_decreases > 0);
+    ASSERT_TRUE(incoming_stats.read_budget >= read_budget.min_read_size);
+    ASSERT_TRUE(outgoing_stats.read_budget >= read_budget.min_read_size);
+
+    ASSERT_BIN_ARRAYS_EQUALS(
+        payload.buffer, payload.len, tester.incoming_rw_args.received_message.buffer, payload.len);
+    ASSERT_BIN_ARRAYS_EQUALS(
+        payload.buffer,
+        payload.len,
+        tester.incoming_rw_args.received_message.buffer + payload.len,
+        tester.incoming_rw_args.received_message.len - payload.len);
+    ASSERT_BIN_ARRAYS_EQUALS(
+        payload.buffer,
+        payload.len,
+        tester.outgoing_rw_args.received_message.buffer,
+        tester.outgoing_rw_args.received_message.len);
+
+    ASSERT_SUCCESS(s_socket_channel_pair_tester_clean_up(&tester));
+
+    aws_byte_buf_clean_up(&outgoing_received_message);
+    aws_byte_buf_clean_up(&incoming_received_message);
+    aws_byte_buf_clean_up(&payload);
+    return AWS_OP_SUCCESS;
 }
 
-static int s_open_channel_statistics_test(struct aws_allocator *allocator, void *ctx) {
+AWS_TEST_CASE(socket_handler_adaptive_read_budget, s_socket_handler_adaptive_read_budget_test)
+
+struct scratch_read_test_args {
+    struct socket_test_rw_args rw_args;
+    int peer_fd;
+    struct aws_byte_buf burst;
+    ssize_t burst_written;
+};
+
+/* the first read came up short. Sends the burst from the peer right then, so the socket handler's next read in the
+ * same tick finds data after all. */
+static struct aws_byte_buf s_scratch_read_test_handle_read(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    struct aws_byte_buf *data_read,
+    void *user_data) {
+
+    struct scratch_read_test_args *test_args = user_data;
+    if (!test_args->burst_written) {
+        test_args->burst_written = send(test_args->peer_fd, test_args->burst.buffer, test_args->burst.len, 0);
+    }
+
+    return s_socket_test_handle_read(handler, slot, data_read, &test_args->rw_args);
+}
+
+/*
+ * Once a read comes up short, the next one goes through the loop's scratch buffer, since it most likely finds the
+ * socket empty. When it fills up instead, the reads after it go straight into messages again, so only that one read's
+ * worth of data is copied.
+ */
+static int s_socket_handler_scratch_read_test(struct aws_allocator *allocator, void *ctx) {
     (void)ctx;
 
-    s_socket_common_tester_statistics_init(allocator, &c_tester);
+    s_socket_common_tester_init(allocator, &c_tester);
 
-    struct aws_byte_buf read_tag = aws_byte_buf_from_c_str("Some bytes");
-    struct aws_byte_buf write_tag = aws_byte_buf_from_c_str("Fresh pressed Washington apples");
+    /* room for the short read, the burst and a few full reads in one tick */
+    struct aws_socket_handler_read_budget_options read_budget = {
+        .min_read_size = 64 * 1024,
+        .max_read_size = 64 * 1024,
+    };
+    struct aws_byte_cursor head = aws_byte_cursor_from_c_str("I'm a little teapot.");
+    const size_t burst_size = read_budget.max_read_size;
+
+    struct scratch_read_test_args test_args;
+    AWS_ZERO_STRUCT(test_args);
+    ASSERT_SUCCESS(aws_byte_buf_init(&test_args.burst, allocator, burst_size));
+    for (size_t i = 0; i < burst_size; ++i) {
+        test_args.burst.buffer[i] = (uint8_t)(i * 31 + i / 256);
+    }
+    test_args.burst.len = burst_size;
+
+    struct aws_byte_buf received_message;
+    ASSERT_SUCCESS(aws_byte_buf_init(&received_message, allocator, head.len + burst_size));
+    ASSERT_SUCCESS(s_rw_args_init(&test_args.rw_args, &c_tester, received_message, (int)(head.len + burst_size)));
+
+    struct aws_channel_handler *incoming_rw_handler = rw_handler_new(
+        allocator, s_scratch_read_test_handle_read, s_socket_test_handle_write, true, SIZE_MAX, &test_args);
+    ASSERT_NOT_NULL(incoming_rw_handler);
+
+    struct socket_test_args incoming_args;
+    ASSERT_SUCCESS(s_socket_test_args_init(&incoming_args, &c_tester, incoming_rw_handler));
+
+    struct local_server_tester local_server_tester;
+    ASSERT_SUCCESS(s_local_server_tester_init_ex(
+        allocator, &local_server_tester, &incoming_args, &c_tester, false, &read_budget));
+
+    test_args.peer_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_TRUE(test_args.peer_fd >= 0);
+    struct sockaddr_un server_address;
+    AWS_ZERO_STRUCT(server_address);
+    server_address.sun_family = AF_UNIX;
+    strncpy(server_address.sun_path, local_server_tester.endpoint.address, sizeof(server_address.sun_path) - 1);
+    ASSERT_SUCCESS(connect(test_args.peer_fd, (struct sockaddr *)&server_address, sizeof(server_address)));
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_setup_predicate, &incoming_args));
+
+    ASSERT_INT_EQUALS(head.len, send(test_args.peer_fd, head.ptr, head.len, 0));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_socket_test_full_read_predicate, &test_args.rw_args));
+    ASSERT_INT_EQUALS(burst_size, test_args.burst_written);
+
+    ASSERT_BIN_ARRAYS_EQUALS(head.ptr, head.len, test_args.rw_args.received_message.buffer, head.len);
+    ASSERT_BIN_ARRAYS_EQUALS(
+        test_args.burst.buffer,
+        test_args.burst.len,
+        test_args.rw_args.received_message.buffer + head.len,
+        test_args.rw_args.received_message.len - head.len);
+
+    /* the head went into a message. Of the burst, only the read right after the head went through the scratch
+     * buffer, the full reads after it went into messages, and so did the rest in the next tick. */
+    struct aws_crt_statistics_socket stats;
+    ASSERT_SUCCESS(s_gather_socket_statistics(&incoming_args, &stats));
+    ASSERT_UINT_EQUALS(head.len + burst_size, stats.bytes_read);
+    ASSERT_UINT_EQUALS(g_aws_channel_max_fragment_size, stats.bytes_read_through_scratch);
+
+    close(test_args.peer_fd);
+    ASSERT_SUCCESS(aws_channel_shutdown(incoming_args.channel, AWS_OP_SUCCESS));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_shutdown_predicate, &incoming_args));
+    aws_server_bootstrap_destroy_socket_listener(local_server_tester.server_bootstrap, local_server_tester.listener);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_listener_destroy_predicate, &incoming_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&c_tester.mutex));
+
+    ASSERT_SUCCESS(s_local_server_tester_clean_up(&local_server_tester));
+    aws_byte_buf_clean_up(&received_message);
+    aws_byte_buf_clean_up(&test_args.burst);
+    return s_socket_common_tester_clean_up(&c_tester);
+}
+
+AWS_TEST_CASE(socket_handler_scratch_read, s_socket_handler_scratch_read_test)
+
+struct receive_file_test_args {
+    struct channel_call_test_args call;
+    struct aws_channel_receive_file_options options;
+};
+
+static void s_receive_file_test_on_completion(
+    struct aws_channel *channel,
+    int error_code,
+    size_t bytes_received,
+    void *user_data) {
+    (void)channel;
+
+    struct receive_file_test_args *receive_args = user_data;
+    s_channel_call_test_completed(&receive_args->call, error_code, bytes_received);
+}
+
+static void s_receive_file_test_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+
+    struct receive_file_test_args *receive_args = arg;
+    if (aws_channel_slot_receive_file(receive_args->call.slot, &receive_args->options)) {
+        s_channel_call_test_completed(&receive_args->call, aws_last_error(), 0);
+        return;
+    }
+
+    s_channel_call_test_started(&receive_args->call);
+}
+
+static int s_socket_handler_receive_file_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t range_length = 200 * 1024;
+    const size_t destination_offset = 500;
+
+    char source_path[] = "aws_io_receive_file_src_XXXXXX";
+    int source_fd = mkstemp(source_path);
+    ASSERT_TRUE(source_fd >= 0);
+    unlink(source_path);
+
+    char destination_path[] = "aws_io_receive_file_dst_XXXXXX";
+    int destination_fd = mkstemp(destination_path);
+    ASSERT_TRUE(destination_fd >= 0);
+    unlink(destination_path);
+
+    struct aws_byte_buf file_contents;
+    ASSERT_SUCCESS(aws_byte_buf_init(&file_contents, allocator, range_length));
+    for (size_t i = 0; i < range_length; ++i) {
+        file_contents.buffer[i] = (uint8_t)(i * 17 + i / 256);
+    }
+    file_contents.len = range_length;
+    ASSERT_INT_EQUALS(range_length, (size_t)write(source_fd, file_contents.buffer, file_contents.len));
+
+    /* whatever follows the range is read as messages again */
+    struct aws_byte_cursor tail = aws_byte_cursor_from_c_str("after the file");
+    struct aws_byte_buf tail_buf = aws_byte_buf_from_array(tail.ptr, tail.len);
+
+    struct aws_byte_buf incoming_received_message;
+    ASSERT_SUCCESS(aws_byte_buf_init(&incoming_received_message, allocator, tail.len));
+
+    struct socket_channel_pair_tester tester;
+    struct socket_channel_pair_tester_options tester_options = {
+        .incoming_received_message = incoming_received_message,
+        .incoming_expected_read = tail.len,
+    };
+    ASSERT_SUCCESS(s_socket_channel_pair_tester_init(allocator, &tester, &tester_options));
+
+    struct receive_file_test_args receive_args = {
+        .options =
+            {
+                .fd = destination_fd,
+                .offset = destination_offset,
+                .length = range_length,
+                .on_completion = s_receive_file_test_on_completion,
+            },
+    };
+    receive_args.options.user_data = &receive_args;
+    s_channel_call_test_args_init(
+        &receive_args.call,
+        aws_atomic_load_ptr(&tester.incoming_args.rw_slot),
+        s_receive_file_test_task,
+        &receive_args);
+    s_channel_call_test_schedule(&receive_args.call);
+
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_call_started_predicate, &receive_args.call));
+    struct aws_byte_buf file_received;
+    AWS_ZERO_STRUCT(file_received);
+    if (!receive_args.call.started) {
+        /* splicing into files is Linux only */
+        ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, receive_args.call.error_code);
+    } else {
+        struct channel_call_test_args send_result;
+        ASSERT_SUCCESS(
+            s_send_file_and_wait(&tester, s_send_file_test_task, source_fd, 0, range_length, &send_result));
+        ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, send_result.error_code);
+
+        ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+            &c_tester.condition_variable, &c_tester.mutex, s_channel_call_completed_predicate, &receive_args.call));
+        ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, receive_args.call.error_code);
+        ASSERT_INT_EQUALS(range_length, receive_args.call.amount);
+
+        /* nothing of the range went up the channel */
+        ASSERT_FALSE(tester.incoming_rw_args.invocation_happened);
+
+        rw_handler_write(
+            tester.outgoing_args.rw_handler, aws_atomic_load_ptr(&tester.outgoing_args.rw_slot), &tail_buf);
+        ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+            &c_tester.condition_variable,
+            &c_tester.mutex,
+            s_socket_test_full_read_predicate,
+            &tester.incoming_rw_args));
+        ASSERT_BIN_ARRAYS_EQUALS(
+            tail.ptr,
+            tail.len,
+            tester.incoming_rw_args.received_message.buffer,
+            tester.incoming_rw_args.received_message.len);
+
+        ASSERT_SUCCESS(aws_byte_buf_init(&file_received, allocator, range_length));
+        ASSERT_INT_EQUALS(
+            range_length, (size_t)pread(destination_fd, file_received.buffer, range_length, (off_t)destination_offset));
+        file_received.len = range_length;
+        ASSERT_BIN_ARRAYS_EQUALS(file_contents.buffer, file_contents.len, file_received.buffer, file_received.len);
+    }
+
+    ASSERT_SUCCESS(s_socket_channel_pair_tester_clean_up(&tester));
+
+    aws_byte_buf_clean_up(&file_received);
+    aws_byte_buf_clean_up(&incoming_received_message);
+    aws_byte_buf_clean_up(&file_contents);
+    close(destination_fd);
+    close(source_fd);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(socket_handler_receive_file, s_socket_handler_receive_file_test)
+#endif /* _WIN32 */
+
+struct lend_read_buffer_test_args {
+    struct channel_call_test_args call;
+    struct aws_channel_lend_read_buffer_options options;
+};
+
+static void s_lend_read_buffer_test_on_filled(
+    struct aws_channel *channel,
+    int error_code,
+    struct aws_byte_buf *buffer,
+    void *user_data) {
+    (void)channel;
+
+    struct lend_read_buffer_test_args *lend_args = user_data;
+    s_channel_call_test_completed(&lend_args->call, error_code, buffer->len);
+}
+
+static void s_lend_read_buffer_test_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+
+    struct lend_read_buffer_test_args *lend_args = arg;
+    if (aws_channel_slot_lend_read_buffer(lend_args->call.slot, &lend_args->options)) {
+        s_channel_call_test_completed(&lend_args->call, aws_last_error(), lend_args->options.buffer->len);
+        return;
+    }
+
+    s_channel_call_test_started(&lend_args->call);
+}
+
+static int s_socket_handler_lend_read_buffer_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t payload_length = 10000;
+    const size_t header_length = 16;
+
+    struct aws_byte_buf payload;
+    ASSERT_SUCCESS(aws_byte_buf_init(&payload, allocator, payload_length));
+    for (size_t i = 0; i < payload_length; ++i) {
+        payload.buffer[i] = (uint8_t)(i * 31 + i / 256);
+    }
+    payload.len = payload_length;
+
+    /* the lent buffer already holds a frame header, the payload goes after it */
+    struct aws_byte_buf frame;
+    ASSERT_SUCCESS(aws_byte_buf_init(&frame, allocator, header_length + payload_length));
+    memset(frame.buffer, 0xAA, header_length);
+    frame.len = header_length;
+
+    /* whatever follows the payload is read as messages again */
+    struct aws_byte_cursor tail = aws_byte_cursor_from_c_str("after the payload");
+    struct aws_byte_buf tail_buf = aws_byte_buf_from_array(tail.ptr, tail.len);
+
+    struct aws_byte_buf incoming_received_message;
+    ASSERT_SUCCESS(aws_byte_buf_init(&incoming_received_message, allocator, tail.len));
+
+    struct socket_channel_pair_tester tester;
+    struct socket_channel_pair_tester_options tester_options = {
+        .incoming_received_message = incoming_received_message,
+        .incoming_expected_read = tail.len,
+    };
+    ASSERT_SUCCESS(s_socket_channel_pair_tester_init(allocator, &tester, &tester_options));
+
+    struct lend_read_buffer_test_args lend_args = {
+        .options =
+            {
+                .buffer = &frame,
+                .on_filled = s_lend_read_buffer_test_on_filled,
+            },
+    };
+    lend_args.options.user_data = &lend_args;
+    s_channel_call_test_args_init(
+        &lend_args.call, aws_atomic_load_ptr(&tester.incoming_args.rw_slot), s_lend_read_buffer_test_task, &lend_args);
+    s_channel_call_test_schedule(&lend_args.call);
+
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_call_started_predicate, &lend_args.call));
+    ASSERT_TRUE(lend_args.call.started);
+
+    rw_handler_write(tester.outgoing_args.rw_handler, aws_atomic_load_ptr(&tester.outgoing_args.rw_slot), &payload);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_call_completed_predicate, &lend_args.call));
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, lend_args.call.error_code);
+    ASSERT_INT_EQUALS(header_length + payload_length, frame.len);
+    ASSERT_BIN_ARRAYS_EQUALS(payload.buffer, payload.len, frame.buffer + header_length, payload_length);
+    ASSERT_UINT_EQUALS(0xAA, frame.buffer[header_length - 1]);
+
+    /* nothing of the payload went up the channel */
+    ASSERT_FALSE(tester.incoming_rw_args.invocation_happened);
+
+    rw_handler_write(tester.outgoing_args.rw_handler, aws_atomic_load_ptr(&tester.outgoing_args.rw_slot), &tail_buf);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_socket_test_full_read_predicate, &tester.incoming_rw_args));
+    ASSERT_BIN_ARRAYS_EQUALS(
+        tail.ptr,
+        tail.len,
+        tester.incoming_rw_args.received_message.buffer,
+        tester.incoming_rw_args.received_message.len);
+
+    ASSERT_SUCCESS(s_socket_channel_pair_tester_clean_up(&tester));
+
+    aws_byte_buf_clean_up(&incoming_received_message);
+    aws_byte_buf_clean_up(&frame);
+    aws_byte_buf_clean_up(&payload);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(socket_handler_lend_read_buffer, s_socket_handler_lend_read_buffer_test)
+
+struct lend_read_buffer_now_test_args {
+    struct channel_call_test_args call;
+    struct aws_byte_buf *buffer;
+    int closed_window_error;
+};
+
+/* with the window closed, nothing can be read. Once it opens, reads whatever the socket has into the buffer until it is
+ * full. The payload was written before this task was scheduled, so it is on its way if not there yet. */
+static void s_lend_read_buffer_now_test_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+
+    struct lend_read_buffer_now_test_args *lend_args = arg;
+    struct aws_channel_slot *slot = lend_args->call.slot;
+    struct aws_channel_lend_read_buffer_options options = {.buffer = lend_args->buffer};
+
+    int closed_window_error = AWS_ERROR_SUCCESS;
+    if (aws_channel_slot_lend_read_buffer(slot, &options)) {
+        closed_window_error = aws_last_error();
+    }
+
+    rw_handler_trigger_increment_read_window(slot->handler, slot, lend_args->buffer->capacity);
+
+    int error_code = AWS_ERROR_SUCCESS;
+    while (lend_args->buffer->len < lend_args->buffer->capacity) {
+        if (aws_channel_slot_lend_read_buffer(slot, &options) && aws_last_error() != AWS_IO_READ_WOULD_BLOCK) {
+            error_code = aws_last_error();
+            break;
+        }
+    }
+
+    lend_args->closed_window_error = closed_window_error;
+    s_channel_call_test_completed(&lend_args->call, error_code, lend_args->buffer->len);
+}
+
+/* without on_filled, the buffer is filled right away from what the socket has, as a TLS handler's receive hook does */
+static int s_socket_handler_lend_read_buffer_now_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t payload_length = 10000;
+
+    struct aws_byte_buf payload;
+    ASSERT_SUCCESS(aws_byte_buf_init(&payload, allocator, payload_length));
+    for (size_t i = 0; i < payload_length; ++i) {
+        payload.buffer[i] = (uint8_t)(i * 13 + i / 256);
+    }
+    payload.len = payload_length;
+
+    struct aws_byte_buf lent;
+    ASSERT_SUCCESS(aws_byte_buf_init(&lent, allocator, payload_length));
+
+    /* whatever follows the payload is read as messages */
+    struct aws_byte_cursor tail = aws_byte_cursor_from_c_str("after the payload");
+    struct aws_byte_buf tail_buf = aws_byte_buf_from_array(tail.ptr, tail.len);
+
+    struct aws_byte_buf incoming_received_message;
+    ASSERT_SUCCESS(aws_byte_buf_init(&incoming_received_message, allocator, tail.len));
+
+    /* the incoming end starts with a closed window, so its socket handler leaves the payload on the socket */
+    struct socket_channel_pair_tester tester;
+    struct socket_channel_pair_tester_options tester_options = {
+        .incoming_received_message = incoming_received_message,
+        .incoming_expected_read = tail.len,
+        .incoming_read_back_pressure = true,
+        .incoming_read_window = 0,
+    };
+    ASSERT_SUCCESS(s_socket_channel_pair_tester_init(allocator, &tester, &tester_options));
+
+    rw_handler_write(tester.outgoing_args.rw_handler, aws_atomic_load_ptr(&tester.outgoing_args.rw_slot), &payload);
+
+    struct lend_read_buffer_now_test_args lend_args = {.buffer = &lent};
+    s_channel_call_test_args_init(
+        &lend_args.call,
+        aws_atomic_load_ptr(&tester.incoming_args.rw_slot),
+        s_lend_read_buffer_now_test_task,
+        &lend_args);
+    s_channel_call_test_schedule(&lend_args.call);
+
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_call_completed_predicate, &lend_args.call));
+    ASSERT_INT_EQUALS(AWS_IO_READ_WOULD_BLOCK, lend_args.closed_window_error);
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, lend_args.call.error_code);
+    ASSERT_BIN_ARRAYS_EQUALS(payload.buffer, payload.len, lent.buffer, lent.len);
+
+    /* nothing of the payload went up the channel */
+    ASSERT_FALSE(tester.incoming_rw_args.invocation_happened);
+
+    rw_handler_write(tester.outgoing_args.rw_handler, aws_atomic_load_ptr(&tester.outgoing_args.rw_slot), &tail_buf);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_socket_test_full_read_predicate, &tester.incoming_rw_args));
+    ASSERT_BIN_ARRAYS_EQUALS(
+        tail.ptr,
+        tail.len,
+        tester.incoming_rw_args.received_message.buffer,
+        tester.incoming_rw_args.received_message.len);
+
+    ASSERT_SUCCESS(s_socket_channel_pair_tester_clean_up(&tester));
+
+    aws_byte_buf_clean_up(&incoming_received_message);
+    aws_byte_buf_clean_up(&lent);
+    aws_byte_buf_clean_up(&payload);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(socket_handler_lend_read_buffer_now, s_socket_handler_lend_read_buffer_now_test)
+
+/* opens the window for the whole payload, then reads until the socket handler's read budget for this tick stops it */
+static void s_lend_read_buffer_now_budget_test_task(
+    struct aws_channel_task *task,
+    void *arg,
+    enum aws_task_status status) {
+    (void)task;
+    (void)status;
+
+    struct lend_read_buffer_now_test_args *lend_args = arg;
+    struct aws_channel_slot *slot = lend_args->call.slot;
+    struct aws_channel_lend_read_buffer_options options = {.buffer = lend_args->buffer};
+
+    rw_handler_trigger_increment_read_window(slot->handler, slot, lend_args->buffer->capacity);
+
+    int error_code = AWS_ERROR_SUCCESS;
+    while (lend_args->buffer->len < lend_args->buffer->capacity) {
+        if (aws_channel_slot_lend_read_buffer(slot, &options)) {
+            error_code = aws_last_error();
+            /* until the payload shows up, there's nothing to read either */
+            if (error_code != AWS_IO_READ_WOULD_BLOCK || lend_args->buffer->len >= g_aws_channel_max_fragment_size) {
+                break;
+            }
+            error_code = AWS_ERROR_SUCCESS;
+        }
+    }
+
+    s_channel_call_test_completed(&lend_args->call, error_code, lend_args->buffer->len);
+}
+
+/* reads into a lent buffer count against the per-tick read budget, what's past it is read as messages on later ticks */
+static int s_socket_handler_lend_read_buffer_now_budget_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t budget = g_aws_channel_max_fragment_size;
+    const size_t payload_length = budget * 3;
+
+    struct aws_byte_buf payload;
+    ASSERT_SUCCESS(aws_byte_buf_init(&payload, allocator, payload_length));
+    for (size_t i = 0; i < payload_length; ++i) {
+        payload.buffer[i] = (uint8_t)(i * 7 + i / 256);
+    }
+    payload.len = payload_length;
+
+    struct aws_byte_buf lent;
+    ASSERT_SUCCESS(aws_byte_buf_init(&lent, allocator, payload_length));
+
+    struct aws_byte_buf incoming_received_message;
+    ASSERT_SUCCESS(aws_byte_buf_init(&incoming_received_message, allocator, payload_length - budget));
+
+    struct socket_channel_pair_tester tester;
+    struct socket_channel_pair_tester_options tester_options = {
+        .incoming_received_message = incoming_received_message,
+        .incoming_expected_read = payload_length - budget,
+        .incoming_read_back_pressure = true,
+        .incoming_read_window = 0,
+    };
+    ASSERT_SUCCESS(s_socket_channel_pair_tester_init(allocator, &tester, &tester_options));
+
+    rw_handler_write(tester.outgoing_args.rw_handler, aws_atomic_load_ptr(&tester.outgoing_args.rw_slot), &payload);
+
+    struct lend_read_buffer_now_test_args lend_args = {.buffer = &lent};
+    s_channel_call_test_args_init(
+        &lend_args.call,
+        aws_atomic_load_ptr(&tester.incoming_args.rw_slot),
+        s_lend_read_buffer_now_budget_test_task,
+        &lend_args);
+    s_channel_call_test_schedule(&lend_args.call);
+
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_call_completed_predicate, &lend_args.call));
+    ASSERT_INT_EQUALS(AWS_IO_READ_WOULD_BLOCK, lend_args.call.error_code);
+    ASSERT_UINT_EQUALS(budget, lent.len);
+    ASSERT_BIN_ARRAYS_EQUALS(payload.buffer, budget, lent.buffer, lent.len);
+
+    /* the socket handler picks up the rest on its own */
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_socket_test_full_read_predicate, &tester.incoming_rw_args));
+    ASSERT_BIN_ARRAYS_EQUALS(
+        payload.buffer + budget,
+        payload_length - budget,
+        tester.incoming_rw_args.received_message.buffer,
+        tester.incoming_rw_args.received_message.len);
+
+    ASSERT_SUCCESS(s_socket_channel_pair_tester_clean_up(&tester));
+
+    aws_byte_buf_clean_up(&incoming_received_message);
+    aws_byte_buf_clean_up(&lent);
+    aws_byte_buf_clean_up(&payload);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(socket_handler_lend_read_buffer_now_budget, s_socket_handler_lend_read_buffer_now_budget_test)
+
+static int s_socket_close_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    s_socket_common_tester_init(allocator, &c_tester);
 
     uint8_t outgoing_received_message[128];
     uint8_t incoming_received_message[128];
@@ -652,11 +1698,10 @@ static int s_open_channel_statistics_test(struct aws_allocator *allocator, void
     struct local_server_tester local_server_tester;
     ASSERT_SUCCESS(s_local_server_tester_init(allocator, &local_server_tester, &incoming_args, &c_tester, false));
 
-    struct aws_client_bootstrap_options bootstrap_options;
-    AWS_ZERO_STRUCT(bootstrap_options);
-    bootstrap_options.event_loop_group = c_tester.el_group;
-    bootstrap_options.host_resolver = NULL;
-
+    struct aws_client_bootstrap_options bootstrap_options = {
+        .event_loop_group = c_tester.el_group,
+        .host_resolver = NULL,
+    };
     struct aws_client_bootstrap *client_bootstrap = aws_client_bootstrap_new(allocator, &bootstrap_options);
     ASSERT_NOT_NULL(client_bootstrap);
 
@@ -666,7 +1711,6 @@ static int s_open_channel_statistics_test(struct aws_allocator *allocator, void
     channel_options.host_name = local_server_tester.endpoint.address;
     channel_options.port = 0;
     channel_options.socket_options = &local_server_tester.socket_options;
-    channel_options.creation_callback = s_creation_callback_test_channel_creation_callback;
     channel_options.setup_callback = s_socket_handler_test_client_setup_callback;
     channel_options.shutdown_callback = s_socket_handler_test_client_shutdown_callback;
     channel_options.user_data = &outgoing_args;
@@ -680,34 +1724,6 @@ static int s_open_channel_statistics_test(struct aws_allocator *allocator, void
     ASSERT_SUCCESS(aws_condition_variable_wait_pred(
         &c_tester.condition_variable, &c_tester.mutex, s_channel_setup_predicate, &outgoing_args));
 
-    ASSERT_TRUE(outgoing_args.creation_callback_invoked);
-
-    struct aws_channel_slot *outgoing_slot = aws_atomic_load_ptr(&outgoing_args.rw_slot);
-    rw_handler_write(outgoing_args.rw_handler, outgoing_slot, &write_tag);
-    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
-        &c_tester.condition_variable, &c_tester.mutex, s_socket_test_read_predicate, &incoming_rw_args));
-
-    struct aws_channel_slot *incoming_slot = aws_atomic_load_ptr(&incoming_args.rw_slot);
-    rw_handler_write(incoming_args.rw_handler, incoming_slot, &read_tag);
-    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
-        &c_tester.condition_variable, &c_tester.mutex, s_socket_test_read_predicate, &outgoing_rw_args));
-
-    uint64_t ms_to_ns = aws_timestamp_convert(1, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL);
-
-    aws_atomic_store_int(&c_tester.current_time_ns, (size_t)ms_to_ns);
-
-    struct aws_crt_statistics_handler *stats_handler = aws_atomic_load_ptr(&c_tester.stats_handler);
-    struct aws_statistics_handler_test_impl *stats_impl = stats_handler->impl;
-
-    aws_mutex_lock(&stats_impl->lock);
-    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
-        &stats_impl->signal, &stats_impl->lock, s_stats_processed_predicate, stats_handler));
-
-    ASSERT_TRUE(stats_impl->total_bytes_read == read_tag.len);
-    ASSERT_TRUE(stats_impl->total_bytes_written == write_tag.len);
-
-    aws_mutex_unlock(&stats_impl->lock);
-
     aws_channel_shutdown(incoming_args.channel, AWS_OP_SUCCESS);
 
     ASSERT_SUCCESS(aws_condition_variable_wait_pred(
@@ -715,6 +1731,9 @@ static int s_open_channel_statistics_test(struct aws_allocator *allocator, void
     ASSERT_SUCCESS(aws_condition_variable_wait_pred(
         &c_tester.condition_variable, &c_tester.mutex, s_channel_shutdown_predicate, &outgoing_args));
 
+    ASSERT_INT_EQUALS(AWS_OP_SUCCESS, incoming_args.error_code);
+    ASSERT_TRUE(
+        AWS_IO_SOCKET_CLOSED == outgoing_args.error_code || AWS_IO_SOCKET_NOT_CONNECTED == outgoing_args.error_code);
     aws_server_bootstrap_destroy_socket_listener(local_server_tester.server_bootstrap, local_server_tester.listener);
     ASSERT_SUCCESS(aws_condition_variable_wait_pred(
         &c_tester.condition_variable, &c_tester.mutex, s_listener_destroy_predicate, &incoming_args));
@@ -730,4 +1749,1694 @@ static int s_open_channel_statistics_test(struct aws_allocator *allocator, void
     return AWS_OP_SUCCESS;
 }
 
-AWS_TEST_CASE(open_channel_statistics_test, s_open_channel_statistics_test)
+AWS_TEST_CASE(socket_handler_close, s_socket_close_test)
+
+#ifndef _WIN32
+/*
+ * Shuts down a server channel with an abortive bulk shutdown and checks the peer, a plain blocking socket that isn't
+ * on any event loop, sees a reset rather than an orderly end of stream.
+ */
+static int s_socket_handler_bulk_abortive_shutdown_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    s_socket_common_tester_init(allocator, &c_tester);
+
+    /* a single loop, so the one bulk request covers the accepted channel */
+    struct aws_event_loop_group *el_group = aws_event_loop_group_new_default(allocator, 1, NULL);
+    ASSERT_NOT_NULL(el_group);
+    struct aws_event_loop *event_loop = aws_event_loop_group_get_loop_at(el_group, 0);
+
+    uint8_t incoming_received_message[128];
+    struct socket_test_rw_args incoming_rw_args;
+    ASSERT_SUCCESS(s_rw_args_init(
+        &incoming_rw_args,
+        &c_tester,
+        aws_byte_buf_from_empty_array(incoming_received_message, sizeof(incoming_received_message)),
+        0));
+
+    struct aws_channel_handler *incoming_rw_handler = rw_handler_new(
+        allocator, s_socket_test_handle_read, s_socket_test_handle_write, true, 10000, &incoming_rw_args);
+    ASSERT_NOT_NULL(incoming_rw_handler);
+
+    struct socket_test_args incoming_args;
+    ASSERT_SUCCESS(s_socket_test_args_init(&incoming_args, &c_tester, incoming_rw_handler));
+
+    struct aws_socket_options socket_options = {
+        .connect_timeout_ms = 3000,
+        .type = AWS_SOCKET_STREAM,
+        .domain = AWS_SOCKET_IPV4,
+    };
+
+    struct aws_server_bootstrap *server_bootstrap = aws_server_bootstrap_new(allocator, el_group);
+    ASSERT_NOT_NULL(server_bootstrap);
+
+    struct aws_server_socket_channel_bootstrap_options bootstrap_options = {
+        .bootstrap = server_bootstrap,
+        .host_name = "127.0.0.1",
+        .port = 0,
+        .socket_options = &socket_options,
+        .incoming_callback = s_socket_handler_test_server_setup_callback,
+        .shutdown_callback = s_socket_handler_test_server_shutdown_callback,
+        .destroy_callback = s_socket_handler_test_server_listener_destroy_callback,
+        .user_data = &incoming_args,
+    };
+    struct aws_socket *listener = aws_server_bootstrap_new_socket_listener(&bootstrap_options);
+    ASSERT_NOT_NULL(listener);
+
+    int peer_fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_TRUE(peer_fd >= 0);
+    struct timeval receive_timeout = {.tv_sec = 5};
+    ASSERT_SUCCESS(setsockopt(peer_fd, SOL_SOCKET, SO_RCVTIMEO, &receive_timeout, sizeof(receive_timeout)));
+
+    struct sockaddr_in server_address;
+    AWS_ZERO_STRUCT(server_address);
+    server_address.sin_family = AF_INET;
+    server_address.sin_port = htons(listener->local_endpoint.port);
+    server_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_SUCCESS(connect(peer_fd, (struct sockaddr *)&server_address, sizeof(server_address)));
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_setup_predicate, &incoming_args));
+
+    struct aws_channel_bulk_shutdown_options shutdown_options = {
+        .error_code = AWS_IO_EVENT_LOOP_SHUTDOWN,
+        .abortive = true,
+    };
+    ASSERT_SUCCESS(aws_channel_shutdown_event_loop_channels(event_loop, &shutdown_options));
+
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_shutdown_predicate, &incoming_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&c_tester.mutex));
+
+    /* SO_LINGER 0 sends a RST, so the peer's read fails instead of returning end of stream */
+    uint8_t byte = 0;
+    ASSERT_INT_EQUALS(-1, recv(peer_fd, &byte, sizeof(byte), 0));
+    ASSERT_INT_EQUALS(ECONNRESET, errno);
+    close(peer_fd);
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+    aws_server_bootstrap_destroy_socket_listener(server_bootstrap, listener);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_listener_destroy_predicate, &incoming_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&c_tester.mutex));
+
+    aws_server_bootstrap_release(server_bootstrap);
+    aws_event_loop_group_release(el_group);
+    ASSERT_SUCCESS(s_socket_common_tester_clean_up(&c_tester));
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(socket_handler_bulk_abortive_shutdown, s_socket_handler_bulk_abortive_shutdown_test)
+#endif /* _WIN32 */
+
+static void s_creation_callback_test_channel_creation_callback(
+    struct aws_client_bootstrap *bootstrap,
+    int error_code,
+    struct aws_channel *channel,
+    void *user_data) {
+
+    (void)bootstrap;
+    (void)error_code;
+
+    struct socket_test_args *setup_test_args = (struct socket_test_args *)user_data;
+
+    setup_test_args->creation_callback_invoked = true;
+
+    struct aws_crt_statistics_handler *stats_handler = aws_statistics_handler_new_test(bootstrap->allocator);
+    aws_atomic_store_ptr(&c_tester.stats_handler, stats_handler);
+
+    aws_channel_set_statistics_handler(channel, stats_handler);
+}
+
+static struct aws_event_loop *s_default_new_event_loop(
+    struct aws_allocator *allocator,
+    aws_io_clock_fn *clock,
+    void *user_data) {
+
+    (void)user_data;
+    return aws_event_loop_new_default(allocator, clock);
+}
+
+static int s_statistic_test_clock_fn(uint64_t *timestamp) {
+    *timestamp = aws_atomic_load_int(&c_tester.current_time_ns);
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_socket_common_tester_statistics_init(
+    struct aws_allocator *allocator,
+    struct socket_common_tester *tester) {
+
+    aws_io_library_init(allocator);
+
+    AWS_ZERO_STRUCT(*tester);
+    tester->el_group =
+        aws_event_loop_group_new(allocator, s_statistic_test_clock_fn, 1, s_default_new_event_loop, NULL, NULL);
+    struct aws_mutex mutex = AWS_MUTEX_INIT;
+    struct aws_condition_variable condition_variable = AWS_CONDITION_VARIABLE_INIT;
+    tester->mutex = mutex;
+    tester->condition_variable = condition_variable;
+    aws_atomic_store_int(&tester->current_time_ns, 0);
+    aws_atomic_store_ptr(&tester->stats_handler, NULL);
+
+    return AWS_OP_SUCCESS;
+}
+
+static bool s_stats_processed_predicate(void *user_data) {
+    struct aws_crt_statistics_handler *stats_handler = user_data;
+    struct aws_statistics_handler_test_impl *stats_impl = stats_handler->impl;
+
+    return stats_impl->total_bytes_read > 0 && stats_impl->total_bytes_written > 0;
+}
+
+static int s_open_channel_statistics_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    s_socket_common_tester_statistics_init(allocator, &c_tester);
+
+    struct aws_byte_buf read_tag = aws_byte_buf_from_c_str("Some bytes");
+    struct aws_byte_buf write_tag = aws_byte_buf_from_c_str("Fresh pressed Washington apples");
+
+    uint8_t outgoing_received_message[128];
+    uint8_t incoming_received_message[128];
+
+    struct socket_test_rw_args incoming_rw_args;
+    ASSERT_SUCCESS(s_rw_args_init(
+        &incoming_rw_args,
+        &c_tester,
+        aws_byte_buf_from_empty_array(incoming_received_message, sizeof(incoming_received_message)),
+        0));
+
+    struct socket_test_rw_args outgoing_rw_args;
+    ASSERT_SUCCESS(s_rw_args_init(
+        &outgoing_rw_args,
+        &c_tester,
+        aws_byte_buf_from_empty_array(outgoing_received_message, sizeof(outgoing_received_message)),
+        0));
+
+    struct aws_channel_handler *outgoing_rw_handler = rw_handler_new(
+        allocator, s_socket_test_handle_read, s_socket_test_handle_write, true, 10000, &outgoing_rw_args);
+    ASSERT_NOT_NULL(outgoing_rw_handler);
+
+    struct aws_channel_handler *incoming_rw_handler = rw_handler_new(
+        allocator, s_socket_test_handle_read, s_socket_test_handle_write, true, 10000, &incoming_rw_args);
+    ASSERT_NOT_NULL(outgoing_rw_handler);
+
+    struct socket_test_args incoming_args;
+    ASSERT_SUCCESS(s_socket_test_args_init(&incoming_args, &c_tester, incoming_rw_handler));
+
+    struct socket_test_args outgoing_args;
+    ASSERT_SUCCESS(s_socket_test_args_init(&outgoing_args, &c_tester, outgoing_rw_handler));
+
+    struct local_server_tester local_server_tester;
+    ASSERT_SUCCESS(s_local_server_tester_init(allocator, &local_server_tester, &incoming_args, &c_tester, false));
+
+    struct aws_client_bootstrap_options bootstrap_options;
+    AWS_ZERO_STRUCT(bootstrap_options);
+    bootstrap_options.event_loop_group = c_tester.el_group;
+    bootstrap_options.host_resolver = NULL;
+
+    struct aws_client_bootstrap *client_bootstrap = aws_client_bootstrap_new(allocator, &bootstrap_options);
+    ASSERT_NOT_NULL(client_bootstrap);
+
+    struct aws_socket_channel_bootstrap_options channel_options;
+    AWS_ZERO_STRUCT(channel_options);
+    channel_options.bootstrap = client_bootstrap;
+    channel_options.host_name = local_server_tester.endpoint.address;
+    channel_options.port = 0;
+    channel_options.socket_options = &local_server_tester.socket_options;
+    channel_options.creation_callback = s_creation_callback_test_channel_creation_callback;
+    channel_options.setup_callback = s_socket_handler_test_client_setup_callback;
+    channel_options.shutdown_callback = s_socket_handler_test_client_shutdown_callback;
+    channel_options.user_data = &outgoing_args;
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+    ASSERT_SUCCESS(aws_client_bootstrap_new_socket_channel(&channel_options));
+
+    /* wait for both ends to setup */
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_setup_predicate, &incoming_args));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_setup_predicate, &outgoing_args));
+
+    ASSERT_TRUE(outgoing_args.creation_callback_invoked);
+
+    struct aws_channel_slot *outgoing_slot = aws_atomic_load_ptr(&outgoing_args.rw_slot);
+    rw_handler_write(outgoing_args.rw_handler, outgoing_slot, &write_tag);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_socket_test_read_predicate, &incoming_rw_args));
+
+    struct aws_channel_slot *incoming_slot = aws_atomic_load_ptr(&incoming_args.rw_slot);
+    rw_handler_write(incoming_args.rw_handler, incoming_slot, &read_tag);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_socket_test_read_predicate, &outgoing_rw_args));
+
+    uint64_t ms_to_ns = aws_timestamp_convert(1, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL);
+
+    aws_atomic_store_int(&c_tester.current_time_ns, (size_t)ms_to_ns);
+
+    struct aws_crt_statistics_handler *stats_handler = aws_atomic_load_ptr(&c_tester.stats_handler);
+    struct aws_statistics_handler_test_impl *stats_impl = stats_handler->impl;
+
+    aws_mutex_lock(&stats_impl->lock);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &stats_impl->signal, &stats_impl->lock, s_stats_processed_predicate, stats_handler));
+
+    ASSERT_TRUE(stats_impl->total_bytes_read == read_tag.len);
+    ASSERT_TRUE(stats_impl->total_bytes_written == write_tag.len);
+
+    aws_mutex_unlock(&stats_impl->lock);
+
+    aws_channel_shutdown(incoming_args.channel, AWS_OP_SUCCESS);
+
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_shutdown_predicate, &incoming_args));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_shutdown_predicate, &outgoing_args));
+
+    aws_server_bootstrap_destroy_socket_listener(local_server_tester.server_bootstrap, local_server_tester.listener);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_listener_destroy_predicate, &incoming_args));
+
+    aws_mutex_unlock(&c_tester.mutex);
+
+    /* clean up */
+    ASSERT_SUCCESS(s_local_server_tester_clean_up(&local_server_tester));
+
+    aws_client_bootstrap_release(client_bootstrap);
+    ASSERT_SUCCESS(s_socket_common_tester_clean_up(&c_tester));
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(open_channel_statistics_test, s_open_channel_statistics_test)
+
+#define FOOTPRINT_TEST_CONNECTION_COUNT 32
+#define CONNECTION_COUNT_TEST_MAX_CONNECTIONS (FOOTPRINT_TEST_CONNECTION_COUNT + 1)
+
+/*
+ * Counts the channels a test's bootstraps set up and shut down, and keeps the client channels so the test can shut
+ * them down. The predicates wait for expected_count of each, or only of the client channels when the test accepts the
+ * connections itself.
+ */
+struct connection_count_test_args {
+    struct aws_allocator *allocator;
+    struct aws_mutex *mutex;
+    struct aws_condition_variable *condition_variable;
+    struct aws_channel *client_channels[CONNECTION_COUNT_TEST_MAX_CONNECTIONS];
+    /* optional, records the event loop of each server channel, up to expected_count of them */
+    struct aws_event_loop **server_channel_loops;
+    size_t client_setup_count;
+    size_t server_setup_count;
+    size_t client_shutdown_count;
+    size_t server_shutdown_count;
+    size_t expected_count;
+    int error_code;
+    bool clients_only;
+    bool listener_destroyed;
+};
+
+static bool s_connection_count_setup_predicate(void *user_data) {
+    struct connection_count_test_args *args = user_data;
+    return args->error_code != 0 || (args->client_setup_count == args->expected_count &&
+                                     (args->clients_only || args->server_setup_count == args->expected_count));
+}
+
+static bool s_connection_count_shutdown_predicate(void *user_data) {
+    struct connection_count_test_args *args = user_data;
+    return args->client_shutdown_count == args->expected_count &&
+           (args->clients_only || args->server_shutdown_count == args->expected_count);
+}
+
+static bool s_connection_count_listener_destroy_predicate(void *user_data) {
+    struct connection_count_test_args *args = user_data;
+    return args->listener_destroyed;
+}
+
+/* adds a pass-through handler that drops whatever it reads at the end of the channel */
+static int s_add_rw_handler_slot(struct aws_allocator *allocator, struct aws_channel *channel) {
+    struct aws_channel_handler *rw_handler =
+        rw_handler_new(allocator, s_socket_test_handle_write, s_socket_test_handle_write, true, 10000, NULL);
+    if (!rw_handler) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_channel_slot *rw_slot = aws_channel_slot_new(channel);
+    if (!rw_slot) {
+        aws_channel_handler_destroy(rw_handler);
+        return AWS_OP_ERR;
+    }
+
+    aws_channel_slot_insert_end(channel, rw_slot);
+    return aws_channel_slot_set_handler(rw_slot, rw_handler);
+}
+
+static void s_connection_count_client_setup_callback(
+    struct aws_client_bootstrap *bootstrap,
+    int error_code,
+    struct aws_channel *channel,
+    void *user_data) {
+
+    (void)bootstrap;
+
+    struct connection_count_test_args *args = user_data;
+    if (!error_code && s_add_rw_handler_slot(args->allocator, channel)) {
+        error_code = aws_last_error();
+    }
+
+    aws_mutex_lock(args->mutex);
+    if (error_code) {
+        args->error_code = error_code;
+    } else {
+        args->client_channels[args->client_setup_count++] = channel;
+    }
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(args->condition_variable);
+}
+
+static void s_connection_count_client_shutdown_callback(
+    struct aws_client_bootstrap *bootstrap,
+    int error_code,
+    struct aws_channel *channel,
+    void *user_data) {
+
+    (void)bootstrap;
+    (void)error_code;
+    (void)channel;
+
+    struct connection_count_test_args *args = user_data;
+    aws_mutex_lock(args->mutex);
+    args->client_shutdown_count++;
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(args->condition_variable);
+}
+
+static void s_connection_count_server_setup_callback(
+    struct aws_server_bootstrap *bootstrap,
+    int error_code,
+    struct aws_channel *channel,
+    void *user_data) {
+
+    (void)bootstrap;
+
+    struct connection_count_test_args *args = user_data;
+    if (!error_code && s_add_rw_handler_slot(args->allocator, channel)) {
+        error_code = aws_last_error();
+    }
+
+    aws_mutex_lock(args->mutex);
+    if (error_code) {
+        args->error_code = error_code;
+    } else {
+        if (args->server_channel_loops && args->server_setup_count < args->expected_count) {
+            args->server_channel_loops[args->server_setup_count] = aws_channel_get_event_loop(channel);
+        }
+        args->server_setup_count++;
+    }
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(args->condition_variable);
+}
+
+static void s_connection_count_server_shutdown_callback(
+    struct aws_server_bootstrap *bootstrap,
+    int error_code,
+    struct aws_channel *channel,
+    void *user_data) {
+
+    (void)bootstrap;
+    (void)error_code;
+    (void)channel;
+
+    struct connection_count_test_args *args = user_data;
+    aws_mutex_lock(args->mutex);
+    args->server_shutdown_count++;
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(args->condition_variable);
+}
+
+static void s_connection_count_listener_destroy_callback(struct aws_server_bootstrap *bootstrap, void *user_data) {
+    (void)bootstrap;
+
+    struct connection_count_test_args *args = user_data;
+    aws_mutex_lock(args->mutex);
+    args->listener_destroyed = true;
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(args->condition_variable);
+}
+
+/*
+ * Measures the steady-state heap footprint of an idle plaintext connection (both the client and the server channel,
+ * each with a socket handler and a pass-through handler). The per-loop message pools are pre-warmed and a warm-up
+ * connection is opened before the baseline is taken, so only memory that scales with the connection count is counted.
+ * Channels without a statistics handler don't reserve statistics storage. The sockets' endpoint storage is still
+ * sized for AF_UNIX paths, shrinking it for IP sockets is not covered here.
+ */
+static int s_socket_handler_connection_footprint_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_allocator *tracer = aws_mem_tracer_new(allocator, NULL, AWS_MEMTRACE_BYTES, 0);
+    ASSERT_NOT_NULL(tracer);
+
+    s_socket_common_tester_init(allocator, &c_tester);
+
+    struct connection_count_test_args args = {
+        .allocator = tracer,
+        .mutex = &c_tester.mutex,
+        .condition_variable = &c_tester.condition_variable,
+    };
+
+    struct local_server_tester server;
+    AWS_ZERO_STRUCT(server);
+    server.socket_options.connect_timeout_ms = 3000;
+    server.socket_options.type = AWS_SOCKET_STREAM;
+    server.socket_options.domain = AWS_SOCKET_LOCAL;
+    ASSERT_SUCCESS(aws_sys_clock_get_ticks(&server.timestamp));
+    snprintf(
+        server.endpoint.address,
+        sizeof(server.endpoint.address),
+        LOCAL_SOCK_TEST_PATTERN,
+        (long long unsigned)server.timestamp);
+    server.server_bootstrap = aws_server_bootstrap_new(tracer, c_tester.el_group);
+    ASSERT_NOT_NULL(server.server_bootstrap);
+
+    struct aws_server_socket_channel_bootstrap_options server_options = {
+        .bootstrap = server.server_bootstrap,
+        .host_name = server.endpoint.address,
+        .port = server.endpoint.port,
+        .socket_options = &server.socket_options,
+        .incoming_callback = s_connection_count_server_setup_callback,
+        .shutdown_callback = s_connection_count_server_shutdown_callback,
+        .destroy_callback = s_connection_count_listener_destroy_callback,
+        .user_data = &args,
+    };
+    server.listener = aws_server_bootstrap_new_socket_listener(&server_options);
+    ASSERT_NOT_NULL(server.listener);
+
+    struct aws_client_bootstrap_options bootstrap_options = {
+        .event_loop_group = c_tester.el_group,
+        .host_resolver = NULL,
+        .prewarm_event_loops = true,
+    };
+    struct aws_client_bootstrap *client_bootstrap = aws_client_bootstrap_new(tracer, &bootstrap_options);
+    ASSERT_NOT_NULL(client_bootstrap);
+
+    struct aws_socket_channel_bootstrap_options channel_options;
+    AWS_ZERO_STRUCT(channel_options);
+    channel_options.bootstrap = client_bootstrap;
+    channel_options.host_name = server.endpoint.address;
+    channel_options.port = 0;
+    channel_options.socket_options = &server.socket_options;
+    channel_options.setup_callback = s_connection_count_client_setup_callback;
+    channel_options.shutdown_callback = s_connection_count_client_shutdown_callback;
+    channel_options.user_data = &args;
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+
+    /* warm-up connection, so lazily created listener and bootstrap state is part of the baseline */
+    args.expected_count = 1;
+    ASSERT_SUCCESS(aws_client_bootstrap_new_socket_channel(&channel_options));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_connection_count_setup_predicate, &args));
+    ASSERT_INT_EQUALS(0, args.error_code);
+
+    size_t baseline_bytes = aws_mem_tracer_bytes(tracer);
+
+    args.expected_count = FOOTPRINT_TEST_CONNECTION_COUNT + 1;
+    for (size_t i = 0; i < FOOTPRINT_TEST_CONNECTION_COUNT; ++i) {
+        ASSERT_SUCCESS(aws_client_bootstrap_new_socket_channel(&channel_options));
+    }
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_connection_count_setup_predicate, &args));
+    ASSERT_INT_EQUALS(0, args.error_code);
+
+    size_t connected_bytes = aws_mem_tracer_bytes(tracer);
+    ASSERT_TRUE(connected_bytes > baseline_bytes);
+
+    for (size_t i = 0; i < args.expected_count; ++i) {
+        ASSERT_SUCCESS(aws_channel_shutdown(args.client_channels[i], AWS_OP_SUCCESS));
+    }
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_connection_count_shutdown_predicate, &args));
+
+    aws_server_bootstrap_destroy_socket_listener(server.server_bootstrap, server.listener);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_connection_count_listener_destroy_predicate, &args));
+
+    aws_mutex_unlock(&c_tester.mutex);
+
+    ASSERT_SUCCESS(s_local_server_tester_clean_up(&server));
+    aws_client_bootstrap_release(client_bootstrap);
+    ASSERT_SUCCESS(s_socket_common_tester_clean_up(&c_tester));
+
+    aws_mem_tracer_destroy(tracer);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(socket_handler_connection_footprint, s_socket_handler_connection_footprint_test)
+
+#ifndef _WIN32
+#    define SHARDED_LISTENER_CONNECTION_COUNT 16
+
+/*
+ * Opens a listener sharded across every event loop of the group on an ephemeral port, connects to it, and makes sure
+ * every connection is set up and shut down, and that the destroy callback only fires once every shard is gone.
+ * Where the kernel supports it, a reuseport BPF program sends every connection to the primary listener, so every
+ * server channel has to be on the primary listener's loop, not wherever the group would have put it.
+ */
+static int s_socket_handler_sharded_listener_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    s_socket_common_tester_init(allocator, &c_tester);
+
+    struct aws_event_loop *server_channel_loops[SHARDED_LISTENER_CONNECTION_COUNT];
+    struct connection_count_test_args args = {
+        .allocator = allocator,
+        .mutex = &c_tester.mutex,
+        .condition_variable = &c_tester.condition_variable,
+        .server_channel_loops = server_channel_loops,
+        .expected_count = SHARDED_LISTENER_CONNECTION_COUNT,
+    };
+
+    struct aws_socket_options socket_options = {
+        .connect_timeout_ms = 3000,
+        .type = AWS_SOCKET_STREAM,
+        .domain = AWS_SOCKET_IPV4,
+    };
+
+    struct aws_server_bootstrap *server_bootstrap = aws_server_bootstrap_new(allocator, c_tester.el_group);
+    ASSERT_NOT_NULL(server_bootstrap);
+
+    struct aws_server_socket_channel_bootstrap_options server_options = {
+        .bootstrap = server_bootstrap,
+        .host_name = "127.0.0.1",
+        .port = 0,
+        .socket_options = &socket_options,
+        .incoming_callback = s_connection_count_server_setup_callback,
+        .shutdown_callback = s_connection_count_server_shutdown_callback,
+        .destroy_callback = s_connection_count_listener_destroy_callback,
+        .shard_across_event_loops = true,
+        .user_data = &args,
+    };
+    struct aws_socket *listener = aws_server_bootstrap_new_socket_listener(&server_options);
+    ASSERT_NOT_NULL(listener);
+    ASSERT_TRUE(listener->local_endpoint.port != 0);
+
+#    ifdef SO_ATTACH_REUSEPORT_CBPF
+    /* the primary listener joined the reuseport group first, so it is index 0 */
+    struct sock_filter select_primary[] = {{.code = BPF_RET | BPF_K, .k = 0}};
+    struct sock_fprog select_primary_program = {.len = 1, .filter = select_primary};
+    ASSERT_SUCCESS(setsockopt(
+        listener->io_handle.data.fd,
+        SOL_SOCKET,
+        SO_ATTACH_REUSEPORT_CBPF,
+        &select_primary_program,
+        sizeof(select_primary_program)));
+#    endif
+
+    struct aws_host_resolver *resolver = aws_host_resolver_new_default(allocator, 8, c_tester.el_group, NULL);
+    ASSERT_NOT_NULL(resolver);
+
+    struct aws_client_bootstrap_options bootstrap_options = {
+        .event_loop_group = c_tester.el_group,
+        .host_resolver = resolver,
+    };
+    struct aws_client_bootstrap *client_bootstrap = aws_client_bootstrap_new(allocator, &bootstrap_options);
+    ASSERT_NOT_NULL(client_bootstrap);
+
+    struct aws_socket_channel_bootstrap_options channel_options;
+    AWS_ZERO_STRUCT(channel_options);
+    channel_options.bootstrap = client_bootstrap;
+    channel_options.host_name = "127.0.0.1";
+    channel_options.port = listener->local_endpoint.port;
+    channel_options.socket_options = &socket_options;
+    channel_options.setup_callback = s_connection_count_client_setup_callback;
+    channel_options.shutdown_callback = s_connection_count_client_shutdown_callback;
+    channel_options.user_data = &args;
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+
+    for (size_t i = 0; i < SHARDED_LISTENER_CONNECTION_COUNT; ++i) {
+        ASSERT_SUCCESS(aws_client_bootstrap_new_socket_channel(&channel_options));
+    }
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_connection_count_setup_predicate, &args));
+    ASSERT_INT_EQUALS(0, args.error_code);
+
+#    ifdef SO_ATTACH_REUSEPORT_CBPF
+    struct aws_event_loop *primary_loop = aws_socket_get_event_loop(listener);
+    for (size_t i = 0; i < SHARDED_LISTENER_CONNECTION_COUNT; ++i) {
+        ASSERT_PTR_EQUALS(primary_loop, server_channel_loops[i]);
+    }
+#    endif
+
+    for (size_t i = 0; i < SHARDED_LISTENER_CONNECTION_COUNT; ++i) {
+        ASSERT_SUCCESS(aws_channel_shutdown(args.client_channels[i], AWS_OP_SUCCESS));
+    }
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_connection_count_shutdown_predicate, &args));
+
+    aws_server_bootstrap_destroy_socket_listener(server_bootstrap, listener);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_connection_count_listener_destroy_predicate, &args));
+
+    aws_mutex_unlock(&c_tester.mutex);
+
+    aws_server_bootstrap_release(server_bootstrap);
+    aws_client_bootstrap_release(client_bootstrap);
+    aws_host_resolver_release(resolver);
+    ASSERT_SUCCESS(s_socket_common_tester_clean_up(&c_tester));
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(socket_handler_sharded_listener, s_socket_handler_sharded_listener_test)
+
+/*
+ * A listener steering by incoming CPU is refused unless the group's loops are pinned. With pinned loops, over
+ * loopback a connection's packets are processed on the CPU that connects, so each accepted connection has to land on
+ * a loop pinned to the same CPU as the client loop that connected it.
+ */
+static int s_socket_handler_steer_by_incoming_cpu_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    s_socket_common_tester_init(allocator, &c_tester);
+
+    struct aws_event_loop *server_channel_loops[SHARDED_LISTENER_CONNECTION_COUNT];
+    struct connection_count_test_args args = {
+        .allocator = allocator,
+        .mutex = &c_tester.mutex,
+        .condition_variable = &c_tester.condition_variable,
+        .server_channel_loops = server_channel_loops,
+    };
+
+    struct aws_socket_options socket_options = {
+        .connect_timeout_ms = 3000,
+        .type = AWS_SOCKET_STREAM,
+        .domain = AWS_SOCKET_IPV4,
+    };
+
+    struct aws_server_bootstrap *unpinned_bootstrap = aws_server_bootstrap_new(allocator, c_tester.el_group);
+    ASSERT_NOT_NULL(unpinned_bootstrap);
+
+    struct aws_server_socket_channel_bootstrap_options server_options = {
+        .bootstrap = unpinned_bootstrap,
+        .host_name = "127.0.0.1",
+        .port = 0,
+        .socket_options = &socket_options,
+        .incoming_callback = s_connection_count_server_setup_callback,
+        .shutdown_callback = s_connection_count_server_shutdown_callback,
+        .destroy_callback = s_connection_count_listener_destroy_callback,
+        .steer_by_incoming_cpu = true,
+        .user_data = &args,
+    };
+    ASSERT_NULL(aws_server_bootstrap_new_socket_listener(&server_options));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+    aws_server_bootstrap_release(unpinned_bootstrap);
+
+#    ifdef SO_INCOMING_CPU
+    struct aws_event_loop_group *pinned_group = aws_event_loop_group_new_default_pinned_to_cpus(allocator, 0, NULL);
+    ASSERT_NOT_NULL(pinned_group);
+
+    struct aws_server_bootstrap *server_bootstrap = aws_server_bootstrap_new(allocator, pinned_group);
+    ASSERT_NOT_NULL(server_bootstrap);
+    server_options.bootstrap = server_bootstrap;
+    struct aws_socket *listener = aws_server_bootstrap_new_socket_listener(&server_options);
+    ASSERT_NOT_NULL(listener);
+
+    struct aws_host_resolver *resolver = aws_host_resolver_new_default(allocator, 8, pinned_group, NULL);
+    ASSERT_NOT_NULL(resolver);
+
+    struct aws_client_bootstrap_options bootstrap_options = {
+        .event_loop_group = pinned_group,
+        .host_resolver = resolver,
+    };
+    struct aws_client_bootstrap *client_bootstrap = aws_client_bootstrap_new(allocator, &bootstrap_options);
+    ASSERT_NOT_NULL(client_bootstrap);
+
+    struct aws_socket_channel_bootstrap_options channel_options;
+    AWS_ZERO_STRUCT(channel_options);
+    channel_options.bootstrap = client_bootstrap;
+    channel_options.host_name = "127.0.0.1";
+    channel_options.port = listener->local_endpoint.port;
+    channel_options.socket_options = &socket_options;
+    channel_options.setup_callback = s_connection_count_client_setup_callback;
+    channel_options.shutdown_callback = s_connection_count_client_shutdown_callback;
+    channel_options.user_data = &args;
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+
+    /* the client connects from its loop's thread, round robin across the group. One connection at a time. */
+    for (size_t i = 0; i < SHARDED_LISTENER_CONNECTION_COUNT; ++i) {
+        args.expected_count = i + 1;
+        ASSERT_SUCCESS(aws_client_bootstrap_new_socket_channel(&channel_options));
+        ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+            &c_tester.condition_variable, &c_tester.mutex, s_connection_count_setup_predicate, &args));
+        ASSERT_INT_EQUALS(0, args.error_code);
+
+        /* a loop left unpinned, on a CPU outside the process's cpuset, can connect from any CPU */
+        struct aws_event_loop *client_loop = aws_channel_get_event_loop(args.client_channels[i]);
+        ASSERT_TRUE(server_channel_loops[i]->cpu_id >= 0);
+        if (client_loop->cpu_id >= 0) {
+            ASSERT_INT_EQUALS(client_loop->cpu_id, server_channel_loops[i]->cpu_id);
+        }
+    }
+
+    for (size_t i = 0; i < SHARDED_LISTENER_CONNECTION_COUNT; ++i) {
+        ASSERT_SUCCESS(aws_channel_shutdown(args.client_channels[i], AWS_OP_SUCCESS));
+    }
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_connection_count_shutdown_predicate, &args));
+
+    aws_server_bootstrap_destroy_socket_listener(server_bootstrap, listener);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_connection_count_listener_destroy_predicate, &args));
+
+    aws_mutex_unlock(&c_tester.mutex);
+
+    aws_server_bootstrap_release(server_bootstrap);
+    aws_client_bootstrap_release(client_bootstrap);
+    aws_host_resolver_release(resolver);
+    aws_event_loop_group_release(pinned_group);
+#    endif
+
+    ASSERT_SUCCESS(s_socket_common_tester_clean_up(&c_tester));
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(socket_handler_steer_by_incoming_cpu, s_socket_handler_steer_by_incoming_cpu_test)
+
+/* opens a plain listening socket on the loopback address of the family, on an ephemeral port */
+static int s_local_address_listen(int family, int *listener_fd, uint32_t *port) {
+    struct sockaddr_storage address;
+    AWS_ZERO_STRUCT(address);
+    socklen_t address_len = 0;
+    if (family == AF_INET6) {
+        struct sockaddr_in6 *address_in6 = (struct sockaddr_in6 *)&address;
+        address_in6->sin6_family = AF_INET6;
+        address_in6->sin6_addr = in6addr_loopback;
+        address_len = sizeof(*address_in6);
+    } else {
+        struct sockaddr_in *address_in = (struct sockaddr_in *)&address;
+        address_in->sin_family = AF_INET;
+        address_in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address_len = sizeof(*address_in);
+    }
+
+    *listener_fd = socket(family, SOCK_STREAM, 0);
+    if (*listener_fd < 0) {
+        return AWS_OP_ERR;
+    }
+
+    struct timeval accept_timeout = {.tv_sec = 5};
+    if (setsockopt(*listener_fd, SOL_SOCKET, SO_RCVTIMEO, &accept_timeout, sizeof(accept_timeout)) ||
+        bind(*listener_fd, (struct sockaddr *)&address, address_len) || listen(*listener_fd, 8) ||
+        getsockname(*listener_fd, (struct sockaddr *)&address, &address_len)) {
+        close(*listener_fd);
+        return AWS_OP_ERR;
+    }
+
+    *port = ntohs(family == AF_INET6 ? ((struct sockaddr_in6 *)&address)->sin6_port
+                                     : ((struct sockaddr_in *)&address)->sin_port);
+    return AWS_OP_SUCCESS;
+}
+
+/* accepts the next connection and checks which local address the client bound it to */
+static int s_local_address_accept(int listener_fd, const char *expected_address, int *connection_fd) {
+    struct sockaddr_storage peer;
+    socklen_t peer_len = sizeof(peer);
+    *connection_fd = accept(listener_fd, (struct sockaddr *)&peer, &peer_len);
+    ASSERT_TRUE(*connection_fd >= 0);
+
+    char peer_address[AWS_ADDRESS_MAX_LEN] = {0};
+    const void *peer_addr = peer.ss_family == AF_INET6 ? (const void *)&((struct sockaddr_in6 *)&peer)->sin6_addr
+                                                       : (const void *)&((struct sockaddr_in *)&peer)->sin_addr;
+    ASSERT_NOT_NULL(inet_ntop(peer.ss_family, peer_addr, peer_address, sizeof(peer_address)));
+    ASSERT_STR_EQUALS(expected_address, peer_address);
+    return AWS_OP_SUCCESS;
+}
+
+#    define LOCAL_ADDRESS_IPV4_CONNECTION_COUNT 4
+
+/*
+ * A client bootstrap with local addresses of both families binds each connection to the next address of the
+ * connection's own family. The IPv6 address in between doesn't throw the IPv4 rotation off. A connection whose local
+ * address can't be bound fails its setup.
+ */
+static int s_socket_handler_client_local_addresses_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    s_socket_common_tester_init(allocator, &c_tester);
+
+    /* the test accepts the connections on a plain listening socket */
+    struct connection_count_test_args args = {
+        .allocator = allocator,
+        .mutex = &c_tester.mutex,
+        .condition_variable = &c_tester.condition_variable,
+        .clients_only = true,
+    };
+
+    struct aws_socket_options socket_options = {
+        .connect_timeout_ms = 3000,
+        .type = AWS_SOCKET_STREAM,
+        .domain = AWS_SOCKET_IPV4,
+    };
+
+    struct aws_host_resolver *resolver = aws_host_resolver_new_default(allocator, 8, c_tester.el_group, NULL);
+    ASSERT_NOT_NULL(resolver);
+
+    struct aws_byte_cursor local_addresses[] = {
+        aws_byte_cursor_from_c_str("127.0.0.2"),
+        aws_byte_cursor_from_c_str("::1"),
+        aws_byte_cursor_from_c_str("127.0.0.3"),
+    };
+    struct aws_client_bootstrap_options bootstrap_options = {
+        .event_loop_group = c_tester.el_group,
+        .host_resolver = resolver,
+        .local_addresses = local_addresses,
+        .local_address_count = AWS_ARRAY_SIZE(local_addresses),
+    };
+    struct aws_client_bootstrap *client_bootstrap = aws_client_bootstrap_new(allocator, &bootstrap_options);
+    ASSERT_NOT_NULL(client_bootstrap);
+
+    int ipv4_listener_fd = -1;
+    uint32_t ipv4_port = 0;
+    ASSERT_SUCCESS(s_local_address_listen(AF_INET, &ipv4_listener_fd, &ipv4_port));
+
+    struct aws_socket_channel_bootstrap_options channel_options;
+    AWS_ZERO_STRUCT(channel_options);
+    channel_options.bootstrap = client_bootstrap;
+    channel_options.host_name = "127.0.0.1";
+    channel_options.port = ipv4_port;
+    channel_options.socket_options = &socket_options;
+    channel_options.setup_callback = s_connection_count_client_setup_callback;
+    channel_options.shutdown_callback = s_connection_count_client_shutdown_callback;
+    channel_options.user_data = &args;
+
+    const char *expected_ipv4_addresses[] = {"127.0.0.2", "127.0.0.3"};
+    int connection_fds[LOCAL_ADDRESS_IPV4_CONNECTION_COUNT + 1];
+    size_t connection_count = 0;
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+    for (size_t i = 0; i < LOCAL_ADDRESS_IPV4_CONNECTION_COUNT; ++i) {
+        args.expected_count = connection_count + 1;
+        ASSERT_SUCCESS(aws_client_bootstrap_new_socket_channel(&channel_options));
+        ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+            &c_tester.condition_variable, &c_tester.mutex, s_connection_count_setup_predicate, &args));
+        ASSERT_INT_EQUALS(0, args.error_code);
+        ASSERT_SUCCESS(s_local_address_accept(
+            ipv4_listener_fd,
+            expected_ipv4_addresses[i % AWS_ARRAY_SIZE(expected_ipv4_addresses)],
+            &connection_fds[connection_count++]));
+    }
+
+    /* an IPv6 connection takes the IPv6 address, where the host has IPv6 loopback */
+    int ipv6_listener_fd = -1;
+    uint32_t ipv6_port = 0;
+    if (!s_local_address_listen(AF_INET6, &ipv6_listener_fd, &ipv6_port)) {
+        struct aws_socket_options ipv6_socket_options = socket_options;
+        ipv6_socket_options.domain = AWS_SOCKET_IPV6;
+        channel_options.host_name = "::1";
+        channel_options.port = ipv6_port;
+        channel_options.socket_options = &ipv6_socket_options;
+
+        args.expected_count = connection_count + 1;
+        ASSERT_SUCCESS(aws_client_bootstrap_new_socket_channel(&channel_options));
+        ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+            &c_tester.condition_variable, &c_tester.mutex, s_connection_count_setup_predicate, &args));
+        ASSERT_INT_EQUALS(0, args.error_code);
+        ASSERT_SUCCESS(s_local_address_accept(ipv6_listener_fd, "::1", &connection_fds[connection_count++]));
+        close(ipv6_listener_fd);
+    }
+
+    for (size_t i = 0; i < connection_count; ++i) {
+        ASSERT_SUCCESS(aws_channel_shutdown(args.client_channels[i], AWS_OP_SUCCESS));
+    }
+    args.expected_count = connection_count;
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_connection_count_shutdown_predicate, &args));
+    for (size_t i = 0; i < connection_count; ++i) {
+        close(connection_fds[i]);
+    }
+
+    aws_client_bootstrap_release(client_bootstrap);
+
+    /* TEST-NET-1 isn't on any interface here, so the bind fails and so does the connection */
+    struct aws_byte_cursor unavailable_address = aws_byte_cursor_from_c_str("192.0.2.1");
+    bootstrap_options.local_addresses = &unavailable_address;
+    bootstrap_options.local_address_count = 1;
+    client_bootstrap = aws_client_bootstrap_new(allocator, &bootstrap_options);
+    ASSERT_NOT_NULL(client_bootstrap);
+
+    struct connection_count_test_args failed_args = {
+        .allocator = allocator,
+        .mutex = &c_tester.mutex,
+        .condition_variable = &c_tester.condition_variable,
+        .expected_count = 1,
+        .clients_only = true,
+    };
+    channel_options.bootstrap = client_bootstrap;
+    channel_options.host_name = "127.0.0.1";
+    channel_options.port = ipv4_port;
+    channel_options.socket_options = &socket_options;
+    channel_options.user_data = &failed_args;
+
+    ASSERT_SUCCESS(aws_client_bootstrap_new_socket_channel(&channel_options));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_connection_count_setup_predicate, &failed_args));
+    ASSERT_INT_EQUALS(AWS_IO_SOCKET_INVALID_ADDRESS, failed_args.error_code);
+    ASSERT_UINT_EQUALS(0, failed_args.client_setup_count);
+
+    aws_mutex_unlock(&c_tester.mutex);
+
+    close(ipv4_listener_fd);
+    aws_client_bootstrap_release(client_bootstrap);
+    aws_host_resolver_release(resolver);
+    ASSERT_SUCCESS(s_socket_common_tester_clean_up(&c_tester));
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(socket_handler_client_local_addresses, s_socket_handler_client_local_addresses_test)
+
+#    define DATAGRAM_ECHO_COUNT 3
+
+struct datagram_echo_test_args {
+    struct aws_allocator *allocator;
+    struct aws_mutex *mutex;
+    struct aws_condition_variable *condition_variable;
+    struct aws_socket server_socket;
+    struct aws_channel *server_channel;
+    /* sits on top of the server's datagram handler */
+    struct aws_channel_handler *app_handler;
+    struct aws_socket_datagram_handler_options handler_options;
+    /* what the server's echo handler saw, and what came back to the client */
+    size_t echoed_lengths[DATAGRAM_ECHO_COUNT];
+    size_t echoed_count;
+    struct aws_socket_endpoint last_source;
+    size_t received_lengths[DATAGRAM_ECHO_COUNT];
+    size_t received_count;
+    /* the error each write message completed with, in the order they completed */
+    int write_error_codes[DATAGRAM_ECHO_COUNT];
+    size_t written_count;
+    int error_code;
+    bool server_setup;
+    bool server_shutdown;
+};
+
+static bool s_datagram_server_setup_predicate(void *user_data) {
+    struct datagram_echo_test_args *args = user_data;
+    return args->server_setup;
+}
+
+static bool s_datagram_server_shutdown_predicate(void *user_data) {
+    struct datagram_echo_test_args *args = user_data;
+    return args->server_shutdown;
+}
+
+static bool s_datagram_echoed_predicate(void *user_data) {
+    struct datagram_echo_test_args *args = user_data;
+    return args->received_count == DATAGRAM_ECHO_COUNT;
+}
+
+/* sends every datagram back to where it came from, the read message is reused as the write message */
+static int s_datagram_echo_process_read_message(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    struct aws_io_message *message) {
+    struct datagram_echo_test_args *args = handler->impl;
+
+    aws_mutex_lock(args->mutex);
+    if (args->echoed_count < DATAGRAM_ECHO_COUNT) {
+        args->echoed_lengths[args->echoed_count++] = message->message_data.len;
+    }
+    args->last_source = *message->endpoint;
+    aws_mutex_unlock(args->mutex);
+
+    message->on_completion = NULL;
+    if (aws_channel_slot_send_message(slot, message, AWS_CHANNEL_DIR_WRITE)) {
+        aws_mem_release(message->allocator, message);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_datagram_echo_process_write_message(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    struct aws_io_message *message) {
+    (void)handler;
+    return aws_channel_slot_send_message(slot, message, AWS_CHANNEL_DIR_WRITE);
+}
+
+static int s_datagram_echo_increment_read_window(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    size_t size) {
+    (void)handler;
+    return aws_channel_slot_increment_read_window(slot, size);
+}
+
+static int s_datagram_echo_shutdown(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    enum aws_channel_direction dir,
+    int error_code,
+    bool free_scarce_resources_immediately) {
+    (void)handler;
+    return aws_channel_slot_on_handler_shutdown_complete(slot, dir, error_code, free_scarce_resources_immediately);
+}
+
+static size_t s_datagram_echo_initial_window_size(struct aws_channel_handler *handler) {
+    (void)handler;
+    return SIZE_MAX;
+}
+
+static size_t s_datagram_echo_message_overhead(struct aws_channel_handler *handler) {
+    (void)handler;
+    return 0;
+}
+
+static void s_datagram_echo_destroy(struct aws_channel_handler *handler) {
+    aws_mem_release(handler->alloc, handler);
+}
+
+static struct aws_channel_handler_vtable s_datagram_echo_vtable = {
+    .process_read_message = s_datagram_echo_process_read_message,
+    .process_write_message = s_datagram_echo_process_write_message,
+    .increment_read_window = s_datagram_echo_increment_read_window,
+    .shutdown = s_datagram_echo_shutdown,
+    .initial_window_size = s_datagram_echo_initial_window_size,
+    .message_overhead = s_datagram_echo_message_overhead,
+    .destroy = s_datagram_echo_destroy,
+};
+
+static void s_datagram_server_on_setup_completed(struct aws_channel *channel, int error_code, void *user_data) {
+    struct datagram_echo_test_args *args = user_data;
+
+    if (!error_code) {
+        struct aws_channel_slot *socket_slot = aws_channel_slot_new(channel);
+        struct aws_channel_handler *datagram_handler = aws_socket_datagram_handler_new(
+            args->allocator, &args->server_socket, socket_slot, &args->handler_options);
+        if (!datagram_handler || aws_channel_slot_set_handler(socket_slot, datagram_handler)) {
+            error_code = aws_last_error();
+        } else {
+            struct aws_channel_slot *app_slot = aws_channel_slot_new(channel);
+            aws_channel_slot_insert_end(channel, app_slot);
+            aws_channel_slot_set_handler(app_slot, args->app_handler);
+        }
+    }
+
+    aws_mutex_lock(args->mutex);
+    args->error_code = error_code;
+    args->server_setup = true;
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(args->condition_variable);
+}
+
+static void s_datagram_server_on_shutdown_completed(struct aws_channel *channel, int error_code, void *user_data) {
+    (void)error_code;
+    struct datagram_echo_test_args *args = user_data;
+
+    aws_channel_destroy(channel);
+
+    aws_mutex_lock(args->mutex);
+    args->server_shutdown = true;
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(args->condition_variable);
+}
+
+static struct aws_byte_buf s_datagram_client_handle_read(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    struct aws_byte_buf *data_read,
+    void *user_data) {
+    (void)handler;
+    (void)slot;
+
+    struct datagram_echo_test_args *args = user_data;
+
+    aws_mutex_lock(args->mutex);
+    if (args->received_count < DATAGRAM_ECHO_COUNT) {
+        args->received_lengths[args->received_count++] = data_read->len;
+    }
+    aws_condition_variable_notify_one(args->condition_variable);
+    aws_mutex_unlock(args->mutex);
+
+    return *data_read;
+}
+
+/*
+ * A UDP client channel from the client bootstrap sends datagrams of different sizes to a channel over a bound, not
+ * connected, UDP socket, which echoes each one back to its source address. Every datagram has to arrive as a message of
+ * its own, both ways.
+ */
+static int s_socket_handler_datagram_echo_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    s_socket_common_tester_init(allocator, &c_tester);
+
+    struct datagram_echo_test_args echo_args = {
+        .allocator = allocator,
+        .mutex = &c_tester.mutex,
+        .condition_variable = &c_tester.condition_variable,
+        .handler_options =
+            {
+                .max_datagram_size = 2048,
+            },
+    };
+
+    struct aws_socket_options socket_options;
+    AWS_ZERO_STRUCT(socket_options);
+    socket_options.connect_timeout_ms = 3000;
+    socket_options.type = AWS_SOCKET_DGRAM;
+    socket_options.domain = AWS_SOCKET_IPV4;
+
+    struct aws_socket_endpoint server_endpoint = {.address = "127.0.0.1", .port = 0};
+    ASSERT_SUCCESS(aws_socket_init(&echo_args.server_socket, allocator, &socket_options));
+    ASSERT_SUCCESS(aws_socket_bind(&echo_args.server_socket, &server_endpoint));
+    ASSERT_TRUE(echo_args.server_socket.local_endpoint.port != 0);
+
+    struct aws_event_loop *server_loop = aws_event_loop_group_get_next_loop(c_tester.el_group);
+    ASSERT_SUCCESS(aws_socket_assign_to_event_loop(&echo_args.server_socket, server_loop));
+
+    echo_args.app_handler = aws_mem_calloc(allocator, 1, sizeof(struct aws_channel_handler));
+    ASSERT_NOT_NULL(echo_args.app_handler);
+    echo_args.app_handler->alloc = allocator;
+    echo_args.app_handler->vtable = &s_datagram_echo_vtable;
+    echo_args.app_handler->impl = &echo_args;
+
+    struct aws_channel_options server_channel_options = {
+        .event_loop = server_loop,
+        .on_setup_completed = s_datagram_server_on_setup_completed,
+        .setup_user_data = &echo_args,
+        .on_shutdown_completed = s_datagram_server_on_shutdown_completed,
+        .shutdown_user_data = &echo_args,
+    };
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+    echo_args.server_channel = aws_channel_new(allocator, &server_channel_options);
+    ASSERT_NOT_NULL(echo_args.server_channel);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_datagram_server_setup_predicate, &echo_args));
+    ASSERT_INT_EQUALS(0, echo_args.error_code);
+    ASSERT_SUCCESS(aws_mutex_unlock(&c_tester.mutex));
+
+    struct aws_channel_handler *client_rw_handler = rw_handler_new(
+        allocator, s_datagram_client_handle_read, s_socket_test_handle_write, true, SIZE_MAX, &echo_args);
+    ASSERT_NOT_NULL(client_rw_handler);
+
+    struct socket_test_args client_args;
+    ASSERT_SUCCESS(s_socket_test_args_init(&client_args, &c_tester, client_rw_handler));
+
+    struct aws_host_resolver *resolver = aws_host_resolver_new_default(allocator, 8, c_tester.el_group, NULL);
+    ASSERT_NOT_NULL(resolver);
+
+    struct aws_client_bootstrap_options bootstrap_options = {
+        .event_loop_group = c_tester.el_group,
+        .host_resolver = resolver,
+    };
+    struct aws_client_bootstrap *client_bootstrap = aws_client_bootstrap_new(allocator, &bootstrap_options);
+    ASSERT_NOT_NULL(client_bootstrap);
+
+    struct aws_socket_channel_bootstrap_options channel_options;
+    AWS_ZERO_STRUCT(channel_options);
+    channel_options.bootstrap = client_bootstrap;
+    channel_options.host_name = server_endpoint.address;
+    channel_options.port = echo_args.server_socket.local_endpoint.port;
+    channel_options.socket_options = &socket_options;
+    channel_options.setup_callback = s_socket_handler_test_client_setup_callback;
+    channel_options.shutdown_callback = s_socket_handler_test_client_shutdown_callback;
+    channel_options.user_data = &client_args;
+
+    ASSERT_SUCCESS(aws_client_bootstrap_new_socket_channel(&channel_options));
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_setup_predicate, &client_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&c_tester.mutex));
+
+    uint8_t payload[1000];
+    memset(payload, 'd', sizeof(payload));
+    struct aws_byte_buf datagrams[DATAGRAM_ECHO_COUNT] = {
+        aws_byte_buf_from_array(payload, 1),
+        aws_byte_buf_from_array(payload, 100),
+        aws_byte_buf_from_array(payload, sizeof(payload)),
+    };
+
+    struct aws_channel_slot *client_rw_slot = aws_atomic_load_ptr(&client_args.rw_slot);
+    for (size_t i = 0; i < DATAGRAM_ECHO_COUNT; ++i) {
+        rw_handler_write(client_rw_handler, client_rw_slot, &datagrams[i]);
+    }
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_datagram_echoed_predicate, &echo_args));
+
+    ASSERT_INT_EQUALS(DATAGRAM_ECHO_COUNT, echo_args.echoed_count);
+    for (size_t i = 0; i < DATAGRAM_ECHO_COUNT; ++i) {
+        ASSERT_UINT_EQUALS(datagrams[i].len, echo_args.echoed_lengths[i]);
+        ASSERT_UINT_EQUALS(datagrams[i].len, echo_args.received_lengths[i]);
+    }
+    ASSERT_INT_EQUALS(0, strcmp("127.0.0.1", echo_args.last_source.address));
+    ASSERT_TRUE(echo_args.last_source.port != 0);
+
+    ASSERT_SUCCESS(aws_channel_shutdown(client_args.channel, AWS_OP_SUCCESS));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_channel_shutdown_predicate, &client_args));
+
+    ASSERT_SUCCESS(aws_channel_shutdown(echo_args.server_channel, AWS_OP_SUCCESS));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_datagram_server_shutdown_predicate, &echo_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&c_tester.mutex));
+
+    aws_socket_clean_up(&echo_args.server_socket);
+    aws_client_bootstrap_release(client_bootstrap);
+    aws_host_resolver_release(resolver);
+    ASSERT_SUCCESS(s_socket_common_tester_clean_up(&c_tester));
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(socket_handler_datagram_echo, s_socket_handler_datagram_echo_test)
+
+#    define DATAGRAM_ERRORS_MAX_SIZE 100
+
+static bool s_datagram_received_predicate(void *user_data) {
+    struct datagram_echo_test_args *args = user_data;
+    return args->received_count == 2;
+}
+
+static void s_datagram_on_write_completed(
+    struct aws_channel *channel,
+    struct aws_io_message *message,
+    int err_code,
+    void *user_data) {
+    (void)channel;
+    (void)message;
+    struct datagram_echo_test_args *args = user_data;
+
+    aws_mutex_lock(args->mutex);
+    if (args->written_count < DATAGRAM_ECHO_COUNT) {
+        args->write_error_codes[args->written_count++] = err_code;
+    }
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(args->condition_variable);
+}
+
+static struct aws_io_message *s_new_datagram_message(struct aws_channel *channel, const char *payload) {
+    struct aws_byte_cursor cursor = aws_byte_cursor_from_c_str(payload);
+    struct aws_io_message *message =
+        aws_channel_acquire_message_from_pool(channel, AWS_IO_MESSAGE_APPLICATION_DATA, cursor.len);
+    if (message) {
+        aws_byte_buf_write_from_whole_cursor(&message->message_data, cursor);
+    }
+
+    return message;
+}
+
+/* bigger than any UDP datagram can be, and than a message from the pool, so it's allocated on its own */
+static struct aws_io_message *s_new_oversized_datagram_message(
+    struct aws_allocator *allocator,
+    struct aws_channel *channel) {
+    size_t size = 70 * 1024;
+    struct aws_io_message *message = aws_mem_calloc(allocator, 1, sizeof(struct aws_io_message) + size);
+    if (!message) {
+        return NULL;
+    }
+
+    message->allocator = allocator;
+    message->owning_channel = channel;
+    message->message_type = AWS_IO_MESSAGE_APPLICATION_DATA;
+    message->message_data = aws_byte_buf_from_empty_array(message + 1, size);
+    memset(message->message_data.buffer, 'o', size);
+    message->message_data.len = size;
+    return message;
+}
+
+struct datagram_send_task_args {
+    struct aws_channel_task task;
+    struct datagram_echo_test_args *args;
+    struct aws_socket_endpoint *destination;
+    /* sent in this order from the slot above the datagram handler, NULL sends a datagram too big for UDP */
+    const char *payloads[DATAGRAM_ECHO_COUNT];
+    size_t message_count;
+    /* if set, the channel's shutdown is scheduled ahead of the messages, so it starts while they are still held */
+    struct aws_channel_bulk_shutdown_options *shutdown_options;
+    int send_results[DATAGRAM_ECHO_COUNT];
+    /* how many messages had completed by the time the task was done sending */
+    size_t written_in_task;
+    bool sent;
+};
+
+static bool s_datagram_sent_predicate(void *user_data) {
+    struct datagram_send_task_args *task_args = user_data;
+    return task_args->sent;
+}
+
+static bool s_datagram_written_predicate(void *user_data) {
+    struct datagram_send_task_args *task_args = user_data;
+    return task_args->args->written_count == task_args->message_count;
+}
+
+static void s_datagram_send_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct datagram_send_task_args *task_args = arg;
+    struct datagram_echo_test_args *args = task_args->args;
+
+    if (task_args->shutdown_options) {
+        aws_channel_shutdown_event_loop_channels(
+            aws_channel_get_event_loop(args->server_channel), task_args->shutdown_options);
+    }
+
+    for (size_t i = 0; i < task_args->message_count; ++i) {
+        struct aws_io_message *message = task_args->payloads[i]
+                                             ? s_new_datagram_message(args->server_channel, task_args->payloads[i])
+                                             : s_new_oversized_datagram_message(args->allocator, args->server_channel);
+        if (!message) {
+            task_args->send_results[i] = AWS_OP_ERR;
+            continue;
+        }
+
+        message->endpoint = task_args->destination;
+        message->on_completion = s_datagram_on_write_completed;
+        message->user_data = args;
+        task_args->send_results[i] =
+            aws_channel_slot_send_message(args->app_handler->slot, message, AWS_CHANNEL_DIR_WRITE);
+        if (task_args->send_results[i]) {
+            aws_mem_release(message->allocator, message);
+        }
+    }
+
+    aws_mutex_lock(args->mutex);
+    task_args->written_in_task = args->written_count;
+    task_args->sent = true;
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(args->condition_variable);
+}
+
+/* sends the messages from the server channel's thread, and waits until they have all completed */
+static int s_datagram_send_and_wait(struct datagram_send_task_args *task_args) {
+    struct datagram_echo_test_args *args = task_args->args;
+    aws_channel_task_init(&task_args->task, s_datagram_send_task, task_args, "datagram_test_send");
+    aws_channel_schedule_task_now(args->server_channel, &task_args->task);
+
+    ASSERT_SUCCESS(aws_mutex_lock(args->mutex));
+    ASSERT_SUCCESS(
+        aws_condition_variable_wait_pred(args->condition_variable, args->mutex, s_datagram_sent_predicate, task_args));
+    for (size_t i = 0; i < task_args->message_count; ++i) {
+        ASSERT_SUCCESS(task_args->send_results[i]);
+    }
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        args->condition_variable, args->mutex, s_datagram_written_predicate, task_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(args->mutex));
+
+    return AWS_OP_SUCCESS;
+}
+
+/* the next datagram read by the plain UDP socket on the other end has to be `expected` */
+static int s_datagram_peer_receive(int peer_fd, const char *expected) {
+    uint8_t buffer[1024];
+    ssize_t amount_read = recv(peer_fd, buffer, sizeof(buffer), 0);
+    ASSERT_TRUE(amount_read >= 0);
+    ASSERT_BIN_ARRAYS_EQUALS(expected, strlen(expected), buffer, (size_t)amount_read);
+
+    return AWS_OP_SUCCESS;
+}
+
+/*
+ * A datagram channel over a bound UDP socket with args->app_handler on top of the datagram handler, and a plain UDP
+ * socket for its peer. Reads on the peer time out rather than hang if a datagram never comes.
+ */
+static int s_datagram_test_channel_setup(
+    struct datagram_echo_test_args *args,
+    int *peer_fd,
+    struct aws_socket_endpoint *peer_endpoint) {
+
+    struct aws_socket_options socket_options;
+    AWS_ZERO_STRUCT(socket_options);
+    socket_options.connect_timeout_ms = 3000;
+    socket_options.type = AWS_SOCKET_DGRAM;
+    socket_options.domain = AWS_SOCKET_IPV4;
+
+    struct aws_socket_endpoint server_endpoint = {.address = "127.0.0.1", .port = 0};
+    ASSERT_SUCCESS(aws_socket_init(&args->server_socket, args->allocator, &socket_options));
+    ASSERT_SUCCESS(aws_socket_bind(&args->server_socket, &server_endpoint));
+
+    struct aws_event_loop *server_loop = aws_event_loop_group_get_next_loop(c_tester.el_group);
+    ASSERT_SUCCESS(aws_socket_assign_to_event_loop(&args->server_socket, server_loop));
+
+    *peer_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_TRUE(*peer_fd >= 0);
+    struct sockaddr_in peer_address;
+    AWS_ZERO_STRUCT(peer_address);
+    peer_address.sin_family = AF_INET;
+    peer_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t peer_address_len = sizeof(peer_address);
+    struct timeval receive_timeout = {.tv_sec = 5};
+    ASSERT_SUCCESS(setsockopt(*peer_fd, SOL_SOCKET, SO_RCVTIMEO, &receive_timeout, sizeof(receive_timeout)));
+    ASSERT_SUCCESS(bind(*peer_fd, (struct sockaddr *)&peer_address, sizeof(peer_address)));
+    ASSERT_SUCCESS(getsockname(*peer_fd, (struct sockaddr *)&peer_address, &peer_address_len));
+
+    AWS_ZERO_STRUCT(*peer_endpoint);
+    snprintf(peer_endpoint->address, sizeof(peer_endpoint->address), "127.0.0.1");
+    peer_endpoint->port = ntohs(peer_address.sin_port);
+
+    args->app_handler = rw_handler_new(
+        args->allocator, s_datagram_client_handle_read, s_socket_test_handle_write, true, SIZE_MAX, args);
+    ASSERT_NOT_NULL(args->app_handler);
+
+    struct aws_channel_options channel_options = {
+        .event_loop = server_loop,
+        .on_setup_completed = s_datagram_server_on_setup_completed,
+        .setup_user_data = args,
+        .on_shutdown_completed = s_datagram_server_on_shutdown_completed,
+        .shutdown_user_data = args,
+    };
+
+    ASSERT_SUCCESS(aws_mutex_lock(args->mutex));
+    args->server_channel = aws_channel_new(args->allocator, &channel_options);
+    ASSERT_NOT_NULL(args->server_channel);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        args->condition_variable, args->mutex, s_datagram_server_setup_predicate, args));
+    ASSERT_INT_EQUALS(0, args->error_code);
+    ASSERT_SUCCESS(aws_mutex_unlock(args->mutex));
+
+    return AWS_OP_SUCCESS;
+}
+
+/* shuts the channel down, unless it already did, and closes both ends */
+static int s_datagram_test_channel_clean_up(struct datagram_echo_test_args *args, int peer_fd) {
+    ASSERT_SUCCESS(aws_mutex_lock(args->mutex));
+    if (!args->server_shutdown) {
+        ASSERT_SUCCESS(aws_channel_shutdown(args->server_channel, AWS_OP_SUCCESS));
+        ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+            args->condition_variable, args->mutex, s_datagram_server_shutdown_predicate, args));
+    }
+    ASSERT_SUCCESS(aws_mutex_unlock(args->mutex));
+
+    close(peer_fd);
+    aws_socket_clean_up(&args->server_socket);
+
+    return AWS_OP_SUCCESS;
+}
+
+/*
+ * A datagram too big to send completes its own write message with an error, the datagram written after it still goes
+ * out and the channel stays up. A datagram bigger than max_datagram_size arrives truncated, and the one after it
+ * arrives whole.
+ */
+static int s_test_datagram_errors(struct aws_allocator *allocator, size_t max_datagrams_per_send) {
+    struct datagram_echo_test_args args = {
+        .allocator = allocator,
+        .mutex = &c_tester.mutex,
+        .condition_variable = &c_tester.condition_variable,
+        .handler_options =
+            {
+                .max_datagram_size = DATAGRAM_ERRORS_MAX_SIZE,
+                .max_datagrams_per_send = max_datagrams_per_send,
+            },
+    };
+
+    int peer_fd = -1;
+    struct aws_socket_endpoint peer_endpoint;
+    ASSERT_SUCCESS(s_datagram_test_channel_setup(&args, &peer_fd, &peer_endpoint));
+
+    struct datagram_send_task_args send_args = {
+        .args = &args,
+        .destination = &peer_endpoint,
+        .payloads = {NULL, "after the big one"},
+        .message_count = 2,
+    };
+    ASSERT_SUCCESS(s_datagram_send_and_wait(&send_args));
+    ASSERT_TRUE(args.write_error_codes[0] != AWS_ERROR_SUCCESS);
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, args.write_error_codes[1]);
+    ASSERT_SUCCESS(s_datagram_peer_receive(peer_fd, "after the big one"));
+
+    struct sockaddr_in server_address;
+    AWS_ZERO_STRUCT(server_address);
+    server_address.sin_family = AF_INET;
+    server_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    server_address.sin_port = htons((uint16_t)args.server_socket.local_endpoint.port);
+
+    uint8_t payload[DATAGRAM_ERRORS_MAX_SIZE * 3];
+    memset(payload, 't', sizeof(payload));
+    size_t sizes[] = {sizeof(payload), DATAGRAM_ERRORS_MAX_SIZE / 2};
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(sizes); ++i) {
+        ASSERT_INT_EQUALS(
+            (ssize_t)sizes[i],
+            sendto(peer_fd, payload, sizes[i], 0, (struct sockaddr *)&server_address, sizeof(server_address)));
+    }
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_datagram_received_predicate, &args));
+    ASSERT_UINT_EQUALS(DATAGRAM_ERRORS_MAX_SIZE, args.received_lengths[0]);
+    ASSERT_UINT_EQUALS(sizes[1], args.received_lengths[1]);
+    ASSERT_FALSE(args.server_shutdown);
+    ASSERT_SUCCESS(aws_mutex_unlock(&c_tester.mutex));
+
+    return s_datagram_test_channel_clean_up(&args, peer_fd);
+}
+
+static int s_socket_handler_datagram_errors_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    s_socket_common_tester_init(allocator, &c_tester);
+
+    /* sent one at a time, then batched */
+    ASSERT_SUCCESS(s_test_datagram_errors(allocator, 1));
+    ASSERT_SUCCESS(s_test_datagram_errors(allocator, 0));
+
+    ASSERT_SUCCESS(s_socket_common_tester_clean_up(&c_tester));
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(socket_handler_datagram_errors, s_socket_handler_datagram_errors_test)
+
+/*
+ * Three write messages sent from one task. written_in_task is how many the handler had sent before the task returned,
+ * the rest were held for the flush task. Either way all of them arrive, in order.
+ */
+static int s_test_datagram_batched_writes(
+    struct aws_allocator *allocator,
+    size_t max_datagrams_per_send,
+    size_t written_in_task) {
+    struct datagram_echo_test_args args = {
+        .allocator = allocator,
+        .mutex = &c_tester.mutex,
+        .condition_variable = &c_tester.condition_variable,
+        .handler_options =
+            {
+                .max_datagrams_per_send = max_datagrams_per_send,
+            },
+    };
+
+    int peer_fd = -1;
+    struct aws_socket_endpoint peer_endpoint;
+    ASSERT_SUCCESS(s_datagram_test_channel_setup(&args, &peer_fd, &peer_endpoint));
+
+    struct datagram_send_task_args send_args = {
+        .args = &args,
+        .destination = &peer_endpoint,
+        .payloads = {"first", "second", "third"},
+        .message_count = DATAGRAM_ECHO_COUNT,
+    };
+
+    ASSERT_SUCCESS(s_datagram_send_and_wait(&send_args));
+    ASSERT_UINT_EQUALS(written_in_task, send_args.written_in_task);
+    for (size_t i = 0; i < DATAGRAM_ECHO_COUNT; ++i) {
+        ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, args.write_error_codes[i]);
+        ASSERT_SUCCESS(s_datagram_peer_receive(peer_fd, send_args.payloads[i]));
+    }
+
+    return s_datagram_test_channel_clean_up(&args, peer_fd);
+}
+
+static int s_socket_handler_datagram_batched_writes_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    s_socket_common_tester_init(allocator, &c_tester);
+
+    /* every message goes out as it is written */
+    ASSERT_SUCCESS(s_test_datagram_batched_writes(allocator, 1, DATAGRAM_ECHO_COUNT));
+    /* the second message fills a batch, the third waits for the flush task */
+    ASSERT_SUCCESS(s_test_datagram_batched_writes(allocator, 2, 2));
+    /* the default batch is never filled, the flush task sends all of them */
+    ASSERT_SUCCESS(s_test_datagram_batched_writes(allocator, 0, 0));
+
+    ASSERT_SUCCESS(s_socket_common_tester_clean_up(&c_tester));
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(socket_handler_datagram_batched_writes, s_socket_handler_datagram_batched_writes_test)
+
+/*
+ * The channel starts shutting down while write messages are held for the flush task. A graceful shutdown still sends
+ * them. An abortive one closes the socket in the read direction, so they fail with AWS_IO_SOCKET_CLOSED.
+ */
+static int s_test_datagram_shutdown_with_held_writes(struct aws_allocator *allocator, bool abortive) {
+    struct datagram_echo_test_args args = {
+        .allocator = allocator,
+        .mutex = &c_tester.mutex,
+        .condition_variable = &c_tester.condition_variable,
+    };
+
+    int peer_fd = -1;
+    struct aws_socket_endpoint peer_endpoint;
+    ASSERT_SUCCESS(s_datagram_test_channel_setup(&args, &peer_fd, &peer_endpoint));
+
+    struct aws_channel_bulk_shutdown_options shutdown_options = {
+        .error_code = AWS_OP_SUCCESS,
+        .abortive = abortive,
+    };
+    struct datagram_send_task_args send_args = {
+        .args = &args,
+        .destination = &peer_endpoint,
+        .payloads = {"first", "second", "third"},
+        .message_count = DATAGRAM_ECHO_COUNT,
+        .shutdown_options = &shutdown_options,
+    };
+
+    ASSERT_SUCCESS(s_datagram_send_and_wait(&send_args));
+    ASSERT_UINT_EQUALS(0, send_args.written_in_task);
+    for (size_t i = 0; i < DATAGRAM_ECHO_COUNT; ++i) {
+        if (abortive) {
+            ASSERT_INT_EQUALS(AWS_IO_SOCKET_CLOSED, args.write_error_codes[i]);
+        } else {
+            ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, args.write_error_codes[i]);
+            ASSERT_SUCCESS(s_datagram_peer_receive(peer_fd, send_args.payloads[i]));
+        }
+    }
+
+    ASSERT_SUCCESS(aws_mutex_lock(&c_tester.mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &c_tester.condition_variable, &c_tester.mutex, s_datagram_server_shutdown_predicate, &args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&c_tester.mutex));
+
+    return s_datagram_test_channel_clean_up(&args, peer_fd);
+}
+
+static int s_socket_handler_datagram_shutdown_with_held_writes_test(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    s_socket_common_tester_init(allocator, &c_tester);
+
+    ASSERT_SUCCESS(s_test_datagram_shutdown_with_held_writes(allocator, false));
+    ASSERT_SUCCESS(s_test_datagram_shutdown_with_held_writes(allocator, true));
+
+    ASSERT_SUCCESS(s_socket_common_tester_clean_up(&c_tester));
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(
+    socket_handler_datagram_shutdown_with_held_writes,
+    s_socket_handler_datagram_shutdown_with_held_writes_test)
+#endif
@@ -13,6 +13,7 @@
 #include <aws/io/event_loop.h>
 #include <aws/io/host_resolver.h>
 #include <aws/io/socket.h>
+#include <aws/io/socket_relay.h>
 
 #ifdef _WIN32
 #    define LOCAL_SOCK_TEST_PATTERN "\\\\.\\pipe\\testsock%llu"
@@ -28,6 +29,13 @@
 #    include <linux/vm_sockets.h>
 #endif
 
+#ifndef _WIN32
+#    include <netinet/in.h>
+#    include <netinet/tcp.h>
+#    include <poll.h>
+#    include <sys/socket.h>
+#endif
+
 struct local_listener_args {
     struct aws_socket *incoming;
     struct aws_mutex *mutex;
@@ -211,11 +219,47 @@ static bool s_test_running_as_root(struct aws_allocator *alloc) {
     return is_root;
 }
 
+/* Checks a test makes on the two ends of a connection, once data went both ways. Runs on the sockets' event loop and
+ * returns AWS_OP_ERR if a check fails. For datagram sockets, incoming is the bound socket. */
+typedef int(socket_test_connected_check_fn)(struct aws_socket *outgoing, struct aws_socket *incoming, void *user_data);
+
+struct socket_test_check_args {
+    socket_test_connected_check_fn *check_fn;
+    void *user_data;
+    struct aws_socket *outgoing;
+    struct aws_socket *incoming;
+    struct aws_mutex *mutex;
+    struct aws_condition_variable condition_variable;
+    int result;
+    bool completed;
+};
+
+static bool s_connected_check_completed_predicate(void *arg) {
+    struct socket_test_check_args *check_args = arg;
+    return check_args->completed;
+}
+
+static void s_connected_check_task(struct aws_task *task, void *args, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct socket_test_check_args *check_args = args;
+
+    int result = check_args->check_fn(check_args->outgoing, check_args->incoming, check_args->user_data);
+
+    aws_mutex_lock(check_args->mutex);
+    check_args->result = result;
+    check_args->completed = true;
+    aws_mutex_unlock(check_args->mutex);
+    aws_condition_variable_notify_one(&check_args->condition_variable);
+}
+
 static int s_test_socket_ex(
     struct aws_allocator *allocator,
     struct aws_socket_options *options,
     struct aws_socket_endpoint *local,
-    struct aws_socket_endpoint *endpoint) {
+    struct aws_socket_endpoint *endpoint,
+    socket_test_connected_check_fn *connected_check,
+    void *check_user_data) {
     struct aws_event_loop *event_loop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
 
     ASSERT_NOT_NULL(event_loop, "Event loop creation failed with error: %s", aws_error_debug_str(aws_last_error()));
@@ -248,7 +292,11 @@ static int s_test_socket_ex(
     struct aws_socket outgoing;
     ASSERT_SUCCESS(aws_socket_init(&outgoing, allocator, options));
     if (local && (strcmp(local->address, endpoint->address) != 0 || local->port != endpoint->port)) {
-        ASSERT_SUCCESS(aws_socket_bind(&outgoing, local));
+        if (options->type == AWS_SOCKET_STREAM) {
+            ASSERT_SUCCESS(aws_socket_bind_for_connect(&outgoing, local));
+        } else {
+            ASSERT_SUCCESS(aws_socket_bind(&outgoing, local));
+        }
     }
     ASSERT_SUCCESS(aws_socket_connect(&outgoing, endpoint, event_loop, s_local_outgoing_connection, &outgoing_args));
 
@@ -273,6 +321,12 @@ static int s_test_socket_ex(
         ASSERT_FALSE(outgoing_args.error_invoked);
         ASSERT_INT_EQUALS(options->domain, listener_args.incoming->options.domain);
         ASSERT_INT_EQUALS(options->type, listener_args.incoming->options.type);
+
+        if (local) {
+            /* the port was left to connect() to pick */
+            ASSERT_INT_EQUALS(0, strcmp(local->address, outgoing.local_endpoint.address));
+            ASSERT_TRUE(outgoing.local_endpoint.port != 0);
+        }
     }
 
     ASSERT_SUCCESS(aws_socket_assign_to_event_loop(server_sock, event_loop));
@@ -349,6 +403,28 @@ static int s_test_socket_ex(
         ASSERT_BIN_ARRAYS_EQUALS(read_buffer.buffer, read_buffer.len, write_buffer.buffer, write_buffer.len);
     }
 
+    if (connected_check) {
+        struct socket_test_check_args check_args = {
+            .check_fn = connected_check,
+            .user_data = check_user_data,
+            .outgoing = &outgoing,
+            .incoming = server_sock,
+            .mutex = &mutex,
+            .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+        };
+        struct aws_task check_task = {
+            .fn = s_connected_check_task,
+            .arg = &check_args,
+        };
+
+        aws_event_loop_schedule_task_now(event_loop, &check_task);
+        ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+        ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+            &check_args.condition_variable, &mutex, s_connected_check_completed_predicate, &check_args));
+        ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+        ASSERT_SUCCESS(check_args.result);
+    }
+
     struct aws_task close_task = {
         .fn = s_socket_close_task,
         .arg = &io_args,
@@ -394,7 +470,7 @@ static int s_test_socket(
     struct aws_socket_options *options,
     struct aws_socket_endpoint *endpoint) {
 
-    return s_test_socket_ex(allocator, options, NULL, endpoint);
+    return s_test_socket_ex(allocator, options, NULL, endpoint, NULL, NULL);
 }
 
 static int s_test_local_socket_communication(struct aws_allocator *allocator, void *ctx) {
@@ -431,10 +507,1064 @@ static int s_test_tcp_socket_communication(struct aws_allocator *allocator, void
 
     struct aws_socket_endpoint endpoint = {.address = "127.0.0.1", .port = 8127};
 
-    return s_test_socket(allocator, &options, &endpoint);
+    return s_test_socket(allocator, &options, &endpoint);
+}
+
+AWS_TEST_CASE(tcp_socket_communication, s_test_tcp_socket_communication)
+
+/* both ends have sent and received, so the kernel has measured the connection's round trip */
+static int s_check_transport_metrics(struct aws_socket *outgoing, struct aws_socket *incoming, void *user_data) {
+    (void)user_data;
+
+    struct aws_socket *sockets[] = {outgoing, incoming};
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(sockets); ++i) {
+        struct aws_socket_transport_metrics metrics;
+        AWS_ZERO_STRUCT(metrics);
+#ifdef __linux__
+        ASSERT_SUCCESS(aws_socket_get_transport_metrics(sockets[i], &metrics));
+        ASSERT_TRUE(metrics.rtt_usec > 0);
+        ASSERT_TRUE(metrics.congestion_window > 0);
+        ASSERT_TRUE(metrics.send_mss > 0);
+        ASSERT_UINT_EQUALS(0, metrics.zero_copy_sends_completed);
+#else
+        ASSERT_ERROR(AWS_ERROR_UNSUPPORTED_OPERATION, aws_socket_get_transport_metrics(sockets[i], &metrics));
+#endif
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_test_tcp_socket_transport_metrics_communication(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_IPV4;
+
+    struct aws_socket_endpoint endpoint = {.address = "127.0.0.1", .port = 8136};
+
+    return s_test_socket_ex(allocator, &options, NULL, &endpoint, s_check_transport_metrics, NULL);
+}
+
+AWS_TEST_CASE(tcp_socket_transport_metrics_communication, s_test_tcp_socket_transport_metrics_communication)
+
+/* the accepted socket has received data, so the kernel knows which CPU processed it */
+static int s_check_incoming_cpu(struct aws_socket *outgoing, struct aws_socket *incoming, void *user_data) {
+    (void)outgoing;
+    (void)user_data;
+
+    int incoming_cpu = -1;
+#ifdef SO_INCOMING_CPU
+    ASSERT_SUCCESS(aws_socket_get_incoming_cpu(incoming, &incoming_cpu));
+    ASSERT_TRUE(incoming_cpu >= 0);
+#else
+    ASSERT_ERROR(AWS_ERROR_UNSUPPORTED_OPERATION, aws_socket_get_incoming_cpu(incoming, &incoming_cpu));
+#endif
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_test_tcp_socket_incoming_cpu_communication(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_IPV4;
+
+    struct aws_socket_endpoint endpoint = {.address = "127.0.0.1", .port = 8137};
+
+    return s_test_socket_ex(allocator, &options, NULL, &endpoint, s_check_incoming_cpu, NULL);
+}
+
+AWS_TEST_CASE(tcp_socket_incoming_cpu_communication, s_test_tcp_socket_incoming_cpu_communication)
+
+static int s_test_tcp_socket_bind_for_connect(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_IPV4;
+
+    struct aws_socket_endpoint local = {.address = "127.0.0.1", .port = 0};
+    struct aws_socket_endpoint endpoint = {.address = "127.0.0.1", .port = 8134};
+
+    return s_test_socket_ex(allocator, &options, &local, &endpoint, NULL, NULL);
+}
+
+AWS_TEST_CASE(tcp_socket_bind_for_connect, s_test_tcp_socket_bind_for_connect)
+
+/* the outgoing socket's write only completed once the kernel reported its MSG_ZEROCOPY send done */
+static int s_check_zero_copy_sends(struct aws_socket *outgoing, struct aws_socket *incoming, void *user_data) {
+    (void)incoming;
+    (void)user_data;
+
+    struct aws_socket_transport_metrics metrics;
+#ifdef __linux__
+    ASSERT_SUCCESS(aws_socket_get_transport_metrics(outgoing, &metrics));
+    ASSERT_TRUE(metrics.zero_copy_sends_completed > 0);
+    /* over loopback the kernel usually copies after all, it still reports each send */
+    ASSERT_TRUE(metrics.zero_copy_sends_copied <= metrics.zero_copy_sends_completed);
+#else
+    ASSERT_ERROR(AWS_ERROR_UNSUPPORTED_OPERATION, aws_socket_get_transport_metrics(outgoing, &metrics));
+#endif
+    return AWS_OP_SUCCESS;
+}
+
+/* every write goes through MSG_ZEROCOPY where supported, so write completions wait on the kernel's notifications */
+static int s_test_tcp_socket_zero_copy_communication(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_IPV4;
+    options.zero_copy_write_threshold = 1;
+
+    struct aws_socket_endpoint endpoint = {.address = "127.0.0.1", .port = 8128};
+
+    return s_test_socket_ex(allocator, &options, NULL, &endpoint, s_check_zero_copy_sends, NULL);
+}
+
+AWS_TEST_CASE(tcp_socket_zero_copy_communication, s_test_tcp_socket_zero_copy_communication)
+
+/* fits in the socket buffers, so the kernel takes all of it at once and only has to be waited on for the buffer */
+#define ZERO_COPY_CLOSE_WRITE_SIZE (64 * 1024)
+
+struct zero_copy_close_args {
+    struct aws_mutex *mutex;
+    struct aws_condition_variable condition_variable;
+    struct aws_socket *writer;
+    struct aws_socket *reader;
+    struct aws_byte_cursor to_write;
+    struct aws_byte_buf *read_buffer;
+    size_t amount_written;
+    int write_error_code;
+    int read_error_code;
+    bool write_completed;
+    bool written_without_socket;
+    bool read_completed;
+};
+
+static void s_on_zero_copy_close_written(
+    struct aws_socket *socket,
+    int error_code,
+    size_t amount_written,
+    void *user_data) {
+    struct zero_copy_close_args *args = user_data;
+
+    aws_mutex_lock(args->mutex);
+    args->write_error_code = error_code;
+    args->amount_written = amount_written;
+    args->written_without_socket = socket == NULL;
+    args->write_completed = true;
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(&args->condition_variable);
+}
+
+static bool s_zero_copy_close_written_predicate(void *arg) {
+    struct zero_copy_close_args *args = arg;
+    return args->write_completed;
+}
+
+/* closes the socket before the loop gets a chance to read the kernel's notification for the write */
+static void s_zero_copy_close_write_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct zero_copy_close_args *args = arg;
+
+    if (aws_socket_write(args->writer, &args->to_write, s_on_zero_copy_close_written, args) ||
+        aws_socket_close(args->writer)) {
+        aws_mutex_lock(args->mutex);
+        args->write_error_code = aws_last_error();
+        args->write_completed = true;
+        aws_mutex_unlock(args->mutex);
+        aws_condition_variable_notify_one(&args->condition_variable);
+    }
+}
+
+static bool s_zero_copy_close_read_predicate(void *arg) {
+    struct zero_copy_close_args *args = arg;
+    return args->read_completed;
+}
+
+/* reads until the connection ends, its error tells an orderly close from a reset */
+static void s_zero_copy_close_read_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct zero_copy_close_args *args = arg;
+
+    int error_code = AWS_OP_SUCCESS;
+    for (;;) {
+        size_t amount_read = 0;
+        if (aws_socket_read(args->reader, args->read_buffer, &amount_read)) {
+            error_code = aws_last_error();
+            if (error_code != AWS_IO_READ_WOULD_BLOCK) {
+                break;
+            }
+        }
+    }
+
+    aws_mutex_lock(args->mutex);
+    args->read_error_code = error_code;
+    args->read_completed = true;
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(&args->condition_variable);
+}
+
+/* Closing the socket right after a zero-copy write, while the kernel may still send from the write's buffer, doesn't
+ * reset the connection: the peer gets all of the data followed by an orderly close, and the write completes once the
+ * kernel is done with the buffer. */
+static int s_test_tcp_socket_zero_copy_close_delivers_data(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_IPV4;
+    options.zero_copy_write_threshold = 1;
+
+    struct aws_socket_endpoint endpoint = {.address = "127.0.0.1", .port = 8138};
+
+    /* the reader spins on its own loop, so the writer's loop stays free to wait on the kernel */
+    struct aws_event_loop *write_loop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+    ASSERT_NOT_NULL(write_loop, "Event loop creation failed with error: %s", aws_error_debug_str(aws_last_error()));
+    ASSERT_SUCCESS(aws_event_loop_run(write_loop));
+
+    struct aws_event_loop *read_loop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+    ASSERT_NOT_NULL(read_loop, "Event loop creation failed with error: %s", aws_error_debug_str(aws_last_error()));
+    ASSERT_SUCCESS(aws_event_loop_run(read_loop));
+
+    struct aws_mutex mutex = AWS_MUTEX_INIT;
+    struct aws_condition_variable condition_variable = AWS_CONDITION_VARIABLE_INIT;
+
+    struct local_listener_args listener_args = {
+        .mutex = &mutex,
+        .condition_variable = &condition_variable,
+        .incoming = NULL,
+        .incoming_invoked = false,
+        .error_invoked = false,
+    };
+
+    struct aws_socket listener;
+    ASSERT_SUCCESS(aws_socket_init(&listener, allocator, &options));
+    ASSERT_SUCCESS(aws_socket_bind(&listener, &endpoint));
+    ASSERT_SUCCESS(aws_socket_listen(&listener, 1024));
+    ASSERT_SUCCESS(aws_socket_start_accept(&listener, write_loop, s_local_listener_incoming, &listener_args));
+
+    struct local_outgoing_args outgoing_args = {
+        .mutex = &mutex, .condition_variable = &condition_variable, .connect_invoked = false, .error_invoked = false};
+
+    struct aws_socket outgoing;
+    ASSERT_SUCCESS(aws_socket_init(&outgoing, allocator, &options));
+    ASSERT_SUCCESS(aws_socket_connect(&outgoing, &endpoint, write_loop, s_local_outgoing_connection, &outgoing_args));
+
+    ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(&condition_variable, &mutex, s_incoming_predicate, &listener_args));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &condition_variable, &mutex, s_connection_completed_predicate, &outgoing_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+    ASSERT_TRUE(listener_args.incoming_invoked);
+    ASSERT_TRUE(outgoing_args.connect_invoked);
+
+    struct aws_socket *server_sock = listener_args.incoming;
+    ASSERT_SUCCESS(aws_socket_assign_to_event_loop(server_sock, read_loop));
+    ASSERT_SUCCESS(aws_socket_subscribe_to_readable_events(server_sock, s_on_readable, NULL));
+    ASSERT_SUCCESS(aws_socket_subscribe_to_readable_events(&outgoing, s_on_readable, NULL));
+
+    struct aws_byte_buf expected;
+    ASSERT_SUCCESS(aws_byte_buf_init(&expected, allocator, ZERO_COPY_CLOSE_WRITE_SIZE));
+    for (size_t i = 0; i < ZERO_COPY_CLOSE_WRITE_SIZE; ++i) {
+        expected.buffer[i] = (uint8_t)(i % 251);
+    }
+    expected.len = ZERO_COPY_CLOSE_WRITE_SIZE;
+
+    /* room for one more byte, so the end of the connection is read as such */
+    struct aws_byte_buf read_buffer;
+    ASSERT_SUCCESS(aws_byte_buf_init(&read_buffer, allocator, ZERO_COPY_CLOSE_WRITE_SIZE + 1));
+
+    struct zero_copy_close_args args = {
+        .mutex = &mutex,
+        .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+        .writer = &outgoing,
+        .reader = server_sock,
+        .to_write = aws_byte_cursor_from_buf(&expected),
+        .read_buffer = &read_buffer,
+    };
+
+    struct aws_task write_task = {
+        .fn = s_zero_copy_close_write_task,
+        .arg = &args,
+    };
+    aws_event_loop_schedule_task_now(write_loop, &write_task);
+
+    struct aws_task read_task = {
+        .fn = s_zero_copy_close_read_task,
+        .arg = &args,
+    };
+    aws_event_loop_schedule_task_now(read_loop, &read_task);
+
+    ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &args.condition_variable, &mutex, s_zero_copy_close_written_predicate, &args));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &args.condition_variable, &mutex, s_zero_copy_close_read_predicate, &args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+
+    ASSERT_INT_EQUALS(AWS_OP_SUCCESS, args.write_error_code);
+    ASSERT_UINT_EQUALS(ZERO_COPY_CLOSE_WRITE_SIZE, args.amount_written);
+#ifdef __linux__
+    /* it was still waiting on the kernel when the socket was closed */
+    ASSERT_TRUE(args.written_without_socket);
+#endif
+    ASSERT_INT_EQUALS(AWS_IO_SOCKET_CLOSED, args.read_error_code);
+    ASSERT_BIN_ARRAYS_EQUALS(expected.buffer, expected.len, read_buffer.buffer, read_buffer.len);
+
+    struct socket_io_args close_args = {
+        .socket = server_sock,
+        .mutex = &mutex,
+        .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+        .close_completed = false,
+    };
+    struct aws_task close_task = {
+        .fn = s_socket_close_task,
+        .arg = &close_args,
+    };
+
+    aws_event_loop_schedule_task_now(read_loop, &close_task);
+    ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+    aws_condition_variable_wait_pred(
+        &close_args.condition_variable, &mutex, s_close_completed_predicate, &close_args);
+    ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+    aws_socket_clean_up(server_sock);
+    aws_mem_release(allocator, server_sock);
+    aws_socket_clean_up(&outgoing);
+
+    close_args.socket = &listener;
+    close_args.close_completed = false;
+    aws_event_loop_schedule_task_now(write_loop, &close_task);
+    ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+    aws_condition_variable_wait_pred(
+        &close_args.condition_variable, &mutex, s_close_completed_predicate, &close_args);
+    ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+    aws_socket_clean_up(&listener);
+
+    aws_byte_buf_clean_up(&read_buffer);
+    aws_byte_buf_clean_up(&expected);
+    aws_event_loop_destroy(read_loop);
+    aws_event_loop_destroy(write_loop);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(tcp_socket_zero_copy_close_delivers_data, s_test_tcp_socket_zero_copy_close_delivers_data)
+
+/* SO_BUSY_POLL itself can't be checked, raising it above net.core.busy_read takes CAP_NET_ADMIN. The loop's spin
+ * registration doesn't. */
+static int s_check_busy_poll_registered(struct aws_socket *outgoing, struct aws_socket *incoming, void *user_data) {
+    (void)user_data;
+
+    ASSERT_PTR_EQUALS(outgoing->event_loop, incoming->event_loop);
+#ifdef _WIN32
+    ASSERT_UINT_EQUALS(0, aws_event_loop_get_busy_poll_usec(outgoing->event_loop));
+#else
+    ASSERT_UINT_EQUALS(outgoing->options.busy_poll_usec, aws_event_loop_get_busy_poll_usec(outgoing->event_loop));
+#endif
+    return AWS_OP_SUCCESS;
+}
+
+/* both ends busy poll, so the event loop spins between reads and writes instead of sleeping in epoll_wait() */
+static int s_test_tcp_socket_busy_poll_communication(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_IPV4;
+    options.busy_poll_usec = 50;
+
+    struct aws_socket_endpoint endpoint = {.address = "127.0.0.1", .port = 8131};
+
+    return s_test_socket_ex(allocator, &options, NULL, &endpoint, s_check_busy_poll_registered, NULL);
+}
+
+AWS_TEST_CASE(tcp_socket_busy_poll_communication, s_test_tcp_socket_busy_poll_communication)
+
+#if defined(__linux__) && defined(TCPI_OPT_SYN_DATA)
+/* Fast Open only happens when net.ipv4.tcp_fastopen enables both the client (1) and the server (2) side */
+static bool s_host_allows_fast_open(void) {
+    FILE *sysctl = fopen("/proc/sys/net/ipv4/tcp_fastopen", "r");
+    if (!sysctl) {
+        return false;
+    }
+
+    int mode = 0;
+    bool read_mode = fscanf(sysctl, "%d", &mode) == 1;
+    fclose(sysctl);
+    return read_mode && (mode & 0x3) == 0x3;
+}
+#endif
+
+/* the outgoing socket's SYN carried data, so the cached cookie was used */
+static int s_check_fast_open_used(struct aws_socket *outgoing, struct aws_socket *incoming, void *user_data) {
+    (void)incoming;
+    (void)user_data;
+
+#if defined(__linux__) && defined(TCPI_OPT_SYN_DATA)
+    if (s_host_allows_fast_open()) {
+        struct tcp_info info;
+        AWS_ZERO_STRUCT(info);
+        socklen_t info_len = sizeof(info);
+        ASSERT_SUCCESS(getsockopt(outgoing->io_handle.data.fd, IPPROTO_TCP, TCP_INFO, &info, &info_len));
+        ASSERT_TRUE(info.tcpi_options & TCPI_OPT_SYN_DATA);
+    }
+#else
+    (void)outgoing;
+#endif
+    return AWS_OP_SUCCESS;
+}
+
+/* the first connection fetches a Fast Open cookie, the second one sends its first write in the SYN. Either way the
+ * data has to make it across; whether data goes in the SYN at all depends on the host's net.ipv4.tcp_fastopen. */
+static int s_test_tcp_socket_fast_open_communication(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_IPV4;
+    options.fast_open = true;
+    options.fast_open_queue_length = 16;
+
+    struct aws_socket_endpoint endpoint = {.address = "127.0.0.1", .port = 8132};
+
+    /* a cookie cached by an earlier run lets the first connection use Fast Open already, so only check the second */
+    ASSERT_SUCCESS(s_test_socket(allocator, &options, &endpoint));
+    return s_test_socket_ex(allocator, &options, NULL, &endpoint, s_check_fast_open_used, NULL);
+}
+
+AWS_TEST_CASE(tcp_socket_fast_open_communication, s_test_tcp_socket_fast_open_communication)
+
+/* each end sent one buffer and read one, and the event loop has gone through the send timestamps since */
+static int s_check_kernel_timestamps(struct aws_socket *outgoing, struct aws_socket *incoming, void *user_data) {
+    (void)user_data;
+
+    uint64_t now_ns = 0;
+    ASSERT_SUCCESS(aws_sys_clock_get_ticks(&now_ns));
+
+    struct aws_socket *sockets[] = {outgoing, incoming};
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(sockets); ++i) {
+        struct aws_socket_kernel_timestamps timestamps;
+        AWS_ZERO_STRUCT(timestamps);
+#ifdef __linux__
+        ASSERT_SUCCESS(aws_socket_get_kernel_timestamps(sockets[i], &timestamps));
+        ASSERT_TRUE(timestamps.last_rx_ns > 0);
+        ASSERT_TRUE(timestamps.last_rx_ns <= now_ns);
+        ASSERT_TRUE(timestamps.last_tx_ns > 0);
+        ASSERT_TRUE(timestamps.last_tx_ns <= now_ns);
+        /* the send was the first one on the connection, its last byte is at this offset */
+        ASSERT_UINT_EQUALS(sizeof("I'm a little teapot") - 1, timestamps.last_tx_id);
+#else
+        ASSERT_ERROR(AWS_ERROR_UNSUPPORTED_OPERATION, aws_socket_get_kernel_timestamps(sockets[i], &timestamps));
+#endif
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_test_tcp_socket_kernel_timestamps_communication(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_IPV4;
+    options.kernel_timestamps = true;
+
+    struct aws_socket_endpoint endpoint = {.address = "127.0.0.1", .port = 8133};
+
+    return s_test_socket_ex(allocator, &options, NULL, &endpoint, s_check_kernel_timestamps, NULL);
+}
+
+AWS_TEST_CASE(tcp_socket_kernel_timestamps_communication, s_test_tcp_socket_kernel_timestamps_communication)
+
+#ifndef _WIN32
+static int s_test_tcp_socket_extended_options(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_IPV4;
+    options.no_delay = true;
+    options.type_of_service = 0x10;
+    options.send_buffer_size = 128 * 1024;
+    options.receive_buffer_size = 128 * 1024;
+#    ifdef __linux__
+    options.quick_ack = true;
+    strncpy(options.congestion_control, "reno", sizeof(options.congestion_control) - 1);
+    options.defer_accept_timeout_sec = 5;
+    options.fast_open_queue_length = 16;
+#    endif
+
+    struct aws_socket socket;
+    ASSERT_SUCCESS(aws_socket_init(&socket, allocator, &options));
+    int fd = socket.io_handle.data.fd;
+
+    int value = 0;
+    socklen_t value_len = sizeof(value);
+    ASSERT_SUCCESS(getsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &value, &value_len));
+    ASSERT_TRUE(value != 0);
+
+    value_len = sizeof(value);
+    ASSERT_SUCCESS(getsockopt(fd, IPPROTO_IP, IP_TOS, &value, &value_len));
+    ASSERT_INT_EQUALS(0x10, value);
+
+    /* the OS may round the buffer sizes up, e.g. linux doubles them for bookkeeping overhead */
+    value_len = sizeof(value);
+    ASSERT_SUCCESS(getsockopt(fd, SOL_SOCKET, SO_SNDBUF, &value, &value_len));
+    ASSERT_TRUE(value >= 128 * 1024);
+
+    value_len = sizeof(value);
+    ASSERT_SUCCESS(getsockopt(fd, SOL_SOCKET, SO_RCVBUF, &value, &value_len));
+    ASSERT_TRUE(value >= 128 * 1024);
+
+#    ifdef __linux__
+    char congestion_control[AWS_SOCKET_CONGESTION_CONTROL_MAX_LEN] = {0};
+    socklen_t congestion_control_len = sizeof(congestion_control);
+    ASSERT_SUCCESS(getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, congestion_control, &congestion_control_len));
+    ASSERT_BIN_ARRAYS_EQUALS("reno", 4, congestion_control, strlen(congestion_control));
+
+    /* TCP_DEFER_ACCEPT and TCP_FASTOPEN are applied by listen(). The kernel rounds TCP_DEFER_ACCEPT to a number of
+     * SYN-ACK retransmits. */
+    struct aws_socket_endpoint endpoint = {.address = "127.0.0.1", .port = 0};
+    ASSERT_SUCCESS(aws_socket_bind(&socket, &endpoint));
+    ASSERT_SUCCESS(aws_socket_listen(&socket, 16));
+    value_len = sizeof(value);
+    ASSERT_SUCCESS(getsockopt(fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, &value, &value_len));
+    ASSERT_TRUE(value > 0);
+
+    value_len = sizeof(value);
+    ASSERT_SUCCESS(getsockopt(fd, IPPROTO_TCP, TCP_FASTOPEN, &value, &value_len));
+    ASSERT_INT_EQUALS(16, value);
+#    endif
+
+    aws_socket_clean_up(&socket);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(tcp_socket_extended_options, s_test_tcp_socket_extended_options)
+
+#    define ACCEPT_BUDGET_CONNECTION_COUNT 8
+
+struct accept_budget_args {
+    struct aws_mutex *mutex;
+    struct aws_condition_variable *condition_variable;
+    struct aws_socket outgoing[ACCEPT_BUDGET_CONNECTION_COUNT];
+    struct local_outgoing_args outgoing_args[ACCEPT_BUDGET_CONNECTION_COUNT];
+    struct aws_socket *incoming[ACCEPT_BUDGET_CONNECTION_COUNT];
+    size_t incoming_count;
+    bool error_invoked;
+    bool close_completed;
+};
+
+static void s_accept_budget_incoming(
+    struct aws_socket *socket,
+    int error_code,
+    struct aws_socket *new_socket,
+    void *user_data) {
+    (void)socket;
+    struct accept_budget_args *args = user_data;
+
+    aws_mutex_lock(args->mutex);
+    if (!error_code && args->incoming_count < ACCEPT_BUDGET_CONNECTION_COUNT) {
+        args->incoming[args->incoming_count++] = new_socket;
+    } else {
+        args->error_invoked = true;
+    }
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(args->condition_variable);
+}
+
+static bool s_accept_budget_connected_predicate(void *arg) {
+    struct accept_budget_args *args = arg;
+
+    for (size_t i = 0; i < ACCEPT_BUDGET_CONNECTION_COUNT; ++i) {
+        if (!s_connection_completed_predicate(&args->outgoing_args[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool s_accept_budget_completed_predicate(void *arg) {
+    struct accept_budget_args *args = arg;
+
+    if (args->error_invoked) {
+        return true;
+    }
+
+    for (size_t i = 0; i < ACCEPT_BUDGET_CONNECTION_COUNT; ++i) {
+        if (!s_connection_completed_predicate(&args->outgoing_args[i])) {
+            return false;
+        }
+    }
+
+    return args->incoming_count == ACCEPT_BUDGET_CONNECTION_COUNT;
+}
+
+static void s_accept_budget_close_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct accept_budget_args *args = arg;
+
+    aws_mutex_lock(args->mutex);
+    for (size_t i = 0; i < args->incoming_count; ++i) {
+        aws_socket_close(args->incoming[i]);
+    }
+    for (size_t i = 0; i < ACCEPT_BUDGET_CONNECTION_COUNT; ++i) {
+        aws_socket_close(&args->outgoing[i]);
+    }
+    args->close_completed = true;
+    aws_mutex_unlock(args->mutex);
+    aws_condition_variable_notify_one(args->condition_variable);
+}
+
+static bool s_accept_budget_close_predicate(void *arg) {
+    struct accept_budget_args *args = arg;
+    return args->close_completed;
+}
+
+/* Every connection is queued in the backlog before accepting starts, so the listener gets a single readable event for
+ * all of them. It accepts one connection per tick, so the other connections are only ever accepted if the
+ * continuation task runs. */
+static int s_test_local_socket_accept_budget(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_event_loop *event_loop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+    ASSERT_NOT_NULL(event_loop, "Event loop creation failed with error: %s", aws_error_debug_str(aws_last_error()));
+    ASSERT_SUCCESS(aws_event_loop_run(event_loop));
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_LOCAL;
+    options.max_accepts_per_tick = 1;
+
+    uint64_t timestamp = 0;
+    ASSERT_SUCCESS(aws_sys_clock_get_ticks(&timestamp));
+    struct aws_socket_endpoint endpoint;
+    snprintf(endpoint.address, sizeof(endpoint.address), LOCAL_SOCK_TEST_PATTERN, (long long unsigned)timestamp);
+
+    struct aws_mutex mutex = AWS_MUTEX_INIT;
+    struct aws_condition_variable condition_variable = AWS_CONDITION_VARIABLE_INIT;
+
+    struct accept_budget_args args;
+    AWS_ZERO_STRUCT(args);
+    args.mutex = &mutex;
+    args.condition_variable = &condition_variable;
+
+    struct aws_socket listener;
+    ASSERT_SUCCESS(aws_socket_init(&listener, allocator, &options));
+    ASSERT_SUCCESS(aws_socket_bind(&listener, &endpoint));
+    ASSERT_SUCCESS(aws_socket_listen(&listener, 1024));
+
+    for (size_t i = 0; i < ACCEPT_BUDGET_CONNECTION_COUNT; ++i) {
+        args.outgoing_args[i].mutex = &mutex;
+        args.outgoing_args[i].condition_variable = &condition_variable;
+        ASSERT_SUCCESS(aws_socket_init(&args.outgoing[i], allocator, &options));
+        ASSERT_SUCCESS(aws_socket_connect(
+            &args.outgoing[i], &endpoint, event_loop, s_local_outgoing_connection, &args.outgoing_args[i]));
+    }
+
+    /* a local connect completes as soon as the connection is in the listener's backlog */
+    ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+    ASSERT_SUCCESS(
+        aws_condition_variable_wait_pred(&condition_variable, &mutex, s_accept_budget_connected_predicate, &args));
+    ASSERT_UINT_EQUALS(0, args.incoming_count);
+    ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+
+    ASSERT_SUCCESS(aws_socket_start_accept(&listener, event_loop, s_accept_budget_incoming, &args));
+
+    ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+    ASSERT_SUCCESS(
+        aws_condition_variable_wait_pred(&condition_variable, &mutex, s_accept_budget_completed_predicate, &args));
+    ASSERT_FALSE(args.error_invoked);
+    ASSERT_UINT_EQUALS(ACCEPT_BUDGET_CONNECTION_COUNT, args.incoming_count);
+    for (size_t i = 0; i < ACCEPT_BUDGET_CONNECTION_COUNT; ++i) {
+        ASSERT_TRUE(args.outgoing_args[i].connect_invoked);
+    }
+    ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+
+    struct aws_task close_task = {
+        .fn = s_accept_budget_close_task,
+        .arg = &args,
+    };
+    aws_event_loop_schedule_task_now(event_loop, &close_task);
+    ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+    ASSERT_SUCCESS(
+        aws_condition_variable_wait_pred(&condition_variable, &mutex, s_accept_budget_close_predicate, &args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+
+    for (size_t i = 0; i < ACCEPT_BUDGET_CONNECTION_COUNT; ++i) {
+        aws_socket_clean_up(args.incoming[i]);
+        aws_mem_release(allocator, args.incoming[i]);
+        aws_socket_clean_up(&args.outgoing[i]);
+    }
+
+    ASSERT_SUCCESS(aws_socket_close(&listener));
+    aws_socket_clean_up(&listener);
+
+    aws_event_loop_destroy(event_loop);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(local_socket_accept_budget, s_test_local_socket_accept_budget)
+
+struct socket_relay_test_args {
+    struct aws_mutex *mutex;
+    struct aws_condition_variable *condition_variable;
+    int error_code;
+    bool shutdown_invoked;
+};
+
+static void s_socket_relay_test_on_shutdown(struct aws_socket_relay *relay, int error_code, void *user_data) {
+    (void)relay;
+    struct socket_relay_test_args *relay_args = user_data;
+    aws_mutex_lock(relay_args->mutex);
+    relay_args->error_code = error_code;
+    relay_args->shutdown_invoked = true;
+    aws_mutex_unlock(relay_args->mutex);
+    aws_condition_variable_notify_one(relay_args->condition_variable);
+}
+
+static bool s_socket_relay_shutdown_predicate(void *arg) {
+    struct socket_relay_test_args *relay_args = arg;
+    return relay_args->shutdown_invoked;
+}
+
+static void s_shutdown_write_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    aws_socket_shutdown_dir(arg, AWS_CHANNEL_DIR_WRITE);
+}
+
+/* connects `outgoing` on client_loop, and returns the accepted end assigned to server_loop */
+static struct aws_socket *s_socket_relay_test_connect(
+    struct aws_allocator *allocator,
+    struct aws_socket_options *options,
+    struct aws_socket_endpoint *endpoint,
+    struct local_listener_args *listener_args,
+    struct aws_socket *outgoing,
+    struct aws_event_loop *client_loop,
+    struct aws_event_loop *server_loop) {
+
+    struct local_outgoing_args outgoing_args = {
+        .mutex = listener_args->mutex,
+        .condition_variable = listener_args->condition_variable,
+    };
+    listener_args->incoming = NULL;
+    listener_args->incoming_invoked = false;
+
+    if (aws_socket_init(outgoing, allocator, options) ||
+        aws_socket_connect(outgoing, endpoint, client_loop, s_local_outgoing_connection, &outgoing_args)) {
+        return NULL;
+    }
+
+    aws_mutex_lock(listener_args->mutex);
+    aws_condition_variable_wait_pred(
+        listener_args->condition_variable, listener_args->mutex, s_incoming_predicate, listener_args);
+    aws_condition_variable_wait_pred(
+        listener_args->condition_variable, listener_args->mutex, s_connection_completed_predicate, &outgoing_args);
+    aws_mutex_unlock(listener_args->mutex);
+
+    if (!listener_args->incoming || !outgoing_args.connect_invoked ||
+        aws_socket_assign_to_event_loop(listener_args->incoming, server_loop)) {
+        return NULL;
+    }
+
+    aws_socket_subscribe_to_readable_events(outgoing, s_on_readable, NULL);
+    return listener_args->incoming;
+}
+
+struct socket_relay_test_read_args {
+    struct aws_mutex *mutex;
+    struct aws_condition_variable *condition_variable;
+    struct aws_socket *socket;
+    /* read into until it is full */
+    struct aws_byte_buf *received;
+    int error_code;
+    bool done;
+};
+
+/* reads until the buffer is full, or the read fails with anything but would-block. The lock isn't held while reading,
+ * the socket writing to the other end of the relay needs it to report its progress. */
+static void s_socket_relay_test_read_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+
+    struct socket_relay_test_read_args *read_args = arg;
+    int error_code = AWS_ERROR_SUCCESS;
+    while (read_args->received->len < read_args->received->capacity) {
+        size_t amount_read = 0;
+        if (aws_socket_read(read_args->socket, read_args->received, &amount_read)) {
+            if (aws_last_error() == AWS_IO_READ_WOULD_BLOCK) {
+                continue;
+            }
+            error_code = aws_last_error();
+            break;
+        }
+    }
+
+    aws_mutex_lock(read_args->mutex);
+    read_args->error_code = error_code;
+    read_args->done = true;
+    aws_mutex_unlock(read_args->mutex);
+    aws_condition_variable_notify_one(read_args->condition_variable);
+}
+
+static bool s_socket_relay_test_read_predicate(void *arg) {
+    struct socket_relay_test_read_args *read_args = arg;
+    return read_args->done;
+}
+
+static int s_socket_relay_test_read(
+    struct aws_mutex *mutex,
+    struct aws_condition_variable *condition_variable,
+    struct aws_socket *socket,
+    struct aws_byte_buf *received,
+    int *error_code) {
+
+    struct socket_relay_test_read_args read_args = {
+        .mutex = mutex,
+        .condition_variable = condition_variable,
+        .socket = socket,
+        .received = received,
+    };
+    struct aws_task read_task;
+    aws_task_init(&read_task, s_socket_relay_test_read_task, &read_args, "socket_relay_test_read");
+    aws_event_loop_schedule_task_now(aws_socket_get_event_loop(socket), &read_task);
+
+    ASSERT_SUCCESS(aws_mutex_lock(mutex));
+    ASSERT_SUCCESS(
+        aws_condition_variable_wait_pred(condition_variable, mutex, s_socket_relay_test_read_predicate, &read_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(mutex));
+
+    *error_code = read_args.error_code;
+    return AWS_OP_SUCCESS;
+}
+
+/* the payload is far more than the sockets and the relay's pipe hold together, so the write only completes once the
+ * reader drains the far end, and the relay has to stop reading and resume many times on the way */
+static int s_socket_relay_test_transfer(
+    struct socket_io_args *io_args,
+    const struct aws_byte_buf *payload,
+    struct aws_socket *from,
+    struct aws_socket *to) {
+
+    struct aws_byte_cursor payload_cursor = aws_byte_cursor_from_buf(payload);
+    io_args->to_write = &payload_cursor;
+    io_args->amount_written = 0;
+    io_args->error_code = 0;
+    io_args->socket = from;
+
+    struct aws_task write_task = {
+        .fn = s_write_task,
+        .arg = io_args,
+    };
+    aws_event_loop_schedule_task_now(aws_socket_get_event_loop(from), &write_task);
+
+    struct aws_byte_buf received;
+    ASSERT_SUCCESS(aws_byte_buf_init(&received, payload->allocator, payload->len));
+    int read_error = AWS_ERROR_SUCCESS;
+    ASSERT_SUCCESS(s_socket_relay_test_read(io_args->mutex, &io_args->condition_variable, to, &received, &read_error));
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, read_error);
+    ASSERT_BIN_ARRAYS_EQUALS(payload->buffer, payload->len, received.buffer, received.len);
+    aws_byte_buf_clean_up(&received);
+
+    ASSERT_SUCCESS(aws_mutex_lock(io_args->mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &io_args->condition_variable, io_args->mutex, s_write_completed_predicate, io_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(io_args->mutex));
+    ASSERT_INT_EQUALS(AWS_OP_SUCCESS, io_args->error_code);
+    ASSERT_UINT_EQUALS(payload->len, io_args->amount_written);
+
+    return AWS_OP_SUCCESS;
+}
+
+/* shuts down the write direction of `from`, and checks the end of the relay's other connection reads EOF */
+static int s_socket_relay_test_half_close(
+    struct socket_io_args *io_args,
+    struct aws_task *shutdown_task,
+    struct aws_socket *from,
+    struct aws_socket *to) {
+
+    aws_task_init(shutdown_task, s_shutdown_write_task, from, "shutdown_write");
+    aws_event_loop_schedule_task_now(aws_socket_get_event_loop(from), shutdown_task);
+
+    uint8_t spare[1];
+    struct aws_byte_buf received = aws_byte_buf_from_empty_array(spare, sizeof(spare));
+    int read_error = AWS_ERROR_SUCCESS;
+    ASSERT_SUCCESS(s_socket_relay_test_read(io_args->mutex, &io_args->condition_variable, to, &received, &read_error));
+    ASSERT_INT_EQUALS(AWS_IO_SOCKET_CLOSED, read_error);
+    ASSERT_UINT_EQUALS(0, received.len);
+
+    return AWS_OP_SUCCESS;
+}
+
+/* relays between the accepted ends of two connections, each socket on its own event loop, and checks that data goes
+ * both ways, that each peer's half-close reaches the other one, and that the relay winds down once both are done */
+static int s_test_local_socket_relay(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    /* the peers on the first and last loop, the relayed ends on the middle ones */
+    struct aws_event_loop *event_loops[4];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(event_loops); ++i) {
+        event_loops[i] = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+        ASSERT_NOT_NULL(event_loops[i]);
+        ASSERT_SUCCESS(aws_event_loop_run(event_loops[i]));
+    }
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_LOCAL;
+
+    uint64_t timestamp = 0;
+    ASSERT_SUCCESS(aws_sys_clock_get_ticks(&timestamp));
+    struct aws_socket_endpoint endpoint;
+    snprintf(endpoint.address, sizeof(endpoint.address), LOCAL_SOCK_TEST_PATTERN, (long long unsigned)timestamp);
+
+    struct aws_mutex mutex = AWS_MUTEX_INIT;
+    struct aws_condition_variable condition_variable = AWS_CONDITION_VARIABLE_INIT;
+
+    struct local_listener_args listener_args = {
+        .mutex = &mutex,
+        .condition_variable = &condition_variable,
+    };
+
+    struct aws_socket listener;
+    ASSERT_SUCCESS(aws_socket_init(&listener, allocator, &options));
+    ASSERT_SUCCESS(aws_socket_bind(&listener, &endpoint));
+    ASSERT_SUCCESS(aws_socket_listen(&listener, 1024));
+    ASSERT_SUCCESS(aws_socket_start_accept(&listener, event_loops[0], s_local_listener_incoming, &listener_args));
+
+    struct aws_socket outgoing[2];
+    struct aws_socket *incoming[2];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(outgoing); ++i) {
+        incoming[i] = s_socket_relay_test_connect(
+            allocator, &options, &endpoint, &listener_args, &outgoing[i], event_loops[i * 3], event_loops[i + 1]);
+        ASSERT_NOT_NULL(incoming[i]);
+    }
+
+    struct socket_relay_test_args relay_args = {
+        .mutex = &mutex,
+        .condition_variable = &condition_variable,
+    };
+    struct aws_socket_relay_options relay_options = {
+        .socket_a = incoming[0],
+        .socket_b = incoming[1],
+        /* a single page, the kernel's smallest pipe */
+        .max_buffered_bytes = 4096,
+        .on_shutdown = s_socket_relay_test_on_shutdown,
+        .user_data = &relay_args,
+    };
+    struct aws_socket_relay *relay = aws_socket_relay_new(allocator, &relay_options);
+    if (!relay) {
+        ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error());
+    } else {
+        struct aws_byte_buf payload;
+        ASSERT_SUCCESS(aws_byte_buf_init(&payload, allocator, 4 * 1024 * 1024));
+        for (size_t i = 0; i < payload.capacity; ++i) {
+            payload.buffer[i] = (uint8_t)(i * 31 + i / 4096);
+        }
+        payload.len = payload.capacity;
+
+        struct socket_io_args io_args = {
+            .mutex = &mutex,
+            .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+        };
+
+        ASSERT_SUCCESS(s_socket_relay_test_transfer(&io_args, &payload, &outgoing[0], &outgoing[1]));
+        ASSERT_SUCCESS(s_socket_relay_test_transfer(&io_args, &payload, &outgoing[1], &outgoing[0]));
+
+        /* a half-closed connection keeps relaying the other way */
+        struct aws_task shutdown_tasks[2];
+        ASSERT_SUCCESS(s_socket_relay_test_half_close(&io_args, &shutdown_tasks[0], &outgoing[0], &outgoing[1]));
+        ASSERT_FALSE(relay_args.shutdown_invoked);
+        ASSERT_SUCCESS(s_socket_relay_test_transfer(&io_args, &payload, &outgoing[1], &outgoing[0]));
+
+        /* once both peers are done sending, the relay passes that on and shuts itself down */
+        ASSERT_SUCCESS(s_socket_relay_test_half_close(&io_args, &shutdown_tasks[1], &outgoing[1], &outgoing[0]));
+        aws_byte_buf_clean_up(&payload);
+
+        ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+        ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+            &condition_variable, &mutex, s_socket_relay_shutdown_predicate, &relay_args));
+        ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+        ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, relay_args.error_code);
+        ASSERT_FALSE(aws_socket_is_open(incoming[0]));
+        ASSERT_FALSE(aws_socket_is_open(incoming[1]));
+
+        aws_socket_relay_release(relay);
+    }
+
+    struct socket_io_args close_args = {
+        .mutex = &mutex,
+        .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+    };
+    struct aws_task close_task = {
+        .fn = s_socket_close_task,
+        .arg = &close_args,
+    };
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(outgoing) * 2; ++i) {
+        /* the relay has closed the accepted ends already */
+        if (i % 2 && relay) {
+            continue;
+        }
+        close_args.socket = i % 2 ? incoming[i / 2] : &outgoing[i / 2];
+        close_args.close_completed = false;
+        aws_event_loop_schedule_task_now(aws_socket_get_event_loop(close_args.socket), &close_task);
+        ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+        ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+            &close_args.condition_variable, &mutex, s_close_completed_predicate, &close_args));
+        ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+    }
+
+    ASSERT_SUCCESS(aws_socket_close(&listener));
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(event_loops); ++i) {
+        aws_event_loop_destroy(event_loops[i]);
+    }
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(outgoing); ++i) {
+        aws_socket_clean_up(incoming[i]);
+        aws_mem_release(allocator, incoming[i]);
+        aws_socket_clean_up(&outgoing[i]);
+    }
+
+    aws_socket_clean_up(&listener);
+
+    return AWS_OP_SUCCESS;
 }
 
-AWS_TEST_CASE(tcp_socket_communication, s_test_tcp_socket_communication)
+AWS_TEST_CASE(local_socket_relay, s_test_local_socket_relay)
+#endif
 
 #if defined(USE_VSOCK)
 static int s_test_vsock_loopback_socket_communication(struct aws_allocator *allocator, void *ctx) {
@@ -489,10 +1619,295 @@ static int s_test_udp_bind_connect_communication(struct aws_allocator *allocator
     struct aws_socket_endpoint local = {.address = "127.0.0.1", .port = 4242};
     struct aws_socket_endpoint endpoint = {.address = "127.0.0.1", .port = 8126};
 
-    return s_test_socket_ex(allocator, &options, &local, &endpoint);
+    return s_test_socket_ex(allocator, &options, &local, &endpoint, NULL, NULL);
 }
 AWS_TEST_CASE(udp_bind_connect_communication, s_test_udp_bind_connect_communication)
 
+#ifndef _WIN32
+#    define DATAGRAM_BATCH_TEST_COUNT 4096
+#    define DATAGRAM_BATCH_BENCHMARK_COUNT 262144
+#    define DATAGRAM_BATCH_TEST_BATCH 32
+#    define DATAGRAM_BATCH_TEST_SIZE 64
+
+struct datagram_batch_test_args {
+    struct aws_mutex mutex;
+    struct aws_condition_variable condition_variable;
+    struct aws_socket *sender;
+    struct aws_socket *receiver;
+    struct aws_socket_endpoint destination;
+    /* datagrams to send, a multiple of DATAGRAM_BATCH_TEST_BATCH */
+    size_t count;
+    /* one syscall per datagram with aws_socket_send_to() and aws_socket_receive_from(), or the batch functions */
+    bool batched;
+    size_t written_count;
+    /* receive calls that returned datagrams */
+    size_t receive_calls;
+    int error_code;
+    bool out_of_order;
+    uint64_t elapsed_ns;
+    bool done;
+};
+
+static void s_on_batch_test_datagram_written(
+    struct aws_socket *socket,
+    int error_code,
+    size_t amount_written,
+    void *user_data) {
+    (void)socket;
+    struct datagram_batch_test_args *args = user_data;
+
+    /* only ever invoked on the loop thread, the test thread reads the results once the task is done */
+    if (error_code) {
+        args->error_code = error_code;
+    } else if (amount_written != DATAGRAM_BATCH_TEST_SIZE) {
+        args->out_of_order = true;
+    }
+    args->written_count++;
+}
+
+static bool s_datagram_batch_test_done_predicate(void *arg) {
+    struct datagram_batch_test_args *args = arg;
+    return args->done;
+}
+
+/* receives the batch of datagrams just sent, each has to arrive whole and in order */
+static int s_datagram_batch_test_receive(struct datagram_batch_test_args *args, size_t first_sequence) {
+    uint8_t storage[DATAGRAM_BATCH_TEST_BATCH][DATAGRAM_BATCH_TEST_SIZE];
+    struct aws_byte_buf buffers[DATAGRAM_BATCH_TEST_BATCH];
+    struct aws_socket_datagram datagrams[DATAGRAM_BATCH_TEST_BATCH];
+
+    size_t received = 0;
+    while (received < DATAGRAM_BATCH_TEST_BATCH) {
+        size_t wanted = args->batched ? DATAGRAM_BATCH_TEST_BATCH - received : 1;
+        for (size_t i = 0; i < wanted; ++i) {
+            buffers[i] = aws_byte_buf_from_empty_array(storage[i], DATAGRAM_BATCH_TEST_SIZE);
+            datagrams[i] = (struct aws_socket_datagram){.buffer = &buffers[i]};
+        }
+
+        size_t count = 0;
+        int result = AWS_OP_SUCCESS;
+        if (args->batched) {
+            result = aws_socket_receive_batch(args->receiver, datagrams, wanted, &count);
+        } else {
+            size_t amount_read = 0;
+            result = aws_socket_receive_from(args->receiver, &buffers[0], NULL, &amount_read);
+            count = 1;
+        }
+
+        if (result) {
+            /* loopback usually delivers before the send returns, but it may not have yet, wait for the rest */
+            struct pollfd receiver_fd = {.fd = args->receiver->io_handle.data.fd, .events = POLLIN};
+            if (aws_last_error() != AWS_IO_READ_WOULD_BLOCK || poll(&receiver_fd, 1, 3000) <= 0) {
+                return AWS_OP_ERR;
+            }
+            continue;
+        }
+
+        args->receive_calls++;
+
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t sequence = 0;
+            memcpy(&sequence, buffers[i].buffer, sizeof(sequence));
+            if (buffers[i].len != DATAGRAM_BATCH_TEST_SIZE || sequence != first_sequence + received + i) {
+                args->out_of_order = true;
+            }
+        }
+        received += count;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* ping-pongs the datagrams a batch at a time over loopback, timing the whole run */
+static void s_datagram_batch_test_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct datagram_batch_test_args *args = arg;
+
+    uint8_t storage[DATAGRAM_BATCH_TEST_BATCH][DATAGRAM_BATCH_TEST_SIZE];
+    struct aws_byte_buf buffers[DATAGRAM_BATCH_TEST_BATCH];
+    struct aws_socket_datagram datagrams[DATAGRAM_BATCH_TEST_BATCH];
+    memset(storage, 'b', sizeof(storage));
+
+    uint64_t start_ns = 0;
+    aws_high_res_clock_get_ticks(&start_ns);
+
+    int error_code = AWS_ERROR_SUCCESS;
+    for (size_t sent = 0; sent < args->count && !error_code; sent += DATAGRAM_BATCH_TEST_BATCH) {
+        for (size_t i = 0; i < DATAGRAM_BATCH_TEST_BATCH; ++i) {
+            uint32_t sequence = (uint32_t)(sent + i);
+            memcpy(storage[i], &sequence, sizeof(sequence));
+            buffers[i] = aws_byte_buf_from_array(storage[i], DATAGRAM_BATCH_TEST_SIZE);
+            datagrams[i] = (struct aws_socket_datagram){
+                .buffer = &buffers[i],
+                .endpoint = &args->destination,
+                .user_data = args,
+            };
+        }
+
+        if (args->batched) {
+            if (aws_socket_send_batch(
+                    args->sender, datagrams, DATAGRAM_BATCH_TEST_BATCH, s_on_batch_test_datagram_written)) {
+                error_code = aws_last_error();
+                break;
+            }
+        } else {
+            for (size_t i = 0; i < DATAGRAM_BATCH_TEST_BATCH; ++i) {
+                struct aws_byte_cursor cursor = aws_byte_cursor_from_buf(&buffers[i]);
+                if (aws_socket_send_to(
+                        args->sender, &cursor, &args->destination, s_on_batch_test_datagram_written, args)) {
+                    error_code = aws_last_error();
+                    break;
+                }
+            }
+        }
+
+        if (!error_code && s_datagram_batch_test_receive(args, sent)) {
+            error_code = aws_last_error();
+        }
+    }
+
+    uint64_t end_ns = 0;
+    aws_high_res_clock_get_ticks(&end_ns);
+
+    aws_mutex_lock(&args->mutex);
+    if (error_code) {
+        args->error_code = error_code;
+    }
+    args->elapsed_ns = end_ns - start_ns;
+    args->done = true;
+    aws_mutex_unlock(&args->mutex);
+    aws_condition_variable_notify_one(&args->condition_variable);
+}
+
+static void s_datagram_batch_test_close_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct datagram_batch_test_args *args = arg;
+
+    aws_mutex_lock(&args->mutex);
+    aws_socket_close(args->sender);
+    aws_socket_close(args->receiver);
+    args->done = true;
+    aws_mutex_unlock(&args->mutex);
+    aws_condition_variable_notify_one(&args->condition_variable);
+}
+
+static int s_datagram_batch_test_run(
+    struct aws_event_loop *event_loop,
+    struct datagram_batch_test_args *args,
+    aws_task_fn *task_fn) {
+
+    struct aws_task task;
+    aws_task_init(&task, task_fn, args, "datagram_batch_test");
+
+    ASSERT_SUCCESS(aws_mutex_lock(&args->mutex));
+    args->done = false;
+    aws_event_loop_schedule_task_now(event_loop, &task);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &args->condition_variable, &args->mutex, s_datagram_batch_test_done_predicate, args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&args->mutex));
+
+    return AWS_OP_SUCCESS;
+}
+
+/*
+ * Sends `count` datagrams over loopback, one syscall per datagram, then again in batches with sendmmsg() and
+ * recvmmsg(). Every datagram has to arrive whole and in order either way, and the batched run has to take fewer
+ * receive calls than there are datagrams. How long each run took goes into elapsed_ns, unbatched first.
+ */
+static int s_datagram_batch_test_loopback(struct aws_allocator *allocator, size_t count, uint64_t elapsed_ns[2]) {
+    struct aws_event_loop *event_loop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+    ASSERT_NOT_NULL(event_loop, "Event loop creation failed with error: %s", aws_error_debug_str(aws_last_error()));
+    ASSERT_SUCCESS(aws_event_loop_run(event_loop));
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_DGRAM;
+    options.domain = AWS_SOCKET_IPV4;
+
+    struct aws_socket_endpoint local = {.address = "127.0.0.1", .port = 0};
+
+    struct aws_socket receiver;
+    ASSERT_SUCCESS(aws_socket_init(&receiver, allocator, &options));
+    ASSERT_SUCCESS(aws_socket_bind(&receiver, &local));
+    ASSERT_SUCCESS(aws_socket_assign_to_event_loop(&receiver, event_loop));
+
+    /* sending to a destination only needs a bound socket */
+    struct aws_socket sender;
+    ASSERT_SUCCESS(aws_socket_init(&sender, allocator, &options));
+    ASSERT_SUCCESS(aws_socket_bind(&sender, &local));
+    ASSERT_SUCCESS(aws_socket_assign_to_event_loop(&sender, event_loop));
+
+    struct datagram_batch_test_args args = {
+        .mutex = AWS_MUTEX_INIT,
+        .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+        .sender = &sender,
+        .receiver = &receiver,
+        .destination = receiver.local_endpoint,
+        .count = count,
+    };
+
+    for (size_t run = 0; run < 2; ++run) {
+        args.batched = run == 1;
+        args.written_count = 0;
+        args.receive_calls = 0;
+        ASSERT_SUCCESS(s_datagram_batch_test_run(event_loop, &args, s_datagram_batch_test_task));
+        ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, args.error_code);
+        ASSERT_FALSE(args.out_of_order);
+        ASSERT_UINT_EQUALS(count, args.written_count);
+        if (args.batched) {
+            ASSERT_TRUE(args.receive_calls < count);
+        } else {
+            ASSERT_UINT_EQUALS(count, args.receive_calls);
+        }
+        elapsed_ns[run] = args.elapsed_ns ? args.elapsed_ns : 1;
+    }
+
+    ASSERT_SUCCESS(s_datagram_batch_test_run(event_loop, &args, s_datagram_batch_test_close_task));
+    aws_socket_clean_up(&sender);
+    aws_socket_clean_up(&receiver);
+    aws_event_loop_destroy(event_loop);
+
+    return AWS_OP_SUCCESS;
+}
+
+/* timing on shared machines is too noisy to assert on, only the delivery is checked */
+static int s_test_udp_socket_batch_loopback(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint64_t elapsed_ns[2] = {0};
+    return s_datagram_batch_test_loopback(allocator, DATAGRAM_BATCH_TEST_COUNT, elapsed_ns);
+}
+
+AWS_TEST_CASE(udp_socket_batch_loopback, s_test_udp_socket_batch_loopback)
+
+/*
+ * Loopback packets-per-second benchmark, batched against one syscall per datagram. Disabled in CTest, run it by hand:
+ * aws-c-io-tests udp_socket_batch_loopback_pps
+ */
+static int s_test_udp_socket_batch_loopback_pps(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint64_t elapsed_ns[2] = {0};
+    ASSERT_SUCCESS(s_datagram_batch_test_loopback(allocator, DATAGRAM_BATCH_BENCHMARK_COUNT, elapsed_ns));
+
+    fprintf(
+        stdout,
+        "udp loopback, %d datagrams of %d bytes: %llu packets/s one per syscall, %llu packets/s in batches of %d\n",
+        DATAGRAM_BATCH_BENCHMARK_COUNT,
+        DATAGRAM_BATCH_TEST_SIZE,
+        (unsigned long long)(DATAGRAM_BATCH_BENCHMARK_COUNT * 1000000000ULL / elapsed_ns[0]),
+        (unsigned long long)(DATAGRAM_BATCH_BENCHMARK_COUNT * 1000000000ULL / elapsed_ns[1]),
+        DATAGRAM_BATCH_TEST_BATCH);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(udp_socket_batch_loopback_pps, s_test_udp_socket_batch_loopback_pps)
+#endif
+
 struct test_host_callback_data {
     struct aws_host_address a_address;
     struct aws_mutex *mutex;
@@ -1314,6 +2729,308 @@ static int s_cleanup_in_write_cb_doesnt_explode(struct aws_allocator *allocator,
 }
 AWS_TEST_CASE(cleanup_in_write_cb_doesnt_explode, s_cleanup_in_write_cb_doesnt_explode)
 
+/* more than twice the 128 requests posix/socket.c gathers per sendmsg(), so a flush spans several gathers */
+#define QUEUED_WRITE_COUNT 300
+#define QUEUED_WRITE_FIRST_SIZE (1024 * 1024)
+#define QUEUED_WRITE_SMALL_SIZE 64
+
+struct queued_write_args {
+    struct aws_mutex *mutex;
+    struct aws_condition_variable condition_variable;
+    struct aws_socket *socket;
+    struct aws_byte_cursor writes[QUEUED_WRITE_COUNT];
+    size_t completed_count;
+    bool out_of_order;
+    int error_code;
+};
+
+static void s_on_queued_write_completed(
+    struct aws_socket *socket,
+    int error_code,
+    size_t amount_written,
+    void *user_data) {
+    (void)socket;
+    struct queued_write_args *write_args = user_data;
+
+    aws_mutex_lock(write_args->mutex);
+    if (error_code) {
+        write_args->error_code = error_code;
+    } else if (
+        write_args->completed_count >= QUEUED_WRITE_COUNT ||
+        amount_written != write_args->writes[write_args->completed_count].len) {
+        write_args->out_of_order = true;
+    }
+    write_args->completed_count++;
+    aws_mutex_unlock(write_args->mutex);
+    aws_condition_variable_notify_one(&write_args->condition_variable);
+}
+
+static bool s_queued_writes_completed_predicate(void *arg) {
+    struct queued_write_args *write_args = arg;
+    return write_args->error_code || write_args->completed_count == QUEUED_WRITE_COUNT;
+}
+
+/* taken by a task queued behind the writes, so it sees how many had completed once they were all queued */
+struct queued_writes_snapshot_args {
+    struct queued_write_args *write_args;
+    size_t completed_count;
+    bool taken;
+};
+
+static void s_queued_writes_snapshot_task(struct aws_task *task, void *args, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct queued_writes_snapshot_args *snapshot_args = args;
+    struct queued_write_args *write_args = snapshot_args->write_args;
+
+    aws_mutex_lock(write_args->mutex);
+    snapshot_args->completed_count = write_args->completed_count;
+    snapshot_args->taken = true;
+    aws_mutex_unlock(write_args->mutex);
+    aws_condition_variable_notify_one(&write_args->condition_variable);
+}
+
+static bool s_queued_writes_snapshot_predicate(void *arg) {
+    struct queued_writes_snapshot_args *snapshot_args = arg;
+    return snapshot_args->taken;
+}
+
+/* the first write fills the socket buffer, so the small writes behind it queue up and are flushed together. */
+static void s_queued_writes_task(struct aws_task *task, void *args, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct queued_write_args *write_args = args;
+
+    for (size_t i = 0; i < QUEUED_WRITE_COUNT; ++i) {
+        if (aws_socket_write(write_args->socket, &write_args->writes[i], s_on_queued_write_completed, write_args)) {
+            aws_mutex_lock(write_args->mutex);
+            write_args->error_code = aws_last_error();
+            aws_mutex_unlock(write_args->mutex);
+            aws_condition_variable_notify_one(&write_args->condition_variable);
+            return;
+        }
+    }
+}
+
+/* queues all the writes before the other end starts reading, then checks they complete in order and all the data
+ * arrives. `completed_before_read` is how many had completed by the time they were all queued. */
+static int s_test_socket_queued_writes(
+    struct aws_allocator *allocator,
+    struct aws_socket_options *options,
+    struct aws_socket_endpoint *endpoint,
+    size_t *completed_before_read) {
+
+    /* the reader spins on its own loop, so the writer's loop stays free to flush the queue */
+    struct aws_event_loop *write_loop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+    ASSERT_NOT_NULL(write_loop, "Event loop creation failed with error: %s", aws_error_debug_str(aws_last_error()));
+    ASSERT_SUCCESS(aws_event_loop_run(write_loop));
+
+    struct aws_event_loop *read_loop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+    ASSERT_NOT_NULL(read_loop, "Event loop creation failed with error: %s", aws_error_debug_str(aws_last_error()));
+    ASSERT_SUCCESS(aws_event_loop_run(read_loop));
+
+    struct aws_mutex mutex = AWS_MUTEX_INIT;
+    struct aws_condition_variable condition_variable = AWS_CONDITION_VARIABLE_INIT;
+    /* the read task holds its mutex until it's done, so it can't share one with the write callbacks */
+    struct aws_mutex read_mutex = AWS_MUTEX_INIT;
+
+    struct local_listener_args listener_args = {
+        .mutex = &mutex,
+        .condition_variable = &condition_variable,
+        .incoming = NULL,
+        .incoming_invoked = false,
+        .error_invoked = false,
+    };
+
+    struct aws_socket listener;
+    ASSERT_SUCCESS(aws_socket_init(&listener, allocator, options));
+    ASSERT_SUCCESS(aws_socket_bind(&listener, endpoint));
+    ASSERT_SUCCESS(aws_socket_listen(&listener, 1024));
+    ASSERT_SUCCESS(aws_socket_start_accept(&listener, write_loop, s_local_listener_incoming, &listener_args));
+
+    struct local_outgoing_args outgoing_args = {
+        .mutex = &mutex, .condition_variable = &condition_variable, .connect_invoked = false, .error_invoked = false};
+
+    struct aws_socket outgoing;
+    ASSERT_SUCCESS(aws_socket_init(&outgoing, allocator, options));
+    ASSERT_SUCCESS(aws_socket_connect(&outgoing, endpoint, write_loop, s_local_outgoing_connection, &outgoing_args));
+
+    ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(&condition_variable, &mutex, s_incoming_predicate, &listener_args));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &condition_variable, &mutex, s_connection_completed_predicate, &outgoing_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+    ASSERT_TRUE(listener_args.incoming_invoked);
+    ASSERT_TRUE(outgoing_args.connect_invoked);
+
+    struct aws_socket *server_sock = listener_args.incoming;
+    ASSERT_SUCCESS(aws_socket_assign_to_event_loop(server_sock, read_loop));
+    ASSERT_SUCCESS(aws_socket_subscribe_to_readable_events(server_sock, s_on_readable, NULL));
+    ASSERT_SUCCESS(aws_socket_subscribe_to_readable_events(&outgoing, s_on_readable, NULL));
+
+    /* one large write followed by small writes of distinct sizes, so completion order can be checked */
+    size_t total_size = QUEUED_WRITE_FIRST_SIZE;
+    for (size_t i = 1; i < QUEUED_WRITE_COUNT; ++i) {
+        total_size += QUEUED_WRITE_SMALL_SIZE + i;
+    }
+
+    struct aws_byte_buf expected;
+    ASSERT_SUCCESS(aws_byte_buf_init(&expected, allocator, total_size));
+    for (size_t i = 0; i < total_size; ++i) {
+        expected.buffer[i] = (uint8_t)(i % 251);
+    }
+    expected.len = total_size;
+
+    struct queued_write_args write_args = {
+        .mutex = &mutex,
+        .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+        .socket = &outgoing,
+    };
+
+    struct aws_byte_cursor remaining = aws_byte_cursor_from_buf(&expected);
+    write_args.writes[0] = aws_byte_cursor_advance(&remaining, QUEUED_WRITE_FIRST_SIZE);
+    for (size_t i = 1; i < QUEUED_WRITE_COUNT; ++i) {
+        write_args.writes[i] = aws_byte_cursor_advance(&remaining, QUEUED_WRITE_SMALL_SIZE + i);
+    }
+    ASSERT_UINT_EQUALS(0, remaining.len);
+
+    struct aws_byte_buf read_buffer;
+    ASSERT_SUCCESS(aws_byte_buf_init(&read_buffer, allocator, total_size));
+
+    struct socket_io_args read_args = {
+        .socket = server_sock,
+        .to_read = &expected,
+        .read_data = &read_buffer,
+        .mutex = &read_mutex,
+        .amount_read = 0,
+        .condition_variable = AWS_CONDITION_VARIABLE_INIT,
+        .close_completed = false,
+    };
+
+    struct aws_task write_task = {
+        .fn = s_queued_writes_task,
+        .arg = &write_args,
+    };
+    aws_event_loop_schedule_task_now(write_loop, &write_task);
+
+    struct queued_writes_snapshot_args snapshot_args = {.write_args = &write_args};
+    struct aws_task snapshot_task = {
+        .fn = s_queued_writes_snapshot_task,
+        .arg = &snapshot_args,
+    };
+    aws_event_loop_schedule_task_now(write_loop, &snapshot_task);
+
+    ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &write_args.condition_variable, &mutex, s_queued_writes_snapshot_predicate, &snapshot_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+    ASSERT_INT_EQUALS(AWS_OP_SUCCESS, write_args.error_code);
+    *completed_before_read = snapshot_args.completed_count;
+
+    struct aws_task read_task = {
+        .fn = s_read_task,
+        .arg = &read_args,
+    };
+    aws_event_loop_schedule_task_now(read_loop, &read_task);
+
+    ASSERT_SUCCESS(aws_mutex_lock(&mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &write_args.condition_variable, &mutex, s_queued_writes_completed_predicate, &write_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&mutex));
+
+    ASSERT_SUCCESS(aws_mutex_lock(&read_mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &read_args.condition_variable, &read_mutex, s_read_task_predicate, &read_args));
+    ASSERT_SUCCESS(aws_mutex_unlock(&read_mutex));
+
+    ASSERT_INT_EQUALS(AWS_OP_SUCCESS, write_args.error_code);
+    ASSERT_FALSE(write_args.out_of_order);
+    ASSERT_BIN_ARRAYS_EQUALS(expected.buffer, expected.len, read_buffer.buffer, read_buffer.len);
+
+    struct aws_task close_task = {
+        .fn = s_socket_close_task,
+        .arg = &read_args,
+    };
+
+    read_args.close_completed = false;
+    aws_event_loop_schedule_task_now(read_loop, &close_task);
+    ASSERT_SUCCESS(aws_mutex_lock(&read_mutex));
+    aws_condition_variable_wait_pred(
+        &read_args.condition_variable, &read_mutex, s_close_completed_predicate, &read_args);
+    ASSERT_SUCCESS(aws_mutex_unlock(&read_mutex));
+    aws_socket_clean_up(server_sock);
+    aws_mem_release(allocator, server_sock);
+
+    read_args.socket = &outgoing;
+    read_args.close_completed = false;
+    aws_event_loop_schedule_task_now(write_loop, &close_task);
+    ASSERT_SUCCESS(aws_mutex_lock(&read_mutex));
+    aws_condition_variable_wait_pred(
+        &read_args.condition_variable, &read_mutex, s_close_completed_predicate, &read_args);
+    ASSERT_SUCCESS(aws_mutex_unlock(&read_mutex));
+    aws_socket_clean_up(&outgoing);
+
+    read_args.socket = &listener;
+    read_args.close_completed = false;
+    aws_event_loop_schedule_task_now(write_loop, &close_task);
+    ASSERT_SUCCESS(aws_mutex_lock(&read_mutex));
+    aws_condition_variable_wait_pred(
+        &read_args.condition_variable, &read_mutex, s_close_completed_predicate, &read_args);
+    ASSERT_SUCCESS(aws_mutex_unlock(&read_mutex));
+    aws_socket_clean_up(&listener);
+
+    aws_byte_buf_clean_up(&read_buffer);
+    aws_byte_buf_clean_up(&expected);
+    aws_event_loop_destroy(read_loop);
+    aws_event_loop_destroy(write_loop);
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_local_socket_queued_writes_in_order(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_LOCAL;
+
+    uint64_t timestamp = 0;
+    ASSERT_SUCCESS(aws_sys_clock_get_ticks(&timestamp));
+    struct aws_socket_endpoint endpoint;
+    AWS_ZERO_STRUCT(endpoint);
+    snprintf(endpoint.address, sizeof(endpoint.address), LOCAL_SOCK_TEST_PATTERN, (long long unsigned)timestamp);
+
+    size_t completed_before_read = 0;
+    return s_test_socket_queued_writes(allocator, &options, &endpoint, &completed_before_read);
+}
+
+AWS_TEST_CASE(local_socket_queued_writes_in_order, s_local_socket_queued_writes_in_order)
+
+/* With a small watermark, the kernel stops taking data once that much of it is unsent, so the large first write
+ * can't complete, and nothing behind it either, until the other end reads. Once it does, every write completes. */
+static int s_test_tcp_socket_notsent_low_watermark_communication(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_socket_options options;
+    AWS_ZERO_STRUCT(options);
+    options.connect_timeout_ms = 3000;
+    options.type = AWS_SOCKET_STREAM;
+    options.domain = AWS_SOCKET_IPV4;
+    options.notsent_low_watermark = 16 * 1024;
+
+    struct aws_socket_endpoint endpoint = {.address = "127.0.0.1", .port = 8135};
+
+    size_t completed_before_read = 0;
+    ASSERT_SUCCESS(s_test_socket_queued_writes(allocator, &options, &endpoint, &completed_before_read));
+    ASSERT_UINT_EQUALS(0, completed_before_read);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(tcp_socket_notsent_low_watermark_communication, s_test_tcp_socket_notsent_low_watermark_communication)
+
 #ifdef _WIN32
 static int s_local_socket_pipe_connected_race(struct aws_allocator *allocator, void *ctx) {
     (void)ctx;